@@ -0,0 +1,175 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <atomic>
+#include <limits>
+
+#include "audio_core/renderer/command/mix/mix_kernels.h"
+
+#ifdef ARCHITECTURE_x86_64
+#include "common/x64/cpu_detect.h"
+#include "common/x64/simd_target.h"
+#endif
+
+namespace AudioCore::Renderer {
+namespace {
+
+MixKernelPath DetectMixKernelPath() {
+#ifdef ARCHITECTURE_x86_64
+    const auto& caps = Common::GetCPUCaps();
+    if (caps.avx2) {
+        return MixKernelPath::AVX2;
+    }
+    if (caps.sse4_1) {
+        return MixKernelPath::SSE41;
+    }
+#endif
+    return MixKernelPath::Scalar;
+}
+
+std::atomic<MixKernelPath> mix_kernel_path{DetectMixKernelPath()};
+
+#ifdef ARCHITECTURE_x86_64
+// Products are rounded like Common::FixedPoint::to_int, adding half of the fractional part before
+// dropping it. Only the low 32 bits of the result are kept, as the scalar loops truncate it to
+// s32, so a logical 64-bit shift gives the same bits as the arithmetic one.
+
+CITRON_TARGET_SSE41 __m128i RoundProductsSSE41(__m128i products, __m128i fraction_mask) {
+    return _mm_add_epi64(products, _mm_srli_epi64(_mm_and_si128(products, fraction_mask), 1));
+}
+
+// Multiplies four samples by four 32-bit volumes, returning the rounded integer parts.
+CITRON_TARGET_SSE41 __m128i MultiplySSE41(__m128i samples, __m128i volumes,
+                                          __m128i fraction_mask, __m128i shift,
+                                          __m128i high_shift) {
+    const __m128i even{RoundProductsSSE41(_mm_mul_epi32(samples, volumes), fraction_mask)};
+    const __m128i odd{RoundProductsSSE41(
+        _mm_mul_epi32(_mm_srli_epi64(samples, 32), _mm_srli_epi64(volumes, 32)), fraction_mask)};
+    // Shift the odd results straight into the high half of their 64-bit lanes
+    return _mm_blend_epi16(_mm_srl_epi64(even, shift), _mm_sll_epi64(odd, high_shift), 0xCC);
+}
+
+template <bool accumulate>
+CITRON_TARGET_SSE41 u32 ApplySSE41(s32* output, const s32* input, s32 volume, s32 ramp,
+                                   u32 fraction_bits, u32 begin, u32 sample_count) {
+    const __m128i fraction_mask{_mm_set1_epi64x((s64{1} << fraction_bits) - 1)};
+    const __m128i shift{_mm_cvtsi32_si128(static_cast<s32>(fraction_bits))};
+    const __m128i high_shift{_mm_cvtsi32_si128(static_cast<s32>(32 - fraction_bits))};
+    // Volumes wrap around within their lanes, the caller checks that every volume fits in s32
+    const __m128i ramps{_mm_set1_epi32(ramp)};
+    const __m128i step{_mm_slli_epi32(ramps, 2)};
+    __m128i volumes{
+        _mm_add_epi32(_mm_set1_epi32(volume), _mm_mullo_epi32(ramps, _mm_setr_epi32(0, 1, 2, 3)))};
+
+    u32 index{begin};
+    for (; index + 4 <= sample_count; index += 4) {
+        const __m128i samples{_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + index))};
+        __m128i result{MultiplySSE41(samples, volumes, fraction_mask, shift, high_shift)};
+        if constexpr (accumulate) {
+            result = _mm_add_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(output + index)), result);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + index), result);
+        volumes = _mm_add_epi32(volumes, step);
+    }
+    return index;
+}
+
+CITRON_TARGET_AVX2 __m256i RoundProductsAVX2(__m256i products, __m256i fraction_mask) {
+    return _mm256_add_epi64(products,
+                            _mm256_srli_epi64(_mm256_and_si256(products, fraction_mask), 1));
+}
+
+// Multiplies eight samples by eight 32-bit volumes, returning the rounded integer parts.
+CITRON_TARGET_AVX2 __m256i MultiplyAVX2(__m256i samples, __m256i volumes, __m256i fraction_mask,
+                                        __m128i shift, __m128i high_shift) {
+    const __m256i even{RoundProductsAVX2(_mm256_mul_epi32(samples, volumes), fraction_mask)};
+    const __m256i odd{RoundProductsAVX2(
+        _mm256_mul_epi32(_mm256_srli_epi64(samples, 32), _mm256_srli_epi64(volumes, 32)),
+        fraction_mask)};
+    return _mm256_blend_epi32(_mm256_srl_epi64(even, shift), _mm256_sll_epi64(odd, high_shift),
+                              0xAA);
+}
+
+template <bool accumulate>
+CITRON_TARGET_AVX2 u32 ApplyAVX2(s32* output, const s32* input, s32 volume, s32 ramp,
+                                 u32 fraction_bits, u32 sample_count) {
+    const __m256i fraction_mask{_mm256_set1_epi64x((s64{1} << fraction_bits) - 1)};
+    const __m128i shift{_mm_cvtsi32_si128(static_cast<s32>(fraction_bits))};
+    const __m128i high_shift{_mm_cvtsi32_si128(static_cast<s32>(32 - fraction_bits))};
+    const __m256i ramps{_mm256_set1_epi32(ramp)};
+    const __m256i step{_mm256_slli_epi32(ramps, 3)};
+    __m256i volumes{_mm256_add_epi32(
+        _mm256_set1_epi32(volume),
+        _mm256_mullo_epi32(ramps, _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)))};
+
+    u32 index{};
+    for (; index + 8 <= sample_count; index += 8) {
+        const __m256i samples{
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + index))};
+        __m256i result{MultiplyAVX2(samples, volumes, fraction_mask, shift, high_shift)};
+        if constexpr (accumulate) {
+            result = _mm256_add_epi32(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(output + index)), result);
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + index), result);
+        volumes = _mm256_add_epi32(volumes, step);
+    }
+    return index;
+}
+
+constexpr bool FitsInS32(s64 value) {
+    return value >= std::numeric_limits<s32>::min() && value <= std::numeric_limits<s32>::max();
+}
+#endif
+
+template <bool accumulate>
+u32 ApplyVectorized(std::span<s32> output, std::span<const s32> input, s64 volume, s64 ramp,
+                    u32 fraction_bits, u32 sample_count) {
+#ifdef ARCHITECTURE_x86_64
+    const MixKernelPath path{mix_kernel_path.load(std::memory_order::relaxed)};
+    if (path == MixKernelPath::Scalar || sample_count == 0) {
+        return 0;
+    }
+    // The kernels multiply by 32-bit volumes, anything louder is left to the scalar loops
+    const s64 last_volume{volume + ramp * static_cast<s64>(sample_count - 1)};
+    if (!FitsInS32(volume) || !FitsInS32(last_volume)) {
+        return 0;
+    }
+    // Only the low 32 bits of the ramp are needed for the volumes to wrap to the right values
+    const s32 lane_ramp{static_cast<s32>(ramp)};
+
+    u32 index{};
+    if (path == MixKernelPath::AVX2) {
+        index = ApplyAVX2<accumulate>(output.data(), input.data(), static_cast<s32>(volume),
+                                      lane_ramp, fraction_bits, sample_count);
+    }
+    const s32 volume_at_index{static_cast<s32>(volume + ramp * static_cast<s64>(index))};
+    return ApplySSE41<accumulate>(output.data(), input.data(), volume_at_index, lane_ramp,
+                                  fraction_bits, index, sample_count);
+#else
+    return 0;
+#endif
+}
+
+} // Anonymous namespace
+
+MixKernelPath GetMixKernelPath() {
+    return mix_kernel_path.load(std::memory_order::relaxed);
+}
+
+void SetMixKernelPath(MixKernelPath path) {
+    mix_kernel_path.store(path, std::memory_order::relaxed);
+}
+
+u32 ApplyMixVectorized(std::span<s32> output, std::span<const s32> input, s64 volume, s64 ramp,
+                       u32 fraction_bits, u32 sample_count) {
+    return ApplyVectorized<true>(output, input, volume, ramp, fraction_bits, sample_count);
+}
+
+u32 ApplyGainVectorized(std::span<s32> output, std::span<const s32> input, s64 volume, s64 ramp,
+                        u32 fraction_bits, u32 sample_count) {
+    return ApplyVectorized<false>(output, input, volume, ramp, fraction_bits, sample_count);
+}
+
+} // namespace AudioCore::Renderer
@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <span>
+
+#include "common/common_types.h"
+
+namespace AudioCore::Renderer {
+
+/// Instruction set used by the vectorized mix kernels.
+enum class MixKernelPath {
+    Scalar,
+    SSE41,
+    AVX2,
+};
+
+/**
+ * Get the kernel path used by the mix commands, the fastest one supported by the host unless
+ * it was overridden.
+ *
+ * @return The current kernel path.
+ */
+MixKernelPath GetMixKernelPath();
+
+/**
+ * Override the kernel path used by the mix commands. Used to compare the vectorized kernels
+ * against the scalar reference.
+ *
+ * @param path - The kernel path to use, must be supported by the host.
+ */
+void SetMixKernelPath(MixKernelPath path);
+
+/**
+ * Add the input samples, with a linearly ramped volume applied, to the output samples.
+ * The result is bit-exact with the Common::FixedPoint loops of the mix commands.
+ *
+ * @param output        - Output mix buffer.
+ * @param input         - Input mix buffer.
+ * @param volume        - Raw fixed point volume applied to the first sample.
+ * @param ramp          - Raw fixed point ramp added to the volume every sample.
+ * @param fraction_bits - Number of fractional bits of the volume and ramp.
+ * @param sample_count  - Number of samples to process.
+ * @return Number of samples processed, the caller handles the remaining ones.
+ */
+u32 ApplyMixVectorized(std::span<s32> output, std::span<const s32> input, s64 volume, s64 ramp,
+                       u32 fraction_bits, u32 sample_count);
+
+/**
+ * Apply a linearly ramped volume to the input samples, saving them to the output samples.
+ * The result is bit-exact with the Common::FixedPoint loops of the volume commands.
+ *
+ * @param output        - Output mix buffer.
+ * @param input         - Input mix buffer.
+ * @param volume        - Raw fixed point volume applied to the first sample.
+ * @param ramp          - Raw fixed point ramp added to the volume every sample.
+ * @param fraction_bits - Number of fractional bits of the volume and ramp.
+ * @param sample_count  - Number of samples to process.
+ * @return Number of samples processed, the caller handles the remaining ones.
+ */
+u32 ApplyGainVectorized(std::span<s32> output, std::span<const s32> input, s64 volume, s64 ramp,
+                        u32 fraction_bits, u32 sample_count);
+
+} // namespace AudioCore::Renderer
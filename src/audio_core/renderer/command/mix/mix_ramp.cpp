@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include "audio_core/adsp/apps/audio_renderer/command_list_processor.h"
+#include "audio_core/renderer/command/mix/mix_kernels.h"
 #include "audio_core/renderer/command/mix/mix_ramp.h"
 #include "common/fixed_point.h"
 #include "common/logging/log.h"
@@ -11,22 +12,34 @@ namespace AudioCore::Renderer {
 template <size_t Q>
 s32 ApplyMixRamp(std::span<s32> output, std::span<const s32> input, const f32 volume_,
                  const f32 ramp_, const u32 sample_count) {
-    Common::FixedPoint<64 - Q, Q> volume{volume_};
-    Common::FixedPoint<64 - Q, Q> sample{0};
+    using FixedPoint = Common::FixedPoint<64 - Q, Q>;
+    FixedPoint volume{volume_};
+
+    if (sample_count == 0) {
+        return 0;
+    }
+    // Read before mixing, the input and output buffers may be the same
+    const s32 last_input{input[sample_count - 1]};
 
     if (ramp_ == 0.0f) {
-        for (u32 i = 0; i < sample_count; i++) {
-            sample = input[i] * volume;
-            output[i] = (output[i] + sample).to_int();
+        u32 i{ApplyMixVectorized(output, input, volume.to_raw(), 0, Q, sample_count)};
+        for (; i < sample_count; i++) {
+            output[i] = (output[i] + input[i] * volume).to_int();
         }
     } else {
-        Common::FixedPoint<64 - Q, Q> ramp{ramp_};
-        for (u32 i = 0; i < sample_count; i++) {
-            sample = input[i] * volume;
-            output[i] = (output[i] + sample).to_int();
+        const FixedPoint ramp{ramp_};
+        const FixedPoint initial_volume{volume};
+        u32 i{ApplyMixVectorized(output, input, volume.to_raw(), ramp.to_raw(), Q, sample_count)};
+        volume = FixedPoint::from_base(initial_volume.to_raw() + ramp.to_raw() * i);
+        for (; i < sample_count; i++) {
+            output[i] = (output[i] + input[i] * volume).to_int();
             volume += ramp;
         }
+        volume = FixedPoint::from_base(initial_volume.to_raw() +
+                                       ramp.to_raw() * static_cast<s64>(sample_count - 1));
     }
+    // The last gained sample is returned for depopping
+    FixedPoint sample{last_input * volume};
     return sample.to_int();
 }
 
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include "audio_core/adsp/apps/audio_renderer/command_list_processor.h"
+#include "audio_core/renderer/command/mix/mix_kernels.h"
 #include "audio_core/renderer/command/mix/volume_ramp.h"
 #include "common/fixed_point.h"
 
@@ -25,13 +26,16 @@ static void ApplyLinearEnvelopeGain(std::span<s32> output, std::span<const s32>
         std::memcpy(output.data(), input.data(), output.size_bytes());
     } else if (ramp_ == 0.0f) {
         const Common::FixedPoint<64 - Q, Q> gain{volume};
-        for (u32 i = 0; i < sample_count; i++) {
+        u32 i{ApplyGainVectorized(output, input, gain.to_raw(), 0, Q, sample_count)};
+        for (; i < sample_count; i++) {
             output[i] = (input[i] * gain).to_int();
         }
     } else {
         Common::FixedPoint<64 - Q, Q> gain{volume};
         const Common::FixedPoint<64 - Q, Q> ramp{ramp_};
-        for (u32 i = 0; i < sample_count; i++) {
+        u32 i{ApplyGainVectorized(output, input, gain.to_raw(), ramp.to_raw(), Q, sample_count)};
+        gain = Common::FixedPoint<64 - Q, Q>::from_base(gain.to_raw() + ramp.to_raw() * i);
+        for (; i < sample_count; i++) {
             output[i] = (input[i] * gain).to_int();
             gain += ramp;
         }
@@ -216,6 +216,11 @@ std::unique_ptr<TranslationMap> InitializeTranslations(QWidget* parent) {
            tr("Enables GPU vendor-specific pipeline cache.\nThis option can improve shader loading "
               "time significantly in cases where the Vulkan driver does not store pipeline cache "
               "files internally."));
+    INSERT(Settings, use_speculative_pipelines, tr("Use speculative pipeline compilation"),
+           tr("Defers cached pipelines that usually follow another one at boot, and compiles "
+              "them when their predecessor is used.\nThis can shorten loading times, but "
+              "pipelines predicted too late are built on the draw that needs them.\nThis "
+              "feature is experimental."));
     INSERT(
         Settings, enable_compute_pipelines, tr("Enable Compute Pipelines (Intel Vulkan Only)"),
         tr("Enable compute pipelines, required by some games.\nThis setting only exists for Intel "
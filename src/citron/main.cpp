@@ -2,6 +2,7 @@
 // SPDX-FileCopyrightText: 2025 citron Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <atomic>
 #include <cinttypes>
 #include <clocale>
 #include <cmath>
@@ -3416,40 +3417,61 @@ void GMainWindow::OnMenuInstallToNAND() {
     install_progress->setFixedWidth(installDialog.GetMinimumWidth() + 40);
     install_progress->show();
 
+    // Install all NSPs together, so that their reads, verification and writes overlap
+    std::vector<std::string> nsp_files;
     for (const QString& file : files) {
-        install_progress->setWindowTitle(tr("%n file(s) remaining", "", remaining));
-        install_progress->setLabelText(
-            tr("Installing file \"%1\"...").arg(QFileInfo(file).fileName()));
+        if (file.endsWith(QStringLiteral("nsp"), Qt::CaseInsensitive)) {
+            nsp_files.push_back(file.toStdString());
+        }
+    }
 
-        QFuture<ContentManager::InstallResult> future;
-        ContentManager::InstallResult result;
+    std::vector<ContentManager::InstallResult> nsp_results;
+    if (!nsp_files.empty()) {
+        install_progress->setWindowTitle(
+            tr("%n file(s) remaining", "", static_cast<int>(nsp_files.size())));
 
-        if (file.endsWith(QStringLiteral("nsp"), Qt::CaseInsensitive)) {
-            const auto progress_callback = [this](size_t size, size_t progress) {
-                emit UpdateInstallProgress();
-                if (install_progress->wasCanceled()) {
-                    return true;
-                }
-                return false;
-            };
-            future = QtConcurrent::run([this, &file, progress_callback] {
-                return ContentManager::InstallNSP(*system, *vfs, file.toStdString(),
-                                                  progress_callback);
+        std::atomic<size_t> nsp_progress{};
+        std::atomic<double> nsp_speed{};
+        const auto progress_callback = [&, this](size_t size, size_t progress, double speed) {
+            nsp_progress = progress;
+            nsp_speed = speed;
+            return install_progress->wasCanceled();
+        };
+        QFuture<std::vector<ContentManager::InstallResult>> future =
+            QtConcurrent::run([this, &nsp_files, progress_callback] {
+                return ContentManager::InstallNSPs(*system, *vfs, nsp_files, progress_callback);
             });
 
-            while (!future.isFinished()) {
-                QCoreApplication::processEvents();
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
-            }
+        const int start_value = install_progress->value();
+        while (!future.isFinished()) {
+            install_progress->setValue(start_value +
+                                       static_cast<int>(nsp_progress.load() / CopyBufferSize));
+            install_progress->setLabelText(
+                tr("Installing %n file(s) (%1 MB/s)...", "", static_cast<int>(nsp_files.size()))
+                    .arg(nsp_speed.load(), 0, 'f', 1));
+            QCoreApplication::processEvents();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        nsp_results = future.result();
+        remaining -= static_cast<int>(nsp_files.size());
+    }
 
-            result = future.result();
+    size_t nsp_index = 0;
+    for (const QString& file : files) {
+        ContentManager::InstallResult result;
 
+        if (file.endsWith(QStringLiteral("nsp"), Qt::CaseInsensitive)) {
+            result = nsp_results[nsp_index++];
         } else {
+            install_progress->setWindowTitle(tr("%n file(s) remaining", "", remaining));
+            install_progress->setLabelText(
+                tr("Installing file \"%1\"...").arg(QFileInfo(file).fileName()));
             result = InstallNCA(file);
+            --remaining;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
         }
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-
         switch (result) {
         case ContentManager::InstallResult::Success:
             new_files.append(QFileInfo(file).fileName());
@@ -3465,8 +3487,6 @@ void GMainWindow::OnMenuInstallToNAND() {
             detected_base_install = true;
             break;
         }
-
-        --remaining;
     }
 
     install_progress->close();
@@ -1,16 +1,24 @@
 // SPDX-FileCopyrightText: 2014 Citra Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <atomic>
 #include <chrono>
+#include <cmath>
 #include <iostream>
 #include <memory>
+#include <numeric>
+#include <optional>
 #include <regex>
 #include <string>
+#include <string_view>
 #include <thread>
 
 #include <fmt/ostream.h>
+#include <fmt/ranges.h>
 
 #include "common/detached_tasks.h"
+#include "common/fs/file.h"
+#include "common/fs/path_util.h"
 #include "common/logging/backend.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
@@ -29,12 +37,16 @@
 #include "core/hle/service/am/applet_manager.h"
 #include "core/hle/service/filesystem/filesystem.h"
 #include "core/loader/loader.h"
+#include "core/perf_stats.h"
 #include "core/telemetry_session.h"
 #include "frontend_common/config.h"
+#include "input_common/drivers/tas_input.h"
 #include "input_common/main.h"
 #include "network/network.h"
 #include "sdl_config.h"
+#include "video_core/gpu.h"
 #include "video_core/renderer_base.h"
+#include "video_core/shader_notify.h"
 #include "citron_cmd/emu_window/emu_window_sdl2.h"
 #include "citron_cmd/emu_window/emu_window_sdl2_gl.h"
 #include "citron_cmd/emu_window/emu_window_sdl2_null.h"
@@ -44,6 +56,7 @@
 // windows.h needs to be included before shellapi.h
 #include <windows.h>
 
+#include <psapi.h>
 #include <shellapi.h>
 
 #include "common/windows/timer_resolution.h"
@@ -54,6 +67,9 @@
 #ifndef _MSC_VER
 #include <unistd.h>
 #endif
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
 
 #ifdef _WIN32
 extern "C" {
@@ -71,6 +87,8 @@ __declspec(dllexport) int AmdPowerXpressRequestHighPerformance = 1;
 static void PrintHelp(const char* argv0) {
     std::cout << "Usage: " << argv0
               << " [options] <filename>\n"
+                 "--benchmark=N[f|s]    Run for N frames, or N seconds, then print a JSON report\n"
+                 "                      of the run and exit\n"
                  "-c, --config          Load the specified configuration file\n"
                  "-f, --fullscreen      Start in fullscreen mode\n"
                  "-g, --game            File path of the game to load\n"
@@ -78,6 +96,11 @@ static void PrintHelp(const char* argv0) {
                  "-m, --multiplayer=nick:password@address:port"
                  " Nickname, password, address and port for multiplayer\n"
                  "-p, --program         Pass following string as arguments to executable\n"
+                 "--renderer=<name>     Use the opengl, vulkan or null renderer\n"
+                 "--report=<path>       Write the benchmark report to a file instead of stdout\n"
+                 "--tas=<directory>     Play back the TAS scripts in the directory from boot\n"
+                 "--timeout=N           Stop a frame count benchmark that did not finish after N\n"
+                 "                      seconds, 600 by default\n"
                  "-u, --user            Select a specific user profile from 0 to 7\n"
                  "-v, --version         Output version information and exit\n";
 }
@@ -86,6 +109,160 @@ static void PrintVersion() {
     std::cout << "citron " << Common::g_scm_branch << " " << Common::g_scm_desc << std::endl;
 }
 
+struct BenchmarkOptions {
+    /// Number of presented frames to run for, zero when running for a duration instead
+    u64 frames{};
+    std::chrono::seconds duration{};
+    /// Wall-clock limit of a frame count run, in case the guest stops presenting frames
+    std::chrono::seconds timeout{600};
+    /// Where to write the report to, standard output if empty
+    std::string report_path;
+};
+
+/// Parses the argument of --benchmark, a frame count or a number of seconds suffixed with s
+static std::optional<BenchmarkOptions> ParseBenchmarkOptions(const std::string& arg) {
+    char* end{};
+    const u64 count = std::strtoull(arg.c_str(), &end, 10);
+    const std::string suffix{end};
+    if (end == arg.c_str() || count == 0) {
+        return std::nullopt;
+    }
+    BenchmarkOptions options;
+    if (suffix.empty() || suffix == "f") {
+        options.frames = count;
+    } else if (suffix == "s") {
+        options.duration = std::chrono::seconds{count};
+    } else {
+        return std::nullopt;
+    }
+    return options;
+}
+
+static std::optional<Settings::RendererBackend> ParseRendererBackend(const std::string& arg) {
+    const auto name = Common::ToLower(arg);
+    for (const auto& [canonical_name, backend] :
+         Settings::EnumMetadata<Settings::RendererBackend>::Canonicalizations()) {
+        if (Common::ToLower(canonical_name) == name) {
+            return backend;
+        }
+    }
+    return std::nullopt;
+}
+
+/// Returns the peak resident set size of the process in bytes, or zero if it is not available
+static u64 GetPeakMemoryUsage() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return counters.PeakWorkingSetSize;
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<u64>(usage.ru_maxrss);
+#else
+    // Reported in kilobytes everywhere but on macOS
+    return static_cast<u64>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+/// Handles window events until the benchmark ran for long enough, the window was closed, the
+/// application exited or the run timed out. Then pauses emulation and writes the report, which
+/// records why the run stopped. Returns true only for completed runs.
+static bool RunBenchmark(Core::System& system, EmuWindow_SDL2& emu_window,
+                         const BenchmarkOptions& options,
+                         const std::atomic_bool& application_exited) {
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    const u64 start_frame = emu_window.FramesDisplayed();
+    // Only count what happens once the guest runs, the disk shader cache is loaded before
+    const int start_shaders = system.GPU().ShaderNotify().ShadersCompleted();
+    const std::size_t start_history = system.GetPerfStats().GetFrametimeHistorySize();
+    void(system.GetAndResetPerfStats());
+
+    std::string_view status = "completed";
+    while (true) {
+        const auto run_time = Clock::now() - start;
+        if (options.frames != 0 ? emu_window.FramesDisplayed() - start_frame >= options.frames
+                                : run_time >= options.duration) {
+            break;
+        }
+        if (!emu_window.IsOpen()) {
+            status = "window_closed";
+            break;
+        }
+        if (application_exited) {
+            status = "application_exited";
+            break;
+        }
+        if (options.frames != 0 && run_time >= options.timeout) {
+            status = "timed_out";
+            break;
+        }
+        emu_window.WaitEvent(std::chrono::milliseconds{10});
+    }
+
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+    const u64 frames = emu_window.FramesDisplayed() - start_frame;
+    void(system.Pause());
+    if (status != "completed") {
+        LOG_ERROR(Frontend, "Benchmark stopped after {} frames: {}", frames, status);
+    }
+
+    // Divisions by zero frames would otherwise produce values JSON can not represent
+    const auto finite = [](double value) { return std::isfinite(value) ? value : 0.0; };
+    const auto results = system.GetAndResetPerfStats();
+    const auto frametimes = system.GetPerfStats().GetFrametimeHistory(start_history);
+    const double mean_frametime =
+        std::accumulate(frametimes.begin(), frametimes.end(), 0.0) /
+        static_cast<double>(frametimes.size());
+    const auto report = fmt::format(
+        "{{\n"
+        "  \"status\": \"{}\",\n"
+        "  \"title_id\": \"{:016X}\",\n"
+        "  \"renderer\": \"{}\",\n"
+        "  \"frames\": {},\n"
+        "  \"seconds\": {:.3f},\n"
+        "  \"fps\": {:.3f},\n"
+        "  \"perf_stats\": {{\n"
+        "    \"system_fps\": {:.3f},\n"
+        "    \"average_game_fps\": {:.3f},\n"
+        "    \"frametime_ms\": {:.3f},\n"
+        "    \"emulation_speed\": {:.3f},\n"
+        "    \"mean_frametime_ms\": {:.3f}\n"
+        "  }},\n"
+        "  \"shaders_compiled\": {},\n"
+        "  \"peak_rss_bytes\": {},\n"
+        "  \"frametimes_ms\": [{:.3f}]\n"
+        "}}\n",
+        status, system.GetApplicationProcessProgramID(),
+        Settings::CanonicalizeEnum(Settings::values.renderer_backend.GetValue()), frames,
+        elapsed.count(), finite(static_cast<double>(frames) / elapsed.count()),
+        finite(results.system_fps), finite(results.average_game_fps),
+        finite(results.frametime * 1000.0), finite(results.emulation_speed),
+        finite(mean_frametime), system.GPU().ShaderNotify().ShadersCompleted() - start_shaders,
+        GetPeakMemoryUsage(), fmt::join(frametimes, ", "));
+
+    const bool completed = status == "completed";
+    if (options.report_path.empty()) {
+        fmt::print("{}", report);
+        return completed;
+    }
+    Common::FS::IOFile file(options.report_path, Common::FS::FileAccessMode::Write,
+                            Common::FS::FileType::TextFile);
+    if (file.WriteString(report) != report.size()) {
+        LOG_CRITICAL(Frontend, "Failed to write the benchmark report to {}", options.report_path);
+        return false;
+    }
+    LOG_INFO(Frontend, "Wrote the benchmark report to {}", options.report_path);
+    return completed;
+}
+
 static void OnStateChanged(const Network::RoomMember::State& state) {
     switch (state) {
     case Network::RoomMember::State::Idle:
@@ -211,6 +388,11 @@ int main(int argc, char** argv) {
     std::optional<std::string> config_path;
     std::string program_args;
     std::optional<int> selected_user;
+    std::optional<BenchmarkOptions> benchmark;
+    std::optional<Settings::RendererBackend> renderer_backend;
+    std::string report_path;
+    std::optional<std::chrono::seconds> benchmark_timeout;
+    std::string tas_path;
 
     bool use_multiplayer = false;
     bool fullscreen = false;
@@ -221,12 +403,17 @@ int main(int argc, char** argv) {
 
     static struct option long_options[] = {
         // clang-format off
+        {"benchmark", required_argument, 0, 'b'},
         {"config", required_argument, 0, 'c'},
         {"fullscreen", no_argument, 0, 'f'},
         {"help", no_argument, 0, 'h'},
         {"game", required_argument, 0, 'g'},
         {"multiplayer", required_argument, 0, 'm'},
         {"program", optional_argument, 0, 'p'},
+        {"renderer", required_argument, 0, 'r'},
+        {"report", required_argument, 0, 'o'},
+        {"tas", required_argument, 0, 't'},
+        {"timeout", required_argument, 0, 'i'},
         {"user", required_argument, 0, 'u'},
         {"version", no_argument, 0, 'v'},
         {0, 0, 0, 0},
@@ -237,6 +424,14 @@ int main(int argc, char** argv) {
         int arg = getopt_long(argc, argv, "g:fhvp::c:u:", long_options, &option_index);
         if (arg != -1) {
             switch (static_cast<char>(arg)) {
+            case 'b':
+                benchmark = ParseBenchmarkOptions(optarg);
+                if (!benchmark) {
+                    std::cout << "Wrong format for option --benchmark\n";
+                    PrintHelp(argv[0]);
+                    return 0;
+                }
+                break;
             case 'c':
                 config_path = optarg;
                 break;
@@ -289,6 +484,31 @@ int main(int argc, char** argv) {
                 program_args = argv[optind];
                 ++optind;
                 break;
+            case 'r':
+                renderer_backend = ParseRendererBackend(optarg);
+                if (!renderer_backend) {
+                    std::cout << "Unknown renderer " << optarg << "\n";
+                    PrintHelp(argv[0]);
+                    return 0;
+                }
+                break;
+            case 'o':
+                report_path = optarg;
+                break;
+            case 't':
+                tas_path = optarg;
+                break;
+            case 'i': {
+                char* end{};
+                const u64 seconds = std::strtoull(optarg, &end, 10);
+                if (end == optarg || *end != '\0' || seconds == 0) {
+                    std::cout << "Wrong format for option --timeout\n";
+                    PrintHelp(argv[0]);
+                    return 0;
+                }
+                benchmark_timeout = std::chrono::seconds{seconds};
+                break;
+            }
             case 'u':
                 selected_user = atoi(optarg);
                 break;
@@ -322,6 +542,21 @@ int main(int argc, char** argv) {
         Settings::values.current_user = std::clamp(*selected_user, 0, 7);
     }
 
+    if (renderer_backend.has_value()) {
+        Settings::values.renderer_backend = *renderer_backend;
+    }
+
+    if (!tas_path.empty()) {
+        Common::FS::SetCitronPath(Common::FS::CitronPath::TASDir, tas_path);
+        Settings::values.tas_enable = true;
+        Settings::values.tas_loop = false;
+    }
+
+    if (benchmark.has_value()) {
+        benchmark->report_path = report_path;
+        benchmark->timeout = benchmark_timeout.value_or(benchmark->timeout);
+    }
+
 #ifdef _WIN32
     LocalFree(argv_w);
 #endif
@@ -430,7 +665,13 @@ int main(int argc, char** argv) {
             [](VideoCore::LoadCallbackStage, size_t value, size_t total) {});
     }
 
+    // A benchmark still has to write its report when the application exits
+    std::atomic_bool application_exited{false};
     system.RegisterExitCallback([&] {
+        if (benchmark.has_value()) {
+            application_exited = true;
+            return;
+        }
         // Just exit right away.
         exit(0);
     });
@@ -439,12 +680,21 @@ int main(int argc, char** argv) {
     Common::Linux::StartGamemode();
 #endif
 
+    if (!tas_path.empty()) {
+        input_subsystem.GetTas()->StartStop();
+    }
+
+    bool success = true;
     void(system.Run());
     if (system.DebuggerEnabled()) {
         system.InitializeDebugger();
     }
-    while (emu_window->IsOpen()) {
-        emu_window->WaitEvent();
+    if (benchmark.has_value()) {
+        success = RunBenchmark(system, *emu_window, *benchmark, application_exited);
+    } else {
+        while (emu_window->IsOpen()) {
+            emu_window->WaitEvent();
+        }
     }
     system.DetachDebugger();
     void(system.Pause());
@@ -455,5 +705,5 @@ int main(int argc, char** argv) {
 #endif
 
     detached_tasks.WaitForAllTasks();
-    return 0;
+    return success ? 0 : -1;
 }
@@ -12,6 +12,7 @@
 #include "hid_core/hid_core.h"
 #include "input_common/drivers/keyboard.h"
 #include "input_common/drivers/mouse.h"
+#include "input_common/drivers/tas_input.h"
 #include "input_common/drivers/touch_screen.h"
 #include "input_common/main.h"
 #include "citron_cmd/emu_window/emu_window_sdl2.h"
@@ -107,6 +108,15 @@ bool EmuWindow_SDL2::IsOpen() const {
     return is_open;
 }
 
+void EmuWindow_SDL2::OnFrameDisplayed() {
+    input_subsystem->GetTas()->UpdateThread();
+    frames_displayed.fetch_add(1, std::memory_order_relaxed);
+}
+
+u64 EmuWindow_SDL2::FramesDisplayed() const {
+    return frames_displayed.load(std::memory_order_relaxed);
+}
+
 bool EmuWindow_SDL2::IsShown() const {
     return is_shown;
 }
@@ -173,6 +183,31 @@ void EmuWindow_SDL2::WaitEvent() {
         exit(1);
     }
 
+    HandleEvent(event);
+
+    const u32 current_time = SDL_GetTicks();
+    if (current_time > last_time + 2000) {
+        const auto results = system.GetAndResetPerfStats();
+        const auto title =
+            fmt::format("citron {} | {}-{} | FPS: {:.0f} ({:.0f}%)", Common::g_build_fullname,
+                        Common::g_scm_branch, Common::g_scm_desc, results.average_game_fps,
+                        results.emulation_speed * 100.0);
+        SDL_SetWindowTitle(render_window, title.c_str());
+        last_time = current_time;
+    }
+}
+
+void EmuWindow_SDL2::WaitEvent(std::chrono::milliseconds timeout) {
+    // Called on main thread
+    SDL_Event event;
+
+    // Errors are not told apart from timeouts, the caller polls again either way
+    if (SDL_WaitEventTimeout(&event, static_cast<int>(timeout.count()))) {
+        HandleEvent(event);
+    }
+}
+
+void EmuWindow_SDL2::HandleEvent(const SDL_Event& event) {
     switch (event.type) {
     case SDL_WINDOWEVENT:
         switch (event.window.event) {
@@ -228,17 +263,6 @@ void EmuWindow_SDL2::WaitEvent() {
     default:
         break;
     }
-
-    const u32 current_time = SDL_GetTicks();
-    if (current_time > last_time + 2000) {
-        const auto results = system.GetAndResetPerfStats();
-        const auto title =
-            fmt::format("citron {} | {}-{} | FPS: {:.0f} ({:.0f}%)", Common::g_build_fullname,
-                        Common::g_scm_branch, Common::g_scm_desc, results.average_game_fps,
-                        results.emulation_speed * 100.0);
-        SDL_SetWindowTitle(render_window, title.c_str());
-        last_time = current_time;
-    }
 }
 
 // Credits to Samantas5855 and others for this function.
@@ -4,12 +4,15 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <utility>
 
 #include "core/frontend/emu_window.h"
 #include "core/frontend/graphics_context.h"
 
 struct SDL_Window;
+union SDL_Event;
 
 namespace Core {
 class System;
@@ -34,10 +37,23 @@ public:
     /// Wait for the next event on the main thread.
     void WaitEvent();
 
+    /// Wait up to timeout for the next event on the main thread. Unlike WaitEvent this does not
+    /// update the window title, so the performance statistics are not reset.
+    void WaitEvent(std::chrono::milliseconds timeout);
+
+    /// Called from the render thread after each presented frame, advances TAS playback.
+    void OnFrameDisplayed() override;
+
+    /// Returns the number of frames presented since the window was created
+    u64 FramesDisplayed() const;
+
     // Sets the window icon from citron.bmp
     void SetWindowIcon();
 
 protected:
+    /// Dispatches an event received by WaitEvent
+    void HandleEvent(const SDL_Event& event);
+
     /// Called by WaitEvent when a key is pressed or released.
     void OnKeyEvent(int key, u8 state);
 
@@ -89,6 +105,9 @@ protected:
     /// Keeps track of how often to update the title bar during gameplay
     u32 last_time = 0;
 
+    /// Number of frames presented by the renderer
+    std::atomic<u64> frames_displayed = 0;
+
     /// Input subsystem to use with this window.
     InputCommon::InputSubsystem* input_subsystem;
 
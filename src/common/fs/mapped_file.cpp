@@ -0,0 +1,129 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cerrno>
+#include <utility>
+
+#include "common/fs/mapped_file.h"
+#include "common/fs/path_util.h"
+#include "common/logging/log.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Common::FS {
+
+MappedFile::MappedFile() = default;
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+    Open(path);
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    std::swap(data, other.data);
+    std::swap(size, other.size);
+#ifdef _WIN32
+    std::swap(mapping_handle, other.mapping_handle);
+#endif
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    std::swap(data, other.data);
+    std::swap(size, other.size);
+#ifdef _WIN32
+    std::swap(mapping_handle, other.mapping_handle);
+#endif
+    return *this;
+}
+
+#ifdef _WIN32
+
+void MappedFile::Open(const std::filesystem::path& path) {
+    Close();
+
+    const HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                    nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    LARGE_INTEGER file_size{};
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(file);
+        return;
+    }
+    const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) {
+        LOG_ERROR(Common_Filesystem, "Failed to create file mapping of {}, error={}",
+                  PathToUTF8String(path), GetLastError());
+        return;
+    }
+    void* const view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        LOG_ERROR(Common_Filesystem, "Failed to map {}, error={}", PathToUTF8String(path),
+                  GetLastError());
+        CloseHandle(mapping);
+        return;
+    }
+    data = static_cast<const u8*>(view);
+    size = static_cast<size_t>(file_size.QuadPart);
+    mapping_handle = mapping;
+}
+
+void MappedFile::Close() {
+    if (data != nullptr) {
+        UnmapViewOfFile(data);
+        CloseHandle(mapping_handle);
+    }
+    data = nullptr;
+    size = 0;
+    mapping_handle = nullptr;
+}
+
+#else
+
+void MappedFile::Open(const std::filesystem::path& path) {
+    Close();
+
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return;
+    }
+    struct stat file_stat {};
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+        close(fd);
+        return;
+    }
+    const size_t file_size = static_cast<size_t>(file_stat.st_size);
+    void* const view = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file
+    close(fd);
+    if (view == MAP_FAILED) {
+        LOG_ERROR(Common_Filesystem, "Failed to map {}, errno={}", PathToUTF8String(path), errno);
+        return;
+    }
+    data = static_cast<const u8*>(view);
+    size = file_size;
+}
+
+void MappedFile::Close() {
+    if (data != nullptr) {
+        munmap(const_cast<u8*>(data), size);
+    }
+    data = nullptr;
+    size = 0;
+}
+
+#endif
+
+} // namespace Common::FS
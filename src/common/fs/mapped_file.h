@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <filesystem>
+#include <span>
+
+#include "common/common_types.h"
+
+namespace Common::FS {
+
+/**
+ * A read-only memory mapping of a whole file.
+ * The mapping stays valid until the object is destroyed, even if the file is later modified.
+ * Writes to the file made after the mapping was created may or may not be visible through it.
+ */
+class MappedFile final {
+public:
+    MappedFile();
+
+    /**
+     * Maps the file at path for reading.
+     * Use IsOpen to check whether the mapping succeeded. Empty files can not be mapped.
+     *
+     * @param path Filesystem path
+     */
+    explicit MappedFile(const std::filesystem::path& path);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * Maps the file at path for reading, releasing any previous mapping.
+     *
+     * @param path Filesystem path
+     */
+    void Open(const std::filesystem::path& path);
+
+    /// Releases the mapping.
+    void Close();
+
+    /**
+     * Checks whether the file is mapped.
+     *
+     * @returns True if the file is mapped, false otherwise.
+     */
+    [[nodiscard]] bool IsOpen() const {
+        return data != nullptr;
+    }
+
+    /**
+     * Gets the mapped contents of the file.
+     *
+     * @returns A span over the whole file, empty if the file is not mapped.
+     */
+    [[nodiscard]] std::span<const u8> Span() const {
+        return {data, size};
+    }
+
+private:
+    const u8* data{};
+    size_t size{};
+#ifdef _WIN32
+    void* mapping_handle{};
+#endif
+};
+
+} // namespace Common::FS
@@ -1,10 +1,15 @@
 // SPDX-FileCopyrightText: 2014 Citra Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <climits>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #include <fmt/format.h>
 
@@ -175,6 +180,66 @@ public:
 };
 #endif
 
+/**
+ * A log call queued on the ring of its thread, usually with its message not formatted yet
+ */
+struct DeferredEntry {
+    std::chrono::microseconds timestamp;
+    Class log_class;
+    Level log_level;
+    const char* filename;
+    unsigned int line_num;
+    const char* function;
+    const char* format;
+    DeferredFormatter formatter; ///< Null when the message was formatted by the caller
+    std::array<u64, MaxDeferredArgs> args;
+    std::string message;
+};
+
+/**
+ * Lock-free ring of deferred entries written by a single thread and read by the logging thread.
+ */
+class DeferredRing {
+public:
+    /// Moves the entry into the ring, it is left untouched when the ring is full.
+    bool TryPush(DeferredEntry& entry) {
+        const size_t write_index = m_write_index.load(std::memory_order::relaxed);
+        if (write_index - m_cached_read_index == Capacity) {
+            // Only look at the consumer's index when the ring looks full
+            m_cached_read_index = m_read_index.load(std::memory_order::acquire);
+            if (write_index - m_cached_read_index == Capacity) {
+                return false;
+            }
+        }
+        m_entries[write_index % Capacity] = std::move(entry);
+        m_write_index.store(write_index + 1, std::memory_order::release);
+        return true;
+    }
+
+    bool TryPop(DeferredEntry& entry) {
+        const size_t read_index = m_read_index.load(std::memory_order::relaxed);
+        if (read_index == m_write_index.load(std::memory_order::acquire)) {
+            return false;
+        }
+        entry = std::move(m_entries[read_index % Capacity]);
+        m_read_index.store(read_index + 1, std::memory_order::release);
+        return true;
+    }
+
+    bool IsEmpty() const {
+        return m_read_index.load(std::memory_order::acquire) ==
+               m_write_index.load(std::memory_order::acquire);
+    }
+
+private:
+    static constexpr size_t Capacity = 0x400;
+
+    alignas(128) std::atomic_size_t m_read_index{0};
+    alignas(128) std::atomic_size_t m_write_index{0};
+    size_t m_cached_read_index{0};
+    std::array<DeferredEntry, Capacity> m_entries;
+};
+
 bool initialization_in_progress_suppress_logging = true;
 
 /**
@@ -191,6 +256,8 @@ public:
 
     static void Initialize() {
         if (instance) {
+            // Logging may have been disabled by DisableLoggingInTests in the meantime
+            initialization_in_progress_suppress_logging = false;
             LOG_WARNING(Log, "Reinitializing logging backend");
             return;
         }
@@ -201,6 +268,7 @@ public:
         filter.ParseFilterString(Settings::values.log_filter.GetValue());
         instance = std::unique_ptr<Impl, decltype(&Deleter)>(new Impl(log_dir / LOG_FILE, filter),
                                                              Deleter);
+        instance->deferred_formatting = Settings::values.deferred_log_formatting.GetValue();
         initialization_in_progress_suppress_logging = false;
     }
 
@@ -226,15 +294,62 @@ public:
         color_console_backend.SetEnabled(enabled);
     }
 
+    void SetDeferredFormattingEnabled(bool enabled) {
+        deferred_formatting = enabled;
+        // Wake up the logging thread so it drains whatever is left in the deferred rings
+        message_queue.EmplaceWait(Entry{});
+    }
+
+    bool CheckMessage(Class log_class, Level log_level) const {
+        return filter.CheckMessage(log_class, log_level);
+    }
+
     void PushEntry(Class log_class, Level log_level, const char* filename, unsigned int line_num,
                    const char* function, std::string&& message) {
-        if (!filter.CheckMessage(log_class, log_level)) {
+        if (DeferredRing* const ring = OrderedThreadRing()) {
+            DeferredEntry entry{
+                .timestamp = GetTimestamp(),
+                .log_class = log_class,
+                .log_level = log_level,
+                .filename = filename,
+                .line_num = line_num,
+                .function = function,
+                .format = nullptr,
+                .formatter = nullptr,
+                .args = {},
+                .message = std::move(message),
+            };
+            PushToRing(*ring, entry);
             return;
         }
         message_queue.EmplaceWait(
             CreateEntry(log_class, log_level, filename, line_num, function, std::move(message)));
     }
 
+    void PushDeferredEntry(Class log_class, Level log_level, const char* filename,
+                           unsigned int line_num, const char* function, const char* format,
+                           DeferredFormatter formatter, const u64* args, size_t num_args) {
+        if (DeferredRing* const ring = OrderedThreadRing()) {
+            DeferredEntry entry{
+                .timestamp = GetTimestamp(),
+                .log_class = log_class,
+                .log_level = log_level,
+                .filename = filename,
+                .line_num = line_num,
+                .function = function,
+                .format = format,
+                .formatter = formatter,
+                .args = {},
+                .message = {},
+            };
+            std::copy_n(args, num_args, entry.args.begin());
+            PushToRing(*ring, entry);
+            return;
+        }
+        message_queue.EmplaceWait(CreateEntry(log_class, log_level, filename, line_num, function,
+                                              formatter(format, args)));
+    }
+
 private:
     Impl(const std::filesystem::path& file_backend_filename, const Filter& filter_)
         : filter{filter_}, file_backend{file_backend_filename} {}
@@ -244,22 +359,28 @@ private:
     void StartBackendThread() {
         backend_thread = std::jthread([this](std::stop_token stop_token) {
             Common::SetCurrentThreadName("Logger");
-            Entry entry;
-            const auto write_logs = [this, &entry]() {
-                ForEachBackend([&entry](Backend& backend) { backend.Write(entry); });
-            };
             while (!stop_token.stop_requested()) {
-                message_queue.PopWait(entry, stop_token);
+                if (WriteQueuedEntries(MaxDeferredBatchSize) != 0) {
+                    continue;
+                }
+                // Nothing is pending. Deferred log calls only wake the logging thread through the
+                // shared queue when it announced that it is about to wait on it.
+                logger_waiting.store(true, std::memory_order::relaxed);
+                std::atomic_thread_fence(std::memory_order::seq_cst);
+                if (HasDeferredEntries()) {
+                    logger_waiting.store(false, std::memory_order::relaxed);
+                    continue;
+                }
+                Entry entry = message_queue.PopWait(stop_token);
+                logger_waiting.store(false, std::memory_order::relaxed);
                 if (entry.filename != nullptr) {
-                    write_logs();
+                    // Written together with the deferred entries so the output stays ordered
+                    pending_entries.push_back(std::move(entry));
                 }
             }
-            // Drain the logging queue. Only writes out up to MAX_LOGS_TO_WRITE to prevent a
+            // Drain the logging queues. Only writes out up to MAX_LOGS_TO_WRITE to prevent a
             // case where a system is repeatedly spamming logs even on close.
-            int max_logs_to_write = filter.IsDebug() ? INT_MAX : 100;
-            while (max_logs_to_write-- && message_queue.TryPop(entry)) {
-                write_logs();
-            }
+            WriteQueuedEntries(filter.IsDebug() ? INT_MAX : 100);
         });
     }
 
@@ -272,14 +393,112 @@ private:
         ForEachBackend([](Backend& backend) { backend.Flush(); });
     }
 
+    /// Moves up to max_entries pending entries out of the shared queue and the deferred rings,
+    /// formats them, and writes them out ordered by timestamp. Returns the number written.
+    size_t WriteQueuedEntries(size_t max_entries) {
+        Entry entry;
+        bool queue_drained{};
+        while (pending_entries.size() < max_entries) {
+            if (!message_queue.TryPop(entry)) {
+                queue_drained = true;
+                break;
+            }
+            if (entry.filename != nullptr) {
+                pending_entries.push_back(std::move(entry));
+            }
+        }
+        // A thread only logs through its ring after everything it put in the shared queue, so
+        // the rings are only read once the shared queue has been emptied.
+        if (queue_drained) {
+            std::scoped_lock lock{deferred_rings_mutex};
+            DeferredEntry deferred;
+            for (const auto& ring : deferred_rings) {
+                while (pending_entries.size() < max_entries && ring->TryPop(deferred)) {
+                    std::string message =
+                        deferred.formatter
+                            ? deferred.formatter(deferred.format, deferred.args.data())
+                            : std::move(deferred.message);
+                    pending_entries.push_back(CreateEntry(deferred.log_class, deferred.log_level,
+                                                          deferred.filename, deferred.line_num,
+                                                          deferred.function, std::move(message),
+                                                          deferred.timestamp));
+                }
+            }
+            // Rings are only referenced here once their thread has exited
+            std::erase_if(deferred_rings, [](const std::shared_ptr<DeferredRing>& ring) {
+                return ring.use_count() == 1 && ring->IsEmpty();
+            });
+        }
+        std::stable_sort(pending_entries.begin(), pending_entries.end(),
+                         [](const Entry& lhs, const Entry& rhs) {
+                             return lhs.timestamp < rhs.timestamp;
+                         });
+        for (const Entry& pending : pending_entries) {
+            ForEachBackend([&pending](Backend& backend) { backend.Write(pending); });
+        }
+        const size_t num_written = pending_entries.size();
+        pending_entries.clear();
+        return num_written;
+    }
+
+    bool HasDeferredEntries() {
+        std::scoped_lock lock{deferred_rings_mutex};
+        return std::ranges::any_of(deferred_rings, [](const std::shared_ptr<DeferredRing>& ring) {
+            return !ring->IsEmpty();
+        });
+    }
+
+    /// Returns the ring the calling thread has to log through, or null if it can use the shared
+    /// queue. A thread keeps using its ring after leaving deferred mode until the ring is empty,
+    /// so its messages are written in the order they were logged.
+    DeferredRing* OrderedThreadRing() {
+        if (deferred_formatting.load(std::memory_order::relaxed)) {
+            if (!thread_ring) [[unlikely]] {
+                thread_ring = std::make_shared<DeferredRing>();
+                std::scoped_lock lock{deferred_rings_mutex};
+                deferred_rings.push_back(thread_ring);
+            }
+            return thread_ring.get();
+        }
+        return thread_ring && !thread_ring->IsEmpty() ? thread_ring.get() : nullptr;
+    }
+
+    void PushToRing(DeferredRing& ring, DeferredEntry& entry) {
+        // A full ring means the logging thread is behind. Wait for it rather than taking another
+        // path, which would reorder the messages of this thread.
+        while (!ring.TryPush(entry)) {
+            WakeLoggingThread();
+            std::this_thread::yield();
+        }
+        WakeLoggingThread();
+    }
+
+    void WakeLoggingThread() {
+        // Pairs with the fence in the logging thread, either it sees the entry before going to
+        // sleep or this sees that it is sleeping and wakes it up
+        std::atomic_thread_fence(std::memory_order::seq_cst);
+        if (logger_waiting.load(std::memory_order::relaxed) &&
+            logger_waiting.exchange(false, std::memory_order::relaxed)) {
+            message_queue.EmplaceWait(Entry{});
+        }
+    }
+
+    std::chrono::microseconds GetTimestamp() const {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - time_origin);
+    }
+
     Entry CreateEntry(Class log_class, Level log_level, const char* filename, unsigned int line_nr,
                       const char* function, std::string&& message) const {
-        using std::chrono::duration_cast;
-        using std::chrono::microseconds;
-        using std::chrono::steady_clock;
+        return CreateEntry(log_class, log_level, filename, line_nr, function, std::move(message),
+                           GetTimestamp());
+    }
 
+    Entry CreateEntry(Class log_class, Level log_level, const char* filename, unsigned int line_nr,
+                      const char* function, std::string&& message,
+                      std::chrono::microseconds timestamp) const {
         return {
-            .timestamp = duration_cast<microseconds>(steady_clock::now() - time_origin),
+            .timestamp = timestamp,
             .log_class = log_class,
             .log_level = log_level,
             .filename = filename,
@@ -312,7 +531,15 @@ private:
     LogcatBackend lc_backend{};
 #endif
 
+    static constexpr size_t MaxDeferredBatchSize = 0x1000;
+
     MPSCQueue<Entry> message_queue{};
+    std::atomic_bool deferred_formatting{false};
+    std::atomic_bool logger_waiting{false};
+    std::mutex deferred_rings_mutex;
+    std::vector<std::shared_ptr<DeferredRing>> deferred_rings;
+    static inline thread_local std::shared_ptr<DeferredRing> thread_ring;
+    std::vector<Entry> pending_entries;
     std::chrono::steady_clock::time_point time_origin{std::chrono::steady_clock::now()};
     std::jthread backend_thread;
 };
@@ -342,12 +569,34 @@ void SetColorConsoleBackendEnabled(bool enabled) {
     Impl::Instance().SetColorConsoleBackendEnabled(enabled);
 }
 
+void SetDeferredFormattingEnabled(bool enabled) {
+    Impl::Instance().SetDeferredFormattingEnabled(enabled);
+}
+
 void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                        unsigned int line_num, const char* function, const char* format,
                        const fmt::format_args& args) {
-    if (!initialization_in_progress_suppress_logging) {
-        Impl::Instance().PushEntry(log_class, log_level, filename, line_num, function,
-                                   fmt::vformat(format, args));
+    if (initialization_in_progress_suppress_logging) {
+        return;
+    }
+    Impl& impl = Impl::Instance();
+    // Filter before formatting, so disabled messages stay cheap
+    if (impl.CheckMessage(log_class, log_level)) {
+        impl.PushEntry(log_class, log_level, filename, line_num, function,
+                       fmt::vformat(format, args));
+    }
+}
+
+void DeferredLogMessageImpl(Class log_class, Level log_level, const char* filename,
+                            unsigned int line_num, const char* function, const char* format,
+                            DeferredFormatter formatter, const u64* args, size_t num_args) {
+    if (initialization_in_progress_suppress_logging) {
+        return;
+    }
+    Impl& impl = Impl::Instance();
+    if (impl.CheckMessage(log_class, log_level)) {
+        impl.PushDeferredEntry(log_class, log_level, filename, line_num, function, format,
+                               formatter, args, num_args);
     }
 }
 } // namespace Common::Log
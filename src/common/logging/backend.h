@@ -25,4 +25,10 @@ void DisableLoggingInTests();
 void SetGlobalFilter(const Filter& filter);
 
 void SetColorConsoleBackendEnabled(bool enabled);
+
+/**
+ * When enabled, log calls whose arguments are plain values only capture them, and the messages
+ * are formatted by the logging thread.
+ */
+void SetDeferredFormattingEnabled(bool enabled);
 } // namespace Common::Log
@@ -4,10 +4,16 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <cstring>
+#include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
 
 #include <fmt/format.h>
 
+#include "common/common_types.h"
 #include "common/logging/formatter.h"
 #include "common/logging/types.h"
 
@@ -27,11 +33,77 @@ void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                        unsigned int line_num, const char* function, const char* format,
                        const fmt::format_args& args);
 
+/// Formats a message from the arguments captured by a deferred log call
+using DeferredFormatter = std::string (*)(const char* format, const u64* args);
+
+/// Maximum number of arguments a log call can capture for deferred formatting
+constexpr size_t MaxDeferredArgs = 8;
+
+/// Logs a message to the global logger. When deferred formatting is enabled, the arguments are
+/// stored as they are and the message is only formatted by the logging thread.
+void DeferredLogMessageImpl(Class log_class, Level log_level, const char* filename,
+                            unsigned int line_num, const char* function, const char* format,
+                            DeferredFormatter formatter, const u64* args, size_t num_args);
+
+namespace detail {
+
+// Only plain values are captured, anything that may refer to caller owned memory like strings
+// has to be formatted on the calling thread.
+template <typename T>
+consteval bool IsDeferrableImpl() {
+    // Arrays of unknown bound like char[] are incomplete, only take the size of plain values
+    if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+        return sizeof(T) <= sizeof(u64);
+    } else {
+        return false;
+    }
+}
+
+template <typename T>
+constexpr bool IsDeferrable = IsDeferrableImpl<T>();
+
+template <typename T>
+u64 StoreDeferredArg(const T& value) {
+    u64 slot{};
+    std::memcpy(&slot, &value, sizeof(T));
+    return slot;
+}
+
+template <typename T>
+T LoadDeferredArg(const u64& slot) {
+    T value;
+    std::memcpy(&value, &slot, sizeof(T));
+    return value;
+}
+
+template <typename... Args, size_t... Indices>
+std::string FormatDeferredArgs(const char* format, const u64* args,
+                               std::index_sequence<Indices...>) {
+    const auto format_values = [format](const auto&... values) {
+        return fmt::vformat(format, fmt::make_format_args(values...));
+    };
+    return format_values(LoadDeferredArg<Args>(args[Indices])...);
+}
+
+template <typename... Args>
+std::string FormatDeferred(const char* format, const u64* args) {
+    return FormatDeferredArgs<Args...>(format, args, std::index_sequence_for<Args...>{});
+}
+
+} // namespace detail
+
 template <typename... Args>
 void FmtLogMessage(Class log_class, Level log_level, const char* filename, unsigned int line_num,
                    const char* function, const char* format, const Args&... args) {
-    FmtLogMessageImpl(log_class, log_level, filename, line_num, function, format,
-                      fmt::make_format_args(args...));
+    if constexpr (sizeof...(Args) <= MaxDeferredArgs && (detail::IsDeferrable<Args> && ...)) {
+        const std::array<u64, sizeof...(Args)> captured{detail::StoreDeferredArg(args)...};
+        DeferredLogMessageImpl(log_class, log_level, filename, line_num, function, format,
+                               &detail::FormatDeferred<Args...>, captured.data(),
+                               captured.size());
+    } else {
+        FmtLogMessageImpl(log_class, log_level, filename, line_num, function, format,
+                          fmt::make_format_args(args...));
+    }
 }
 
 } // namespace Common::Log
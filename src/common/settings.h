@@ -465,6 +465,8 @@ struct Values {
                                                              Specialization::Default,
                                                              true,
                                                              true};
+    SwitchableSetting<bool> use_speculative_pipelines{linkage, false, "use_speculative_pipelines",
+                                                      Category::RendererAdvanced};
     SwitchableSetting<bool> enable_compute_pipelines{linkage, false, "enable_compute_pipelines",
                                                      Category::RendererAdvanced};
     SwitchableSetting<bool> use_video_framerate{linkage, false, "use_video_framerate",
@@ -571,6 +573,8 @@ struct Values {
                                            Category::Controls};
     Setting<bool> enable_udp_controller{linkage, false, "enable_udp_controller",
                                         Category::Controls};
+    Setting<bool> hid_event_driven_updates{linkage, false, "hid_event_driven_updates",
+                                           Category::Controls};
 
     Setting<bool> pause_tas_on_load{linkage, true, "pause_tas_on_load", Category::Controls};
     Setting<bool> tas_enable{linkage, false, "tas_enable", Category::Controls};
@@ -625,6 +629,9 @@ struct Values {
                                         Category::DataStorage};
     Setting<std::string> gamecard_path{linkage, std::string(), "gamecard_path",
                                        Category::DataStorage};
+    Setting<u32, true> nca_block_cache_size{linkage, 256, 0, 4096, "nca_block_cache_size",
+                                            Category::DataStorage};
+    Setting<bool> map_game_files{linkage, false, "map_game_files", Category::DataStorage};
 
     // Debugging
     bool record_frame_times;
@@ -646,8 +653,11 @@ struct Values {
                                     Category::DebuggingGraphics};
     Setting<bool> disable_macro_hle{linkage, false, "disable_macro_hle",
                                     Category::DebuggingGraphics};
+    Setting<bool> profile_macros{linkage, false, "profile_macros", Category::DebuggingGraphics};
     Setting<bool> extended_logging{
         linkage, false, "extended_logging", Category::Debugging, Specialization::Default, false};
+    Setting<bool> deferred_log_formatting{linkage, false, "deferred_log_formatting",
+                                          Category::Debugging};
     Setting<bool> use_debug_asserts{linkage, false, "use_debug_asserts", Category::Debugging};
     Setting<bool> use_auto_stub{
         linkage, false, "use_auto_stub", Category::Debugging, Specialization::Default, false};
@@ -0,0 +1,23 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <immintrin.h>
+
+// Function attributes used to compile individual kernels for an instruction set extension that
+// the rest of the binary is not built for. Callers must check Common::GetCPUCaps() before
+// invoking a function marked with one of these.
+//
+// MSVC exposes every intrinsic regardless of the /arch setting, so no attribute is required.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define CITRON_TARGET_SSE41
+#define CITRON_TARGET_AVX2
+#define CITRON_TARGET_AESNI
+#define CITRON_TARGET_SHANI
+#else
+#define CITRON_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define CITRON_TARGET_AVX2 __attribute__((target("avx2")))
+#define CITRON_TARGET_AESNI __attribute__((target("sse4.1,aes")))
+#define CITRON_TARGET_SHANI __attribute__((target("sse4.1,sha")))
+#endif
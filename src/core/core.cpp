@@ -104,11 +104,20 @@ FileSys::VirtualFile GetGameFileFromPath(const FileSys::VirtualFilesystem& vfs,
                                                                   std::move(concat));
     }
 
+    const auto open_file = [&vfs](const std::string& file_path) {
+        if (Settings::values.map_game_files.GetValue()) {
+            if (auto* const real_vfs = dynamic_cast<FileSys::RealVfsFilesystem*>(vfs.get())) {
+                return real_vfs->OpenMappedFile(file_path);
+            }
+        }
+        return vfs->OpenFile(file_path, FileSys::OpenMode::Read);
+    };
+
     if (Common::FS::IsDir(path)) {
-        return vfs->OpenFile(path + "/main", FileSys::OpenMode::Read);
+        return open_file(path + "/main");
     }
 
-    return vfs->OpenFile(path, FileSys::OpenMode::Read);
+    return open_file(path);
 }
 
 struct System::Impl {
@@ -29,21 +29,36 @@ std::shared_ptr<EventType> CreateEvent(std::string name, TimedCallback&& callbac
 struct CoreTiming::Event {
     s64 time;
     u64 fifo_order;
-    std::weak_ptr<EventType> type;
-    s64 reschedule_time;
-    heap_t::handle_type handle{};
+    u32 slot;
 
     // Sort by time, unless the times are the same, in which case sort by
     // the order added to the queue
-    friend bool operator>(const Event& left, const Event& right) {
-        return std::tie(left.time, left.fifo_order) > std::tie(right.time, right.fifo_order);
-    }
-
     friend bool operator<(const Event& left, const Event& right) {
         return std::tie(left.time, left.fifo_order) < std::tie(right.time, right.fifo_order);
     }
 };
 
+struct CoreTiming::EventSlot {
+    std::weak_ptr<EventType> type;
+    s64 reschedule_time;
+    size_t queue_index;
+};
+
+namespace {
+
+constexpr size_t QUEUE_ARITY = 4;
+
+void DetachSlot(EventType& event_type, u32 slot) {
+    auto& slots = event_type.pending_slots;
+    const auto it = std::find(slots.begin(), slots.end(), slot);
+    if (it != slots.end()) {
+        *it = slots.back();
+        slots.pop_back();
+    }
+}
+
+} // Anonymous namespace
+
 CoreTiming::CoreTiming() : clock{Common::CreateOptimalClock()} {}
 
 CoreTiming::~CoreTiming() {
@@ -73,7 +88,15 @@ void CoreTiming::Initialize(std::function<void()>&& on_thread_init_) {
 
 void CoreTiming::ClearPendingEvents() {
     std::scoped_lock lock{advance_lock, basic_lock};
+    for (const Event& evt : event_queue) {
+        if (const auto event_type{event_slots[evt.slot].type.lock()}) {
+            event_type->pending_slots.clear();
+            event_type->sequence_number++;
+        }
+    }
     event_queue.clear();
+    event_slots.clear();
+    free_event_slots.clear();
     event.Set();
 }
 
@@ -117,31 +140,35 @@ bool CoreTiming::HasPendingEvents() const {
 
 void CoreTiming::ScheduleEvent(std::chrono::nanoseconds ns_into_future,
                                const std::shared_ptr<EventType>& event_type, bool absolute_time) {
+    bool is_earliest{};
     {
         std::scoped_lock scope{basic_lock};
         const auto next_time{absolute_time ? ns_into_future : GetGlobalTimeNs() + ns_into_future};
 
-        auto h{event_queue.emplace(Event{next_time.count(), event_fifo_id++, event_type, 0})};
-        (*h).handle = h;
+        is_earliest = PushEvent(next_time.count(), event_type, 0);
     }
 
-    event.Set();
+    // The timer thread only needs to wake up if it is waiting on a later event
+    if (is_earliest && is_multicore) {
+        event.Set();
+    }
 }
 
 void CoreTiming::ScheduleLoopingEvent(std::chrono::nanoseconds start_time,
                                       std::chrono::nanoseconds resched_time,
                                       const std::shared_ptr<EventType>& event_type,
                                       bool absolute_time) {
+    bool is_earliest{};
     {
         std::scoped_lock scope{basic_lock};
         const auto next_time{absolute_time ? start_time : GetGlobalTimeNs() + start_time};
 
-        auto h{event_queue.emplace(
-            Event{next_time.count(), event_fifo_id++, event_type, resched_time.count()})};
-        (*h).handle = h;
+        is_earliest = PushEvent(next_time.count(), event_type, resched_time.count());
     }
 
-    event.Set();
+    if (is_earliest && is_multicore) {
+        event.Set();
+    }
 }
 
 void CoreTiming::UnscheduleEvent(const std::shared_ptr<EventType>& event_type,
@@ -149,18 +176,10 @@ void CoreTiming::UnscheduleEvent(const std::shared_ptr<EventType>& event_type,
     {
         std::scoped_lock lk{basic_lock};
 
-        std::vector<heap_t::handle_type> to_remove;
-        for (auto itr = event_queue.begin(); itr != event_queue.end(); itr++) {
-            const Event& e = *itr;
-            if (e.type.lock().get() == event_type.get()) {
-                to_remove.push_back(itr->handle);
-            }
+        for (const u32 slot : event_type->pending_slots) {
+            RemoveEvent(event_slots[slot].queue_index);
         }
-
-        for (auto& h : to_remove) {
-            event_queue.erase(h);
-        }
-
+        event_type->pending_slots.clear();
         event_type->sequence_number++;
     }
 
@@ -201,61 +220,154 @@ std::optional<s64> CoreTiming::Advance() {
     std::scoped_lock lock{advance_lock, basic_lock};
     global_timer = GetGlobalTimeNs().count();
 
-    while (!event_queue.empty() && event_queue.top().time <= global_timer) {
-        const Event& evt = event_queue.top();
-
-        if (const auto event_type{evt.type.lock()}) {
-            const auto evt_time = evt.time;
-            const auto evt_sequence_num = event_type->sequence_number;
+    while (!event_queue.empty() && event_queue.front().time <= global_timer) {
+        const Event evt = event_queue.front();
+        const auto event_type{event_slots[evt.slot].type.lock()};
+        if (!event_type) {
+            // The event type was destroyed while it was still scheduled
+            RemoveEvent(0);
+            continue;
+        }
 
-            if (evt.reschedule_time == 0) {
-                event_queue.pop();
+        const auto evt_sequence_num = event_type->sequence_number;
+        const auto reschedule_time = event_slots[evt.slot].reschedule_time;
 
-                basic_lock.unlock();
+        if (reschedule_time == 0) {
+            DetachSlot(*event_type, evt.slot);
+            RemoveEvent(0);
 
-                event_type->callback(
-                    evt_time, std::chrono::nanoseconds{GetGlobalTimeNs().count() - evt_time});
+            basic_lock.unlock();
 
-                basic_lock.lock();
-            } else {
-                basic_lock.unlock();
+            event_type->callback(evt.time,
+                                 std::chrono::nanoseconds{GetGlobalTimeNs().count() - evt.time});
 
-                const auto new_schedule_time{event_type->callback(
-                    evt_time, std::chrono::nanoseconds{GetGlobalTimeNs().count() - evt_time})};
+            basic_lock.lock();
+        } else {
+            basic_lock.unlock();
 
-                basic_lock.lock();
+            const auto new_schedule_time{event_type->callback(
+                evt.time, std::chrono::nanoseconds{GetGlobalTimeNs().count() - evt.time})};
 
-                if (evt_sequence_num != event_type->sequence_number) {
-                    // Heap handle is invalidated after external modification.
-                    continue;
-                }
+            basic_lock.lock();
 
-                const auto next_schedule_time{new_schedule_time.has_value()
-                                                  ? new_schedule_time.value().count()
-                                                  : evt.reschedule_time};
+            if (evt_sequence_num != event_type->sequence_number) {
+                // The event was unscheduled and its slot may have been reused.
+                continue;
+            }
 
-                // If this event was scheduled into a pause, its time now is going to be way
-                // behind. Re-set this event to continue from the end of the pause.
-                auto next_time{evt.time + next_schedule_time};
-                if (evt.time < pause_end_time) {
-                    next_time = pause_end_time + next_schedule_time;
-                }
+            const auto next_schedule_time{new_schedule_time.has_value()
+                                              ? new_schedule_time.value().count()
+                                              : reschedule_time};
 
-                event_queue.update(evt.handle, Event{next_time, event_fifo_id++, evt.type,
-                                                     next_schedule_time, evt.handle});
+            // If this event was scheduled into a pause, its time now is going to be way
+            // behind. Re-set this event to continue from the end of the pause.
+            auto next_time{evt.time + next_schedule_time};
+            if (evt.time < pause_end_time) {
+                next_time = pause_end_time + next_schedule_time;
             }
+
+            // Events scheduled during the callback may have moved this one in the queue
+            EventSlot& slot = event_slots[evt.slot];
+            slot.reschedule_time = next_schedule_time;
+            Event& queued = event_queue[slot.queue_index];
+            queued.time = next_time;
+            queued.fifo_order = event_fifo_id++;
+            UpdateEvent(slot.queue_index);
         }
 
         global_timer = GetGlobalTimeNs().count();
     }
 
     if (!event_queue.empty()) {
-        return event_queue.top().time;
+        return event_queue.front().time;
     } else {
         return std::nullopt;
     }
 }
 
+bool CoreTiming::PushEvent(s64 time, const std::shared_ptr<EventType>& event_type,
+                           s64 reschedule_time) {
+    u32 slot;
+    if (free_event_slots.empty()) {
+        slot = static_cast<u32>(event_slots.size());
+        event_slots.emplace_back();
+    } else {
+        slot = free_event_slots.back();
+        free_event_slots.pop_back();
+    }
+    event_slots[slot] = EventSlot{event_type, reschedule_time, event_queue.size()};
+    event_type->pending_slots.push_back(slot);
+
+    event_queue.push_back(Event{time, event_fifo_id++, slot});
+    SiftUp(event_queue.size() - 1);
+    return event_slots[slot].queue_index == 0;
+}
+
+void CoreTiming::RemoveEvent(size_t index) {
+    const u32 slot = event_queue[index].slot;
+    event_slots[slot].type.reset();
+    free_event_slots.push_back(slot);
+
+    const size_t last = event_queue.size() - 1;
+    if (index != last) {
+        PlaceEvent(index, event_queue[last]);
+        event_queue.pop_back();
+        UpdateEvent(index);
+    } else {
+        event_queue.pop_back();
+    }
+}
+
+void CoreTiming::UpdateEvent(size_t index) {
+    if (index > 0 && event_queue[index] < event_queue[(index - 1) / QUEUE_ARITY]) {
+        SiftUp(index);
+    } else {
+        SiftDown(index);
+    }
+}
+
+void CoreTiming::SiftUp(size_t index) {
+    const Event moving = event_queue[index];
+    while (index > 0) {
+        const size_t parent = (index - 1) / QUEUE_ARITY;
+        if (!(moving < event_queue[parent])) {
+            break;
+        }
+        PlaceEvent(index, event_queue[parent]);
+        index = parent;
+    }
+    PlaceEvent(index, moving);
+}
+
+void CoreTiming::SiftDown(size_t index) {
+    const Event moving = event_queue[index];
+    const size_t size = event_queue.size();
+    while (true) {
+        const size_t first_child = index * QUEUE_ARITY + 1;
+        if (first_child >= size) {
+            break;
+        }
+        const size_t last_child = std::min(first_child + QUEUE_ARITY, size);
+        size_t earliest = first_child;
+        for (size_t child = first_child + 1; child < last_child; ++child) {
+            if (event_queue[child] < event_queue[earliest]) {
+                earliest = child;
+            }
+        }
+        if (!(event_queue[earliest] < moving)) {
+            break;
+        }
+        PlaceEvent(index, event_queue[earliest]);
+        index = earliest;
+    }
+    PlaceEvent(index, moving);
+}
+
+void CoreTiming::PlaceEvent(size_t index, const Event& evt) {
+    event_queue[index] = evt;
+    event_slots[evt.slot].queue_index = index;
+}
+
 void CoreTiming::ThreadLoop() {
     has_started = true;
     while (!shutting_down) {
@@ -11,8 +11,9 @@
 #include <optional>
 #include <string>
 #include <thread>
+#include <vector>
 
-#include <boost/heap/fibonacci_heap.hpp>
+#include <boost/container/small_vector.hpp>
 
 #include "common/common_types.h"
 #include "common/thread.h"
@@ -36,6 +37,9 @@ struct EventType {
     /// A monotonic sequence number, incremented when this event is
     /// changed externally.
     size_t sequence_number;
+    /// Queue slots of the pending instances of this event, owned by the CoreTiming instance the
+    /// event is scheduled on and guarded by its lock. Lets unscheduling skip the queue scan.
+    boost::container::small_vector<u32, 2> pending_slots;
 };
 
 enum class UnscheduleEventType {
@@ -140,12 +144,23 @@ public:
 
 private:
     struct Event;
+    struct EventSlot;
 
     static void ThreadEntry(CoreTiming& instance);
     void ThreadLoop();
 
     void Reset();
 
+    /// Queues an event and returns true when it became the earliest pending event.
+    bool PushEvent(s64 time, const std::shared_ptr<EventType>& event_type, s64 reschedule_time);
+    /// Removes the event at the given queue index and releases its slot.
+    void RemoveEvent(size_t index);
+    /// Restores the queue order after the event at the given index changed its time.
+    void UpdateEvent(size_t index);
+    void SiftUp(size_t index);
+    void SiftDown(size_t index);
+    void PlaceEvent(size_t index, const Event& evt);
+
     std::unique_ptr<Common::WallClock> clock;
 
     s64 global_timer = 0;
@@ -154,10 +169,11 @@ private:
     s64 timer_resolution_ns;
 #endif
 
-    using heap_t =
-        boost::heap::fibonacci_heap<CoreTiming::Event, boost::heap::compare<std::greater<>>>;
-
-    heap_t event_queue;
+    /// 4-ary min heap ordered by time, then by fifo id. Entries refer to an EventSlot, which
+    /// tracks the entry's position so it can be removed or updated without a search.
+    std::vector<Event> event_queue;
+    std::vector<EventSlot> event_slots;
+    std::vector<u32> free_event_slots;
     u64 event_fifo_id = 0;
 
     Common::Event event{};
@@ -2,12 +2,19 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <array>
+#include <cstring>
+#include <utility>
 #include <mbedtls/cipher.h>
 #include "common/assert.h"
 #include "common/logging/log.h"
 #include "core/crypto/aes_util.h"
 #include "core/crypto/key_manager.h"
 
+#ifdef ARCHITECTURE_x86_64
+#include "common/x64/cpu_detect.h"
+#include "common/x64/simd_target.h"
+#endif
+
 namespace Core::Crypto {
 namespace {
 using NintendoTweak = std::array<u8, 16>;
@@ -20,6 +27,199 @@ NintendoTweak CalculateNintendoTweak(std::size_t sector_id) {
     }
     return out;
 }
+
+// Increments a 128-bit big-endian counter, as mbedtls does for CTR and as XTS sector tweaks are.
+void IncrementCounter(AESBlock& counter) {
+    for (std::size_t i = counter.size(); i-- > 0;) {
+        if (++counter[i] != 0) {
+            break;
+        }
+    }
+}
+
+#ifdef ARCHITECTURE_x86_64
+constexpr std::size_t AES128Rounds = 10;
+
+// Blocks processed together, so that the latency of each AES round is hidden by the others
+constexpr std::size_t InterleavedBlocks = 8;
+
+using RoundKeys = __m128i[AES128Rounds + 1];
+
+template <int Rcon>
+CITRON_TARGET_AESNI inline __m128i ExpandKeyAESNI(__m128i key) {
+    const __m128i assist = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(key, Rcon), 0xFF);
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    return _mm_xor_si128(key, assist);
+}
+
+CITRON_TARGET_AESNI void ExpandKeysAESNI(const u8* key, RoundKeys& keys) {
+    keys[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key));
+    keys[1] = ExpandKeyAESNI<0x01>(keys[0]);
+    keys[2] = ExpandKeyAESNI<0x02>(keys[1]);
+    keys[3] = ExpandKeyAESNI<0x04>(keys[2]);
+    keys[4] = ExpandKeyAESNI<0x08>(keys[3]);
+    keys[5] = ExpandKeyAESNI<0x10>(keys[4]);
+    keys[6] = ExpandKeyAESNI<0x20>(keys[5]);
+    keys[7] = ExpandKeyAESNI<0x40>(keys[6]);
+    keys[8] = ExpandKeyAESNI<0x80>(keys[7]);
+    keys[9] = ExpandKeyAESNI<0x1B>(keys[8]);
+    keys[10] = ExpandKeyAESNI<0x36>(keys[9]);
+}
+
+// The equivalent inverse cipher uses the encryption keys in reverse order, with the InvMixColumns
+// transform applied to the inner ones.
+CITRON_TARGET_AESNI void InvertKeysAESNI(const RoundKeys& encryption_keys,
+                                         RoundKeys& decryption_keys) {
+    decryption_keys[0] = encryption_keys[AES128Rounds];
+    for (std::size_t i = 1; i < AES128Rounds; ++i) {
+        decryption_keys[i] = _mm_aesimc_si128(encryption_keys[AES128Rounds - i]);
+    }
+    decryption_keys[AES128Rounds] = encryption_keys[0];
+}
+
+// Applies each round to all blocks before moving to the next one. The expansion over the block
+// indices keeps the blocks in registers regardless of the unrolling done by the compiler.
+template <Op op, std::size_t... I>
+CITRON_TARGET_AESNI inline void CryptBlocksAESNI(const RoundKeys& keys,
+                                                 __m128i (&blocks)[sizeof...(I)],
+                                                 std::index_sequence<I...>) {
+    ((blocks[I] = _mm_xor_si128(blocks[I], keys[0])), ...);
+    for (std::size_t round = 1; round < AES128Rounds; ++round) {
+        const __m128i key = keys[round];
+        if constexpr (op == Op::Encrypt) {
+            ((blocks[I] = _mm_aesenc_si128(blocks[I], key)), ...);
+        } else {
+            ((blocks[I] = _mm_aesdec_si128(blocks[I], key)), ...);
+        }
+    }
+    if constexpr (op == Op::Encrypt) {
+        ((blocks[I] = _mm_aesenclast_si128(blocks[I], keys[AES128Rounds])), ...);
+    } else {
+        ((blocks[I] = _mm_aesdeclast_si128(blocks[I], keys[AES128Rounds])), ...);
+    }
+}
+
+CITRON_TARGET_AESNI inline __m128i NextCounterAESNI(u64& counter_hi, u64& counter_lo) {
+    const __m128i byte_swap = _mm_set_epi64x(0x0001020304050607ULL, 0x08090A0B0C0D0E0FULL);
+    const __m128i block = _mm_shuffle_epi8(
+        _mm_set_epi64x(static_cast<s64>(counter_hi), static_cast<s64>(counter_lo)), byte_swap);
+    if (++counter_lo == 0) {
+        ++counter_hi;
+    }
+    return block;
+}
+
+template <std::size_t... I>
+CITRON_TARGET_AESNI inline void CTRBlocksAESNI(const RoundKeys& keys, u64& counter_hi,
+                                               u64& counter_lo, const u8* src, u8* dest,
+                                               std::index_sequence<I...> indices) {
+    __m128i blocks[sizeof...(I)];
+    ((blocks[I] = NextCounterAESNI(counter_hi, counter_lo)), ...);
+    CryptBlocksAESNI<Op::Encrypt>(keys, blocks, indices);
+    (_mm_storeu_si128(
+         reinterpret_cast<__m128i*>(dest + I * 16),
+         _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + I * 16)),
+                       blocks[I])),
+     ...);
+}
+
+CITRON_TARGET_AESNI void CTRTranscodeAESNI(const RoundKeys& keys, AESBlock& counter,
+                                           const u8* src, std::size_t size, u8* dest) {
+    u64 counter_hi = 0;
+    u64 counter_lo = 0;
+    for (std::size_t i = 0; i < 8; ++i) {
+        counter_hi = (counter_hi << 8) | counter[i];
+        counter_lo = (counter_lo << 8) | counter[i + 8];
+    }
+
+    std::size_t offset = 0;
+    for (; size - offset >= InterleavedBlocks * 16; offset += InterleavedBlocks * 16) {
+        CTRBlocksAESNI(keys, counter_hi, counter_lo, src + offset, dest + offset,
+                       std::make_index_sequence<InterleavedBlocks>{});
+    }
+    for (; size - offset >= 16; offset += 16) {
+        CTRBlocksAESNI(keys, counter_hi, counter_lo, src + offset, dest + offset,
+                       std::index_sequence<0>{});
+    }
+    if (offset != size) {
+        // Only the head of the last keystream block is used, the counter still moves past it.
+        AESBlock block{};
+        std::memcpy(block.data(), src + offset, size - offset);
+        CTRBlocksAESNI(keys, counter_hi, counter_lo, block.data(), block.data(),
+                       std::index_sequence<0>{});
+        std::memcpy(dest + offset, block.data(), size - offset);
+    }
+
+    for (std::size_t i = 8; i-- > 0;) {
+        counter[i] = static_cast<u8>(counter_hi);
+        counter[i + 8] = static_cast<u8>(counter_lo);
+        counter_hi >>= 8;
+        counter_lo >>= 8;
+    }
+}
+
+// Multiplies an XTS tweak by x in GF(2^128), in the little-endian convention of IEEE P1619.
+CITRON_TARGET_AESNI inline __m128i MultiplyTweakAESNI(__m128i tweak) {
+    // Move the carry out of each 32-bit lane into the next one, and the carry out of the whole
+    // value back into the first lane as the reduction polynomial.
+    __m128i carry = _mm_shuffle_epi32(_mm_srai_epi32(tweak, 31), 0x93);
+    carry = _mm_and_si128(carry, _mm_set_epi32(1, 1, 1, 0x87));
+    return _mm_xor_si128(_mm_slli_epi32(tweak, 1), carry);
+}
+
+// Returns the tweak of the current block and moves to that of the next one.
+CITRON_TARGET_AESNI inline __m128i NextTweakAESNI(__m128i& tweak) {
+    const __m128i current = tweak;
+    tweak = MultiplyTweakAESNI(tweak);
+    return current;
+}
+
+template <Op op, std::size_t... I>
+CITRON_TARGET_AESNI inline void XTSBlocksAESNI(const RoundKeys& keys, __m128i& tweak,
+                                               const u8* src, u8* dest,
+                                               std::index_sequence<I...> indices) {
+    __m128i tweaks[sizeof...(I)];
+    __m128i blocks[sizeof...(I)];
+    ((tweaks[I] = NextTweakAESNI(tweak)), ...);
+    ((blocks[I] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + I * 16)),
+                                tweaks[I])),
+     ...);
+    CryptBlocksAESNI<op>(keys, blocks, indices);
+    (_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + I * 16),
+                      _mm_xor_si128(blocks[I], tweaks[I])),
+     ...);
+}
+
+/// Transcodes one XTS data unit whose size is a multiple of the AES block size.
+template <Op op>
+CITRON_TARGET_AESNI void XTSTranscodeAESNI(const RoundKeys& data_keys,
+                                           const RoundKeys& tweak_keys, const AESBlock& iv,
+                                           const u8* src, std::size_t size, u8* dest) {
+    __m128i tweak[1]{_mm_loadu_si128(reinterpret_cast<const __m128i*>(iv.data()))};
+    CryptBlocksAESNI<Op::Encrypt>(tweak_keys, tweak, std::index_sequence<0>{});
+
+    std::size_t offset = 0;
+    for (; size - offset >= InterleavedBlocks * 16; offset += InterleavedBlocks * 16) {
+        XTSBlocksAESNI<op>(data_keys, tweak[0], src + offset, dest + offset,
+                           std::make_index_sequence<InterleavedBlocks>{});
+    }
+    for (; offset < size; offset += 16) {
+        XTSBlocksAESNI<op>(data_keys, tweak[0], src + offset, dest + offset,
+                           std::index_sequence<0>{});
+    }
+}
+#endif
+
+bool HasAESNI() {
+#ifdef ARCHITECTURE_x86_64
+    const auto& caps = Common::GetCPUCaps();
+    return caps.aes && caps.sse4_1 && caps.ssse3;
+#else
+    return false;
+#endif
+}
 } // Anonymous namespace
 
 static_assert(static_cast<std::size_t>(Mode::CTR) ==
@@ -36,6 +236,19 @@ static_assert(static_cast<std::size_t>(Mode::XTS) ==
 struct CipherContext {
     mbedtls_cipher_context_t encryption_context;
     mbedtls_cipher_context_t decryption_context;
+
+    Mode mode;
+
+#ifdef ARCHITECTURE_x86_64
+    // Set when CTR and XTS are transcoded with AES-NI instead of mbedtls. The IVs then mirror
+    // those of the mbedtls contexts, including the CTR counter advancing with each call.
+    bool use_aesni = false;
+    AESBlock encryption_iv{};
+    AESBlock decryption_iv{};
+    RoundKeys encryption_keys;
+    RoundKeys decryption_keys;
+    RoundKeys tweak_keys; ///< Encryption keys of the second XTS key
+#endif
 };
 
 template <typename Key, std::size_t KeySize>
@@ -57,6 +270,23 @@ Crypto::AESCipher<Key, KeySize>::AESCipher(Key key, Mode mode)
     ASSERT(
         !mbedtls_cipher_setkey(&ctx->decryption_context, key.data(), KeySize * 8, MBEDTLS_DECRYPT));
     //"Failed to set key on mbedtls ciphers.");
+
+    ctx->mode = mode;
+
+#ifdef ARCHITECTURE_x86_64
+    // CTR uses AES-128 and XTS a pair of AES-128 keys, ECB is only used on a few keys and is
+    // left to mbedtls.
+    const bool aesni_mode = (mode == Mode::CTR && KeySize == 0x10) ||
+                            (mode == Mode::XTS && KeySize == 0x20);
+    if (aesni_mode && HasAESNI()) {
+        ctx->use_aesni = true;
+        ExpandKeysAESNI(key.data(), ctx->encryption_keys);
+        InvertKeysAESNI(ctx->encryption_keys, ctx->decryption_keys);
+        if (mode == Mode::XTS) {
+            ExpandKeysAESNI(key.data() + 0x10, ctx->tweak_keys);
+        }
+    }
+#endif
 }
 
 template <typename Key, std::size_t KeySize>
@@ -67,6 +297,27 @@ AESCipher<Key, KeySize>::~AESCipher() {
 
 template <typename Key, std::size_t KeySize>
 void AESCipher<Key, KeySize>::Transcode(const u8* src, std::size_t size, u8* dest, Op op) const {
+#ifdef ARCHITECTURE_x86_64
+    if (ctx->use_aesni) {
+        AESBlock& iv = op == Op::Encrypt ? ctx->encryption_iv : ctx->decryption_iv;
+        if (ctx->mode == Mode::CTR) {
+            CTRTranscodeAESNI(ctx->encryption_keys, iv, src, size, dest);
+            return;
+        }
+        // Data units that need ciphertext stealing are left to mbedtls.
+        if (size % sizeof(AESBlock) == 0) {
+            if (op == Op::Encrypt) {
+                XTSTranscodeAESNI<Op::Encrypt>(ctx->encryption_keys, ctx->tweak_keys,
+                                               iv, src, size, dest);
+            } else {
+                XTSTranscodeAESNI<Op::Decrypt>(ctx->decryption_keys, ctx->tweak_keys,
+                                               iv, src, size, dest);
+            }
+            return;
+        }
+    }
+#endif
+
     auto* const context = op == Op::Encrypt ? &ctx->encryption_context : &ctx->decryption_context;
 
     mbedtls_cipher_reset(context);
@@ -109,11 +360,20 @@ void AESCipher<Key, KeySize>::Transcode(const u8* src, std::size_t size, u8* des
 template <typename Key, std::size_t KeySize>
 void AESCipher<Key, KeySize>::XTSTranscode(const u8* src, std::size_t size, u8* dest,
                                            std::size_t sector_id, std::size_t sector_size, Op op) {
+    XTSTranscode(src, size, dest, CalculateNintendoTweak(sector_id), sector_size, op);
+}
+
+template <typename Key, std::size_t KeySize>
+void AESCipher<Key, KeySize>::XTSTranscode(const u8* src, std::size_t size, u8* dest,
+                                           const AESBlock& first_tweak, std::size_t sector_size,
+                                           Op op) {
     ASSERT_MSG(size % sector_size == 0, "XTS decryption size must be a multiple of sector size.");
 
+    AESBlock tweak = first_tweak;
     for (std::size_t i = 0; i < size; i += sector_size) {
-        SetIV(CalculateNintendoTweak(sector_id++));
+        SetIV(tweak);
         Transcode(src + i, sector_size, dest + i, op);
+        IncrementCounter(tweak);
     }
 }
 
@@ -122,6 +382,14 @@ void AESCipher<Key, KeySize>::SetIV(std::span<const u8> data) {
     ASSERT_MSG((mbedtls_cipher_set_iv(&ctx->encryption_context, data.data(), data.size()) ||
                 mbedtls_cipher_set_iv(&ctx->decryption_context, data.data(), data.size())) == 0,
                "Failed to set IV on mbedtls ciphers.");
+
+#ifdef ARCHITECTURE_x86_64
+    if (ctx->use_aesni) {
+        ASSERT(data.size() == sizeof(AESBlock));
+        std::memcpy(ctx->encryption_iv.data(), data.data(), data.size());
+        std::memcpy(ctx->decryption_iv.data(), data.data(), data.size());
+    }
+#endif
 }
 
 template class AESCipher<Key128>;
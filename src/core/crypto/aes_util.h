@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <array>
 #include <memory>
 #include <span>
 #include <type_traits>
@@ -13,6 +14,8 @@ namespace Core::Crypto {
 
 struct CipherContext;
 
+using AESBlock = std::array<u8, 0x10>;
+
 enum class Mode {
     CTR = 11,
     ECB = 2,
@@ -56,6 +59,13 @@ public:
     void XTSTranscode(const u8* src, std::size_t size, u8* dest, std::size_t sector_id,
                       std::size_t sector_size, Op op);
 
+    /**
+     * Transcodes consecutive XTS sectors in one call. The tweak of each following sector is the
+     * previous one incremented as a 128-bit big-endian counter.
+     */
+    void XTSTranscode(const u8* src, std::size_t size, u8* dest, const AESBlock& first_tweak,
+                      std::size_t sector_size, Op op);
+
 private:
     std::unique_ptr<CipherContext> ctx;
 };
@@ -18,8 +18,8 @@ std::size_t CTREncryptionLayer::Read(u8* data, std::size_t length, std::size_t o
     const auto sector_offset = offset & 0xF;
     if (sector_offset == 0) {
         UpdateIV(base_offset + offset);
-        std::vector<u8> raw = base->ReadBytes(length, offset);
-        cipher.Transcode(raw.data(), raw.size(), data, Op::Decrypt);
+        const std::size_t read = base->Read(data, length, offset);
+        cipher.Transcode(data, read, data, Op::Decrypt);
         return length;
     }
 
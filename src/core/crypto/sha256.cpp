@@ -0,0 +1,317 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <mbedtls/sha256.h>
+
+#include "common/alignment.h"
+#include "common/assert.h"
+#include "common/bounded_threadsafe_queue.h"
+#include "common/literals.h"
+#include "common/polyfill_thread.h"
+#include "common/thread.h"
+#include "core/crypto/sha256.h"
+#include "core/file_sys/vfs/vfs.h"
+
+#ifdef ARCHITECTURE_x86_64
+#include "common/x64/cpu_detect.h"
+#include "common/x64/simd_target.h"
+#endif
+
+namespace Core::Crypto {
+
+namespace {
+
+using namespace Common::Literals;
+
+constexpr size_t BlockSize = 64;
+
+constexpr std::array<u32, 8> InitialState{
+    0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19,
+};
+
+#ifdef ARCHITECTURE_x86_64
+alignas(16) constexpr std::array<u32, 64> RoundConstants{
+    0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+    0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+    0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+    0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+    0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+    0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+    0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+    0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2,
+};
+
+// Four rounds of the compression function. The message schedule of the upcoming rounds is
+// computed in the same pass, keeping the last four schedule vectors in msg.
+template <size_t Group>
+CITRON_TARGET_SHANI inline void RoundsSHANI(__m128i& state0, __m128i& state1, __m128i (&msg)[4]) {
+    const __m128i& current = msg[Group % 4];
+    __m128i words = _mm_add_epi32(
+        current, _mm_load_si128(reinterpret_cast<const __m128i*>(&RoundConstants[Group * 4])));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, words);
+    if constexpr (Group >= 3 && Group <= 14) {
+        __m128i& next = msg[(Group + 1) % 4];
+        next = _mm_add_epi32(next, _mm_alignr_epi8(current, msg[(Group + 3) % 4], 4));
+        next = _mm_sha256msg2_epu32(next, current);
+    }
+    words = _mm_shuffle_epi32(words, 0x0E);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, words);
+    if constexpr (Group >= 1 && Group <= 12) {
+        __m128i& previous = msg[(Group + 3) % 4];
+        previous = _mm_sha256msg1_epu32(previous, current);
+    }
+}
+
+template <size_t... Groups>
+CITRON_TARGET_SHANI inline void AllRoundsSHANI(__m128i& state0, __m128i& state1, __m128i (&msg)[4],
+                                               std::index_sequence<Groups...>) {
+    (RoundsSHANI<Groups>(state0, state1, msg), ...);
+}
+
+CITRON_TARGET_SHANI void CompressSHANI(std::array<u32, 8>& state, const u8* data,
+                                       size_t num_blocks) {
+    const __m128i byte_swap = _mm_set_epi64x(0x0C0D0E0F08090A0BULL, 0x0405060700010203ULL);
+
+    // Rearrange the state into the ABEF/CDGH layout used by the SHA instructions
+    __m128i tmp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0]));
+    __m128i state1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4]));
+    tmp = _mm_shuffle_epi32(tmp, 0xB1);
+    state1 = _mm_shuffle_epi32(state1, 0x1B);
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+    for (; num_blocks > 0; --num_blocks, data += BlockSize) {
+        const __m128i abef = state0;
+        const __m128i cdgh = state1;
+
+        __m128i msg[4];
+        for (size_t i = 0; i < std::size(msg); ++i) {
+            msg[i] = _mm_shuffle_epi8(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 16)), byte_swap);
+        }
+        AllRoundsSHANI(state0, state1, msg, std::make_index_sequence<16>{});
+
+        state0 = _mm_add_epi32(state0, abef);
+        state1 = _mm_add_epi32(state1, cdgh);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);
+    state1 = _mm_shuffle_epi32(state1, 0xB1);
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+    state1 = _mm_alignr_epi8(state1, tmp, 8);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), state0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), state1);
+}
+#endif
+
+bool HasSHAExtensions() {
+#ifdef ARCHITECTURE_x86_64
+    const auto& caps = Common::GetCPUCaps();
+    return caps.sha && caps.sse4_1 && caps.ssse3;
+#else
+    return false;
+#endif
+}
+
+// Buffers in flight per file, the reader fills one while the hasher consumes the others
+constexpr size_t ChunkSize = 4_MiB;
+constexpr size_t ChunksInFlight = 4;
+
+struct Chunk {
+    size_t index;
+    size_t size;
+};
+
+/// Hashes a whole file, reading it on a helper thread. Returns nullopt if a read fell short.
+std::optional<SHA256Hash> HashFile(const FileSys::VirtualFile& file,
+                                   std::atomic<size_t>& processed_size,
+                                   const std::atomic_bool& cancelled) {
+    const size_t total_size = file->GetSize();
+    std::vector<std::vector<u8>> buffers(ChunksInFlight, std::vector<u8>(ChunkSize));
+    Common::SPSCQueue<size_t, ChunksInFlight> free_chunks;
+    Common::SPSCQueue<Chunk, ChunksInFlight> filled_chunks;
+    for (size_t i = 0; i < ChunksInFlight; ++i) {
+        free_chunks.EmplaceWait(i);
+    }
+
+    std::jthread reader([&](std::stop_token stop_token) {
+        for (size_t offset = 0; offset < total_size;) {
+            size_t index{};
+            free_chunks.PopWait(index, stop_token);
+            if (stop_token.stop_requested()) {
+                return;
+            }
+            const size_t read_size = file->Read(buffers[index].data(),
+                                                std::min(ChunkSize, total_size - offset), offset);
+            filled_chunks.EmplaceWait(Chunk{index, read_size});
+            if (read_size == 0) {
+                return;
+            }
+            offset += read_size;
+        }
+    });
+
+    SHA256 sha256;
+    for (size_t offset = 0; offset < total_size;) {
+        if (cancelled.load(std::memory_order_relaxed)) {
+            return std::nullopt;
+        }
+        const Chunk chunk = filled_chunks.PopWait();
+        if (chunk.size == 0) {
+            return std::nullopt;
+        }
+        sha256.Update(std::span(buffers[chunk.index].data(), chunk.size));
+        free_chunks.EmplaceWait(chunk.index);
+        offset += chunk.size;
+        processed_size.fetch_add(chunk.size, std::memory_order_relaxed);
+    }
+    return sha256.Finish();
+}
+
+} // Anonymous namespace
+
+struct SHA256::SoftwareContext {
+    mbedtls_sha256_context ctx;
+};
+
+SHA256::SHA256(Backend backend) : state{InitialState} {
+    if (backend == Backend::Software || !IsHardwareAccelerated()) {
+        software = std::make_unique<SoftwareContext>();
+        mbedtls_sha256_init(&software->ctx);
+        mbedtls_sha256_starts_ret(&software->ctx, 0);
+    }
+}
+
+SHA256::~SHA256() {
+    if (software) {
+        mbedtls_sha256_free(&software->ctx);
+    }
+}
+
+bool SHA256::IsHardwareAccelerated() {
+    static const bool has_sha_extensions = HasSHAExtensions();
+    return has_sha_extensions;
+}
+
+void SHA256::UpdateBlocks(const u8* data, size_t num_blocks) {
+#ifdef ARCHITECTURE_x86_64
+    CompressSHANI(state, data, num_blocks);
+#else
+    UNREACHABLE();
+#endif
+}
+
+void SHA256::Update(std::span<const u8> data) {
+    if (software) {
+        mbedtls_sha256_update_ret(&software->ctx, data.data(), data.size());
+        return;
+    }
+
+    total_size += data.size();
+    if (buffered_size > 0) {
+        const size_t copy_size = std::min(BlockSize - buffered_size, data.size());
+        std::memcpy(buffer.data() + buffered_size, data.data(), copy_size);
+        buffered_size += copy_size;
+        data = data.subspan(copy_size);
+        if (buffered_size < BlockSize) {
+            return;
+        }
+        UpdateBlocks(buffer.data(), 1);
+        buffered_size = 0;
+    }
+
+    const size_t num_blocks = data.size() / BlockSize;
+    if (num_blocks > 0) {
+        UpdateBlocks(data.data(), num_blocks);
+        data = data.subspan(num_blocks * BlockSize);
+    }
+
+    std::memcpy(buffer.data(), data.data(), data.size());
+    buffered_size = data.size();
+}
+
+SHA256Hash SHA256::Finish() {
+    SHA256Hash hash;
+    if (software) {
+        mbedtls_sha256_finish_ret(&software->ctx, hash.data());
+        return hash;
+    }
+
+    // Pad with a single set bit, zeroes and the message length in bits
+    const u64 total_bits = total_size * 8;
+    buffer[buffered_size++] = 0x80;
+    if (buffered_size > BlockSize - sizeof(u64)) {
+        std::memset(buffer.data() + buffered_size, 0, BlockSize - buffered_size);
+        UpdateBlocks(buffer.data(), 1);
+        buffered_size = 0;
+    }
+    std::memset(buffer.data() + buffered_size, 0, BlockSize - sizeof(u64) - buffered_size);
+    for (size_t i = 0; i < sizeof(u64); ++i) {
+        buffer[BlockSize - 1 - i] = static_cast<u8>(total_bits >> (i * 8));
+    }
+    UpdateBlocks(buffer.data(), 1);
+
+    for (size_t i = 0; i < state.size(); ++i) {
+        hash[i * 4 + 0] = static_cast<u8>(state[i] >> 24);
+        hash[i * 4 + 1] = static_cast<u8>(state[i] >> 16);
+        hash[i * 4 + 2] = static_cast<u8>(state[i] >> 8);
+        hash[i * 4 + 3] = static_cast<u8>(state[i]);
+    }
+    return hash;
+}
+
+bool HashFiles(std::span<const FileSys::VirtualFile> files,
+               std::span<std::optional<SHA256Hash>> out_hashes,
+               const std::function<bool(size_t, size_t)>& progress_callback) {
+    ASSERT(files.size() == out_hashes.size());
+
+    size_t total_size = 0;
+    for (const auto& file : files) {
+        total_size += file->GetSize();
+    }
+
+    // Each file uses a reading and a hashing thread
+    const size_t num_workers = std::clamp<size_t>(std::thread::hardware_concurrency() / 2, 1,
+                                                  std::max<size_t>(files.size(), 1));
+    std::atomic<size_t> next_file{};
+    std::atomic<size_t> processed_size{};
+    std::atomic<size_t> finished_files{};
+    std::atomic_bool cancelled{};
+
+    std::vector<std::jthread> workers;
+    workers.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; ++i) {
+        workers.emplace_back([&] {
+            Common::SetCurrentThreadName("HashFiles");
+            for (size_t index = next_file++; index < files.size(); index = next_file++) {
+                out_hashes[index] = HashFile(files[index], processed_size, cancelled);
+                ++finished_files;
+            }
+        });
+    }
+
+    // Report the progress from this thread, as the callback usually drives a UI
+    while (finished_files.load() < files.size()) {
+        if (!progress_callback(processed_size.load(), total_size)) {
+            cancelled = true;
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+    workers.clear();
+
+    if (cancelled) {
+        return false;
+    }
+    return progress_callback(total_size, total_size);
+}
+
+} // namespace Core::Crypto
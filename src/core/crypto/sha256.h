@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include "common/common_types.h"
+#include "core/file_sys/vfs/vfs_types.h"
+
+namespace Core::Crypto {
+
+using SHA256Hash = std::array<u8, 0x20>;
+
+/// Incremental SHA-256 that uses the SHA extensions of the host CPU when they are available.
+class SHA256 {
+public:
+    enum class Backend {
+        Auto,     ///< SHA extensions if supported by the host, mbedtls otherwise
+        Software, ///< Always mbedtls
+    };
+
+    explicit SHA256(Backend backend = Backend::Auto);
+    ~SHA256();
+
+    SHA256(const SHA256&) = delete;
+    SHA256& operator=(const SHA256&) = delete;
+
+    void Update(std::span<const u8> data);
+
+    /// Returns the hash of all data passed to Update. The object must not be used afterwards.
+    SHA256Hash Finish();
+
+    /// Whether the Auto backend hashes with the SHA extensions on this host
+    static bool IsHardwareAccelerated();
+
+private:
+    void UpdateBlocks(const u8* data, size_t num_blocks);
+
+    struct SoftwareContext;
+    std::unique_ptr<SoftwareContext> software; ///< Set when hashing with mbedtls
+
+    std::array<u32, 8> state;
+    std::array<u8, 64> buffer;
+    size_t buffered_size = 0;
+    u64 total_size = 0;
+};
+
+/**
+ * Computes the SHA-256 of whole files. Reads are pipelined with the hashing through several
+ * buffers per file, and independent files are hashed concurrently. The progress callback is only
+ * invoked from the calling thread, with the number of bytes hashed across all files and their
+ * total size. Returning false from it cancels the remaining work.
+ * @param out_hashes Receives the hash of each file, or nullopt if it could not be read entirely.
+ * @return False if hashing was cancelled.
+ */
+bool HashFiles(std::span<const FileSys::VirtualFile> files,
+               std::span<std::optional<SHA256Hash>> out_hashes,
+               const std::function<bool(size_t, size_t)>& progress_callback);
+
+} // namespace Core::Crypto
@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <vector>
 #include "core/crypto/xts_encryption_layer.h"
 
 namespace Core::Crypto {
@@ -19,10 +20,21 @@ std::size_t XTSEncryptionLayer::Read(u8* data, std::size_t length, std::size_t o
     const auto sector_offset = offset & 0x3FFF;
     if (sector_offset == 0) {
         if (length % XTS_SECTOR_SIZE == 0) {
-            std::vector<u8> raw = base->ReadBytes(length, offset);
-            cipher.XTSTranscode(raw.data(), raw.size(), data, offset / XTS_SECTOR_SIZE,
+            // Decrypt in place, all sectors at once
+            const std::size_t read = base->Read(data, length, offset);
+            const std::size_t read_sectors = read - read % XTS_SECTOR_SIZE;
+            cipher.XTSTranscode(data, read_sectors, data, offset / XTS_SECTOR_SIZE,
                                 XTS_SECTOR_SIZE, Op::Decrypt);
-            return raw.size();
+            if (read_sectors != read) {
+                // A short read ends within a sector, decrypt it padded like the unaligned path
+                std::vector<u8> block(XTS_SECTOR_SIZE);
+                std::memcpy(block.data(), data + read_sectors, read - read_sectors);
+                cipher.XTSTranscode(block.data(), block.size(), block.data(),
+                                    (offset + read_sectors) / XTS_SECTOR_SIZE, XTS_SECTOR_SIZE,
+                                    Op::Decrypt);
+                std::memcpy(data + read_sectors, block.data(), read - read_sectors);
+            }
+            return read;
         }
         if (length > XTS_SECTOR_SIZE) {
             const auto rem = length % XTS_SECTOR_SIZE;
@@ -186,17 +186,75 @@ bool RomFSBuildContext::AddFile(std::shared_ptr<RomFSBuildDirectoryContext> pare
     return true;
 }
 
-RomFSBuildContext::RomFSBuildContext(VirtualDir base_, VirtualDir ext_)
-    : base(std::move(base_)), ext(std::move(ext_)) {
+void RomFSBuildContext::InitializeRoot() {
     root = std::make_shared<RomFSBuildDirectoryContext>();
     root->path = "\0";
     directories.emplace_back(root);
     num_dirs = 1;
     dir_table_size = 0x18;
+}
+
+std::shared_ptr<RomFSBuildDirectoryContext> RomFSBuildContext::GetOrAddDirectory(
+    std::string_view path) {
+    if (path.empty()) {
+        return root;
+    }
+    if (const auto it = dir_map.find(path); it != dir_map.end()) {
+        return it->second;
+    }
 
+    const auto slash = path.rfind('/');
+    auto parent = GetOrAddDirectory(slash == std::string_view::npos ? std::string_view{}
+                                                                    : path.substr(0, slash));
+    const auto name = slash == std::string_view::npos ? path : path.substr(slash + 1);
+    const auto child = std::make_shared<RomFSBuildDirectoryContext>();
+    child->cur_path_ofs = parent->path_len + 1;
+    child->path_len = child->cur_path_ofs + static_cast<u32>(name.size());
+    child->path = parent->path + "/" + std::string(name);
+
+    // Sanity check on path_len
+    ASSERT(child->path_len < FS_MAX_PATH);
+
+    AddDirectory(std::move(parent), child);
+    dir_map.emplace(std::string(path), child);
+    return child;
+}
+
+RomFSBuildContext::RomFSBuildContext(VirtualDir base_, VirtualDir ext_)
+    : base(std::move(base_)), ext(std::move(ext_)) {
+    InitializeRoot();
     VisitDirectory(base, ext, root);
 }
 
+RomFSBuildContext::RomFSBuildContext(
+    std::span<const std::string> dir_paths,
+    std::vector<std::pair<std::string, VirtualFile>> file_sources) {
+    InitializeRoot();
+    for (const auto& path : dir_paths) {
+        GetOrAddDirectory(path);
+    }
+
+    for (auto& [path, source] : file_sources) {
+        const auto slash = path.rfind('/');
+        auto parent = GetOrAddDirectory(std::string_view{path}.substr(
+            0, slash == std::string::npos ? 0 : slash));
+        const auto name_size = slash == std::string::npos ? path.size() : path.size() - slash - 1;
+
+        const auto child = std::make_shared<RomFSBuildFileContext>();
+        child->cur_path_ofs = parent->path_len + 1;
+        child->path_len = child->cur_path_ofs + static_cast<u32>(name_size);
+        child->path = parent->path + "/" + path.substr(path.size() - name_size);
+
+        // Sanity check on path_len
+        ASSERT(child->path_len < FS_MAX_PATH);
+
+        child->source = std::move(source);
+        child->size = child->source->GetSize();
+        AddFile(std::move(parent), child);
+    }
+    dir_map.clear();
+}
+
 RomFSBuildContext::~RomFSBuildContext() = default;
 
 std::vector<std::pair<u64, VirtualFile>> RomFSBuildContext::Build() {
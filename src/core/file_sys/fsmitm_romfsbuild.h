@@ -5,7 +5,10 @@
 
 #include <map>
 #include <memory>
+#include <span>
 #include <string>
+#include <utility>
+#include <vector>
 #include "common/common_types.h"
 #include "core/file_sys/vfs/vfs.h"
 
@@ -19,6 +22,11 @@ struct RomFSFileEntry;
 class RomFSBuildContext {
 public:
     explicit RomFSBuildContext(VirtualDir base, VirtualDir ext = nullptr);
+
+    // Builds from flat lists of directories and files, with paths relative to the root such as
+    // "a/b.bin". Missing parent directories are added implicitly.
+    RomFSBuildContext(std::span<const std::string> dir_paths,
+                      std::vector<std::pair<std::string, VirtualFile>> file_sources);
     ~RomFSBuildContext();
 
     // This finalizes the context.
@@ -38,6 +46,11 @@ private:
     u64 file_hash_table_size = 0;
     u64 file_partition_size = 0;
 
+    std::map<std::string, std::shared_ptr<RomFSBuildDirectoryContext>, std::less<>> dir_map;
+
+    void InitializeRoot();
+    std::shared_ptr<RomFSBuildDirectoryContext> GetOrAddDirectory(std::string_view path);
+
     void VisitDirectory(VirtualDir filesys, VirtualDir ext_dir,
                         std::shared_ptr<RomFSBuildDirectoryContext> parent);
 
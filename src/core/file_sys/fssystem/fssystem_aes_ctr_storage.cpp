@@ -57,8 +57,7 @@ size_t AesCtrStorage::Read(u8* buffer, size_t size, size_t offset) const {
     AddCounter(ctr.data(), IvSize, offset / BlockSize);
 
     // Decrypt.
-    m_cipher->SetIV(ctr);
-    m_cipher->Transcode(buffer, size, buffer, Core::Crypto::Op::Decrypt);
+    Transcode(buffer, size, buffer, ctr, Core::Crypto::Op::Decrypt);
 
     return size;
 }
@@ -104,9 +103,8 @@ size_t AesCtrStorage::Write(const u8* buffer, size_t size, size_t offset) {
         }
 
         // Encrypt the data.
-        m_cipher->SetIV(ctr);
-        m_cipher->Transcode(buffer, write_size, reinterpret_cast<u8*>(write_buf),
-                            Core::Crypto::Op::Encrypt);
+        Transcode(buffer + cur_offset, write_size, reinterpret_cast<u8*>(write_buf), ctr,
+                  Core::Crypto::Op::Encrypt);
 
         // Write the encrypted data.
         m_base_storage->Write(reinterpret_cast<u8*>(write_buf), write_size, offset + cur_offset);
@@ -122,6 +120,23 @@ size_t AesCtrStorage::Write(const u8* buffer, size_t size, size_t offset) {
     return size;
 }
 
+void AesCtrStorage::Transcode(const u8* src, size_t size, u8* dst,
+                              const std::array<u8, IvSize>& ctr, Core::Crypto::Op op) const {
+    // The cipher keeps the counter it is transcoding from, so concurrent reads (such as the ExeFS
+    // modules read by the NSO loader workers) cannot share it. Use a context of our own when
+    // another thread holds the shared one.
+    std::unique_lock lk{m_cipher_mutex, std::try_to_lock};
+    if (lk.owns_lock()) {
+        m_cipher->SetIV(ctr);
+        m_cipher->Transcode(src, size, dst, op);
+        return;
+    }
+
+    Core::Crypto::AESCipher<Core::Crypto::Key128> cipher(m_key, Core::Crypto::Mode::CTR);
+    cipher.SetIV(ctr);
+    cipher.Transcode(src, size, dst, op);
+}
+
 size_t AesCtrStorage::GetSize() const {
     return m_base_storage->GetSize();
 }
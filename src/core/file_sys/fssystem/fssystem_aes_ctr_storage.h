@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <mutex>
 #include <optional>
 
 #include "core/crypto/aes_util.h"
@@ -33,11 +34,16 @@ public:
     virtual size_t Write(const u8* buffer, size_t size, size_t offset) override;
     virtual size_t GetSize() const override;
 
+private:
+    void Transcode(const u8* src, size_t size, u8* dst, const std::array<u8, IvSize>& ctr,
+                   Core::Crypto::Op op) const;
+
 private:
     VirtualFile m_base_storage;
     std::array<u8, KeySize> m_key;
     std::array<u8, IvSize> m_iv;
     mutable std::optional<Core::Crypto::AESCipher<Core::Crypto::Key128>> m_cipher;
+    mutable std::mutex m_cipher_mutex;
 };
 
 } // namespace FileSys
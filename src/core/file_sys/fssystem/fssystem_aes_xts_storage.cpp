@@ -87,19 +87,24 @@ size_t AesXtsStorage::Read(u8* buffer, size_t size, size_t offset) const {
         ASSERT(processed_size == std::min(size, m_block_size - skip_size));
     }
 
-    // Decrypt aligned chunks.
-    char* cur = reinterpret_cast<char*>(buffer) + processed_size;
+    // Decrypt all whole blocks in a single call.
+    u8* cur = buffer + processed_size;
     size_t remaining = size - processed_size;
-    while (remaining > 0) {
-        const size_t cur_size = std::min(m_block_size, remaining);
+    const size_t aligned_size = Common::AlignDown(remaining, m_block_size);
+    if (aligned_size > 0) {
+        m_cipher->XTSTranscode(cur, aligned_size, cur, ctr, m_block_size,
+                               Core::Crypto::Op::Decrypt);
 
-        m_cipher->SetIV(ctr);
-        m_cipher->Transcode(cur, cur_size, cur, Core::Crypto::Op::Decrypt);
+        remaining -= aligned_size;
+        cur += aligned_size;
 
-        remaining -= cur_size;
-        cur += cur_size;
+        AddCounter(ctr.data(), IvSize, aligned_size / m_block_size);
+    }
 
-        AddCounter(ctr.data(), IvSize, 1);
+    // Decrypt the partial block at the end.
+    if (remaining > 0) {
+        m_cipher->SetIV(ctr);
+        m_cipher->Transcode(cur, remaining, cur, Core::Crypto::Op::Decrypt);
     }
 
     return size;
@@ -0,0 +1,18 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <thread>
+
+#include "core/file_sys/fssystem/fssystem_compressed_storage.h"
+
+namespace FileSys {
+
+Common::ThreadWorker& CompressedStorage::GetPrefetchWorker() {
+    static Common::ThreadWorker worker(
+        std::clamp<size_t>(std::thread::hardware_concurrency() / 2, 1, 4),
+        "CompressedStoragePrefetch");
+    return worker;
+}
+
+} // namespace FileSys
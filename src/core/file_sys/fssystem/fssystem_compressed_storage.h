@@ -3,7 +3,17 @@
 
 #pragma once
 
+#include <algorithm>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <utility>
+
 #include "common/literals.h"
+#include "common/make_unique_for_overwrite.h"
+#include "common/thread_worker.h"
 
 #include "core/file_sys/errors.h"
 #include "core/file_sys/fssystem/fs_i_storage.h"
@@ -45,7 +55,18 @@ public:
         return BucketTree::QueryEntryStorageSize(NodeSize, sizeof(Entry), entry_count);
     }
 
+    struct PrefetchStatistics {
+        u64 cache_hits;      ///< Reads served at least in part from decompressed entries
+        u64 cache_misses;    ///< Reads that had to go through the core entirely
+        u64 prefetch_issued; ///< Entries queued for decompression ahead of the reader
+        u64 prefetch_hits;   ///< Prefetched entries that were read afterwards
+        u64 prefetch_wasted; ///< Prefetched entries dropped before being read
+    };
+
 private:
+    /// Worker pool shared by all compressed storages to decompress entries ahead of the reader.
+    static Common::ThreadWorker& GetPrefetchWorker();
+
     class CompressedStorageCore {
         CITRON_NON_COPYABLE(CompressedStorageCore);
         CITRON_NON_MOVEABLE(CompressedStorageCore);
@@ -650,7 +671,6 @@ private:
             R_SUCCEED();
         }
 
-    private:
         DecompressorFunction GetDecompressor(CompressionType type) const {
             // Check that we can get a decompressor for the type.
             if (CompressionTypeUtility::IsUnknownType(type)) {
@@ -661,6 +681,11 @@ private:
             return m_get_decompressor_function(type);
         }
 
+        size_t GetBlockSizeMax() const {
+            return m_block_size_max;
+        }
+
+    private:
         bool IsInitialized() const {
             return m_table.IsInitialized();
         }
@@ -690,18 +715,78 @@ private:
         };
         static_assert(std::is_trivial_v<AccessRange>);
 
+        struct CachedEntry {
+            std::unique_ptr<u8[]> data;
+            s64 virtual_size;
+            u64 last_access;
+            bool is_prefetched; ///< Decompressed ahead of time and not read yet
+        };
+
+        // Keeps the last prefetch job of an entry accounted for until its task is destroyed,
+        // whether it ran or was dropped with the worker queue.
+        class PrefetchTicket {
+        public:
+            PrefetchTicket(CacheManager* manager, s64 virtual_offset)
+                : m_manager(manager), m_virtual_offset(virtual_offset) {}
+
+            PrefetchTicket(PrefetchTicket&& rhs) noexcept
+                : m_manager(std::exchange(rhs.m_manager, nullptr)),
+                  m_virtual_offset(rhs.m_virtual_offset) {}
+
+            PrefetchTicket& operator=(PrefetchTicket&&) = delete;
+
+            ~PrefetchTicket() {
+                if (m_manager != nullptr) {
+                    m_manager->CompletePrefetch(m_virtual_offset);
+                }
+            }
+
+        private:
+            CacheManager* m_manager;
+            s64 m_virtual_offset;
+        };
+
+        // Consecutive sequential reads after which the following entries are prefetched.
+        static constexpr u32 SequentialReadsForPrefetch = 2;
+
+        // Entries decompressed ahead of a sequential reader.
+        static constexpr s32 PrefetchEntryCountMax = 8;
+
+        // Decompressed entries larger than this are never cached.
+        static constexpr s64 CachedEntrySizeMax = 1_MiB;
+
     public:
         CacheManager() = default;
 
+        ~CacheManager() {
+            this->Finalize();
+        }
+
     public:
         Result Initialize(s64 storage_size, size_t cache_size_0, size_t cache_size_1,
                           size_t max_cache_entries) {
             // Set our fields.
             m_storage_size = storage_size;
+            m_max_cache_entries = std::max<size_t>(max_cache_entries, 1);
+            m_prefetch_entry_count =
+                std::min<s32>(PrefetchEntryCountMax, static_cast<s32>(m_max_cache_entries / 2));
 
             R_SUCCEED();
         }
 
+        void Finalize() {
+            // Drop the queued prefetches and wait for the running ones, they reference the core.
+            std::unique_lock lk{m_cache_mutex};
+            this->CancelPrefetchLocked();
+            m_prefetch_condvar.wait(lk, [this] { return m_prefetch_pending.empty(); });
+            m_cached_entries.clear();
+        }
+
+        PrefetchStatistics GetPrefetchStatistics() {
+            std::scoped_lock lk{m_cache_mutex};
+            return m_statistics;
+        }
+
         Result Read(CompressedStorageCore& core, s64 offset, void* buffer, size_t size) {
             // If we have nothing to read, succeed.
             R_SUCCEED_IF(size == 0);
@@ -715,6 +800,236 @@ private:
             // Determine how much we can read.
             const size_t read_size = std::min<size_t>(size, m_storage_size - offset);
 
+            // Serve the head of the read from entries that are already decompressed.
+            const size_t cached_size =
+                this->ReadFromCache(offset, static_cast<u8*>(buffer), read_size);
+
+            // Read the rest from the core.
+            if (cached_size < read_size) {
+                std::scoped_lock lk{m_core_mutex};
+                R_TRY(this->ReadImpl(core, offset + cached_size,
+                                     static_cast<u8*>(buffer) + cached_size,
+                                     read_size - cached_size));
+            }
+
+            // Decompress the following entries in the background when reading sequentially.
+            this->UpdateAccessPattern(core, offset, read_size);
+
+            R_SUCCEED();
+        }
+
+    private:
+        size_t ReadFromCache(s64 offset, u8* buffer, size_t size) {
+            std::scoped_lock lk{m_cache_mutex};
+
+            size_t processed = 0;
+            while (processed < size) {
+                const s64 cur_offset = offset + processed;
+
+                // Find the entry containing the offset.
+                auto it = m_cached_entries.upper_bound(cur_offset);
+                if (it == m_cached_entries.begin()) {
+                    break;
+                }
+                --it;
+                CachedEntry& entry = it->second;
+                const s64 entry_end = it->first + entry.virtual_size;
+                if (entry_end <= cur_offset) {
+                    break;
+                }
+
+                // Copy out what we need.
+                const size_t copy_size =
+                    std::min<size_t>(size - processed, static_cast<size_t>(entry_end - cur_offset));
+                std::memcpy(buffer + processed, entry.data.get() + (cur_offset - it->first),
+                            copy_size);
+                processed += copy_size;
+
+                entry.last_access = ++m_access_counter;
+                if (entry.is_prefetched) {
+                    entry.is_prefetched = false;
+                    ++m_statistics.prefetch_hits;
+                }
+            }
+
+            if (processed == 0) {
+                ++m_statistics.cache_misses;
+            } else {
+                ++m_statistics.cache_hits;
+            }
+            return processed;
+        }
+
+        void InsertCache(s64 virtual_offset, std::unique_ptr<u8[]> data, s64 virtual_size,
+                         bool is_prefetched) {
+            std::scoped_lock lk{m_cache_mutex};
+            this->InsertCacheLocked(virtual_offset, std::move(data), virtual_size,
+                                    is_prefetched);
+        }
+
+        void InsertCacheLocked(s64 virtual_offset, std::unique_ptr<u8[]> data, s64 virtual_size,
+                               bool is_prefetched) {
+            if (m_cached_entries.contains(virtual_offset)) {
+                return;
+            }
+
+            // Evict the least recently used entry to stay within our budget.
+            if (m_cached_entries.size() >= m_max_cache_entries) {
+                const auto victim = std::min_element(
+                    m_cached_entries.begin(), m_cached_entries.end(),
+                    [](const auto& lhs, const auto& rhs) {
+                        return lhs.second.last_access < rhs.second.last_access;
+                    });
+                if (victim->second.is_prefetched) {
+                    ++m_statistics.prefetch_wasted;
+                }
+                m_cached_entries.erase(victim);
+            }
+
+            CachedEntry entry{
+                .data = std::move(data),
+                .virtual_size = virtual_size,
+                .last_access = ++m_access_counter,
+                .is_prefetched = is_prefetched,
+            };
+            m_cached_entries.emplace(virtual_offset, std::move(entry));
+        }
+
+        void UpdateAccessPattern(CompressedStorageCore& core, s64 offset, size_t size) {
+            const s64 end_offset = offset + static_cast<s64>(size);
+            s64 prefetch_offset;
+            {
+                std::scoped_lock lk{m_cache_mutex};
+
+                // Track how long the title has been reading sequentially, and stop looking ahead
+                // as soon as it seeks elsewhere.
+                if (offset == m_next_sequential_offset) {
+                    ++m_sequential_reads;
+                } else {
+                    if (m_sequential_reads >= SequentialReadsForPrefetch) {
+                        this->CancelPrefetchLocked();
+                    }
+                    m_sequential_reads = 0;
+                }
+                m_next_sequential_offset = end_offset;
+
+                if (m_sequential_reads < SequentialReadsForPrefetch ||
+                    m_prefetch_entry_count == 0 || end_offset >= m_storage_size) {
+                    return;
+                }
+                prefetch_offset = std::max(end_offset, m_prefetch_end_offset);
+                if (prefetch_offset >= m_storage_size) {
+                    return;
+                }
+            }
+
+            std::scoped_lock lk{m_core_mutex};
+
+            // Get the entries following the read, and one more to know the size of the last.
+            std::array<Entry, PrefetchEntryCountMax + 1> entries;
+            s32 entry_count = 0;
+            if (R_FAILED(core.GetEntryList(entries.data(), std::addressof(entry_count),
+                                           m_prefetch_entry_count + 1, prefetch_offset,
+                                           m_storage_size - prefetch_offset))) {
+                return;
+            }
+
+            std::scoped_lock lk2{m_cache_mutex};
+            const s32 prefetch_count = std::min(entry_count, m_prefetch_entry_count);
+            for (s32 i = 0; i < prefetch_count; ++i) {
+                const Entry& entry = entries[i];
+                const s64 entry_end =
+                    i + 1 < entry_count ? entries[i + 1].virt_offset : m_storage_size;
+                const s64 virtual_size = entry_end - entry.virt_offset;
+                m_prefetch_end_offset = std::max(m_prefetch_end_offset, entry_end);
+
+                // Only compressed entries are worth decompressing ahead of time.
+                if (!CompressionTypeUtility::IsBlockAlignmentRequired(entry.compression_type) ||
+                    entry.virt_offset < end_offset || virtual_size <= 0 ||
+                    virtual_size > CachedEntrySizeMax ||
+                    entry.GetPhysicalSize() > static_cast<s64>(core.GetBlockSizeMax()) ||
+                    m_cached_entries.contains(entry.virt_offset) ||
+                    m_prefetch_pending.contains(entry.virt_offset)) {
+                    continue;
+                }
+
+                const auto decompressor = core.GetDecompressor(entry.compression_type);
+                if (decompressor == nullptr) {
+                    continue;
+                }
+
+                m_prefetch_pending.insert(entry.virt_offset);
+                ++m_statistics.prefetch_issued;
+                GetPrefetchWorker().QueueWork(
+                    [this, ticket = PrefetchTicket{this, entry.virt_offset},
+                     data_storage = core.GetDataStorage(), decompressor, entry, virtual_size,
+                     generation = m_prefetch_generation] {
+                        this->Prefetch(data_storage, decompressor, entry, virtual_size,
+                                       generation);
+                    });
+            }
+        }
+
+        void Prefetch(const VirtualFile& data_storage, DecompressorFunction decompressor,
+                      const Entry& entry, s64 virtual_size, u64 generation) {
+            // Skip the work if the access pattern changed since the prefetch was queued.
+            {
+                std::scoped_lock lk{m_cache_mutex};
+                if (generation != m_prefetch_generation) {
+                    return;
+                }
+            }
+
+            // Read the compressed data. Only the accesses to the data storage are serialized with
+            // the reader, the decompression runs in parallel with it and the other workers.
+            const size_t physical_size = static_cast<size_t>(entry.GetPhysicalSize());
+            auto compressed = Common::make_unique_for_overwrite<u8[]>(physical_size);
+            {
+                std::scoped_lock lk{m_core_mutex};
+                if (entry.phys_offset < 0 ||
+                    entry.phys_offset + entry.GetPhysicalSize() >
+                        static_cast<s64>(data_storage->GetSize()) ||
+                    data_storage->Read(compressed.get(), physical_size,
+                                       static_cast<size_t>(entry.phys_offset)) != physical_size) {
+                    return;
+                }
+            }
+
+            auto data = Common::make_unique_for_overwrite<u8[]>(static_cast<size_t>(virtual_size));
+            if (R_FAILED(decompressor(data.get(), static_cast<size_t>(virtual_size),
+                                      compressed.get(), physical_size))) {
+                return;
+            }
+
+            std::scoped_lock lk{m_cache_mutex};
+            if (generation == m_prefetch_generation) {
+                this->InsertCacheLocked(entry.virt_offset, std::move(data), virtual_size, true);
+            }
+        }
+
+        void CompletePrefetch(s64 virtual_offset) {
+            // Notify under the lock, Finalize may destroy the condition variable once it wakes.
+            std::scoped_lock lk{m_cache_mutex};
+            m_prefetch_pending.erase(virtual_offset);
+            m_prefetch_condvar.notify_all();
+        }
+
+        void CancelPrefetchLocked() {
+            ++m_prefetch_generation;
+            m_prefetch_end_offset = 0;
+
+            // Drop what was decompressed ahead and never read.
+            std::erase_if(m_cached_entries, [this](const auto& item) {
+                if (item.second.is_prefetched) {
+                    ++m_statistics.prefetch_wasted;
+                    return true;
+                }
+                return false;
+            });
+        }
+
+        Result ReadImpl(CompressedStorageCore& core, s64 offset, u8* buffer, size_t read_size) {
+
             // Create head/tail ranges.
             AccessRange head_range = {};
             AccessRange tail_range = {};
@@ -779,7 +1094,7 @@ private:
             // Begin performing the accesses.
             s64 cur_offset = offset;
             size_t cur_size = read_size;
-            char* cur_dst = static_cast<char*>(buffer);
+            u8* cur_dst = buffer;
 
             // Determine our alignment.
             const bool head_unaligned = head_range.is_block_alignment_required &&
@@ -879,6 +1194,16 @@ private:
 
                         std::memcpy(cur_dst, pooled_buffer.GetBuffer() + skip_size, copy_size);
 
+                        // Keep the decompressed entry, the next small read likely lands in it too.
+                        if (unaligned_range->virtual_size <= CachedEntrySizeMax) {
+                            auto data = Common::make_unique_for_overwrite<u8[]>(
+                                size_buffer_required);
+                            std::memcpy(data.get(), pooled_buffer.GetBuffer(),
+                                        size_buffer_required);
+                            this->InsertCache(unaligned_range->virtual_offset, std::move(data),
+                                              unaligned_range->virtual_size, false);
+                        }
+
                         // Advance.
                         cur_dst += copy_size;
                         cur_offset += copy_size;
@@ -893,6 +1218,21 @@ private:
 
     private:
         s64 m_storage_size = 0;
+        size_t m_max_cache_entries = 1;
+        s32 m_prefetch_entry_count = 0;
+
+        std::mutex m_core_mutex; ///< Serializes the accesses to the core and its data storage
+
+        std::mutex m_cache_mutex;
+        std::map<s64, CachedEntry> m_cached_entries; ///< Keyed by virtual offset
+        u64 m_access_counter = 0;
+        s64 m_next_sequential_offset = -1;
+        u32 m_sequential_reads = 0;
+        s64 m_prefetch_end_offset = 0;
+        u64 m_prefetch_generation = 0;
+        std::set<s64> m_prefetch_pending;
+        std::condition_variable m_prefetch_condvar;
+        PrefetchStatistics m_statistics{};
     };
 
 public:
@@ -920,9 +1260,14 @@ public:
     }
 
     void Finalize() {
+        m_cache_manager.Finalize();
         m_core.Finalize();
     }
 
+    PrefetchStatistics GetPrefetchStatistics() {
+        return m_cache_manager.GetPrefetchStatistics();
+    }
+
     VirtualFile GetDataStorage() {
         return m_core.GetDataStorage();
     }
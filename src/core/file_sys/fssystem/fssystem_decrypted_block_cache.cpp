@@ -0,0 +1,164 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/alignment.h"
+#include "common/assert.h"
+#include "common/make_unique_for_overwrite.h"
+#include "core/file_sys/fssystem/fssystem_decrypted_block_cache.h"
+
+namespace FileSys {
+
+DecryptedBlockCache& DecryptedBlockCache::GetInstance() {
+    static DecryptedBlockCache instance;
+    return instance;
+}
+
+void DecryptedBlockCache::SetCapacity(size_t capacity) {
+    if (m_capacity.exchange(capacity, std::memory_order_relaxed) <= capacity) {
+        return;
+    }
+    for (Shard& shard : m_shards) {
+        std::scoped_lock lk{shard.mutex};
+        this->EvictLocked(shard, capacity / ShardCount);
+    }
+}
+
+std::shared_ptr<const DecryptedBlockCache::Block> DecryptedBlockCache::Find(u64 storage_id,
+                                                                            s64 offset) {
+    const Key key{storage_id, offset};
+    Shard& shard = this->GetShard(key);
+    {
+        std::scoped_lock lk{shard.mutex};
+        const auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            // Move the entry to the front of the recently used list.
+            shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+            m_hits.fetch_add(1, std::memory_order_relaxed);
+            return it->second->block;
+        }
+    }
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+void DecryptedBlockCache::Insert(u64 storage_id, s64 offset, std::shared_ptr<const Block> block) {
+    ASSERT(block != nullptr);
+
+    const size_t shard_capacity = this->GetCapacity() / ShardCount;
+    if (block->size > shard_capacity) {
+        return;
+    }
+
+    const Key key{storage_id, offset};
+    Shard& shard = this->GetShard(key);
+    std::scoped_lock lk{shard.mutex};
+
+    // Another reader may have inserted the same block in the meantime.
+    if (shard.index.contains(key)) {
+        return;
+    }
+
+    shard.size += block->size;
+    m_cached_bytes.fetch_add(block->size, std::memory_order_relaxed);
+    shard.entries.push_front(Entry{key, std::move(block)});
+    shard.index.emplace(key, shard.entries.begin());
+    this->EvictLocked(shard, shard_capacity);
+}
+
+void DecryptedBlockCache::EvictLocked(Shard& shard, size_t shard_capacity) {
+    while (shard.size > shard_capacity && !shard.entries.empty()) {
+        const Entry& entry = shard.entries.back();
+        shard.size -= entry.block->size;
+        m_cached_bytes.fetch_sub(entry.block->size, std::memory_order_relaxed);
+        m_evictions.fetch_add(1, std::memory_order_relaxed);
+        shard.index.erase(entry.key);
+        shard.entries.pop_back();
+    }
+}
+
+void DecryptedBlockCache::Clear() {
+    for (Shard& shard : m_shards) {
+        std::scoped_lock lk{shard.mutex};
+        m_cached_bytes.fetch_sub(shard.size, std::memory_order_relaxed);
+        shard.index.clear();
+        shard.entries.clear();
+        shard.size = 0;
+    }
+}
+
+DecryptedBlockCache::Statistics DecryptedBlockCache::GetStatistics() const {
+    return {
+        .hits = m_hits.load(std::memory_order_relaxed),
+        .misses = m_misses.load(std::memory_order_relaxed),
+        .evictions = m_evictions.load(std::memory_order_relaxed),
+        .cached_bytes = m_cached_bytes.load(std::memory_order_relaxed),
+    };
+}
+
+void DecryptedBlockCache::ResetStatistics() {
+    m_hits.store(0, std::memory_order_relaxed);
+    m_misses.store(0, std::memory_order_relaxed);
+    m_evictions.store(0, std::memory_order_relaxed);
+}
+
+DecryptedBlockCacheStorage::DecryptedBlockCacheStorage(VirtualFile base_storage, u64 storage_id,
+                                                       DecryptedBlockCache& cache)
+    : m_base_storage(std::move(base_storage)), m_storage_id(storage_id),
+      m_size(m_base_storage->GetSize()), m_cache(cache) {
+    ASSERT(m_base_storage != nullptr);
+}
+
+size_t DecryptedBlockCacheStorage::Read(u8* buffer, size_t size, size_t offset) const {
+    // Allow zero-size reads.
+    if (size == 0 || offset >= m_size) {
+        return 0;
+    }
+
+    // Ensure buffer is valid.
+    ASSERT(buffer != nullptr);
+
+    // Clamp the read to the storage.
+    size = std::min(size, m_size - offset);
+
+    size_t processed = 0;
+    while (processed < size) {
+        const size_t cur_offset = offset + processed;
+        const size_t block_offset = Common::AlignDown(cur_offset, DecryptedBlockCache::BlockSize);
+        const size_t offset_in_block = cur_offset - block_offset;
+
+        auto block = m_cache.Find(m_storage_id, static_cast<s64>(block_offset));
+        if (block == nullptr) {
+            // Read and decrypt the whole block once, so the following reads of it are served
+            // from memory.
+            const size_t block_size =
+                std::min(DecryptedBlockCache::BlockSize, m_size - block_offset);
+            auto new_block = std::make_shared<DecryptedBlockCache::Block>();
+            new_block->data = Common::make_unique_for_overwrite<u8[]>(block_size);
+            new_block->size = block_size;
+            const size_t read_size =
+                m_base_storage->Read(new_block->data.get(), block_size, block_offset);
+            if (read_size != block_size) {
+                // Never cache a short read, fall back to reading straight from the base.
+                return processed + m_base_storage->Read(buffer + processed, size - processed,
+                                                        cur_offset);
+            }
+            m_cache.Insert(m_storage_id, static_cast<s64>(block_offset), new_block);
+            block = std::move(new_block);
+        }
+
+        const size_t copy_size = std::min(block->size - offset_in_block, size - processed);
+        std::memcpy(buffer + processed, block->data.get() + offset_in_block, copy_size);
+        processed += copy_size;
+    }
+
+    return size;
+}
+
+size_t DecryptedBlockCacheStorage::GetSize() const {
+    return m_size;
+}
+
+} // namespace FileSys
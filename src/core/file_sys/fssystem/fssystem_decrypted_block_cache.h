@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "common/common_funcs.h"
+#include "common/common_types.h"
+#include "common/literals.h"
+#include "core/file_sys/fssystem/fs_i_storage.h"
+
+namespace FileSys {
+
+using namespace Common::Literals;
+
+/**
+ * Process wide cache of NCA section blocks that have already been decrypted and resolved through
+ * the sparse, patch and indirect layers. Storages are identified by a hash of their content and
+ * keys rather than by object, so the blocks are shared by every storage opened on the same
+ * section, including those of NCAs opened again later.
+ */
+class DecryptedBlockCache {
+    CITRON_NON_COPYABLE(DecryptedBlockCache);
+    CITRON_NON_MOVEABLE(DecryptedBlockCache);
+
+public:
+    static constexpr size_t BlockSize = 64_KiB;
+    static constexpr size_t ShardCount = 16;
+
+    struct Block {
+        std::unique_ptr<u8[]> data;
+        size_t size;
+    };
+
+    struct Statistics {
+        u64 hits;
+        u64 misses;
+        u64 evictions;
+        u64 cached_bytes;
+    };
+
+public:
+    DecryptedBlockCache() = default;
+
+    static DecryptedBlockCache& GetInstance();
+
+    /// Sets the memory budget of the cache, evicting blocks if it shrinks. Zero disables it.
+    void SetCapacity(size_t capacity);
+    size_t GetCapacity() const {
+        return m_capacity.load(std::memory_order_relaxed);
+    }
+
+    /// Returns the cached block at the BlockSize aligned offset, or null on a miss.
+    std::shared_ptr<const Block> Find(u64 storage_id, s64 offset);
+    void Insert(u64 storage_id, s64 offset, std::shared_ptr<const Block> block);
+
+    void Clear();
+
+    Statistics GetStatistics() const;
+    void ResetStatistics();
+
+private:
+    struct Key {
+        u64 storage_id;
+        s64 offset;
+
+        bool operator==(const Key&) const = default;
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            const u64 offset_hash = static_cast<u64>(key.offset) * 0x9E3779B97F4A7C15ULL;
+            return static_cast<size_t>(key.storage_id ^ offset_hash);
+        }
+    };
+
+    struct Entry {
+        Key key;
+        std::shared_ptr<const Block> block;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::list<Entry> entries; ///< Most recently used first
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+        size_t size{};
+    };
+
+    Shard& GetShard(const Key& key) {
+        return m_shards[KeyHash{}(key) % ShardCount];
+    }
+
+    void EvictLocked(Shard& shard, size_t shard_capacity);
+
+    std::array<Shard, ShardCount> m_shards;
+    std::atomic<size_t> m_capacity{};
+    std::atomic<u64> m_hits{};
+    std::atomic<u64> m_misses{};
+    std::atomic<u64> m_evictions{};
+    std::atomic<u64> m_cached_bytes{};
+};
+
+/// Read-only storage that serves the reads of its base storage from a DecryptedBlockCache.
+class DecryptedBlockCacheStorage : public IReadOnlyStorage {
+    CITRON_NON_COPYABLE(DecryptedBlockCacheStorage);
+    CITRON_NON_MOVEABLE(DecryptedBlockCacheStorage);
+
+public:
+    DecryptedBlockCacheStorage(VirtualFile base_storage, u64 storage_id,
+                               DecryptedBlockCache& cache);
+
+    virtual size_t Read(u8* buffer, size_t size, size_t offset) const override;
+    virtual size_t GetSize() const override;
+
+private:
+    VirtualFile m_base_storage;
+    u64 m_storage_id;
+    size_t m_size;
+    DecryptedBlockCache& m_cache;
+};
+
+} // namespace FileSys
@@ -2,11 +2,14 @@
 // SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include "common/cityhash.h"
+#include "common/settings.h"
 #include "core/file_sys/fssystem/fssystem_aes_ctr_counter_extended_storage.h"
 #include "core/file_sys/fssystem/fssystem_aes_ctr_storage.h"
 #include "core/file_sys/fssystem/fssystem_aes_xts_storage.h"
 #include "core/file_sys/fssystem/fssystem_alignment_matching_storage.h"
 #include "core/file_sys/fssystem/fssystem_compressed_storage.h"
+#include "core/file_sys/fssystem/fssystem_decrypted_block_cache.h"
 #include "core/file_sys/fssystem/fssystem_hierarchical_integrity_verification_storage.h"
 #include "core/file_sys/fssystem/fssystem_hierarchical_sha256_storage.h"
 #include "core/file_sys/fssystem/fssystem_indirect_storage.h"
@@ -282,6 +285,19 @@ Result NcaFileSystemDriver::OpenStorageImpl(VirtualFile* out, NcaFsHeaderReader*
         storage = std::move(indirect_storage);
     }
 
+    // Serve repeated reads of the decrypted data from the shared block cache. A patched section
+    // also reads from its original, so it is only cached when the original comes from the
+    // original reader, which is part of the storage id. External and dummy originals are not.
+    auto& block_cache = DecryptedBlockCache::GetInstance();
+    block_cache.SetCapacity(static_cast<size_t>(Settings::values.nca_block_cache_size.GetValue()) *
+                            1_MiB);
+    const bool has_keyed_original =
+        m_original_reader != nullptr && m_original_reader->HasFsInfo(fs_index);
+    if (block_cache.GetCapacity() != 0 && (!patch_info.HasIndirectTable() || has_keyed_original)) {
+        storage = std::make_shared<DecryptedBlockCacheStorage>(
+            std::move(storage), this->GetBlockCacheStorageId(fs_index), block_cache);
+    }
+
     // Check if we're sparse or requested to skip the integrity layer.
     if (out_header_reader->ExistsSparseLayer() || (ctx != nullptr && ctx->open_raw_storage)) {
         *out = std::move(storage);
@@ -420,6 +436,35 @@ Result NcaFileSystemDriver::OpenIndirectableStorageAsOriginal(
     R_SUCCEED();
 }
 
+u64 NcaFileSystemDriver::GetBlockCacheStorageId(s32 fs_index) const {
+    // The fs header hash covers the master hash of the section and its patch tables, while the
+    // keys tell apart a section decrypted with another title key.
+    const auto hash_reader = [fs_index](const NcaReader& reader, u64 seed) {
+        const Hash& header_hash = reader.GetFsHeaderHash(fs_index);
+        seed = Common::CityHash64WithSeed(reinterpret_cast<const char*>(header_hash.value.data()),
+                                          header_hash.value.size(), seed);
+        if (reader.HasExternalDecryptionKey()) {
+            return Common::CityHash64WithSeed(
+                static_cast<const char*>(reader.GetExternalDecryptionKey()),
+                NcaCryptoConfiguration::Aes128KeySize, seed);
+        }
+        for (const s32 key_index :
+             {NcaHeader::DecryptionKey_AesXts1, NcaHeader::DecryptionKey_AesXts2,
+              NcaHeader::DecryptionKey_AesCtr}) {
+            seed = Common::CityHash64WithSeed(
+                static_cast<const char*>(reader.GetDecryptionKey(key_index)),
+                NcaCryptoConfiguration::Aes128KeySize, seed);
+        }
+        return seed;
+    };
+
+    u64 storage_id = hash_reader(*m_reader, m_reader->GetKeyGeneration());
+    if (m_original_reader != nullptr && m_original_reader->HasFsInfo(fs_index)) {
+        storage_id = hash_reader(*m_original_reader, storage_id);
+    }
+    return storage_id;
+}
+
 Result NcaFileSystemDriver::CreateBodySubStorage(VirtualFile* out, s64 offset, s64 size) {
     // Create the body storage.
     auto body_storage =
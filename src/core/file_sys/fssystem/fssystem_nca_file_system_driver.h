@@ -278,6 +278,8 @@ private:
                                              const NcaFsHeaderReader* header_reader,
                                              StorageContext* ctx);
 
+    u64 GetBlockCacheStorageId(s32 fs_index) const;
+
     Result CreateBodySubStorage(VirtualFile* out, s64 offset, s64 size);
 
     Result CreateAesCtrStorage(VirtualFile* out, VirtualFile base_storage, s64 offset,
@@ -0,0 +1,289 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string_view>
+#include <thread>
+
+#include "common/alignment.h"
+#include "common/bounded_threadsafe_queue.h"
+#include "common/hex_util.h"
+#include "common/literals.h"
+#include "common/logging/log.h"
+#include "common/polyfill_thread.h"
+#include "common/thread.h"
+#include "core/crypto/sha256.h"
+#include "core/file_sys/content_archive.h"
+#include "core/file_sys/install_pipeline.h"
+#include "core/file_sys/registered_cache.h"
+#include "core/file_sys/submission_package.h"
+#include "core/file_sys/vfs/vfs.h"
+
+namespace FileSys {
+
+namespace {
+
+using namespace Common::Literals;
+
+// Buffers in flight per copy, one is read while another is hashed and a third is written
+constexpr size_t ChunkSize = 8_MiB;
+constexpr size_t ChunksInFlight = 4;
+
+// Concurrent installs, each of them uses a reading, a hashing and a writing thread
+constexpr size_t MaxConcurrentInstalls = 4;
+
+using AlignedBuffer = std::vector<u8, Common::AlignmentAllocator<u8, 4096>>;
+
+struct Chunk {
+    size_t index;
+    size_t size;
+};
+
+/// Returns the content ID a file is named after, if any. Content IDs are the first half of the
+/// SHA-256 of the NCA, and NCAs in submission packages are named <id>.nca or <id>.cnmt.nca.
+std::optional<NcaID> GetContentIDFromName(std::string_view name) {
+    constexpr size_t IDLength = 2 * sizeof(NcaID);
+    if (name.size() <= IDLength || name[IDLength] != '.') {
+        return std::nullopt;
+    }
+    const auto id = name.substr(0, IDLength);
+    if (!std::all_of(id.begin(), id.end(), [](char c) { return std::isxdigit(c) != 0; })) {
+        return std::nullopt;
+    }
+    return Common::HexStringToArray<sizeof(NcaID)>(id);
+}
+
+} // Anonymous namespace
+
+bool PipelinedCopy(const VirtualFile& src, const VirtualFile& dest, InstallProgress& progress) {
+    if (src == nullptr || dest == nullptr) {
+        return false;
+    }
+    const size_t total_size = src->GetSize();
+    if (!dest->Resize(total_size)) {
+        return false;
+    }
+
+    std::vector<AlignedBuffer> buffers(ChunksInFlight, AlignedBuffer(ChunkSize));
+    Common::SPSCQueue<size_t, ChunksInFlight> free_chunks;
+    Common::SPSCQueue<Chunk, ChunksInFlight> read_chunks;
+    Common::SPSCQueue<Chunk, ChunksInFlight> hashed_chunks;
+    for (size_t i = 0; i < ChunksInFlight; ++i) {
+        free_chunks.EmplaceWait(i);
+    }
+
+    // A chunk of size zero marks a short read. As there are as many slots in each queue as there
+    // are buffers, emplacing never blocks and only the pops need to observe the stop token.
+    std::jthread reader([&](std::stop_token stop_token) {
+        Common::SetCurrentThreadName("InstallRead");
+        for (size_t offset = 0; offset < total_size;) {
+            size_t index{};
+            free_chunks.PopWait(index, stop_token);
+            if (stop_token.stop_requested()) {
+                return;
+            }
+            const size_t read_size = src->Read(buffers[index].data(),
+                                               std::min(ChunkSize, total_size - offset), offset);
+            read_chunks.EmplaceWait(Chunk{index, read_size});
+            if (read_size == 0) {
+                return;
+            }
+            offset += read_size;
+        }
+    });
+
+    std::optional<Core::Crypto::SHA256Hash> hash;
+    std::jthread hasher([&](std::stop_token stop_token) {
+        Common::SetCurrentThreadName("InstallHash");
+        Core::Crypto::SHA256 sha256;
+        for (size_t offset = 0; offset < total_size;) {
+            Chunk chunk{};
+            read_chunks.PopWait(chunk, stop_token);
+            if (stop_token.stop_requested()) {
+                return;
+            }
+            if (chunk.size != 0) {
+                sha256.Update(std::span(buffers[chunk.index].data(), chunk.size));
+            }
+            hashed_chunks.EmplaceWait(chunk);
+            if (chunk.size == 0) {
+                return;
+            }
+            offset += chunk.size;
+        }
+        hash = sha256.Finish();
+    });
+
+    bool success = true;
+    for (size_t offset = 0; offset < total_size;) {
+        if (progress.cancelled.load(std::memory_order_relaxed)) {
+            success = false;
+            break;
+        }
+        const Chunk chunk = hashed_chunks.PopWait();
+        if (chunk.size == 0 ||
+            dest->Write(buffers[chunk.index].data(), chunk.size, offset) != chunk.size) {
+            LOG_ERROR(Loader, "Failed to copy {} at offset {:#X}", src->GetName(), offset);
+            success = false;
+            break;
+        }
+        free_chunks.EmplaceWait(chunk.index);
+        offset += chunk.size;
+        progress.processed_size.fetch_add(chunk.size, std::memory_order_relaxed);
+    }
+
+    if (success) {
+        hasher.join();
+        const auto content_id = GetContentIDFromName(src->GetName());
+        if (content_id && hash &&
+            !std::equal(content_id->begin(), content_id->end(), hash->begin())) {
+            LOG_ERROR(Loader, "Hash mismatch for {}, got {}", src->GetName(),
+                      Common::HexToString(*hash));
+            success = false;
+        }
+    }
+
+    if (!success) {
+        reader.request_stop();
+        hasher.request_stop();
+        // Do not leave a truncated or corrupt file behind to be picked up as installed content
+        if (const auto parent = dest->GetContainingDirectory(); parent != nullptr) {
+            parent->DeleteFile(dest->GetName());
+        } else {
+            dest->Resize(0);
+        }
+    }
+    return success;
+}
+
+std::vector<InstallResult> InstallNSPs(
+    RegisteredCache& cache, std::span<const std::shared_ptr<NSP>> nsps, bool overwrite_if_exists,
+    const std::function<bool(size_t, size_t, double)>& progress_callback) {
+    if (nsps.empty()) {
+        return {};
+    }
+
+    std::vector<InstallResult> results(nsps.size(), InstallResult::ErrorCopyFailed);
+    std::vector<std::set<u64>> title_ids(nsps.size());
+    size_t total_size = 0;
+    for (size_t i = 0; i < nsps.size(); ++i) {
+        for (const auto& [title_id, ncas] : nsps[i]->GetNCAs()) {
+            title_ids[i].insert(title_id);
+        }
+        for (const auto& nca : nsps[i]->GetNCAsCollapsed()) {
+            total_size += nca->GetBaseFile()->GetSize();
+        }
+    }
+
+    InstallProgress progress;
+    const auto copy = [&progress](const VirtualFile& src, const VirtualFile& dest, size_t) {
+        return PipelinedCopy(src, dest, progress);
+    };
+
+    // Workers take the first package that does not share a title ID with one being installed
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<bool> started(nsps.size());
+    std::multiset<u64> busy_title_ids;
+    size_t num_finished = 0;
+    const auto pick_next = [&]() -> std::optional<size_t> {
+        for (size_t i = 0; i < nsps.size(); ++i) {
+            if (started[i]) {
+                continue;
+            }
+            const bool is_busy =
+                std::any_of(title_ids[i].begin(), title_ids[i].end(),
+                            [&](u64 title_id) { return busy_title_ids.contains(title_id); });
+            if (!is_busy) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    };
+    const auto has_pending = [&] {
+        return std::find(started.begin(), started.end(), false) != started.end();
+    };
+
+    const size_t num_workers = std::clamp<size_t>(std::thread::hardware_concurrency() / 3, 1,
+                                                  std::min(nsps.size(), MaxConcurrentInstalls));
+    std::vector<std::jthread> workers;
+    workers.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; ++i) {
+        workers.emplace_back([&] {
+            Common::SetCurrentThreadName("InstallNSP");
+            while (true) {
+                size_t index{};
+                {
+                    std::unique_lock lock{mutex};
+                    std::optional<size_t> next;
+                    condition.wait(lock, [&] {
+                        next = pick_next();
+                        return next || !has_pending() || progress.cancelled.load();
+                    });
+                    if (!next || progress.cancelled.load()) {
+                        return;
+                    }
+                    index = *next;
+                    started[index] = true;
+                    busy_title_ids.insert(title_ids[index].begin(), title_ids[index].end());
+                }
+
+                const auto result = cache.InstallEntry(*nsps[index], overwrite_if_exists, copy);
+
+                std::scoped_lock lock{mutex};
+                results[index] = result;
+                for (const u64 title_id : title_ids[index]) {
+                    busy_title_ids.erase(busy_title_ids.find(title_id));
+                }
+                ++num_finished;
+                condition.notify_all();
+            }
+        });
+    }
+
+    // Report the progress from this thread, as the callback usually drives a UI
+    using Clock = std::chrono::steady_clock;
+    auto rate_time = Clock::now();
+    size_t rate_processed_size = 0;
+    double bytes_per_second = 0.0;
+    while (true) {
+        {
+            std::scoped_lock lock{mutex};
+            if (num_finished == nsps.size()) {
+                break;
+            }
+        }
+
+        const size_t processed_size = progress.processed_size.load();
+        const auto now = Clock::now();
+        const std::chrono::duration<double> elapsed = now - rate_time;
+        if (elapsed.count() >= 0.5) {
+            bytes_per_second =
+                static_cast<double>(processed_size - rate_processed_size) / elapsed.count();
+            rate_time = now;
+            rate_processed_size = processed_size;
+        }
+        if (!progress_callback(std::min(processed_size, total_size), total_size,
+                               bytes_per_second)) {
+            std::scoped_lock lock{mutex};
+            progress.cancelled = true;
+            condition.notify_all();
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+    workers.clear();
+
+    if (!progress.cancelled) {
+        progress_callback(total_size, total_size, bytes_per_second);
+    }
+    return results;
+}
+
+} // namespace FileSys
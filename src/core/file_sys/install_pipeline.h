@@ -0,0 +1,48 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+#include "core/file_sys/vfs/vfs_types.h"
+
+namespace FileSys {
+
+class NSP;
+class RegisteredCache;
+
+enum class InstallResult;
+
+/// Progress of a batch of installs, shared by all the threads copying its files.
+struct InstallProgress {
+    std::atomic<size_t> processed_size{};
+    std::atomic_bool cancelled{};
+};
+
+/**
+ * Copies a file through a bounded pipeline of large aligned buffers. A reader thread fills them,
+ * a hashing thread computes the SHA-256 of the data and the calling thread writes it out.
+ * Files named after their content ID, as the NCAs of submission packages are, are verified against
+ * it and the copy fails on a mismatch.
+ * @return False if the copy failed, was cancelled or did not verify. dest is emptied in that case.
+ */
+bool PipelinedCopy(const VirtualFile& src, const VirtualFile& dest, InstallProgress& progress);
+
+/**
+ * Installs several submission packages into a registered cache, copying their NCAs with
+ * PipelinedCopy. Independent packages are installed concurrently, packages that share a title ID
+ * are installed one after another in the given order.
+ * The progress callback is only invoked from the calling thread, with the number of bytes copied
+ * across all packages, their total size and the current throughput in bytes per second. Returning
+ * false from it cancels the remaining work.
+ * @return The result of each package, in the same order.
+ */
+std::vector<InstallResult> InstallNSPs(
+    RegisteredCache& cache, std::span<const std::shared_ptr<NSP>> nsps, bool overwrite_if_exists,
+    const std::function<bool(size_t, size_t, double)>& progress_callback);
+
+} // namespace FileSys
@@ -0,0 +1,661 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <optional>
+#include <set>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include "common/cityhash.h"
+#include "common/common_funcs.h"
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+#include "common/fs/path_util.h"
+#include "common/logging/log.h"
+#include "core/file_sys/fsmitm_romfsbuild.h"
+#include "core/file_sys/ips_layer.h"
+#include "core/file_sys/layered_fs_cache.h"
+#include "core/file_sys/romfs.h"
+#include "core/file_sys/vfs/vfs.h"
+#include "core/file_sys/vfs/vfs_concat.h"
+#include "core/file_sys/vfs/vfs_offset.h"
+#include "core/file_sys/vfs/vfs_vector.h"
+
+namespace FileSys {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr u32 CacheMagic = Common::MakeMagic('L', 'F', 'S', 'C');
+constexpr u32 CacheVersion = 1;
+constexpr u32 NoLayer = 0xFFFFFFFF;
+
+struct RomFSHeader {
+    u64 header_size;
+    u64 dir_hash_table_ofs;
+    u64 dir_hash_table_size;
+    u64 dir_table_ofs;
+    u64 dir_table_size;
+    u64 file_hash_table_ofs;
+    u64 file_hash_table_size;
+    u64 file_table_ofs;
+    u64 file_table_size;
+    u64 file_partition_ofs;
+};
+static_assert(sizeof(RomFSHeader) == 0x50, "RomFSHeader has incorrect size.");
+
+// Contents of a layer, with paths relative to its root.
+struct LayerListing {
+    std::string path;
+    bool is_ext{};
+    std::map<std::string, VirtualFile, std::less<>> files;
+    std::set<std::string, std::less<>> directories;
+    std::map<std::string, u64, std::less<>> subtree_fingerprints;
+};
+
+// A file of the built RomFS, and where its data comes from.
+struct SourceEntry {
+    std::string path;
+    u64 offset{};      ///< Offset in the built RomFS
+    u64 size{};        ///< Size in the built RomFS, after IPS patching
+    u32 layer{};       ///< Index of the layer the file comes from, NoLayer for the base RomFS
+    u64 base_offset{}; ///< Offset of the data in the base RomFS
+    u64 base_size{};   ///< Size of the data in the base RomFS
+    u32 ips_layer{};   ///< Index of the layer with the IPS patch, NoLayer if not patched
+};
+
+struct CacheRecord {
+    u64 base_fingerprint{};
+    std::vector<std::pair<std::string, bool>> layers;
+    std::map<std::string, u64, std::less<>> subtree_fingerprints;
+    std::vector<std::string> directories;
+    std::vector<SourceEntry> files;
+    std::vector<u8> header;
+    u64 metadata_offset{};
+    std::vector<u8> metadata;
+};
+
+struct BuildFile {
+    SourceEntry entry;
+    VirtualFile source;
+};
+
+class CacheWriter {
+public:
+    template <typename T>
+    void Write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "Data type must be trivially copyable.");
+        const auto* const bytes = reinterpret_cast<const u8*>(&value);
+        data.insert(data.end(), bytes, bytes + sizeof(T));
+    }
+
+    void WriteBytes(std::span<const u8> bytes) {
+        Write<u64>(bytes.size());
+        data.insert(data.end(), bytes.begin(), bytes.end());
+    }
+
+    void WriteString(std::string_view string) {
+        WriteBytes({reinterpret_cast<const u8*>(string.data()), string.size()});
+    }
+
+    std::vector<u8> data;
+};
+
+class CacheReader {
+public:
+    explicit CacheReader(std::span<const u8> data_) : data{data_} {}
+
+    template <typename T>
+    bool Read(T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "Data type must be trivially copyable.");
+        if (data.size() - offset < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, data.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+
+    template <typename Container>
+    bool ReadBytes(Container& bytes) {
+        u64 size{};
+        if (!Read(size) || data.size() - offset < size) {
+            return false;
+        }
+        const auto* const begin = data.data() + offset;
+        bytes.assign(begin, begin + size);
+        offset += size;
+        return true;
+    }
+
+    bool IsAtEnd() const {
+        return offset == data.size();
+    }
+
+private:
+    std::span<const u8> data;
+    size_t offset = 0;
+};
+
+std::vector<u8> SerializeRecord(const CacheRecord& record) {
+    CacheWriter writer;
+    writer.Write(CacheMagic);
+    writer.Write(CacheVersion);
+    writer.Write(record.base_fingerprint);
+
+    writer.Write(static_cast<u32>(record.layers.size()));
+    for (const auto& [path, is_ext] : record.layers) {
+        writer.WriteString(path);
+        writer.Write(static_cast<u8>(is_ext));
+    }
+    writer.Write(static_cast<u32>(record.subtree_fingerprints.size()));
+    for (const auto& [subtree, fingerprint] : record.subtree_fingerprints) {
+        writer.WriteString(subtree);
+        writer.Write(fingerprint);
+    }
+    writer.Write(static_cast<u32>(record.directories.size()));
+    for (const auto& path : record.directories) {
+        writer.WriteString(path);
+    }
+    writer.Write(static_cast<u32>(record.files.size()));
+    for (const auto& entry : record.files) {
+        writer.WriteString(entry.path);
+        writer.Write(entry.offset);
+        writer.Write(entry.size);
+        writer.Write(entry.layer);
+        writer.Write(entry.base_offset);
+        writer.Write(entry.base_size);
+        writer.Write(entry.ips_layer);
+    }
+
+    writer.WriteBytes(record.header);
+    writer.Write(record.metadata_offset);
+    writer.WriteBytes(record.metadata);
+    return std::move(writer.data);
+}
+
+std::optional<CacheRecord> DeserializeRecord(std::span<const u8> data) {
+    CacheReader reader{data};
+    CacheRecord record;
+    u32 magic{};
+    u32 version{};
+    if (!reader.Read(magic) || magic != CacheMagic || !reader.Read(version) ||
+        version != CacheVersion || !reader.Read(record.base_fingerprint)) {
+        return std::nullopt;
+    }
+
+    u32 count{};
+    if (!reader.Read(count)) {
+        return std::nullopt;
+    }
+    for (u32 i = 0; i < count; ++i) {
+        std::string path;
+        u8 is_ext{};
+        if (!reader.ReadBytes(path) || !reader.Read(is_ext)) {
+            return std::nullopt;
+        }
+        record.layers.emplace_back(std::move(path), is_ext != 0);
+    }
+    if (!reader.Read(count)) {
+        return std::nullopt;
+    }
+    for (u32 i = 0; i < count; ++i) {
+        std::string subtree;
+        u64 fingerprint{};
+        if (!reader.ReadBytes(subtree) || !reader.Read(fingerprint)) {
+            return std::nullopt;
+        }
+        record.subtree_fingerprints.emplace(std::move(subtree), fingerprint);
+    }
+    if (!reader.Read(count)) {
+        return std::nullopt;
+    }
+    for (u32 i = 0; i < count; ++i) {
+        if (!reader.ReadBytes(record.directories.emplace_back())) {
+            return std::nullopt;
+        }
+    }
+    if (!reader.Read(count)) {
+        return std::nullopt;
+    }
+    for (u32 i = 0; i < count; ++i) {
+        SourceEntry& entry = record.files.emplace_back();
+        if (!reader.ReadBytes(entry.path) || !reader.Read(entry.offset) ||
+            !reader.Read(entry.size) || !reader.Read(entry.layer) ||
+            !reader.Read(entry.base_offset) || !reader.Read(entry.base_size) ||
+            !reader.Read(entry.ips_layer)) {
+            return std::nullopt;
+        }
+    }
+
+    if (!reader.ReadBytes(record.header) || !reader.Read(record.metadata_offset) ||
+        !reader.ReadBytes(record.metadata) || !reader.IsAtEnd()) {
+        return std::nullopt;
+    }
+    return record;
+}
+
+std::optional<CacheRecord> LoadRecord(const std::filesystem::path& path) {
+    Common::FS::IOFile file{path, Common::FS::FileAccessMode::Read,
+                            Common::FS::FileType::BinaryFile};
+    if (!file.IsOpen()) {
+        return std::nullopt;
+    }
+    std::vector<u8> data(file.GetSize());
+    if (file.ReadSpan(std::span{data}) != data.size()) {
+        return std::nullopt;
+    }
+    auto record = DeserializeRecord(data);
+    if (!record) {
+        LOG_WARNING(Loader, "Ignoring invalid LayeredFS cache {}",
+                    Common::FS::PathToUTF8String(path));
+    }
+    return record;
+}
+
+void StoreRecord(const std::filesystem::path& path, const CacheRecord& record) {
+    if (!Common::FS::CreateParentDirs(path)) {
+        return;
+    }
+    const auto data = SerializeRecord(record);
+    Common::FS::IOFile file{path, Common::FS::FileAccessMode::Write,
+                            Common::FS::FileType::BinaryFile};
+    if (!file.IsOpen() || file.WriteSpan(std::span{data}) != data.size()) {
+        LOG_WARNING(Loader, "Failed to write LayeredFS cache {}",
+                    Common::FS::PathToUTF8String(path));
+    }
+}
+
+// Identifies the base RomFS by its header and entry tables, the file data is read from it as is.
+std::optional<u64> FingerprintBaseRomFS(const VirtualFile& romfs) {
+    if (romfs == nullptr) {
+        return 0;
+    }
+    RomFSHeader header{};
+    if (romfs->ReadObject(&header) != sizeof(RomFSHeader) ||
+        header.header_size != sizeof(RomFSHeader)) {
+        return std::nullopt;
+    }
+    const auto dir_table = romfs->ReadBytes(header.dir_table_size, header.dir_table_ofs);
+    const auto file_table = romfs->ReadBytes(header.file_table_size, header.file_table_ofs);
+
+    u64 hash = Common::CityHash64(reinterpret_cast<const char*>(&header), sizeof(header));
+    hash = Common::CityHash64WithSeeds(reinterpret_cast<const char*>(dir_table.data()),
+                                       dir_table.size(), hash, romfs->GetSize());
+    return Common::CityHash64WithSeed(reinterpret_cast<const char*>(file_table.data()),
+                                      file_table.size(), hash);
+}
+
+// Returns the top level entry a path belongs to, which is the unit of incremental rebuilds.
+std::string_view GetSubtree(std::string_view path, bool is_ext) {
+    if (const auto slash = path.find('/'); slash != std::string_view::npos) {
+        return path.substr(0, slash);
+    }
+    if (is_ext) {
+        // Stubs and patches of top level entries belong to the entry they apply to.
+        for (const std::string_view suffix : {".stub", ".ips"}) {
+            if (path.ends_with(suffix)) {
+                return path.substr(0, path.size() - suffix.size());
+            }
+        }
+    }
+    return path;
+}
+
+void ScanDirectory(LayerListing& listing, const VirtualDir& dir, const std::string& prefix) {
+    const auto add_to_fingerprint = [&listing](std::string_view path, u64 hash) {
+        // Summed, so that the fingerprint does not depend on the enumeration order.
+        const auto subtree = GetSubtree(path, listing.is_ext);
+        auto it = listing.subtree_fingerprints.find(subtree);
+        if (it == listing.subtree_fingerprints.end()) {
+            it = listing.subtree_fingerprints.emplace(std::string(subtree), 0).first;
+        }
+        it->second += hash;
+    };
+
+    for (auto& file : dir->GetFiles()) {
+        const auto name = file->GetName();
+        auto path = prefix + name;
+        const u64 modified = dir->GetFileTimeStamp(name).modified;
+        add_to_fingerprint(path, Common::CityHash64WithSeeds(path.data(), path.size(),
+                                                             file->GetSize(), modified));
+        listing.files.emplace(std::move(path), std::move(file));
+    }
+    for (const auto& subdir : dir->GetSubdirectories()) {
+        auto path = prefix + subdir->GetName();
+        add_to_fingerprint(path, Common::CityHash64(path.data(), path.size()));
+        ScanDirectory(listing, subdir, path + '/');
+        listing.directories.emplace(std::move(path));
+    }
+}
+
+LayerListing ScanLayer(const VirtualDir& dir, bool is_ext) {
+    LayerListing listing;
+    listing.path = dir->GetFullPath();
+    listing.is_ext = is_ext;
+    ScanDirectory(listing, dir, {});
+    return listing;
+}
+
+// Combines the fingerprints of each top level entry across the layers, in order of priority.
+std::map<std::string, u64, std::less<>> CombineFingerprints(
+    std::span<const LayerListing> listings) {
+    std::map<std::string, u64, std::less<>> combined;
+    for (const auto& listing : listings) {
+        const u64 layer_hash =
+            Common::CityHash64WithSeed(listing.path.data(), listing.path.size(), listing.is_ext);
+        for (const auto& [subtree, fingerprint] : listing.subtree_fingerprints) {
+            u64& hash = combined[subtree];
+            hash = Common::CityHash64WithSeeds(reinterpret_cast<const char*>(&fingerprint),
+                                               sizeof(fingerprint), hash, layer_hash);
+        }
+    }
+    return combined;
+}
+
+// Maps the layers of a cached build to the current layers.
+std::vector<u32> MapLayers(const CacheRecord& record, std::span<const LayerListing> listings) {
+    std::vector<u32> layer_map(record.layers.size(), NoLayer);
+    for (size_t i = 0; i < record.layers.size(); ++i) {
+        const auto it = std::ranges::find_if(listings, [&](const LayerListing& listing) {
+            return listing.path == record.layers[i].first &&
+                   listing.is_ext == record.layers[i].second;
+        });
+        if (it != listings.end()) {
+            layer_map[i] = static_cast<u32>(it - listings.begin());
+        }
+    }
+    return layer_map;
+}
+
+// Opens the data of a cached file, and points its layers at the current ones.
+VirtualFile RestoreSource(SourceEntry& entry, std::span<const u32> layer_map,
+                          const VirtualFile& base_romfs, std::span<const LayerListing> listings) {
+    const auto find_in_layer = [&](u32& layer, std::string_view path) -> VirtualFile {
+        if (layer >= layer_map.size() || layer_map[layer] == NoLayer) {
+            return nullptr;
+        }
+        layer = layer_map[layer];
+        const auto& files = listings[layer].files;
+        const auto it = files.find(path);
+        return it != files.end() ? it->second : nullptr;
+    };
+
+    VirtualFile source;
+    if (entry.layer == NoLayer) {
+        if (base_romfs == nullptr) {
+            return nullptr;
+        }
+        source = std::make_shared<OffsetVfsFile>(base_romfs, entry.base_size, entry.base_offset,
+                                                 entry.path.substr(entry.path.rfind('/') + 1));
+    } else {
+        source = find_in_layer(entry.layer, entry.path);
+    }
+    if (source != nullptr && entry.ips_layer != NoLayer) {
+        const auto ips = find_in_layer(entry.ips_layer, entry.path + ".ips");
+        if (ips == nullptr) {
+            return nullptr;
+        }
+        if (auto patched = PatchIPS(source, ips)) {
+            source = std::move(patched);
+        }
+    }
+    if (source == nullptr || source->GetSize() != entry.size) {
+        return nullptr;
+    }
+    return source;
+}
+
+VirtualFile RestoreRomFS(CacheRecord& record, const VirtualFile& base_romfs,
+                         std::span<const LayerListing> listings) {
+    const auto layer_map = MapLayers(record, listings);
+    std::vector<std::pair<u64, VirtualFile>> out;
+    out.reserve(record.files.size() + 2);
+    out.emplace_back(0, std::make_shared<VectorVfsFile>(std::move(record.header)));
+    for (auto& entry : record.files) {
+        auto source = RestoreSource(entry, layer_map, base_romfs, listings);
+        if (source == nullptr) {
+            return nullptr;
+        }
+        out.emplace_back(entry.offset, std::move(source));
+    }
+    out.emplace_back(record.metadata_offset,
+                     std::make_shared<VectorVfsFile>(std::move(record.metadata)));
+
+    std::sort(out.begin(), out.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    return ConcatenatedVfsFile::MakeConcatenatedFile(0, {}, std::move(out));
+}
+
+// Carries the files and directories of the unchanged top level entries over from a cached build.
+bool RestoreUnchanged(const CacheRecord& record, const std::set<std::string, std::less<>>& changed,
+                      const VirtualFile& base_romfs, std::span<const LayerListing> listings,
+                      std::vector<std::string>& directories, std::vector<BuildFile>& files) {
+    const auto layer_map = MapLayers(record, listings);
+    for (const auto& path : record.directories) {
+        if (!changed.contains(GetSubtree(path, false))) {
+            directories.push_back(path);
+        }
+    }
+    for (const auto& cached_entry : record.files) {
+        if (changed.contains(GetSubtree(cached_entry.path, false))) {
+            continue;
+        }
+        SourceEntry entry = cached_entry;
+        auto source = RestoreSource(entry, layer_map, base_romfs, listings);
+        if (source == nullptr) {
+            return false;
+        }
+        files.push_back({std::move(entry), std::move(source)});
+    }
+    return true;
+}
+
+// Merges the layers over the base RomFS for the top level entries that are rebuilt, and applies
+// the stubs and IPS patches of the ext layers to them.
+void MergeLayers(const LayerListing& base_listing, std::span<const LayerListing> listings,
+                 const std::function<bool(std::string_view)>& is_rebuilt,
+                 std::vector<std::string>& directories, std::vector<BuildFile>& files) {
+    std::map<std::string, BuildFile, std::less<>> merged_files;
+    std::set<std::string, std::less<>> merged_dirs;
+    std::map<std::string_view, std::pair<VirtualFile, u32>> ext_files;
+
+    const auto merge = [&](const LayerListing& listing, u32 layer) {
+        for (const auto& path : listing.directories) {
+            if (is_rebuilt(GetSubtree(path, false))) {
+                merged_dirs.insert(path);
+            }
+        }
+        for (const auto& [path, file] : listing.files) {
+            if (!is_rebuilt(GetSubtree(path, false)) || merged_files.contains(path)) {
+                continue;
+            }
+            SourceEntry entry{.path = path, .layer = layer, .ips_layer = NoLayer};
+            if (layer == NoLayer) {
+                // Files extracted from a RomFS are always views into it.
+                entry.base_offset = std::static_pointer_cast<OffsetVfsFile>(file)->GetOffset();
+                entry.base_size = file->GetSize();
+            }
+            merged_files.emplace(path, BuildFile{std::move(entry), file});
+        }
+    };
+    for (u32 layer = 0; layer < listings.size(); ++layer) {
+        if (listings[layer].is_ext) {
+            for (const auto& [path, file] : listings[layer].files) {
+                ext_files.try_emplace(path, file, layer);
+            }
+        } else {
+            merge(listings[layer], layer);
+        }
+    }
+    merge(base_listing, NoLayer);
+
+    const auto is_stubbed = [&ext_files](std::string_view path) {
+        for (size_t slash = path.find('/');; slash = path.find('/', slash + 1)) {
+            const auto stub = std::string(path.substr(0, slash)) + ".stub";
+            if (ext_files.contains(stub)) {
+                return true;
+            }
+            if (slash == std::string_view::npos) {
+                return false;
+            }
+        }
+    };
+    for (const auto& path : merged_dirs) {
+        if (!is_stubbed(path)) {
+            directories.push_back(path);
+        }
+    }
+    for (auto& [path, file] : merged_files) {
+        if (is_stubbed(path)) {
+            continue;
+        }
+        if (const auto it = ext_files.find(path + ".ips"); it != ext_files.end()) {
+            if (auto patched = PatchIPS(file.source, it->second.first)) {
+                file.source = std::move(patched);
+                file.entry.ips_layer = it->second.second;
+            }
+        }
+        files.push_back(std::move(file));
+    }
+}
+
+} // Anonymous namespace
+
+VirtualFile CreateLayeredRomFS(VirtualFile base_romfs, std::vector<VirtualDir> layers,
+                               std::vector<VirtualDir> ext_layers,
+                               const std::filesystem::path& cache_path) {
+    const auto scan_start = Clock::now();
+    std::vector<LayerListing> listings;
+    listings.reserve(layers.size() + ext_layers.size());
+    size_t num_files = 0;
+    for (const auto& [dirs, is_ext] : {std::pair{&layers, false}, std::pair{&ext_layers, true}}) {
+        for (const auto& dir : *dirs) {
+            num_files += listings.emplace_back(ScanLayer(dir, is_ext)).files.size();
+        }
+    }
+    const auto base_fingerprint = FingerprintBaseRomFS(base_romfs);
+    if (!base_fingerprint) {
+        return nullptr;
+    }
+    auto subtree_fingerprints = CombineFingerprints(listings);
+    LOG_INFO(Loader, "    RomFS: Scanned {} files in {} LayeredFS layers in {} ms", num_files,
+             listings.size(),
+             std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - scan_start)
+                 .count());
+
+    std::optional<CacheRecord> cached;
+    if (!cache_path.empty()) {
+        cached = LoadRecord(cache_path);
+    }
+    if (cached && cached->base_fingerprint != *base_fingerprint) {
+        cached.reset();
+    }
+
+    std::set<std::string, std::less<>> changed;
+    if (cached) {
+        const auto collect_changed = [&changed](const auto& from, const auto& to) {
+            for (const auto& [subtree, fingerprint] : from) {
+                const auto it = to.find(subtree);
+                if (it == to.end() || it->second != fingerprint) {
+                    changed.insert(subtree);
+                }
+            }
+        };
+        collect_changed(subtree_fingerprints, cached->subtree_fingerprints);
+        collect_changed(cached->subtree_fingerprints, subtree_fingerprints);
+
+        if (changed.empty()) {
+            const auto reuse_start = Clock::now();
+            if (auto romfs = RestoreRomFS(*cached, base_romfs, listings)) {
+                LOG_INFO(Loader, "    RomFS: Reused cached LayeredFS build in {} ms",
+                         std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() -
+                                                                               reuse_start)
+                             .count());
+                return romfs;
+            }
+            cached.reset();
+        }
+    }
+
+    const auto build_start = Clock::now();
+    std::vector<std::string> directories;
+    std::vector<BuildFile> files;
+    if (cached &&
+        !RestoreUnchanged(*cached, changed, base_romfs, listings, directories, files)) {
+        cached.reset();
+        directories.clear();
+        files.clear();
+    }
+
+    const auto extracted = ExtractRomFS(base_romfs);
+    if (extracted == nullptr) {
+        return nullptr;
+    }
+    LayerListing base_listing;
+    ScanDirectory(base_listing, extracted, {});
+    MergeLayers(base_listing, listings,
+                [&](std::string_view subtree) { return !cached || changed.contains(subtree); },
+                directories, files);
+
+    std::vector<std::pair<std::string, VirtualFile>> file_sources;
+    std::unordered_map<const VfsFile*, size_t> file_indices;
+    file_sources.reserve(files.size());
+    for (size_t i = 0; i < files.size(); ++i) {
+        file_sources.emplace_back(files[i].entry.path, files[i].source);
+        file_indices.emplace(files[i].source.get(), i);
+    }
+    RomFSBuildContext ctx{directories, std::move(file_sources)};
+    auto out = ctx.Build();
+
+    CacheRecord record;
+    record.base_fingerprint = *base_fingerprint;
+    record.subtree_fingerprints = std::move(subtree_fingerprints);
+    record.directories = std::move(directories);
+    for (const auto& listing : listings) {
+        record.layers.emplace_back(listing.path, listing.is_ext);
+    }
+    for (const auto& [offset, file] : out) {
+        if (const auto it = file_indices.find(file.get()); it != file_indices.end()) {
+            SourceEntry& entry = files[it->second].entry;
+            entry.offset = offset;
+            entry.size = file->GetSize();
+        } else if (offset == 0) {
+            record.header = file->ReadAllBytes();
+        } else {
+            record.metadata_offset = offset;
+            record.metadata = file->ReadAllBytes();
+        }
+    }
+    record.files.reserve(files.size());
+    for (auto& file : files) {
+        record.files.push_back(std::move(file.entry));
+    }
+
+    if (cached) {
+        LOG_INFO(Loader, "    RomFS: Rebuilt {} changed top level LayeredFS entries in {} ms",
+                 changed.size(),
+                 std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - build_start)
+                     .count());
+    } else {
+        LOG_INFO(Loader, "    RomFS: Built LayeredFS RomFS with {} files in {} ms",
+                 record.files.size(),
+                 std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - build_start)
+                     .count());
+    }
+    if (!cache_path.empty()) {
+        StoreRecord(cache_path, record);
+    }
+    return ConcatenatedVfsFile::MakeConcatenatedFile(0, {}, std::move(out));
+}
+
+} // namespace FileSys
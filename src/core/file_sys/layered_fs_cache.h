@@ -0,0 +1,30 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <filesystem>
+#include <vector>
+#include "core/file_sys/vfs/vfs_types.h"
+
+namespace FileSys {
+
+/**
+ * Creates the RomFS of a title with LayeredFS mods applied on top of it.
+ *
+ * The metadata of the built RomFS and the origin of each of its files are kept in a cache file,
+ * along with fingerprints of the paths, sizes and modification times below every top level entry
+ * of the layers. On the next build the cached RomFS is reused as is when nothing changed,
+ * otherwise only the top level entries that changed are merged from the layers again.
+ *
+ * @param base_romfs The RomFS being patched.
+ * @param layers Directories layered over the RomFS, in decreasing priority.
+ * @param ext_layers romfs_ext directories with .stub and .ips files, in decreasing priority.
+ * @param cache_path Path of the cache file, or empty to always build from scratch.
+ * @return The patched RomFS, or nullptr on failure.
+ */
+VirtualFile CreateLayeredRomFS(VirtualFile base_romfs, std::vector<VirtualDir> layers,
+                               std::vector<VirtualDir> ext_layers,
+                               const std::filesystem::path& cache_path);
+
+} // namespace FileSys
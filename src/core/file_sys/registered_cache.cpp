@@ -454,6 +454,7 @@ void RegisteredCache::AccumulateCitronMeta() {
 }
 
 void RegisteredCache::Refresh() {
+    std::scoped_lock lock{install_mutex};
     if (dir == nullptr) {
         return;
     }
@@ -700,6 +701,7 @@ InstallResult RegisteredCache::InstallEntry(const NCA& nca, const CNMTHeader& ba
 }
 
 bool RegisteredCache::RemoveExistingEntry(u64 title_id) const {
+    std::scoped_lock lock{install_mutex};
     bool removed_data = false;
 
     const auto delete_nca = [this](const NcaID& id) {
@@ -782,19 +784,23 @@ InstallResult RegisteredCache::RawInstallNCA(const NCA& nca, const VfsCopyFuncti
 
     std::string path = GetRelativePathFromNcaID(id, false, true, false);
 
-    if (GetFileAtID(id) != nullptr && !overwrite_if_exists) {
-        LOG_WARNING(Loader, "Attempting to overwrite existing NCA. Skipping...");
-        return InstallResult::ErrorAlreadyExists;
-    }
+    VirtualFile out;
+    {
+        std::scoped_lock lock{install_mutex};
+        if (GetFileAtID(id) != nullptr && !overwrite_if_exists) {
+            LOG_WARNING(Loader, "Attempting to overwrite existing NCA. Skipping...");
+            return InstallResult::ErrorAlreadyExists;
+        }
 
-    if (GetFileAtID(id) != nullptr) {
-        LOG_WARNING(Loader, "Overwriting existing NCA...");
-        VirtualDir c_dir;
-        { c_dir = dir->GetFileRelative(path)->GetContainingDirectory(); }
-        c_dir->DeleteFile(Common::FS::GetFilename(path));
-    }
+        if (GetFileAtID(id) != nullptr) {
+            LOG_WARNING(Loader, "Overwriting existing NCA...");
+            VirtualDir c_dir;
+            { c_dir = dir->GetFileRelative(path)->GetContainingDirectory(); }
+            c_dir->DeleteFile(Common::FS::GetFilename(path));
+        }
 
-    auto out = dir->CreateFileRelative(path);
+        out = dir->CreateFileRelative(path);
+    }
     if (out == nullptr) {
         return InstallResult::ErrorCopyFailed;
     }
@@ -803,6 +809,7 @@ InstallResult RegisteredCache::RawInstallNCA(const NCA& nca, const VfsCopyFuncti
 }
 
 bool RegisteredCache::RawInstallCitronMeta(const CNMT& cnmt) {
+    std::scoped_lock lock{install_mutex};
     // Reasoning behind this method can be found in the comment for InstallEntry, NCA overload.
     const auto meta_dir = dir->CreateDirectoryRelative("citron_meta");
     const auto filename = GetCNMTName(cnmt.GetType(), cnmt.GetTitleID());
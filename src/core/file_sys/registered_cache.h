@@ -7,6 +7,7 @@
 #include <array>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <boost/container/flat_map.hpp>
@@ -196,6 +197,9 @@ private:
     VirtualDir dir;
     ContentProviderParsingFunction parser;
 
+    // Serializes changes to the cache between concurrent installs, the copies run outside of it
+    mutable std::recursive_mutex install_mutex;
+
     // maps tid -> NcaID of meta
     std::map<u64, NcaID> meta_id;
     // maps tid -> meta
@@ -183,6 +183,10 @@ std::vector<u8> VfsFile::ReadAllBytes() const {
     return ReadBytes(GetSize());
 }
 
+std::span<const u8> VfsFile::ViewBytes(std::size_t length, std::size_t offset) const {
+    return {};
+}
+
 bool VfsFile::WriteByte(u8 data, std::size_t offset) {
     return Write(&data, 1, offset) == 1;
 }
@@ -7,6 +7,7 @@
 #include <map>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <type_traits>
 #include <vector>
@@ -118,6 +119,11 @@ public:
     // 0)'
     virtual std::vector<u8> ReadAllBytes() const;
 
+    // Returns a view of up to length bytes starting at offset into the file without copying them,
+    // if the file is backed by memory. Returns an empty span otherwise, in which case Read has to
+    // be used instead. The view remains valid until the file is modified or destroyed.
+    virtual std::span<const u8> ViewBytes(std::size_t length, std::size_t offset = 0) const;
+
     // Reads an array of type T, size number_elements starting at offset.
     // Returns the number of bytes (sizeof(T)*number_elements) read successfully.
     template <typename T>
@@ -145,8 +145,12 @@ std::size_t ConcatenatedVfsFile::Read(u8* data, std::size_t length, std::size_t
     }
 
     // Binary search to find the iterator to the first position we can check.
-    // It must exist, since we are not empty and are comparing unsigned integers.
-    auto it = std::prev(std::upper_bound(concatenation_map.begin(), concatenation_map.end(), key));
+    // Read nothing if the offset precedes the first mapped file.
+    auto it = std::upper_bound(concatenation_map.begin(), concatenation_map.end(), key);
+    if (it == concatenation_map.begin()) {
+        return 0;
+    }
+    it = std::prev(it);
     u64 cur_length = length;
     u64 cur_offset = offset;
 
@@ -181,6 +185,31 @@ std::size_t ConcatenatedVfsFile::Read(u8* data, std::size_t length, std::size_t
     return cur_offset - offset;
 }
 
+std::span<const u8> ConcatenatedVfsFile::ViewBytes(std::size_t length, std::size_t offset) const {
+    const ConcatenationEntry key{
+        .offset = offset,
+        .file = nullptr,
+    };
+
+    if (concatenation_map.empty()) {
+        return {};
+    }
+
+    // Only ranges that lie within a single file can be viewed.
+    auto it = std::upper_bound(concatenation_map.begin(), concatenation_map.end(), key);
+    if (it == concatenation_map.begin()) {
+        return {};
+    }
+    it = std::prev(it);
+    const u64 file_seek = offset - it->offset;
+    const u64 file_size = it->file->GetSize();
+    if (file_seek > file_size ||
+        (length > file_size - file_seek && std::next(it) != concatenation_map.end())) {
+        return {};
+    }
+    return it->file->ViewBytes(length, file_seek);
+}
+
 std::size_t ConcatenatedVfsFile::Write(const u8* data, std::size_t length, std::size_t offset) {
     return 0;
 }
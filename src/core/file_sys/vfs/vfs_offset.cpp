@@ -52,6 +52,13 @@ std::size_t OffsetVfsFile::Read(u8* data, std::size_t length, std::size_t r_offs
     return file->Read(data, TrimToFit(length, r_offset), offset + r_offset);
 }
 
+std::span<const u8> OffsetVfsFile::ViewBytes(std::size_t length, std::size_t r_offset) const {
+    if (r_offset > size) {
+        return {};
+    }
+    return file->ViewBytes(TrimToFit(length, r_offset), offset + r_offset);
+}
+
 std::size_t OffsetVfsFile::Write(const u8* data, std::size_t length, std::size_t r_offset) {
     return file->Write(data, TrimToFit(length, r_offset), offset + r_offset);
 }
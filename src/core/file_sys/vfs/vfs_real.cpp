@@ -3,11 +3,13 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstring>
 #include <iterator>
 #include <utility>
 #include "common/assert.h"
 #include "common/fs/file.h"
 #include "common/fs/fs.h"
+#include "common/fs/mapped_file.h"
 #include "common/fs/path_util.h"
 #include "common/logging/log.h"
 #include "core/file_sys/vfs/vfs.h"
@@ -104,6 +106,23 @@ VirtualFile RealVfsFilesystem::OpenFile(std::string_view path_, OpenMode perms)
     return OpenFileFromEntry(path_, {}, perms);
 }
 
+VirtualFile RealVfsFilesystem::OpenMappedFile(std::string_view path_) {
+    const auto path = FS::SanitizePath(path_, FS::DirectorySeparator::PlatformDefault);
+    auto mapping = std::make_unique<FS::MappedFile>(std::filesystem::path{FS::ToU8String(path)});
+    if (!mapping->IsOpen()) {
+        return OpenFile(path, OpenMode::Read);
+    }
+
+    // Mapped files are not shared through the cache, as they must never be written to.
+    std::scoped_lock lk{list_lock};
+    auto reference = std::make_unique<FileReference>();
+    this->InsertReferenceIntoListLocked(*reference);
+
+    const u64 size = mapping->Span().size();
+    return std::shared_ptr<RealVfsFile>(new RealVfsFile(*this, std::move(reference), path,
+                                                        OpenMode::Read, size, std::move(mapping)));
+}
+
 VirtualFile RealVfsFilesystem::CreateFile(std::string_view path_, OpenMode perms) {
     const auto path = FS::SanitizePath(path_, FS::DirectorySeparator::PlatformDefault);
     {
@@ -268,10 +287,11 @@ void RealVfsFilesystem::RemoveReferenceFromListLocked(FileReference& reference)
 }
 
 RealVfsFile::RealVfsFile(RealVfsFilesystem& base_, std::unique_ptr<FileReference> reference_,
-                         const std::string& path_, OpenMode perms_, std::optional<u64> size_)
+                         const std::string& path_, OpenMode perms_, std::optional<u64> size_,
+                         std::unique_ptr<FS::MappedFile> mapping_)
     : base(base_), reference(std::move(reference_)), path(path_),
       parent_path(FS::GetParentPath(path_)), path_components(FS::SplitPathComponentsCopy(path_)),
-      size(size_), perms(perms_) {}
+      size(size_), perms(perms_), mapping(std::move(mapping_)) {}
 
 RealVfsFile::~RealVfsFile() {
     base.DropReference(std::move(reference));
@@ -290,14 +310,19 @@ std::size_t RealVfsFile::GetSize() const {
     if (size) {
         return *size;
     }
-    auto lk = base.RefreshReference(path, perms, *reference);
-    return reference->file ? reference->file->GetSize() : 0;
+    std::scoped_lock lk{io_lock};
+    const auto file = GetHandle();
+    return file ? file->GetSize() : 0;
 }
 
 bool RealVfsFile::Resize(std::size_t new_size) {
+    if (mapping) {
+        return false;
+    }
     size.reset();
-    auto lk = base.RefreshReference(path, perms, *reference);
-    return reference->file ? reference->file->SetSize(new_size) : false;
+    std::scoped_lock lk{io_lock};
+    const auto file = GetHandle();
+    return file ? file->SetSize(new_size) : false;
 }
 
 VirtualDir RealVfsFile::GetContainingDirectory() const {
@@ -313,20 +338,49 @@ bool RealVfsFile::IsReadable() const {
 }
 
 std::size_t RealVfsFile::Read(u8* data, std::size_t length, std::size_t offset) const {
-    auto lk = base.RefreshReference(path, perms, *reference);
-    if (!reference->file || !reference->file->Seek(static_cast<s64>(offset))) {
+    if (mapping) {
+        const auto view = ViewBytes(length, offset);
+        std::memcpy(data, view.data(), view.size());
+        return view.size();
+    }
+
+    std::scoped_lock lk{io_lock};
+    const auto file = GetHandle();
+    if (!file || !file->Seek(static_cast<s64>(offset))) {
         return 0;
     }
-    return reference->file->ReadSpan(std::span{data, length});
+    return file->ReadSpan(std::span{data, length});
+}
+
+std::span<const u8> RealVfsFile::ViewBytes(std::size_t length, std::size_t offset) const {
+    if (!mapping) {
+        return {};
+    }
+    const auto contents = mapping->Span();
+    if (offset > contents.size()) {
+        return {};
+    }
+    return contents.subspan(offset, std::min(length, contents.size() - offset));
 }
 
 std::size_t RealVfsFile::Write(const u8* data, std::size_t length, std::size_t offset) {
+    if (mapping) {
+        return 0;
+    }
     size.reset();
-    auto lk = base.RefreshReference(path, perms, *reference);
-    if (!reference->file || !reference->file->Seek(static_cast<s64>(offset))) {
+    std::scoped_lock lk{io_lock};
+    const auto file = GetHandle();
+    if (!file || !file->Seek(static_cast<s64>(offset))) {
         return 0;
     }
-    return reference->file->WriteSpan(std::span{data, length});
+    return file->WriteSpan(std::span{data, length});
+}
+
+std::shared_ptr<FS::IOFile> RealVfsFile::GetHandle() const {
+    // An evicted handle is closed once the last transfer using it completes. The caller holds
+    // io_lock past that point, so data written through it is flushed before the file is reopened.
+    auto lk = base.RefreshReference(path, perms, *reference);
+    return reference->file;
 }
 
 bool RealVfsFile::Rename(std::string_view name) {
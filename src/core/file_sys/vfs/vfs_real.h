@@ -13,7 +13,8 @@
 
 namespace Common::FS {
 class IOFile;
-}
+class MappedFile;
+} // namespace Common::FS
 
 namespace FileSys {
 
@@ -45,6 +46,13 @@ public:
     VirtualDir MoveDirectory(std::string_view old_path, std::string_view new_path) override;
     bool DeleteDirectory(std::string_view path) override;
 
+    /**
+     * Opens a file for reading through a memory mapping, which avoids a system call per read and
+     * allows the contents to be viewed without copies. Files that can not be mapped, such as
+     * empty files, are opened like with OpenFile instead.
+     */
+    VirtualFile OpenMappedFile(std::string_view path);
+
 private:
     using ReferenceListType = Common::IntrusiveListBaseTraits<FileReference>::ListType;
     std::map<std::string, std::weak_ptr<VfsFile>, std::less<>> cache;
@@ -85,13 +93,22 @@ public:
     bool IsWritable() const override;
     bool IsReadable() const override;
     std::size_t Read(u8* data, std::size_t length, std::size_t offset) const override;
+    std::span<const u8> ViewBytes(std::size_t length, std::size_t offset) const override;
     std::size_t Write(const u8* data, std::size_t length, std::size_t offset) override;
     bool Rename(std::string_view name) override;
 
 private:
     RealVfsFile(RealVfsFilesystem& base, std::unique_ptr<FileReference> reference,
                 const std::string& path, OpenMode perms = OpenMode::Read,
-                std::optional<u64> size = {});
+                std::optional<u64> size = {},
+                std::unique_ptr<Common::FS::MappedFile> mapping = nullptr);
+
+    /**
+     * Returns the handle of the file, reopening it if it was evicted. The handle stays open while
+     * it is held, so transfers through it are done without holding the filesystem lock and only
+     * serialize with other transfers on this file.
+     */
+    std::shared_ptr<Common::FS::IOFile> GetHandle() const;
 
     RealVfsFilesystem& base;
     std::unique_ptr<FileReference> reference;
@@ -100,6 +117,8 @@ private:
     std::vector<std::string> path_components;
     std::optional<u64> size;
     OpenMode perms;
+    std::unique_ptr<Common::FS::MappedFile> mapping; ///< Set when reading from a mapping
+    mutable std::mutex io_lock; ///< Guards the position of the handle
 };
 
 // An implementation of VfsDirectory that represents a directory on the user's computer.
@@ -42,6 +42,13 @@ std::size_t VectorVfsFile::Read(u8* data_, std::size_t length, std::size_t offse
     return read;
 }
 
+std::span<const u8> VectorVfsFile::ViewBytes(std::size_t length, std::size_t offset) const {
+    if (offset > data.size()) {
+        return {};
+    }
+    return std::span{data}.subspan(offset, std::min(length, data.size() - offset));
+}
+
 std::size_t VectorVfsFile::Write(const u8* data_, std::size_t length, std::size_t offset) {
     if (offset + length > data.size())
         data.resize(offset + length);
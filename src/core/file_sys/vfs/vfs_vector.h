@@ -50,6 +50,13 @@ public:
         return read;
     }
 
+    std::span<const u8> ViewBytes(std::size_t length, std::size_t offset) const override {
+        if (offset > size) {
+            return {};
+        }
+        return std::span{data}.subspan(offset, std::min(length, size - offset));
+    }
+
     std::size_t Write(const u8* data_, std::size_t length, std::size_t offset) override {
         return 0;
     }
@@ -85,6 +92,7 @@ public:
     bool IsWritable() const override;
     bool IsReadable() const override;
     std::size_t Read(u8* data, std::size_t length, std::size_t offset) const override;
+    std::span<const u8> ViewBytes(std::size_t length, std::size_t offset) const override;
     std::size_t Write(const u8* data, std::size_t length, std::size_t offset) override;
     bool Rename(std::string_view name) override;
 
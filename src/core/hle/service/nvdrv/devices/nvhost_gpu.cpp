@@ -199,24 +199,19 @@ NvResult nvhost_gpu::AllocateObjectContext(IoctlAllocObjCtx& params) {
     return NvResult::Success;
 }
 
-static boost::container::small_vector<Tegra::CommandHeader, 512> BuildWaitCommandList(
-    NvFence fence) {
-    return {
-        Tegra::BuildCommandHeader(Tegra::BufferMethods::SyncpointPayload, 1,
-                                  Tegra::SubmissionMode::Increasing),
-        {fence.value},
-        Tegra::BuildCommandHeader(Tegra::BufferMethods::SyncpointOperation, 1,
-                                  Tegra::SubmissionMode::Increasing),
-        BuildFenceAction(Tegra::Engines::Puller::FenceOperation::Acquire, fence.id),
-    };
+static void BuildWaitCommandList(std::vector<Tegra::CommandHeader>& result, NvFence fence) {
+    result.push_back(Tegra::BuildCommandHeader(Tegra::BufferMethods::SyncpointPayload, 1,
+                                               Tegra::SubmissionMode::Increasing));
+    result.push_back({fence.value});
+    result.push_back(Tegra::BuildCommandHeader(Tegra::BufferMethods::SyncpointOperation, 1,
+                                               Tegra::SubmissionMode::Increasing));
+    result.push_back(BuildFenceAction(Tegra::Engines::Puller::FenceOperation::Acquire, fence.id));
 }
 
-static boost::container::small_vector<Tegra::CommandHeader, 512> BuildIncrementCommandList(
-    NvFence fence) {
-    boost::container::small_vector<Tegra::CommandHeader, 512> result{
-        Tegra::BuildCommandHeader(Tegra::BufferMethods::SyncpointPayload, 1,
-                                  Tegra::SubmissionMode::Increasing),
-        {}};
+static void BuildIncrementCommandList(std::vector<Tegra::CommandHeader>& result, NvFence fence) {
+    result.push_back(Tegra::BuildCommandHeader(Tegra::BufferMethods::SyncpointPayload, 1,
+                                               Tegra::SubmissionMode::Increasing));
+    result.push_back({});
 
     for (u32 count = 0; count < 2; ++count) {
         result.push_back(Tegra::BuildCommandHeader(Tegra::BufferMethods::SyncpointOperation, 1,
@@ -224,19 +219,14 @@ static boost::container::small_vector<Tegra::CommandHeader, 512> BuildIncrementC
         result.push_back(
             BuildFenceAction(Tegra::Engines::Puller::FenceOperation::Increment, fence.id));
     }
-
-    return result;
 }
 
-static boost::container::small_vector<Tegra::CommandHeader, 512> BuildIncrementWithWfiCommandList(
-    NvFence fence) {
-    boost::container::small_vector<Tegra::CommandHeader, 512> result{
-        Tegra::BuildCommandHeader(Tegra::BufferMethods::WaitForIdle, 1,
-                                  Tegra::SubmissionMode::Increasing),
-        {}};
-    auto increment_list{BuildIncrementCommandList(fence)};
-    result.insert(result.end(), increment_list.begin(), increment_list.end());
-    return result;
+static void BuildIncrementWithWfiCommandList(std::vector<Tegra::CommandHeader>& result,
+                                             NvFence fence) {
+    result.push_back(Tegra::BuildCommandHeader(Tegra::BufferMethods::WaitForIdle, 1,
+                                               Tegra::SubmissionMode::Increasing));
+    result.push_back({});
+    BuildIncrementCommandList(result, fence);
 }
 
 NvResult nvhost_gpu::SubmitGPFIFOImpl(IoctlSubmitGpfifo& params, Tegra::CommandList&& entries) {
@@ -257,7 +247,9 @@ NvResult nvhost_gpu::SubmitGPFIFOImpl(IoctlSubmitGpfifo& params, Tegra::CommandL
         }
 
         if (!syncpoint_manager.IsFenceSignalled(params.fence)) {
-            gpu.PushGPUEntries(bind_id, Tegra::CommandList{BuildWaitCommandList(params.fence)});
+            Tegra::CommandList wait_list = gpu.CommandLists().Acquire();
+            BuildWaitCommandList(wait_list.Prefetch(), params.fence);
+            gpu.PushGPUEntries(bind_id, std::move(wait_list));
         }
     }
 
@@ -269,13 +261,13 @@ NvResult nvhost_gpu::SubmitGPFIFOImpl(IoctlSubmitGpfifo& params, Tegra::CommandL
     gpu.PushGPUEntries(bind_id, std::move(entries));
 
     if (flags.fence_increment.Value()) {
+        Tegra::CommandList increment_list = gpu.CommandLists().Acquire();
         if (flags.suppress_wfi.Value()) {
-            gpu.PushGPUEntries(bind_id,
-                               Tegra::CommandList{BuildIncrementCommandList(params.fence)});
+            BuildIncrementCommandList(increment_list.Prefetch(), params.fence);
         } else {
-            gpu.PushGPUEntries(bind_id,
-                               Tegra::CommandList{BuildIncrementWithWfiCommandList(params.fence)});
+            BuildIncrementWithWfiCommandList(increment_list.Prefetch(), params.fence);
         }
+        gpu.PushGPUEntries(bind_id, std::move(increment_list));
     }
 
     flags.raw = 0;
@@ -290,14 +282,18 @@ NvResult nvhost_gpu::SubmitGPFIFOBase1(IoctlSubmitGpfifo& params,
         return NvResult::InvalidSize;
     }
 
-    Tegra::CommandList entries(params.num_entries);
+    // The headers are written once here, later stages only move the list around
+    auto& pool = system.GPU().CommandLists();
+    Tegra::CommandList entries = pool.Acquire();
+    std::vector<Tegra::CommandListHeader>& headers = entries.Headers();
+    headers.resize(params.num_entries);
+    const size_t size = params.num_entries * sizeof(Tegra::CommandListHeader);
     if (kickoff) {
-        system.ApplicationMemory().ReadBlock(params.address, entries.command_lists.data(),
-                                             params.num_entries * sizeof(Tegra::CommandListHeader));
+        system.ApplicationMemory().ReadBlock(params.address, headers.data(), size);
     } else {
-        std::memcpy(entries.command_lists.data(), commands.data(),
-                    params.num_entries * sizeof(Tegra::CommandListHeader));
+        std::memcpy(headers.data(), commands.data(), size);
     }
+    pool.CountCopy(size);
 
     return SubmitGPFIFOImpl(params, std::move(entries));
 }
@@ -309,9 +305,13 @@ NvResult nvhost_gpu::SubmitGPFIFOBase2(IoctlSubmitGpfifo& params,
         return NvResult::InvalidSize;
     }
 
-    Tegra::CommandList entries(params.num_entries);
-    std::memcpy(entries.command_lists.data(), commands.data(),
-                params.num_entries * sizeof(Tegra::CommandListHeader));
+    auto& pool = system.GPU().CommandLists();
+    Tegra::CommandList entries = pool.Acquire();
+    std::vector<Tegra::CommandListHeader>& headers = entries.Headers();
+    headers.resize(params.num_entries);
+    const size_t size = params.num_entries * sizeof(Tegra::CommandListHeader);
+    std::memcpy(headers.data(), commands.data(), size);
+    pool.CountCopy(size);
     return SubmitGPFIFOImpl(params, std::move(entries));
 }
 
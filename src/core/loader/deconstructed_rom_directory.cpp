@@ -1,9 +1,15 @@
 // SPDX-FileCopyrightText: Copyright 2018 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <chrono>
 #include <cstring>
+#include <future>
+#include <thread>
+
 #include "common/logging/log.h"
 #include "common/settings.h"
+#include "common/thread_worker.h"
 #include "core/core.h"
 #include "core/file_sys/content_archive.h"
 #include "core/file_sys/control_metadata.h"
@@ -185,6 +191,51 @@ AppLoader_DeconstructedRomDirectory::LoadResult AppLoader_DeconstructedRomDirect
                                        "subsdk3", "subsdk4", "subsdk5", "subsdk6", "subsdk7",
                                        "subsdk8", "subsdk9", "sdk"};
 
+    // Read and decompress all modules concurrently, then apply patches to each of them on this
+    // thread in load order, as soon as its data is available.
+    const FileSys::PatchManager pm{metadata.GetTitleID(), system.GetFileSystemController(),
+                                   system.GetContentProvider()};
+    std::array<std::optional<AppLoader_NSO::NSOModule>, static_modules.size()> module_images;
+    {
+        std::array<std::promise<std::optional<AppLoader_NSO::NSOModule>>, static_modules.size()>
+            promises;
+        std::array<std::future<std::optional<AppLoader_NSO::NSOModule>>, static_modules.size()>
+            futures;
+        std::array<FileSys::VirtualFile, static_modules.size()> module_files;
+        for (size_t i = 0; i < static_modules.size(); i++) {
+            module_files[i] = dir->GetFile(static_modules[i]);
+            futures[i] = promises[i].get_future();
+        }
+
+        const auto num_files =
+            std::count_if(module_files.begin(), module_files.end(),
+                          [](const auto& module_file) { return module_file != nullptr; });
+        const size_t num_workers = std::min<size_t>(std::thread::hardware_concurrency(),
+                                                    static_cast<size_t>(num_files));
+        Common::ThreadWorker worker(std::max<size_t>(num_workers, 1), "NSOLoader");
+        for (size_t i = 0; i < static_modules.size(); i++) {
+            if (!module_files[i]) {
+                continue;
+            }
+            worker.QueueWork([&, i] {
+                const bool should_pass_arguments = std::strcmp(static_modules[i], "rtld") == 0;
+                promises[i].set_value(
+                    AppLoader_NSO::ReadModule(*module_files[i], should_pass_arguments));
+            });
+        }
+
+        for (size_t i = 0; i < static_modules.size(); i++) {
+            if (!module_files[i]) {
+                continue;
+            }
+            module_images[i] = futures[i].get();
+            if (!module_images[i]) {
+                return {ResultStatus::ErrorLoadingNSO, {}};
+            }
+            AppLoader_NSO::PatchModule(*module_images[i], pm);
+        }
+    }
+
     std::size_t code_size{};
 
     // Define an nce patch context for each potential module.
@@ -192,16 +243,13 @@ AppLoader_DeconstructedRomDirectory::LoadResult AppLoader_DeconstructedRomDirect
 
     // Use the NSO module loader to figure out the code layout
     for (size_t i = 0; i < static_modules.size(); i++) {
-        const auto& module = static_modules[i];
-        const FileSys::VirtualFile module_file{dir->GetFile(module)};
-        if (!module_file) {
+        if (!module_images[i]) {
             continue;
         }
 
-        const bool should_pass_arguments = std::strcmp(module, "rtld") == 0;
         const auto tentative_next_load_addr = AppLoader_NSO::LoadModule(
-            process, system, *module_file, code_size, should_pass_arguments, false, {},
-            patch_ctx.GetPatchers(), patch_ctx.GetLastIndex());
+            process, system, *module_images[i], code_size, false, {}, patch_ctx.GetPatchers(),
+            patch_ctx.GetLastIndex());
         if (!tentative_next_load_addr) {
             return {ResultStatus::ErrorLoadingNSO, {}};
         }
@@ -232,27 +280,33 @@ AppLoader_DeconstructedRomDirectory::LoadResult AppLoader_DeconstructedRomDirect
     modules.clear();
     const VAddr base_address{GetInteger(process.GetEntryPoint())};
     VAddr next_load_addr{base_address};
-    const FileSys::PatchManager pm{metadata.GetTitleID(), system.GetFileSystemController(),
-                                   system.GetContentProvider()};
     for (size_t i = 0; i < static_modules.size(); i++) {
         const auto& module = static_modules[i];
-        const FileSys::VirtualFile module_file{dir->GetFile(module)};
-        if (!module_file) {
+        if (!module_images[i]) {
             continue;
         }
 
+        const auto start_time = std::chrono::steady_clock::now();
         const VAddr load_addr{next_load_addr};
-        const bool should_pass_arguments = std::strcmp(module, "rtld") == 0;
-        const auto tentative_next_load_addr = AppLoader_NSO::LoadModule(
-            process, system, *module_file, load_addr, should_pass_arguments, true, pm,
-            patch_ctx.GetPatchers(), patch_ctx.GetIndex(i));
+        const auto tentative_next_load_addr =
+            AppLoader_NSO::LoadModule(process, system, *module_images[i], load_addr, true, pm,
+                                      patch_ctx.GetPatchers(), patch_ctx.GetIndex(i));
         if (!tentative_next_load_addr) {
             return {ResultStatus::ErrorLoadingNSO, {}};
         }
 
+        const auto to_ms = [](auto duration) {
+            return std::chrono::duration<double, std::milli>(duration).count();
+        };
+        LOG_INFO(Loader,
+                 "Loaded {} @ {:#X} ({} KiB): read {:.2f} ms, patch {:.2f} ms, load {:.2f} ms",
+                 module, load_addr, (*tentative_next_load_addr - load_addr) / 1024,
+                 to_ms(module_images[i]->read_time), to_ms(module_images[i]->patch_time),
+                 to_ms(std::chrono::steady_clock::now() - start_time));
+
         next_load_addr = *tentative_next_load_addr;
         modules.insert_or_assign(load_addr, module);
-        LOG_DEBUG(Loader, "loaded module {} @ {:#X}", module, load_addr);
+        module_images[i].reset();
     }
 
     is_loaded = true;
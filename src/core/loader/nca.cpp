@@ -1,11 +1,12 @@
 // SPDX-FileCopyrightText: Copyright 2018 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <cstring>
 #include <utility>
 
 #include "common/hex_util.h"
-#include "common/scope_exit.h"
 #include "core/core.h"
+#include "core/crypto/sha256.h"
 #include "core/file_sys/content_archive.h"
 #include "core/file_sys/nca_metadata.h"
 #include "core/file_sys/registered_cache.h"
@@ -14,7 +15,6 @@
 #include "core/hle/service/filesystem/filesystem.h"
 #include "core/loader/deconstructed_rom_directory.h"
 #include "core/loader/nca.h"
-#include "mbedtls/sha256.h"
 
 namespace Loader {
 
@@ -84,77 +84,58 @@ AppLoader_NCA::LoadResult AppLoader_NCA::Load(Kernel::KProcess& process, Core::S
 }
 
 ResultStatus AppLoader_NCA::VerifyIntegrity(std::function<bool(size_t, size_t)> progress_callback) {
-    using namespace Common::Literals;
+    return VerifyIntegrity(std::span{&file, 1}, std::move(progress_callback));
+}
 
+ResultStatus AppLoader_NCA::VerifyIntegrity(std::span<const FileSys::VirtualFile> nca_files,
+                                            std::function<bool(size_t, size_t)> progress_callback) {
     constexpr size_t NcaFileNameWithHashLength = 36;
     constexpr size_t NcaFileNameHashLength = 32;
-    constexpr size_t NcaSha256HashLength = 32;
-    constexpr size_t NcaSha256HalfHashLength = NcaSha256HashLength / 2;
-
-    // Get the file name.
-    const auto name = file->GetName();
-
-    // We won't try to verify meta NCAs.
-    if (name.ends_with(".cnmt.nca")) {
-        return ResultStatus::Success;
-    }
-
-    // Check if we can verify this file. NCAs should be named after their hashes.
-    if (!name.ends_with(".nca") || name.size() != NcaFileNameWithHashLength) {
-        LOG_WARNING(Loader, "Unable to validate NCA with name {}", name);
-        return ResultStatus::ErrorIntegrityVerificationNotImplemented;
-    }
-
-    // Get the expected truncated hash of the NCA.
-    const auto input_hash =
-        Common::HexStringToVector(file->GetName().substr(0, NcaFileNameHashLength), false);
-
-    // Declare buffer to read into.
-    std::vector<u8> buffer(4_MiB);
-
-    // Initialize sha256 verification context.
-    mbedtls_sha256_context ctx;
-    mbedtls_sha256_init(&ctx);
-    mbedtls_sha256_starts_ret(&ctx, 0);
-
-    // Ensure we maintain a clean state on exit.
-    SCOPE_EXIT {
-        mbedtls_sha256_free(&ctx);
-    };
+    constexpr size_t NcaSha256HalfHashLength = sizeof(Core::Crypto::SHA256Hash) / 2;
 
-    // Declare counters.
-    const size_t total_size = file->GetSize();
-    size_t processed_size = 0;
+    std::vector<FileSys::VirtualFile> files;
+    std::vector<std::vector<u8>> input_hashes;
+    files.reserve(nca_files.size());
+    input_hashes.reserve(nca_files.size());
 
-    // Begin iterating the file.
-    while (processed_size < total_size) {
-        // Refill the buffer.
-        const size_t intended_read_size = std::min(buffer.size(), total_size - processed_size);
-        const size_t read_size = file->Read(buffer.data(), intended_read_size, processed_size);
+    for (const auto& nca_file : nca_files) {
+        // Get the file name.
+        const auto name = nca_file->GetName();
 
-        // Update the hash function with the buffer contents.
-        mbedtls_sha256_update_ret(&ctx, buffer.data(), read_size);
-
-        // Update counters.
-        processed_size += read_size;
+        // We won't try to verify meta NCAs.
+        if (name.ends_with(".cnmt.nca")) {
+            continue;
+        }
 
-        // Call the progress function.
-        if (!progress_callback(processed_size, total_size)) {
-            return ResultStatus::ErrorIntegrityVerificationFailed;
+        // Check if we can verify this file. NCAs should be named after their hashes.
+        if (!name.ends_with(".nca") || name.size() != NcaFileNameWithHashLength) {
+            LOG_WARNING(Loader, "Unable to validate NCA with name {}", name);
+            return ResultStatus::ErrorIntegrityVerificationNotImplemented;
         }
+
+        // Get the expected truncated hash of the NCA.
+        files.push_back(nca_file);
+        input_hashes.push_back(
+            Common::HexStringToVector(name.substr(0, NcaFileNameHashLength), false));
     }
 
-    // Finalize context and compute the output hash.
-    std::array<u8, NcaSha256HashLength> output_hash;
-    mbedtls_sha256_finish_ret(&ctx, output_hash.data());
+    // Hash all the files at once, so they are read and hashed in parallel.
+    std::vector<std::optional<Core::Crypto::SHA256Hash>> output_hashes(files.size());
+    if (!Core::Crypto::HashFiles(files, output_hashes, progress_callback)) {
+        return ResultStatus::ErrorIntegrityVerificationFailed;
+    }
 
     // Compare to expected.
-    if (std::memcmp(input_hash.data(), output_hash.data(), NcaSha256HalfHashLength) != 0) {
-        LOG_ERROR(Loader, "NCA hash mismatch detected for file {}", name);
-        return ResultStatus::ErrorIntegrityVerificationFailed;
+    for (size_t i = 0; i < files.size(); ++i) {
+        const auto& output_hash = output_hashes[i];
+        if (!output_hash || std::memcmp(input_hashes[i].data(), output_hash->data(),
+                                        NcaSha256HalfHashLength) != 0) {
+            LOG_ERROR(Loader, "NCA hash mismatch detected for file {}", files[i]->GetName());
+            return ResultStatus::ErrorIntegrityVerificationFailed;
+        }
     }
 
-    // File verified.
+    // Files verified.
     return ResultStatus::Success;
 }
 
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <span>
+
 #include "common/common_types.h"
 #include "core/loader/loader.h"
 
@@ -41,6 +43,13 @@ public:
 
     ResultStatus VerifyIntegrity(std::function<bool(size_t, size_t)> progress_callback) override;
 
+    /**
+     * Verifies several NCA files against the hashes in their names, hashing them concurrently.
+     * Meta NCAs are skipped. The progress callback receives the progress across all the files.
+     */
+    static ResultStatus VerifyIntegrity(std::span<const FileSys::VirtualFile> nca_files,
+                                        std::function<bool(size_t, size_t)> progress_callback);
+
     ResultStatus ReadRomFS(FileSys::VirtualFile& dir) override;
     ResultStatus ReadProgramId(u64& out_program_id) override;
 
@@ -1,8 +1,10 @@
 // SPDX-FileCopyrightText: Copyright 2018 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <chrono>
 #include <cinttypes>
 #include <cstring>
+#include <span>
 #include <vector>
 
 #include "common/common_funcs.h"
@@ -37,17 +39,6 @@ struct MODHeader {
 };
 static_assert(sizeof(MODHeader) == 0x1c, "MODHeader has incorrect size.");
 
-std::vector<u8> DecompressSegment(const std::vector<u8>& compressed_data,
-                                  const NSOSegmentHeader& header) {
-    std::vector<u8> uncompressed_data =
-        Common::Compression::DecompressDataLZ4(compressed_data, header.size);
-
-    ASSERT_MSG(uncompressed_data.size() == header.size, "{} != {}", header.size,
-               uncompressed_data.size());
-
-    return uncompressed_data;
-}
-
 constexpr u32 PageAlignSize(u32 size) {
     return static_cast<u32>((size + Core::Memory::CITRON_PAGEMASK) & ~Core::Memory::CITRON_PAGEMASK);
 }
@@ -73,17 +64,15 @@ FileType AppLoader_NSO::IdentifyType(const FileSys::VirtualFile& in_file) {
     return FileType::NSO;
 }
 
-std::optional<VAddr> AppLoader_NSO::LoadModule(Kernel::KProcess& process, Core::System& system,
-                                               const FileSys::VfsFile& nso_file, VAddr load_base,
-                                               bool should_pass_arguments, bool load_into_process,
-                                               std::optional<FileSys::PatchManager> pm,
-                                               std::vector<Core::NCE::Patcher>* patches,
-                                               s32 patch_index) {
+std::optional<AppLoader_NSO::NSOModule> AppLoader_NSO::ReadModule(
+    const FileSys::VfsFile& nso_file, bool should_pass_arguments) {
+    const auto start_time = std::chrono::steady_clock::now();
     if (nso_file.GetSize() < sizeof(NSOHeader)) {
         return std::nullopt;
     }
 
-    NSOHeader nso_header{};
+    NSOModule module;
+    NSOHeader& nso_header = module.header;
     if (sizeof(NSOHeader) != nso_file.ReadObject(&nso_header)) {
         return std::nullopt;
     }
@@ -91,36 +80,40 @@ std::optional<VAddr> AppLoader_NSO::LoadModule(Kernel::KProcess& process, Core::
     if (nso_header.magic != Common::MakeMagic('N', 'S', 'O', '0')) {
         return std::nullopt;
     }
+    module.name = nso_file.GetName();
 
-    // Allocate some space at the beginning if we are patching in PreText mode.
-    const size_t module_start = [&]() -> size_t {
-#ifdef HAS_NCE
-        if (patches && load_into_process) {
-            auto* patch = &patches->operator[](patch_index);
-            if (patch->GetPatchMode() == Core::NCE::PatchMode::PreText) {
-                return patch->GetSectionSize();
-            }
-        }
-#endif
-        return 0;
-    }();
-
-    // Build program image
-    Kernel::CodeSet codeset;
-    Kernel::PhysicalMemory program_image;
+    // Build program image, decompressing each segment straight into it
+    Kernel::CodeSet& codeset = module.codeset;
+    Kernel::PhysicalMemory& program_image = codeset.memory;
     for (std::size_t i = 0; i < nso_header.segments.size(); ++i) {
-        std::vector<u8> data = nso_file.ReadBytes(nso_header.segments_compressed_size[i],
-                                                  nso_header.segments[i].offset);
+        const auto& segment = nso_header.segments[i];
+        const size_t file_size = nso_header.segments_compressed_size[i];
         if (nso_header.IsSegmentCompressed(i)) {
-            data = DecompressSegment(data, nso_header.segments[i]);
+            // Decompress from the file contents when they are mapped.
+            std::vector<u8> compressed_data;
+            std::span<const u8> compressed = nso_file.ViewBytes(file_size, segment.offset);
+            if (compressed.size() != file_size) {
+                compressed_data = nso_file.ReadBytes(file_size, segment.offset);
+                compressed = compressed_data;
+            }
+            program_image.resize(segment.location + segment.size);
+            const int decompressed_size = Common::Compression::DecompressDataLZ4(
+                program_image.data() + segment.location, segment.size, compressed.data(),
+                compressed.size());
+            if (decompressed_size != static_cast<int>(segment.size)) {
+                LOG_ERROR(Loader, "Segment {} of {} decompressed to {} bytes instead of {}", i,
+                          module.name, decompressed_size, segment.size);
+                return std::nullopt;
+            }
+        } else {
+            program_image.resize(segment.location + file_size);
+            const size_t read_size =
+                nso_file.Read(program_image.data() + segment.location, file_size, segment.offset);
+            program_image.resize(segment.location + read_size);
         }
-        program_image.resize(module_start + nso_header.segments[i].location +
-                             static_cast<u32>(data.size()));
-        std::memcpy(program_image.data() + module_start + nso_header.segments[i].location,
-                    data.data(), data.size());
-        codeset.segments[i].addr = module_start + nso_header.segments[i].location;
-        codeset.segments[i].offset = module_start + nso_header.segments[i].location;
-        codeset.segments[i].size = nso_header.segments[i].size;
+        codeset.segments[i].addr = segment.location;
+        codeset.segments[i].offset = segment.location;
+        codeset.segments[i].size = segment.size;
     }
 
     if (should_pass_arguments && !Settings::values.program_args.GetValue().empty()) {
@@ -138,33 +131,61 @@ std::optional<VAddr> AppLoader_NSO::LoadModule(Kernel::KProcess& process, Core::
     }
 
     codeset.DataSegment().size += nso_header.segments[2].bss_size;
-    u32 image_size{
-        PageAlignSize(static_cast<u32>(program_image.size()) + nso_header.segments[2].bss_size)};
-    program_image.resize(image_size);
+    program_image.resize(
+        PageAlignSize(static_cast<u32>(program_image.size()) + nso_header.segments[2].bss_size));
 
     for (std::size_t i = 0; i < nso_header.segments.size(); ++i) {
         codeset.segments[i].size = PageAlignSize(codeset.segments[i].size);
     }
 
-    // Apply patches if necessary
-    const auto name = nso_file.GetName();
-    if (pm && (pm->HasNSOPatch(nso_header.build_id, name) || Settings::values.dump_nso)) {
-        std::span<u8> patchable_section(program_image.data() + module_start,
-                                        program_image.size() - module_start);
-        std::vector<u8> pi_header(sizeof(NSOHeader) + patchable_section.size());
-        std::memcpy(pi_header.data(), &nso_header, sizeof(NSOHeader));
-        std::memcpy(pi_header.data() + sizeof(NSOHeader), patchable_section.data(),
-                    patchable_section.size());
+    module.read_time = std::chrono::steady_clock::now() - start_time;
+    return module;
+}
+
+void AppLoader_NSO::PatchModule(NSOModule& module, const FileSys::PatchManager& pm) {
+    if (!pm.HasNSOPatch(module.header.build_id, module.name) && !Settings::values.dump_nso) {
+        return;
+    }
+
+    const auto start_time = std::chrono::steady_clock::now();
+    Kernel::PhysicalMemory& program_image = module.codeset.memory;
+    std::vector<u8> pi_header(sizeof(NSOHeader) + program_image.size());
+    std::memcpy(pi_header.data(), &module.header, sizeof(NSOHeader));
+    std::memcpy(pi_header.data() + sizeof(NSOHeader), program_image.data(), program_image.size());
 
-        pi_header = pm->PatchNSO(pi_header, name);
+    pi_header = pm.PatchNSO(pi_header, module.name);
+
+    std::copy(pi_header.begin() + sizeof(NSOHeader), pi_header.end(), program_image.data());
+    module.patch_time = std::chrono::steady_clock::now() - start_time;
+}
 
-        std::copy(pi_header.begin() + sizeof(NSOHeader), pi_header.end(), patchable_section.data());
+std::optional<VAddr> AppLoader_NSO::LoadModule(Kernel::KProcess& process, Core::System& system,
+                                               NSOModule& module, VAddr load_base,
+                                               bool load_into_process,
+                                               std::optional<FileSys::PatchManager> pm,
+                                               std::vector<Core::NCE::Patcher>* patches,
+                                               s32 patch_index) {
+    Kernel::CodeSet& codeset = module.codeset;
+    Kernel::PhysicalMemory& program_image = codeset.memory;
+
+#ifdef HAS_NCE
+    // Allocate some space at the beginning if we are patching in PreText mode.
+    auto* patch = patches ? &patches->operator[](patch_index) : nullptr;
+    if (patch && load_into_process && patch->GetPatchMode() == Core::NCE::PatchMode::PreText) {
+        const size_t module_start = patch->GetSectionSize();
+        program_image.insert(program_image.begin(), module_start, 0);
+        for (std::size_t i = 0; i < module.header.segments.size(); ++i) {
+            codeset.segments[i].addr = module_start + module.header.segments[i].location;
+            codeset.segments[i].offset = module_start + module.header.segments[i].location;
+        }
     }
+#endif
+
+    u32 image_size = static_cast<u32>(program_image.size());
 
 #ifdef HAS_NCE
     // If we are computing the process code layout and using nce backend, patch.
     const auto& code = codeset.CodeSegment();
-    auto* patch = patches ? &patches->operator[](patch_index) : nullptr;
     if (patch && !load_into_process) {
         // Patch SVCs and MRS calls in the guest code
         while (!patch->PatchText(program_image, code)) {
@@ -192,15 +213,14 @@ std::optional<VAddr> AppLoader_NSO::LoadModule(Kernel::KProcess& process, Core::
 
     // Apply cheats if they exist and the program has a valid title ID
     if (pm) {
-        system.SetApplicationProcessBuildID(nso_header.build_id);
-        const auto cheats = pm->CreateCheatList(nso_header.build_id);
+        system.SetApplicationProcessBuildID(module.header.build_id);
+        const auto cheats = pm->CreateCheatList(module.header.build_id);
         if (!cheats.empty()) {
-            system.RegisterCheatList(cheats, nso_header.build_id, load_base, image_size);
+            system.RegisterCheatList(cheats, module.header.build_id, load_base, image_size);
         }
     }
 
     // Load codeset for current process
-    codeset.memory = std::move(program_image);
     process.LoadModule(std::move(codeset), load_base);
 
     return load_base + image_size;
@@ -215,7 +235,8 @@ AppLoader_NSO::LoadResult AppLoader_NSO::Load(Kernel::KProcess& process, Core::S
 
     // Load module
     const VAddr base_address = GetInteger(process.GetEntryPoint());
-    if (!LoadModule(process, system, *file, base_address, true, true)) {
+    auto module = ReadModule(*file, true);
+    if (!module || !LoadModule(process, system, *module, base_address, true)) {
         return {ResultStatus::ErrorLoadingNSO, {}};
     }
 
@@ -4,11 +4,14 @@
 #pragma once
 
 #include <array>
+#include <chrono>
 #include <optional>
+#include <string>
 #include <type_traits>
 #include "common/common_types.h"
 #include "common/swap.h"
 #include "core/file_sys/patch_manager.h"
+#include "core/hle/kernel/code_set.h"
 #include "core/loader/loader.h"
 
 namespace Core {
@@ -89,9 +92,41 @@ public:
         return IdentifyType(file);
     }
 
+    /// An NSO module read into memory, with its segments laid out as they are mapped.
+    struct NSOModule {
+        NSOHeader header{};
+        std::string name;
+        Kernel::CodeSet codeset;
+        std::chrono::nanoseconds read_time{};
+        std::chrono::nanoseconds patch_time{};
+    };
+
+    /**
+     * Reads an NSO file and decompresses its segments into a program image. This only touches
+     * the given file, so several modules may be read concurrently.
+     *
+     * @param nso_file The NSO file to read.
+     * @param should_pass_arguments Whether to append the program arguments to the data segment.
+     *
+     * @return The module, or std::nullopt if the file is not a valid NSO.
+     */
+    static std::optional<NSOModule> ReadModule(const FileSys::VfsFile& nso_file,
+                                               bool should_pass_arguments);
+
+    /// Applies the IPS and text patches of the title to a module, and dumps it if enabled.
+    static void PatchModule(NSOModule& module, const FileSys::PatchManager& pm);
+
+    /**
+     * Places a module read with ReadModule in the process code layout.
+     *
+     * When load_into_process is false the module is left untouched and only the end of its
+     * image is computed, otherwise its memory is moved into the process.
+     *
+     * @return The address following the module image, or std::nullopt on failure.
+     */
     static std::optional<VAddr> LoadModule(Kernel::KProcess& process, Core::System& system,
-                                           const FileSys::VfsFile& nso_file, VAddr load_base,
-                                           bool should_pass_arguments, bool load_into_process,
+                                           NSOModule& module, VAddr load_base,
+                                           bool load_into_process,
                                            std::optional<FileSys::PatchManager> pm = {},
                                            std::vector<Core::NCE::Patcher>* patches = nullptr,
                                            s32 patch_index = -1);
@@ -92,6 +92,22 @@ double PerfStats::GetMeanFrametime() const {
     return sum / static_cast<double>(current_index - IgnoreFrames);
 }
 
+std::vector<double> PerfStats::GetFrametimeHistory(std::size_t first_frame) const {
+    std::scoped_lock lock{object_mutex};
+
+    first_frame = std::max(first_frame, IgnoreFrames);
+    if (current_index <= first_frame) {
+        return {};
+    }
+    return std::vector<double>(perf_history.begin() + first_frame,
+                               perf_history.begin() + current_index);
+}
+
+std::size_t PerfStats::GetFrametimeHistorySize() const {
+    std::scoped_lock lock{object_mutex};
+    return current_index;
+}
+
 PerfStatsResults PerfStats::GetAndResetStats(microseconds current_system_time_us) {
     std::scoped_lock lock{object_mutex};
 
@@ -8,6 +8,7 @@
 #include <chrono>
 #include <cstddef>
 #include <mutex>
+#include <vector>
 #include "common/common_types.h"
 
 namespace Core {
@@ -45,6 +46,19 @@ public:
      */
     double GetMeanFrametime() const;
 
+    /**
+     * Returns the frametime values stored in the performance history from first_frame on, in
+     * milliseconds and in the order the frames were emulated. Like the mean, this skips the frames
+     * emulated during boot.
+     */
+    std::vector<double> GetFrametimeHistory(std::size_t first_frame = 0) const;
+
+    /**
+     * Returns the number of frames stored in the performance history, which is where the history
+     * of the frames emulated from now on starts.
+     */
+    std::size_t GetFrametimeHistorySize() const;
+
     /**
      * Gets the ratio between walltime and the emulated time of the previous system frame. This is
      * useful for scaling inputs or outputs moving between the two time domains.
@@ -8,6 +8,7 @@
 #include <regex>
 #include <string>
 #include <thread>
+#include <vector>
 
 #ifdef _WIN32
 // windows.h needs to be included before shellapi.h
@@ -31,6 +32,7 @@
 #include "network/announce_multiplayer_session.h"
 #include "network/network.h"
 #include "network/room.h"
+#include "network/room_pool.h"
 #include "network/verify_user.h"
 
 #ifdef ENABLE_WEB_SERVICE
@@ -61,6 +63,9 @@ static void PrintHelp(const char* argv0) {
              "--ban-list-file     The file for storing the room ban list\n"
              "--log-file          The file for storing the room log\n"
              "--enable-citron-mods Allow citron Community Moderators to moderate on your room\n"
+             "--room-config       Host every room listed in the file from this process\n"
+             "--workers           The number of threads servicing the rooms of --room-config\n"
+             "--status-port       The localhost TCP port that reports the metrics of each room\n"
              "-h, --help          Display this help and exit\n"
              "-v, --version       Output version information and exit\n",
              argv0);
@@ -175,6 +180,124 @@ static void SaveBanList(const Network::Room::BanList& ban_list, const std::strin
     }
 }
 
+/**
+ * Reads the rooms to host from a file with one room per line, formatted as
+ * port|name|preferred game|preferred game id (hex)|max members|password|description
+ * The trailing fields are optional. Empty lines and lines starting with # are ignored.
+ */
+static std::vector<Network::RoomPool::RoomConfig> LoadRoomConfig(const std::string& path) {
+    std::ifstream file;
+    Common::FS::OpenFileStream(file, path, std::ios_base::in);
+    if (!file) {
+        LOG_ERROR(Network, "Could not open room config!");
+        return {};
+    }
+
+    std::vector<Network::RoomPool::RoomConfig> configs;
+    std::string line;
+    while (std::getline(file, line)) {
+        line = Common::StripSpaces(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::vector<std::string> fields;
+        Common::SplitString(line, '|', fields);
+        if (fields.size() < 2) {
+            LOG_ERROR(Network, "Invalid room config line: {}", line);
+            continue;
+        }
+        const auto field = [&fields](std::size_t index) {
+            return index < fields.size() ? Common::StripSpaces(fields[index]) : std::string{};
+        };
+
+        Network::RoomPool::RoomConfig config;
+        const u32 port = static_cast<u32>(std::strtoul(field(0).c_str(), nullptr, 0));
+        if (port == 0 || port > UINT16_MAX) {
+            LOG_ERROR(Network, "Invalid port in room config line: {}", line);
+            continue;
+        }
+        config.port = static_cast<u16>(port);
+        config.name = field(1);
+        config.preferred_game.name = field(2);
+        config.preferred_game.id = std::strtoull(field(3).c_str(), nullptr, 16);
+        config.max_members = 16;
+        if (!field(4).empty()) {
+            config.max_members = static_cast<u32>(std::strtoul(field(4).c_str(), nullptr, 0));
+        }
+        if (config.max_members > Network::MaxConcurrentConnections || config.max_members < 2) {
+            LOG_ERROR(Network, "max_members needs to be in the range 2 - {}: {}",
+                      Network::MaxConcurrentConnections, line);
+            continue;
+        }
+        config.password = field(5);
+        config.description = field(6);
+        configs.push_back(std::move(config));
+    }
+    return configs;
+}
+
+static std::unique_ptr<Network::VerifyUser::Backend> CreateVerifyBackend(bool announce) {
+    if (announce) {
+#ifdef ENABLE_WEB_SERVICE
+        return std::make_unique<WebService::VerifyUserJWT>(
+            Settings::values.web_api_url.GetValue());
+#else
+        LOG_INFO(Network,
+                 "citron Web Services is not available with this build: validation is disabled.");
+#endif
+    }
+    return std::make_unique<Network::VerifyUser::NullBackend>();
+}
+
+/// Hosts every room of the room config file until Q+Enter is pressed.
+static int HostRoomPool(const std::vector<Network::RoomPool::RoomConfig>& configs, u32 workers,
+                        u32 status_port, bool announce, const std::string& ban_list_file) {
+    // Load the ban list, which all the rooms share
+    Network::Room::BanList ban_list;
+    if (!ban_list_file.empty()) {
+        ban_list = LoadBanList(ban_list_file);
+    }
+
+    Network::RoomNetwork network{};
+    network.Init();
+    int result = 0;
+    {
+        Network::RoomPool pool{ban_list};
+        for (const auto& config : configs) {
+            if (!pool.AddRoom(config, CreateVerifyBackend(announce))) {
+                result = -1;
+            }
+        }
+        if (result == 0) {
+            pool.Start(workers);
+            if (status_port != 0 && !pool.StartStatusServer(static_cast<u16>(status_port))) {
+                result = -1;
+            }
+        }
+        if (result == 0) {
+            LOG_INFO(Network, "{} rooms are open. Close with Q+Enter...", configs.size());
+            auto announce_session =
+                std::make_unique<Core::AnnounceMultiplayerSession>(pool.GetRooms());
+            if (announce) {
+                announce_session->Start();
+            }
+            std::string in;
+            std::cin >> in;
+            if (announce) {
+                announce_session->Stop();
+            }
+            announce_session.reset();
+            // Save the ban list
+            if (!ban_list_file.empty()) {
+                SaveBanList(pool.GetBanList(), ban_list_file);
+            }
+        }
+        pool.Stop();
+    }
+    network.Shutdown();
+    return result;
+}
+
 static void InitializeLogging(const std::string& log_file) {
     Common::Log::Initialize();
     Common::Log::SetColorConsoleBackendEnabled(true);
@@ -197,9 +320,12 @@ int main(int argc, char** argv) {
     std::string ban_list_file;
     std::string log_file = "citron-room.log";
     std::string bind_address;
+    std::string room_config_file;
     u64 preferred_game_id = 0;
     u32 port = Network::DefaultRoomPort;
     u32 max_members = 16;
+    u32 workers = std::max(std::thread::hardware_concurrency(), 1U);
+    u32 status_port = 0;
     bool enable_citron_mods = false;
 
     static struct option long_options[] = {
@@ -217,6 +343,9 @@ int main(int argc, char** argv) {
         {"ban-list-file", required_argument, 0, 'b'},
         {"log-file", required_argument, 0, 'l'},
         {"enable-citron-mods", no_argument, 0, 'e'},
+        {"room-config", required_argument, 0, 'c'},
+        {"workers", required_argument, 0, 'j'},
+        {"status-port", required_argument, 0, 'o'},
         {"help", no_argument, 0, 'h'},
         {"version", no_argument, 0, 'v'},
         {0, 0, 0, 0},
@@ -225,8 +354,8 @@ int main(int argc, char** argv) {
     InitializeLogging(log_file);
 
     while (optind < argc) {
-        int arg =
-            getopt_long(argc, argv, "n:d:s:p:m:w:g:u:t:a:i:l:hv", long_options, &option_index);
+        int arg = getopt_long(argc, argv, "n:d:s:p:m:w:g:u:t:a:i:l:c:j:o:hv", long_options,
+                              &option_index);
         if (arg != -1) {
             switch (static_cast<char>(arg)) {
             case 'n':
@@ -271,6 +400,15 @@ int main(int argc, char** argv) {
             case 'e':
                 enable_citron_mods = true;
                 break;
+            case 'c':
+                room_config_file.assign(optarg);
+                break;
+            case 'j':
+                workers = strtoul(optarg, &endarg, 0);
+                break;
+            case 'o':
+                status_port = strtoul(optarg, &endarg, 0);
+                break;
             case 'h':
                 PrintHelp(argv[0]);
                 return 0;
@@ -281,21 +419,28 @@ int main(int argc, char** argv) {
         }
     }
 
-    if (room_name.empty()) {
+    // With a room config file, the rooms are described by the file instead of the options
+    const bool multi_room = !room_config_file.empty();
+    if (room_name.empty() && !multi_room) {
         LOG_ERROR(Network, "Room name is empty!");
         PrintHelp(argv[0]);
         return -1;
     }
-    if (preferred_game.empty()) {
+    if (preferred_game.empty() && !multi_room) {
         LOG_ERROR(Network, "Preferred game is empty!");
         PrintHelp(argv[0]);
         return -1;
     }
-    if (preferred_game_id == 0) {
+    if (preferred_game_id == 0 && !multi_room) {
         LOG_ERROR(Network,
                   "preferred-game-id not set!\nThis should get set to allow users to find your "
                   "room.\nSet with --preferred-game-id id");
     }
+    if (status_port > UINT16_MAX) {
+        LOG_ERROR(Network, "Status port needs to be in the range 0 - 65535!");
+        PrintHelp(argv[0]);
+        return -1;
+    }
     if (max_members > Network::MaxConcurrentConnections || max_members < 2) {
         LOG_ERROR(Network, "max_members needs to be in the range 2 - {}!",
                   Network::MaxConcurrentConnections);
@@ -343,25 +488,29 @@ int main(int argc, char** argv) {
         LOG_INFO(Network, "Can not enable citron Moderators for private rooms");
     }
 
+    if (multi_room) {
+        std::vector<Network::RoomPool::RoomConfig> configs = LoadRoomConfig(room_config_file);
+        if (configs.empty()) {
+            LOG_ERROR(Network, "Room config does not contain any valid room!");
+            return -1;
+        }
+        for (auto& config : configs) {
+            config.bind_address = bind_address;
+            config.host_username = username;
+            config.enable_citron_mods = enable_citron_mods;
+        }
+        const int result = HostRoomPool(configs, workers, status_port, announce, ban_list_file);
+        detached_tasks.WaitForAllTasks();
+        return result;
+    }
+
     // Load the ban list
     Network::Room::BanList ban_list;
     if (!ban_list_file.empty()) {
         ban_list = LoadBanList(ban_list_file);
     }
 
-    std::unique_ptr<Network::VerifyUser::Backend> verify_backend;
-    if (announce) {
-#ifdef ENABLE_WEB_SERVICE
-        verify_backend =
-            std::make_unique<WebService::VerifyUserJWT>(Settings::values.web_api_url.GetValue());
-#else
-        LOG_INFO(Network,
-                 "citron Web Services is not available with this build: validation is disabled.");
-        verify_backend = std::make_unique<Network::VerifyUser::NullBackend>();
-#endif
-    } else {
-        verify_backend = std::make_unique<Network::VerifyUser::NullBackend>();
-    }
+    std::unique_ptr<Network::VerifyUser::Backend> verify_backend = CreateVerifyBackend(announce);
 
     Network::RoomNetwork network{};
     network.Init();
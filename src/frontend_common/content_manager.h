@@ -10,6 +10,7 @@
 #include "core/file_sys/common_funcs.h"
 #include "core/file_sys/content_archive.h"
 #include "core/file_sys/fs_filesystem.h"
+#include "core/file_sys/install_pipeline.h"
 #include "core/file_sys/nca_metadata.h"
 #include "core/file_sys/patch_manager.h"
 #include "core/file_sys/registered_cache.h"
@@ -122,6 +123,41 @@ inline bool RemoveMod(const Service::FileSystem::FileSystemController& fs_contro
     return false;
 }
 
+/**
+ * \brief Opens an NSP for installation
+ * \param vfs Reference to the VfsFilesystem instance in Core::System
+ * \param filename Path to the NSP file
+ * \return The NSP, or nullptr if the file is not a valid, non extracted NSP
+ */
+inline std::shared_ptr<FileSys::NSP> OpenNSP(FileSys::VfsFilesystem& vfs,
+                                             const std::string& filename) {
+    FileSys::VirtualFile file = vfs.OpenFile(filename, FileSys::OpenMode::Read);
+    if (file == nullptr || !boost::to_lower_copy(file->GetName()).ends_with(std::string("nsp"))) {
+        return nullptr;
+    }
+    auto nsp = std::make_shared<FileSys::NSP>(file);
+    if (nsp->IsExtractedType() || nsp->GetStatus() != Loader::ResultStatus::Success) {
+        return nullptr;
+    }
+    return nsp;
+}
+
+/**
+ * \brief Converts the result of a registered cache install
+ */
+inline InstallResult ToInstallResult(FileSys::InstallResult result) {
+    switch (result) {
+    case FileSys::InstallResult::Success:
+        return InstallResult::Success;
+    case FileSys::InstallResult::OverwriteExisting:
+        return InstallResult::Overwrite;
+    case FileSys::InstallResult::ErrorBaseInstall:
+        return InstallResult::BaseInstallAttempted;
+    default:
+        return InstallResult::Failure;
+    }
+}
+
 /**
  * \brief Installs an NSP
  * \param system Reference to the system instance
@@ -158,32 +194,48 @@ inline InstallResult InstallNSP(Core::System& system, FileSys::VfsFilesystem& vf
         return true;
     };
 
-    std::shared_ptr<FileSys::NSP> nsp;
-    FileSys::VirtualFile file = vfs.OpenFile(filename, FileSys::OpenMode::Read);
-    if (boost::to_lower_copy(file->GetName()).ends_with(std::string("nsp"))) {
-        nsp = std::make_shared<FileSys::NSP>(file);
-        if (nsp->IsExtractedType()) {
-            return InstallResult::Failure;
-        }
-    } else {
+    const auto nsp = OpenNSP(vfs, filename);
+    if (nsp == nullptr) {
         return InstallResult::Failure;
     }
+    return ToInstallResult(
+        system.GetFileSystemController().GetUserNANDContents()->InstallEntry(*nsp, true, copy));
+}
 
-    if (nsp->GetStatus() != Loader::ResultStatus::Success) {
-        return InstallResult::Failure;
+/**
+ * \brief Installs several NSPs at once. The NCAs of each one are read, verified against their
+ * SHA-256 and written on separate threads, and independent NSPs are installed concurrently.
+ * \param system Reference to the system instance
+ * \param vfs Reference to the VfsFilesystem instance in Core::System
+ * \param filenames Paths to the NSP files
+ * \param callback Callback to report the aggregate progress of the installation, invoked from
+ * the calling thread. The parameters are the total size of the NSPs, the current progress and the
+ * current throughput in MB/s. If you return true to the callback, it will cancel the installation
+ * as soon as possible.
+ * \return [InstallResult] representing how the installation of each file finished
+ */
+inline std::vector<InstallResult> InstallNSPs(
+    Core::System& system, FileSys::VfsFilesystem& vfs, const std::vector<std::string>& filenames,
+    const std::function<bool(size_t, size_t, double)>& callback) {
+    std::vector<InstallResult> results(filenames.size(), InstallResult::Failure);
+    std::vector<std::shared_ptr<FileSys::NSP>> nsps;
+    std::vector<size_t> nsp_indices;
+    for (size_t i = 0; i < filenames.size(); ++i) {
+        if (auto nsp = OpenNSP(vfs, filenames[i])) {
+            nsps.push_back(std::move(nsp));
+            nsp_indices.push_back(i);
+        }
     }
-    const auto res =
-        system.GetFileSystemController().GetUserNANDContents()->InstallEntry(*nsp, true, copy);
-    switch (res) {
-    case FileSys::InstallResult::Success:
-        return InstallResult::Success;
-    case FileSys::InstallResult::OverwriteExisting:
-        return InstallResult::Overwrite;
-    case FileSys::InstallResult::ErrorBaseInstall:
-        return InstallResult::BaseInstallAttempted;
-    default:
-        return InstallResult::Failure;
+
+    const auto nsp_results = FileSys::InstallNSPs(
+        *system.GetFileSystemController().GetUserNANDContents(), nsps, true,
+        [&callback](size_t processed_size, size_t total_size, double bytes_per_second) {
+            return !callback(total_size, processed_size, bytes_per_second / 1e6);
+        });
+    for (size_t i = 0; i < nsp_results.size(); ++i) {
+        results[nsp_indices[i]] = ToInstallResult(nsp_results[i]);
     }
+    return results;
 }
 
 /**
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "common/logging/log.h"
+#include "common/settings.h"
 #include "core/core.h"
 #include "core/core_timing.h"
 #include "core/hle/service/ipc_helpers.h"
@@ -15,6 +16,7 @@
 #include "hid_core/resources/debug_pad/debug_pad.h"
 #include "hid_core/resources/digitizer/digitizer.h"
 #include "hid_core/resources/hid_firmware_settings.h"
+#include "hid_core/resources/input_update_scheduler.h"
 #include "hid_core/resources/keyboard/keyboard.h"
 #include "hid_core/resources/mouse/debug_mouse.h"
 #include "hid_core/resources/mouse/mouse.h"
@@ -46,6 +48,9 @@ constexpr auto npad_update_ns = std::chrono::nanoseconds{1 * 1000 * 1000};    //
 constexpr auto default_update_ns = std::chrono::nanoseconds{4 * 1000 * 1000}; // (4ms, 1000Hz)
 constexpr auto mouse_keyboard_update_ns = std::chrono::nanoseconds{8 * 1000 * 1000}; // (8ms, 125Hz)
 constexpr auto motion_update_ns = std::chrono::nanoseconds{5 * 1000 * 1000};         // (5ms, 200Hz)
+// In event driven mode input changes are pushed from the emulated controllers, and the samplers
+// only run often enough to give the guest a new sample on every 60Hz frame.
+constexpr auto idle_update_ns = std::chrono::nanoseconds{8 * 1000 * 1000}; // (8ms, 125Hz)
 
 ResourceManager::ResourceManager(Core::System& system_,
                                  std::shared_ptr<HidFirmwareSettings> settings)
@@ -56,6 +61,7 @@ ResourceManager::ResourceManager(Core::System& system_,
     npad_update_event = Core::Timing::CreateEvent("HID::UpdatePadCallback",
                                                   [this](s64 time, std::chrono::nanoseconds ns_late)
                                                       -> std::optional<std::chrono::nanoseconds> {
+                                                      CountSharedMemoryUpdate();
                                                       UpdateNpad(ns_late);
                                                       return std::nullopt;
                                                   });
@@ -63,6 +69,7 @@ ResourceManager::ResourceManager(Core::System& system_,
         "HID::UpdateDefaultCallback",
         [this](s64 time,
                std::chrono::nanoseconds ns_late) -> std::optional<std::chrono::nanoseconds> {
+            CountSharedMemoryUpdate();
             UpdateControllers(ns_late);
             return std::nullopt;
         });
@@ -70,6 +77,7 @@ ResourceManager::ResourceManager(Core::System& system_,
         "HID::UpdateMouseKeyboardCallback",
         [this](s64 time,
                std::chrono::nanoseconds ns_late) -> std::optional<std::chrono::nanoseconds> {
+            CountSharedMemoryUpdate();
             UpdateMouseKeyboard(ns_late);
             return std::nullopt;
         });
@@ -77,12 +85,14 @@ ResourceManager::ResourceManager(Core::System& system_,
         "HID::UpdateMotionCallback",
         [this](s64 time,
                std::chrono::nanoseconds ns_late) -> std::optional<std::chrono::nanoseconds> {
+            CountSharedMemoryUpdate();
             UpdateMotion(ns_late);
             return std::nullopt;
         });
 }
 
 ResourceManager::~ResourceManager() {
+    input_update_scheduler.reset();
     system.CoreTiming().UnscheduleEvent(npad_update_event);
     system.CoreTiming().UnscheduleEvent(default_update_event);
     system.CoreTiming().UnscheduleEvent(mouse_keyboard_update_event);
@@ -248,13 +258,32 @@ void ResourceManager::InitializeHidCommonSampler() {
     sleep_button->SetAppletResource(applet_resource, &shared_mutex);
     capture_button->SetAppletResource(applet_resource, &shared_mutex);
 
-    system.CoreTiming().ScheduleLoopingEvent(npad_update_ns, npad_update_ns, npad_update_event);
-    system.CoreTiming().ScheduleLoopingEvent(default_update_ns, default_update_ns,
+    // Input changes are pushed as they happen in event driven mode, the periodic updates only
+    // have to keep the sampling numbers moving.
+    is_event_driven = Settings::values.hid_event_driven_updates.GetValue();
+    if (is_event_driven) {
+        input_update_scheduler = std::make_unique<InputUpdateScheduler>(
+            system.HIDCore(), system.CoreTiming(), npad_update_ns, motion_update_ns,
+            [this](std::chrono::nanoseconds ns_late) {
+                CountSharedMemoryUpdate();
+                UpdateNpad(ns_late);
+                UpdateControllers(ns_late);
+            },
+            [this](std::chrono::nanoseconds ns_late) {
+                CountSharedMemoryUpdate();
+                UpdateMotion(ns_late);
+            });
+    }
+
+    const auto pad_period = is_event_driven ? idle_update_ns : npad_update_ns;
+    const auto default_period = is_event_driven ? idle_update_ns : default_update_ns;
+    const auto motion_period = is_event_driven ? idle_update_ns : motion_update_ns;
+    system.CoreTiming().ScheduleLoopingEvent(pad_period, pad_period, npad_update_event);
+    system.CoreTiming().ScheduleLoopingEvent(default_period, default_period,
                                              default_update_event);
     system.CoreTiming().ScheduleLoopingEvent(mouse_keyboard_update_ns, mouse_keyboard_update_ns,
                                              mouse_keyboard_update_event);
-    system.CoreTiming().ScheduleLoopingEvent(motion_update_ns, motion_update_ns,
-                                             motion_update_event);
+    system.CoreTiming().ScheduleLoopingEvent(motion_period, motion_period, motion_update_event);
 }
 
 void ResourceManager::InitializeTouchScreenSampler() {
@@ -470,6 +499,19 @@ Result ResourceManager::GetTouchScreenFirmwareVersion(Core::HID::FirmwareVersion
     return ResultSuccess;
 }
 
+void ResourceManager::CountSharedMemoryUpdate() {
+    ++shared_memory_updates;
+
+    const s64 time = system.CoreTiming().GetGlobalTimeNs().count();
+    const s64 elapsed = time - shared_memory_report_time;
+    if (elapsed >= 1'000'000'000) {
+        LOG_DEBUG(Service_HID, "Shared memory updates: {:.1f}/s ({} mode)",
+                  static_cast<double>(shared_memory_updates.exchange(0)) * 1e9 / elapsed,
+                  is_event_driven ? "event driven" : "polling");
+        shared_memory_report_time = time;
+    }
+}
+
 void ResourceManager::UpdateControllers(std::chrono::nanoseconds ns_late) {
     auto& core_timing = system.CoreTiming();
     debug_pad->OnUpdate(core_timing);
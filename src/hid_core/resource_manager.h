@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+
 #include "core/hle/service/kernel_helpers.h"
 #include "core/hle/service/service.h"
 
@@ -37,6 +40,7 @@ class Digitizer;
 class Gesture;
 class HidFirmwareSettings;
 class HomeButton;
+class InputUpdateScheduler;
 class Keyboard;
 class Mouse;
 class NPad;
@@ -121,6 +125,7 @@ private:
     void InitializeTouchScreenSampler();
     void InitializeConsoleSixAxisSampler();
     void InitializeAHidSampler();
+    void CountSharedMemoryUpdate();
 
     bool is_initialized{false};
 
@@ -152,6 +157,13 @@ private:
     std::shared_ptr<Core::Timing::EventType> mouse_keyboard_update_event;
     std::shared_ptr<Core::Timing::EventType> motion_update_event;
 
+    // Input changes pushed from the emulated controllers in event driven mode
+    bool is_event_driven{false};
+    std::unique_ptr<InputUpdateScheduler> input_update_scheduler;
+
+    std::atomic<u64> shared_memory_updates{0};
+    s64 shared_memory_report_time{0};
+
     // TODO: Create these resources
     // std::shared_ptr<AudioControl> audio_control{nullptr};
     // std::shared_ptr<ButtonConfig> button_config{nullptr};
@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/core_timing.h"
+#include "hid_core/frontend/emulated_controller.h"
+#include "hid_core/hid_core.h"
+#include "hid_core/resources/input_update_scheduler.h"
+
+namespace Service::HID {
+
+InputUpdateScheduler::InputUpdateScheduler(Core::HID::HIDCore& hid_core_,
+                                           Core::Timing::CoreTiming& core_timing_,
+                                           std::chrono::nanoseconds npad_delay_,
+                                           std::chrono::nanoseconds motion_delay_,
+                                           UpdateCallback on_npad_update,
+                                           UpdateCallback on_motion_update)
+    : hid_core{hid_core_}, core_timing{core_timing_}, npad_delay{npad_delay_},
+      motion_delay{motion_delay_} {
+    npad_event = Core::Timing::CreateEvent(
+        "HID::NpadInputCallback",
+        [this, on_npad_update = std::move(on_npad_update)](
+            s64 time, std::chrono::nanoseconds ns_late) -> std::optional<std::chrono::nanoseconds> {
+            npad_pending = false;
+            on_npad_update(ns_late);
+            return std::nullopt;
+        });
+    motion_event = Core::Timing::CreateEvent(
+        "HID::MotionInputCallback",
+        [this, on_motion_update = std::move(on_motion_update)](
+            s64 time, std::chrono::nanoseconds ns_late) -> std::optional<std::chrono::nanoseconds> {
+            motion_pending = false;
+            on_motion_update(ns_late);
+            return std::nullopt;
+        });
+
+    for (std::size_t i = 0; i < Core::HID::HIDCore::available_controllers; ++i) {
+        Core::HID::ControllerUpdateCallback engine_callback{
+            .on_change = [this](Core::HID::ControllerTriggerType type) {
+                OnControllerChange(type);
+            },
+            .is_npad_service = false,
+        };
+        callback_keys.push_back(
+            hid_core.GetEmulatedControllerByIndex(i)->SetCallback(engine_callback));
+    }
+}
+
+InputUpdateScheduler::~InputUpdateScheduler() {
+    // Stop listening first, so no change can schedule an event after it was unscheduled
+    for (std::size_t i = 0; i < callback_keys.size(); ++i) {
+        hid_core.GetEmulatedControllerByIndex(i)->DeleteCallback(callback_keys[i]);
+    }
+    core_timing.UnscheduleEvent(npad_event);
+    core_timing.UnscheduleEvent(motion_event);
+}
+
+void InputUpdateScheduler::OnControllerChange(Core::HID::ControllerTriggerType type) {
+    // Coalesce the changes of each update delay into a single update of the shared memory
+    switch (type) {
+    case Core::HID::ControllerTriggerType::Motion:
+        if (!motion_pending.exchange(true)) {
+            core_timing.ScheduleEvent(motion_delay, motion_event);
+        }
+        break;
+    case Core::HID::ControllerTriggerType::Button:
+    case Core::HID::ControllerTriggerType::Stick:
+    case Core::HID::ControllerTriggerType::Trigger:
+    case Core::HID::ControllerTriggerType::Connected:
+    case Core::HID::ControllerTriggerType::Disconnected:
+    case Core::HID::ControllerTriggerType::Type:
+    case Core::HID::ControllerTriggerType::All:
+        if (!npad_pending.exchange(true)) {
+            core_timing.ScheduleEvent(npad_delay, npad_event);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+} // namespace Service::HID
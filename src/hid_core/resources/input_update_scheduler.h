@@ -0,0 +1,55 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace Core::HID {
+class HIDCore;
+enum class ControllerTriggerType;
+} // namespace Core::HID
+
+namespace Core::Timing {
+class CoreTiming;
+struct EventType;
+} // namespace Core::Timing
+
+namespace Service::HID {
+
+/// Schedules a one-shot shared memory update whenever an emulated controller reports a change.
+/// Changes reported within one update delay are coalesced into a single update.
+class InputUpdateScheduler {
+public:
+    using UpdateCallback = std::function<void(std::chrono::nanoseconds ns_late)>;
+
+    explicit InputUpdateScheduler(Core::HID::HIDCore& hid_core_,
+                                  Core::Timing::CoreTiming& core_timing_,
+                                  std::chrono::nanoseconds npad_delay_,
+                                  std::chrono::nanoseconds motion_delay_,
+                                  UpdateCallback on_npad_update, UpdateCallback on_motion_update);
+    ~InputUpdateScheduler();
+
+    InputUpdateScheduler(const InputUpdateScheduler&) = delete;
+    InputUpdateScheduler& operator=(const InputUpdateScheduler&) = delete;
+
+private:
+    void OnControllerChange(Core::HID::ControllerTriggerType type);
+
+    Core::HID::HIDCore& hid_core;
+    Core::Timing::CoreTiming& core_timing;
+    const std::chrono::nanoseconds npad_delay;
+    const std::chrono::nanoseconds motion_delay;
+
+    std::vector<int> callback_keys;
+    std::shared_ptr<Core::Timing::EventType> npad_event;
+    std::shared_ptr<Core::Timing::EventType> motion_event;
+    std::atomic<bool> npad_pending{false};
+    std::atomic<bool> motion_pending{false};
+};
+
+} // namespace Service::HID
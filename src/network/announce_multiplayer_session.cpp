@@ -19,19 +19,49 @@ namespace Core {
 // Time between room is announced to web_service
 static constexpr std::chrono::seconds announce_time_interval(15);
 
-AnnounceMultiplayerSession::AnnounceMultiplayerSession(Network::RoomNetwork& room_network_)
-    : room_network{room_network_} {
+namespace {
+
+std::unique_ptr<AnnounceMultiplayerRoom::Backend> CreateBackend() {
 #ifdef ENABLE_WEB_SERVICE
-    backend = std::make_unique<WebService::RoomJson>(Settings::values.web_api_url.GetValue(),
-                                                     Settings::values.citron_username.GetValue(),
-                                                     Settings::values.citron_token.GetValue());
+    return std::make_unique<WebService::RoomJson>(Settings::values.web_api_url.GetValue(),
+                                                  Settings::values.citron_username.GetValue(),
+                                                  Settings::values.citron_token.GetValue());
 #else
-    backend = std::make_unique<AnnounceMultiplayerRoom::NullBackend>();
+    return std::make_unique<AnnounceMultiplayerRoom::NullBackend>();
 #endif
 }
 
+} // Anonymous namespace
+
+AnnounceMultiplayerSession::AnnounceMultiplayerSession(Network::RoomNetwork& room_network_) {
+    auto& announced_room = announced_rooms.emplace_back(std::make_unique<AnnouncedRoom>());
+    announced_room->get_room = [&room_network_] { return room_network_.GetRoom().lock(); };
+    announced_room->backend = CreateBackend();
+}
+
+AnnounceMultiplayerSession::AnnounceMultiplayerSession(
+    const std::vector<std::weak_ptr<Network::Room>>& rooms_) {
+    ASSERT_MSG(!rooms_.empty(), "No rooms to announce");
+    for (const auto& room : rooms_) {
+        auto& announced_room = announced_rooms.emplace_back(std::make_unique<AnnouncedRoom>());
+        announced_room->get_room = [room] { return room.lock(); };
+        announced_room->backend = CreateBackend();
+    }
+}
+
 WebService::WebResult AnnounceMultiplayerSession::Register() {
-    auto room = room_network.GetRoom().lock();
+    WebService::WebResult result{WebService::WebResult::Code::Success, "", ""};
+    for (const auto& announced_room : announced_rooms) {
+        WebService::WebResult room_result = Register(*announced_room);
+        if (result.result_code == WebService::WebResult::Code::Success) {
+            result = std::move(room_result);
+        }
+    }
+    return result;
+}
+
+WebService::WebResult AnnounceMultiplayerSession::Register(AnnouncedRoom& announced_room) {
+    auto room = announced_room.get_room();
     if (!room) {
         return WebService::WebResult{WebService::WebResult::Code::LibError,
                                      "Network is not initialized", ""};
@@ -39,14 +69,14 @@ WebService::WebResult AnnounceMultiplayerSession::Register() {
     if (room->GetState() != Network::Room::State::Open) {
         return WebService::WebResult{WebService::WebResult::Code::LibError, "Room is not open", ""};
     }
-    UpdateBackendData(room);
-    WebService::WebResult result = backend->Register();
+    UpdateBackendData(announced_room, room);
+    WebService::WebResult result = announced_room.backend->Register();
     if (result.result_code != WebService::WebResult::Code::Success) {
         return result;
     }
     LOG_INFO(WebService, "Room has been registered");
     room->SetVerifyUID(result.returned_data);
-    registered = true;
+    announced_room.registered = true;
     return WebService::WebResult{WebService::WebResult::Code::Success, "", ""};
 }
 
@@ -64,8 +94,10 @@ void AnnounceMultiplayerSession::Stop() {
         shutdown_event.Set();
         announce_multiplayer_thread->join();
         announce_multiplayer_thread.reset();
-        backend->Delete();
-        registered = false;
+        for (const auto& announced_room : announced_rooms) {
+            announced_room->backend->Delete();
+            announced_room->registered = false;
+        }
     }
 }
 
@@ -86,9 +118,11 @@ AnnounceMultiplayerSession::~AnnounceMultiplayerSession() {
     Stop();
 }
 
-void AnnounceMultiplayerSession::UpdateBackendData(std::shared_ptr<Network::Room> room) {
+void AnnounceMultiplayerSession::UpdateBackendData(AnnouncedRoom& announced_room,
+                                                   std::shared_ptr<Network::Room> room) {
     Network::RoomInformation room_information = room->GetRoomInformation();
     std::vector<AnnounceMultiplayerRoom::Member> memberlist = room->GetRoomMemberList();
+    auto& backend = announced_room.backend;
     backend->SetRoomInformation(room_information.name, room_information.description,
                                 room_information.port, room_information.member_slots,
                                 Network::network_version, room->HasPassword(),
@@ -108,43 +142,54 @@ void AnnounceMultiplayerSession::AnnounceMultiplayerLoop() {
         }
     };
 
-    if (!registered) {
-        WebService::WebResult result = Register();
-        if (result.result_code != WebService::WebResult::Code::Success) {
-            ErrorCallback(result);
-            return;
+    // A room that fails to register is reported and left out, the others are still announced
+    std::vector<AnnouncedRoom*> registered_rooms;
+    for (const auto& announced_room : announced_rooms) {
+        if (!announced_room->registered) {
+            WebService::WebResult result = Register(*announced_room);
+            if (result.result_code != WebService::WebResult::Code::Success) {
+                ErrorCallback(result);
+                continue;
+            }
         }
+        registered_rooms.push_back(announced_room.get());
+    }
+    if (registered_rooms.empty()) {
+        return;
     }
 
     auto update_time = std::chrono::steady_clock::now();
-    std::future<WebService::WebResult> future;
     while (!shutdown_event.WaitUntil(update_time)) {
         update_time += announce_time_interval;
-        auto room = room_network.GetRoom().lock();
-        if (!room) {
-            break;
+        bool any_open = false;
+        for (AnnouncedRoom* const announced_room : registered_rooms) {
+            auto room = announced_room->get_room();
+            if (!room || room->GetState() != Network::Room::State::Open) {
+                continue;
+            }
+            any_open = true;
+            UpdateBackendData(*announced_room, room);
+            WebService::WebResult result = announced_room->backend->Update();
+            if (result.result_code != WebService::WebResult::Code::Success) {
+                ErrorCallback(result);
+            }
+            if (result.result_string == "404") {
+                announced_room->registered = false;
+                // Needs to register the room again
+                WebService::WebResult register_result = Register(*announced_room);
+                if (register_result.result_code != WebService::WebResult::Code::Success) {
+                    ErrorCallback(register_result);
+                }
+            }
         }
-        if (room->GetState() != Network::Room::State::Open) {
+        if (!any_open) {
             break;
         }
-        UpdateBackendData(room);
-        WebService::WebResult result = backend->Update();
-        if (result.result_code != WebService::WebResult::Code::Success) {
-            ErrorCallback(result);
-        }
-        if (result.result_string == "404") {
-            registered = false;
-            // Needs to register the room again
-            WebService::WebResult register_result = Register();
-            if (register_result.result_code != WebService::WebResult::Code::Success) {
-                ErrorCallback(register_result);
-            }
-        }
     }
 }
 
 AnnounceMultiplayerRoom::RoomList AnnounceMultiplayerSession::GetRoomList() {
-    return backend->GetRoomList();
+    return announced_rooms.front()->backend->GetRoomList();
 }
 
 bool AnnounceMultiplayerSession::IsRunning() const {
@@ -155,9 +200,9 @@ void AnnounceMultiplayerSession::UpdateCredentials() {
     ASSERT_MSG(!IsRunning(), "Credentials can only be updated when session is not running");
 
 #ifdef ENABLE_WEB_SERVICE
-    backend = std::make_unique<WebService::RoomJson>(Settings::values.web_api_url.GetValue(),
-                                                     Settings::values.citron_username.GetValue(),
-                                                     Settings::values.citron_token.GetValue());
+    for (const auto& announced_room : announced_rooms) {
+        announced_room->backend = CreateBackend();
+    }
 #endif
 }
 
@@ -9,6 +9,7 @@
 #include <mutex>
 #include <set>
 #include <thread>
+#include <vector>
 #include "common/announce_multiplayer_room.h"
 #include "common/common_types.h"
 #include "common/thread.h"
@@ -29,6 +30,13 @@ class AnnounceMultiplayerSession {
 public:
     using CallbackHandle = std::shared_ptr<std::function<void(const WebService::WebResult&)>>;
     AnnounceMultiplayerSession(Network::RoomNetwork& room_network_);
+
+    /**
+     * Announces several rooms hosted by this process from a single thread. Each room is
+     * registered to web services separately.
+     */
+    explicit AnnounceMultiplayerSession(const std::vector<std::weak_ptr<Network::Room>>& rooms_);
+
     ~AnnounceMultiplayerSession();
 
     /**
@@ -45,8 +53,8 @@ public:
     void UnbindErrorCallback(CallbackHandle handle);
 
     /**
-     * Registers a room to web services
-     * @return The result of the registration attempt.
+     * Registers the announced rooms to web services
+     * @return The result of the registration attempt, the first failure if there are several.
      */
     WebService::WebResult Register();
 
@@ -79,7 +87,18 @@ public:
     void UpdateCredentials();
 
 private:
-    void UpdateBackendData(std::shared_ptr<Network::Room> room);
+    /// A room announced by this session along with its registration
+    struct AnnouncedRoom {
+        std::function<std::shared_ptr<Network::Room>()> get_room;
+
+        /// Backend interface that logs fields
+        std::unique_ptr<AnnounceMultiplayerRoom::Backend> backend;
+
+        std::atomic_bool registered = false; ///< Whether the room has been registered
+    };
+
+    WebService::WebResult Register(AnnouncedRoom& announced_room);
+    void UpdateBackendData(AnnouncedRoom& announced_room, std::shared_ptr<Network::Room> room);
     void AnnounceMultiplayerLoop();
 
     Common::Event shutdown_event;
@@ -87,12 +106,7 @@ private:
     std::set<CallbackHandle> error_callbacks;
     std::unique_ptr<std::thread> announce_multiplayer_thread;
 
-    /// Backend interface that logs fields
-    std::unique_ptr<AnnounceMultiplayerRoom::Backend> backend;
-
-    std::atomic_bool registered = false; ///< Whether the room has been registered
-
-    Network::RoomNetwork& room_network;
+    std::vector<std::unique_ptr<AnnouncedRoom>> announced_rooms;
 };
 
 } // namespace Core
@@ -4,13 +4,17 @@
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <cstring>
 #include <iomanip>
 #include <mutex>
+#include <optional>
 #include <random>
 #include <regex>
 #include <shared_mutex>
 #include <sstream>
 #include <thread>
+#include <unordered_map>
 #include "common/logging/log.h"
 #include "enet/enet.h"
 #include "network/packet.h"
@@ -19,6 +23,23 @@
 
 namespace Network {
 
+namespace {
+
+/// Offsets of the routing fields in the relayed packets, see RoomMember::SendProxyPacket and
+/// RoomMember::SendLdnPacket for their layout.
+constexpr std::size_t ProxyPacketRemoteIPOffset = 9;
+constexpr std::size_t ProxyPacketBroadcastOffset = 16;
+constexpr std::size_t LdnPacketRemoteIPOffset = 6;
+constexpr std::size_t LdnPacketBroadcastOffset = 10;
+
+u32 FakeIPKey(const IPv4Address& address) {
+    u32 key;
+    std::memcpy(&key, address.data(), sizeof(key));
+    return key;
+}
+
+} // Anonymous namespace
+
 class Room::RoomImpl {
 public:
     std::mt19937 random_gen; ///< Random number generator. Used for GenerateFakeIPAddress
@@ -45,9 +66,17 @@ public:
     MemberList members;                     ///< Information about the members of this room
     mutable std::shared_mutex member_mutex; ///< Mutex for locking the members list
 
-    UsernameBanList username_ban_list; ///< List of banned usernames
-    IPBanList ip_ban_list;             ///< List of banned IP addresses
-    mutable std::mutex ban_list_mutex; ///< Mutex for the ban lists
+    /// Lookup tables into members, guarded by member_mutex
+    std::unordered_map<u32, ENetPeer*> peer_by_fake_ip;
+    std::unordered_map<const ENetPeer*, std::size_t> member_index_by_peer;
+
+    RelayStatistics relay_statistics;           ///< Counters of the relayed packets
+    RelayStatistics pending_relay_statistics;   ///< Counters of the current service iteration
+    mutable std::mutex relay_statistics_mutex; ///< Mutex for relay_statistics
+
+    /// Lists of banned usernames and IP addresses, possibly shared with other rooms
+    std::shared_ptr<SharedBanList> ban_list = std::make_shared<SharedBanList>();
+    bool has_shared_ban_list = false; ///< Whether ban_list was provided by the owner
 
     RoomImpl() : random_gen(std::random_device()()) {}
 
@@ -61,6 +90,32 @@ public:
     void ServerLoop();
     void StartLoop();
 
+    /**
+     * Waits up to timeout_ms for an event, then handles every event that has been received and
+     * sends out the replies. Returns true if any event was handled.
+     */
+    bool ServiceEvents(u32 timeout_ms);
+
+    /// Dispatches a single event received from the ENet host.
+    void HandleEvent(ENetEvent* event);
+
+    /// Rebuilds the member lookup tables after members changed. member_mutex must be held.
+    void RebuildMemberIndex();
+
+    /// Returns the member using the given peer, or nullptr. member_mutex must be held.
+    Member* FindMember(const ENetPeer* peer);
+    const Member* FindMember(const ENetPeer* peer) const;
+
+    /**
+     * Forwards the received packet as is to the destination member, or to all members except
+     * the sender when broadcasting. The packet is sent once the current service iteration ends.
+     */
+    void RelayPacket(const ENetEvent* event, std::size_t remote_ip_offset,
+                     std::size_t broadcast_offset);
+
+    /// Adds the counters of the finished service iteration to the room's relay statistics.
+    void CommitRelayStatistics(std::chrono::steady_clock::time_point iteration_start);
+
     /**
      * Parses and answers a room join request from a client.
      * Validates the uniqueness of the username and assigns the MAC address
@@ -240,55 +295,93 @@ public:
 // RoomImpl
 void Room::RoomImpl::ServerLoop() {
     while (state != State::Closed) {
-        ENetEvent event;
-        if (enet_host_service(server, &event, 5) > 0) {
-            switch (event.type) {
-            case ENET_EVENT_TYPE_RECEIVE:
-                switch (event.packet->data[0]) {
-                case IdJoinRequest:
-                    HandleJoinRequest(&event);
-                    break;
-                case IdSetGameInfo:
-                    HandleGameInfoPacket(&event);
-                    break;
-                case IdProxyPacket:
-                    HandleProxyPacket(&event);
-                    break;
-                case IdLdnPacket:
-                    HandleLdnPacket(&event);
-                    break;
-                case IdChatMessage:
-                    HandleChatPacket(&event);
-                    break;
-                // Moderation
-                case IdModKick:
-                    HandleModKickPacket(&event);
-                    break;
-                case IdModBan:
-                    HandleModBanPacket(&event);
-                    break;
-                case IdModUnban:
-                    HandleModUnbanPacket(&event);
-                    break;
-                case IdModGetBanList:
-                    HandleModGetBanListPacket(&event);
-                    break;
-                }
-                enet_packet_destroy(event.packet);
-                break;
-            case ENET_EVENT_TYPE_DISCONNECT:
-                HandleClientDisconnection(event.peer);
-                break;
-            case ENET_EVENT_TYPE_NONE:
-            case ENET_EVENT_TYPE_CONNECT:
-                break;
-            }
-        }
+        ServiceEvents(5);
     }
     // Close the connection to all members:
     SendCloseMessage();
 }
 
+bool Room::RoomImpl::ServiceEvents(u32 timeout_ms) {
+    ENetEvent event;
+    if (enet_host_service(server, &event, timeout_ms) <= 0) {
+        return false;
+    }
+    const auto iteration_start = std::chrono::steady_clock::now();
+    // Handle everything that has already been received before sending out the replies
+    do {
+        HandleEvent(&event);
+    } while (enet_host_check_events(server, &event) > 0);
+    enet_host_flush(server);
+    CommitRelayStatistics(iteration_start);
+    return true;
+}
+
+void Room::RoomImpl::HandleEvent(ENetEvent* event) {
+    switch (event->type) {
+    case ENET_EVENT_TYPE_RECEIVE:
+        switch (event->packet->data[0]) {
+        case IdJoinRequest:
+            HandleJoinRequest(event);
+            break;
+        case IdSetGameInfo:
+            HandleGameInfoPacket(event);
+            break;
+        case IdProxyPacket:
+            HandleProxyPacket(event);
+            break;
+        case IdLdnPacket:
+            HandleLdnPacket(event);
+            break;
+        case IdChatMessage:
+            HandleChatPacket(event);
+            break;
+        // Moderation
+        case IdModKick:
+            HandleModKickPacket(event);
+            break;
+        case IdModBan:
+            HandleModBanPacket(event);
+            break;
+        case IdModUnban:
+            HandleModUnbanPacket(event);
+            break;
+        case IdModGetBanList:
+            HandleModGetBanListPacket(event);
+            break;
+        }
+        // Relayed packets are owned by ENet until they have been sent to every destination
+        if (event->packet->referenceCount == 0) {
+            enet_packet_destroy(event->packet);
+        }
+        break;
+    case ENET_EVENT_TYPE_DISCONNECT:
+        HandleClientDisconnection(event->peer);
+        break;
+    case ENET_EVENT_TYPE_NONE:
+    case ENET_EVENT_TYPE_CONNECT:
+        break;
+    }
+}
+
+void Room::RoomImpl::RebuildMemberIndex() {
+    peer_by_fake_ip.clear();
+    member_index_by_peer.clear();
+    for (std::size_t index = 0; index < members.size(); ++index) {
+        peer_by_fake_ip.emplace(FakeIPKey(members[index].fake_ip), members[index].peer);
+        member_index_by_peer.emplace(members[index].peer, index);
+    }
+}
+
+Room::RoomImpl::Member* Room::RoomImpl::FindMember(const ENetPeer* peer) {
+    const auto it = member_index_by_peer.find(peer);
+    return it != member_index_by_peer.end() ? &members[it->second] : nullptr;
+}
+
+const Room::RoomImpl::Member* Room::RoomImpl::FindMember(const ENetPeer* peer) const {
+    const auto it = member_index_by_peer.find(peer);
+    return it != member_index_by_peer.end() ? &members[it->second] : nullptr;
+}
+
 void Room::RoomImpl::StartLoop() {
     room_thread = std::make_unique<std::thread>(&Room::RoomImpl::ServerLoop, this);
 }
@@ -360,7 +453,9 @@ void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
 
     std::string ip;
     {
-        std::lock_guard lock(ban_list_mutex);
+        std::lock_guard lock(ban_list->mutex);
+        const auto& username_ban_list = ban_list->username_ban_list;
+        const auto& ip_ban_list = ban_list->ip_ban_list;
 
         // Check username ban
         if (!member.user_data.username.empty() &&
@@ -388,6 +483,7 @@ void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
     {
         std::lock_guard lock(member_mutex);
         members.push_back(std::move(member));
+        RebuildMemberIndex();
     }
 
     // Notify everyone that the room information has changed.
@@ -434,6 +530,7 @@ void Room::RoomImpl::HandleModKickPacket(const ENetEvent* event) {
 
         enet_peer_disconnect(target_member->peer, 0);
         members.erase(target_member);
+        RebuildMemberIndex();
     }
 
     // Announce the change to all clients.
@@ -477,10 +574,13 @@ void Room::RoomImpl::HandleModBanPacket(const ENetEvent* event) {
 
         enet_peer_disconnect(target_member->peer, 0);
         members.erase(target_member);
+        RebuildMemberIndex();
     }
 
     {
-        std::lock_guard lock(ban_list_mutex);
+        std::lock_guard lock(ban_list->mutex);
+        auto& username_ban_list = ban_list->username_ban_list;
+        auto& ip_ban_list = ban_list->ip_ban_list;
 
         if (!username.empty()) {
             // Ban the forum username
@@ -517,7 +617,9 @@ void Room::RoomImpl::HandleModUnbanPacket(const ENetEvent* event) {
 
     bool unbanned = false;
     {
-        std::lock_guard lock(ban_list_mutex);
+        std::lock_guard lock(ban_list->mutex);
+        auto& username_ban_list = ban_list->username_ban_list;
+        auto& ip_ban_list = ban_list->ip_ban_list;
 
         auto it = std::find(username_ban_list.begin(), username_ban_list.end(), address);
         if (it != username_ban_list.end()) {
@@ -563,16 +665,13 @@ bool Room::RoomImpl::IsValidNickname(const std::string& nickname) const {
 bool Room::RoomImpl::IsValidFakeIPAddress(const IPv4Address& address) const {
     // An IP address is valid if it is not already taken by anybody else in the room.
     std::lock_guard lock(member_mutex);
-    return std::all_of(members.begin(), members.end(),
-                       [&address](const auto& member) { return member.fake_ip != address; });
+    return !peer_by_fake_ip.contains(FakeIPKey(address));
 }
 
 bool Room::RoomImpl::HasModPermission(const ENetPeer* client) const {
     std::lock_guard lock(member_mutex);
-    const auto sending_member =
-        std::find_if(members.begin(), members.end(),
-                     [client](const auto& member) { return member.peer == client; });
-    if (sending_member == members.end()) {
+    const Member* const sending_member = FindMember(client);
+    if (sending_member == nullptr) {
         return false;
     }
     if (room_information.enable_citron_mods &&
@@ -703,9 +802,9 @@ void Room::RoomImpl::SendModBanListResponse(ENetPeer* client) {
     Packet packet;
     packet.Write(static_cast<u8>(IdModBanListResponse));
     {
-        std::lock_guard lock(ban_list_mutex);
-        packet.Write(username_ban_list);
-        packet.Write(ip_ban_list);
+        std::lock_guard lock(ban_list->mutex);
+        packet.Write(ban_list->username_ban_list);
+        packet.Write(ban_list->ip_ban_list);
     }
 
     ENetPacket* enet_packet =
@@ -814,123 +913,90 @@ IPv4Address Room::RoomImpl::GenerateFakeIPAddress() {
 }
 
 void Room::RoomImpl::HandleProxyPacket(const ENetEvent* event) {
-    Packet in_packet;
-    in_packet.Append(event->packet->data, event->packet->dataLength);
-    in_packet.IgnoreBytes(sizeof(u8)); // Message type
-
-    in_packet.IgnoreBytes(sizeof(u8));          // Domain
-    in_packet.IgnoreBytes(sizeof(IPv4Address)); // IP
-    in_packet.IgnoreBytes(sizeof(u16));         // Port
-
-    in_packet.IgnoreBytes(sizeof(u8)); // Domain
-    IPv4Address remote_ip;
-    in_packet.Read(remote_ip);          // IP
-    in_packet.IgnoreBytes(sizeof(u16)); // Port
-
-    in_packet.IgnoreBytes(sizeof(u8)); // Protocol
-
-    bool broadcast;
-    in_packet.Read(broadcast); // Broadcast
-
-    bool reliable;
-    in_packet.Read(reliable); // Reliability flag
+    RelayPacket(event, ProxyPacketRemoteIPOffset, ProxyPacketBroadcastOffset);
+}
 
-    Packet out_packet;
-    out_packet.Append(event->packet->data, event->packet->dataLength);
-    const u32 enet_flags = reliable ? ENET_PACKET_FLAG_RELIABLE : ENET_PACKET_FLAG_UNSEQUENCED;
-    ENetPacket* enet_packet = enet_packet_create(out_packet.GetData(), out_packet.GetDataSize(),
-                                                 enet_flags);
+void Room::RoomImpl::HandleLdnPacket(const ENetEvent* event) {
+    RelayPacket(event, LdnPacketRemoteIPOffset, LdnPacketBroadcastOffset);
+}
 
-    const auto& destination_address = remote_ip;
+void Room::RoomImpl::RelayPacket(const ENetEvent* event, std::size_t remote_ip_offset,
+                                 std::size_t broadcast_offset) {
+    ENetPacket* const enet_packet = event->packet;
+    ++pending_relay_statistics.packets_received;
+    pending_relay_statistics.bytes_received += enet_packet->dataLength;
+
+    // The reliability flag directly follows the broadcast flag
+    if (enet_packet->dataLength < broadcast_offset + 2) {
+        LOG_ERROR(Network, "Received truncated relay packet of {} bytes",
+                  enet_packet->dataLength);
+        ++pending_relay_statistics.packets_dropped;
+        return;
+    }
+    IPv4Address destination_address;
+    std::memcpy(destination_address.data(), enet_packet->data + remote_ip_offset,
+                destination_address.size());
+    const bool broadcast = enet_packet->data[broadcast_offset] != 0;
+    const bool reliable = enet_packet->data[broadcast_offset + 1] != 0;
+
+    // Forward the received packet itself, ENet keeps it alive until every peer has sent it
+    enet_packet->flags = reliable ? ENET_PACKET_FLAG_RELIABLE : ENET_PACKET_FLAG_UNSEQUENCED;
+
+    u64 num_sent = 0;
+    std::shared_lock lock(member_mutex);
+    if (!member_index_by_peer.contains(event->peer)) {
+        // Peers that never joined, or were turned away because they are banned, stay connected
+        // until they disconnect themselves. Only members may send anything to the others.
+        LOG_DEBUG(Network, "Dropping relay packet from a peer that is not a member");
+        ++pending_relay_statistics.packets_dropped;
+        return;
+    }
     if (broadcast) { // Send the data to everyone except the sender
-        std::lock_guard lock(member_mutex);
-        bool sent_packet = false;
         for (const auto& member : members) {
-            if (member.peer != event->peer) {
-                sent_packet = true;
-                enet_peer_send(member.peer, 0, enet_packet);
+            if (member.peer != event->peer && enet_peer_send(member.peer, 0, enet_packet) == 0) {
+                ++num_sent;
             }
         }
-
-        if (!sent_packet) {
-            enet_packet_destroy(enet_packet);
-        }
     } else { // Send the data only to the destination client
-        std::lock_guard lock(member_mutex);
-        auto member = std::find_if(members.begin(), members.end(),
-                                   [destination_address](const Member& member_entry) -> bool {
-                                       return member_entry.fake_ip == destination_address;
-                                   });
-        if (member != members.end()) {
-            enet_peer_send(member->peer, 0, enet_packet);
+        const auto it = peer_by_fake_ip.find(FakeIPKey(destination_address));
+        if (it != peer_by_fake_ip.end()) {
+            if (enet_peer_send(it->second, 0, enet_packet) == 0) {
+                ++num_sent;
+            }
         } else {
             LOG_ERROR(Network,
                       "Attempting to send to unknown IP address: "
                       "{}.{}.{}.{}",
                       destination_address[0], destination_address[1], destination_address[2],
                       destination_address[3]);
-            enet_packet_destroy(enet_packet);
         }
     }
-    enet_host_flush(server);
-}
-
-void Room::RoomImpl::HandleLdnPacket(const ENetEvent* event) {
-    Packet in_packet;
-    in_packet.Append(event->packet->data, event->packet->dataLength);
-
-    in_packet.IgnoreBytes(sizeof(u8)); // Message type
 
-    in_packet.IgnoreBytes(sizeof(u8));          // LAN packet type
-    in_packet.IgnoreBytes(sizeof(IPv4Address)); // Local IP
-
-    IPv4Address remote_ip;
-    in_packet.Read(remote_ip); // Remote IP
-
-    bool broadcast;
-    in_packet.Read(broadcast); // Broadcast
-
-    bool reliable;
-    in_packet.Read(reliable); // Reliability flag
-
-    Packet out_packet;
-    out_packet.Append(event->packet->data, event->packet->dataLength);
-    const u32 enet_flags = reliable ? ENET_PACKET_FLAG_RELIABLE : ENET_PACKET_FLAG_UNSEQUENCED;
-    ENetPacket* enet_packet = enet_packet_create(out_packet.GetData(), out_packet.GetDataSize(),
-                                                 enet_flags);
-
-    const auto& destination_address = remote_ip;
-    if (broadcast) { // Send the data to everyone except the sender
-        std::lock_guard lock(member_mutex);
-        bool sent_packet = false;
-        for (const auto& member : members) {
-            if (member.peer != event->peer) {
-                sent_packet = true;
-                enet_peer_send(member.peer, 0, enet_packet);
-            }
-        }
+    if (num_sent == 0) {
+        ++pending_relay_statistics.packets_dropped;
+    }
+    pending_relay_statistics.packets_forwarded += num_sent;
+    pending_relay_statistics.bytes_forwarded += num_sent * enet_packet->dataLength;
+}
 
-        if (!sent_packet) {
-            enet_packet_destroy(enet_packet);
-        }
-    } else {
-        std::lock_guard lock(member_mutex);
-        auto member = std::find_if(members.begin(), members.end(),
-                                   [destination_address](const Member& member_entry) -> bool {
-                                       return member_entry.fake_ip == destination_address;
-                                   });
-        if (member != members.end()) {
-            enet_peer_send(member->peer, 0, enet_packet);
-        } else {
-            LOG_ERROR(Network,
-                      "Attempting to send to unknown IP address: "
-                      "{}.{}.{}.{}",
-                      destination_address[0], destination_address[1], destination_address[2],
-                      destination_address[3]);
-            enet_packet_destroy(enet_packet);
-        }
+void Room::RoomImpl::CommitRelayStatistics(std::chrono::steady_clock::time_point iteration_start) {
+    RelayStatistics& pending = pending_relay_statistics;
+    if (pending.packets_received == 0) {
+        return;
     }
-    enet_host_flush(server);
+    const auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - iteration_start);
+
+    std::lock_guard lock(relay_statistics_mutex);
+    relay_statistics.packets_received += pending.packets_received;
+    relay_statistics.packets_forwarded += pending.packets_forwarded;
+    relay_statistics.packets_dropped += pending.packets_dropped;
+    relay_statistics.bytes_received += pending.bytes_received;
+    relay_statistics.bytes_forwarded += pending.bytes_forwarded;
+    relay_statistics.total_latency +=
+        latency * static_cast<s64>(pending.packets_received - pending.packets_dropped);
+    relay_statistics.max_latency = std::max(relay_statistics.max_latency, latency);
+    pending = {};
 }
 
 void Room::RoomImpl::HandleChatPacket(const ENetEvent* event) {
@@ -940,13 +1006,10 @@ void Room::RoomImpl::HandleChatPacket(const ENetEvent* event) {
     in_packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
     std::string message;
     in_packet.Read(message);
-    auto CompareNetworkAddress = [event](const Member member) -> bool {
-        return member.peer == event->peer;
-    };
 
     std::lock_guard lock(member_mutex);
-    const auto sending_member = std::find_if(members.begin(), members.end(), CompareNetworkAddress);
-    if (sending_member == members.end()) {
+    const Member* const sending_member = FindMember(event->peer);
+    if (sending_member == nullptr) {
         return; // Received a chat message from a unknown sender
     }
 
@@ -973,8 +1036,6 @@ void Room::RoomImpl::HandleChatPacket(const ENetEvent* event) {
         enet_packet_destroy(enet_packet);
     }
 
-    enet_host_flush(server);
-
     if (sending_member->user_data.username.empty()) {
         LOG_INFO(Network, "{}: {}", sending_member->nickname, message);
     } else {
@@ -995,11 +1056,8 @@ void Room::RoomImpl::HandleGameInfoPacket(const ENetEvent* event) {
 
     {
         std::lock_guard lock(member_mutex);
-        auto member = std::find_if(members.begin(), members.end(),
-                                   [event](const Member& member_entry) -> bool {
-                                       return member_entry.peer == event->peer;
-                                   });
-        if (member != members.end()) {
+        Member* const member = FindMember(event->peer);
+        if (member != nullptr) {
             member->game_info = game_info;
 
             const std::string display_name =
@@ -1023,11 +1081,8 @@ void Room::RoomImpl::HandleClientDisconnection(ENetPeer* client) {
     std::string nickname, username, ip;
     {
         std::lock_guard lock(member_mutex);
-        auto member =
-            std::find_if(members.begin(), members.end(), [client](const Member& member_entry) {
-                return member_entry.peer == client;
-            });
-        if (member != members.end()) {
+        const Member* const member = FindMember(client);
+        if (member != nullptr) {
             nickname = member->nickname;
             username = member->user_data.username;
 
@@ -1035,7 +1090,8 @@ void Room::RoomImpl::HandleClientDisconnection(ENetPeer* client) {
             enet_address_get_host_ip(&member->peer->address, ip_raw.data(), sizeof(ip_raw) - 1);
             ip = ip_raw.data();
 
-            members.erase(member);
+            members.erase(members.begin() + (member - members.data()));
+            RebuildMemberIndex();
         }
     }
 
@@ -1056,7 +1112,7 @@ bool Room::Create(const std::string& name, const std::string& description,
                   const u32 max_connections, const std::string& host_username,
                   const GameInfo preferred_game,
                   std::unique_ptr<VerifyUser::Backend> verify_backend,
-                  const Room::BanList& ban_list, bool enable_citron_mods) {
+                  const Room::BanList& ban_list, bool enable_citron_mods, bool start_thread) {
     ENetAddress address;
     address.host = ENET_HOST_ANY;
     if (!server_address.empty()) {
@@ -1081,13 +1137,70 @@ bool Room::Create(const std::string& name, const std::string& description,
     room_impl->room_information.enable_citron_mods = enable_citron_mods;
     room_impl->password = password;
     room_impl->verify_backend = std::move(verify_backend);
-    room_impl->username_ban_list = ban_list.first;
-    room_impl->ip_ban_list = ban_list.second;
+    {
+        std::lock_guard lock(room_impl->ban_list->mutex);
+        auto& username_ban_list = room_impl->ban_list->username_ban_list;
+        auto& ip_ban_list = room_impl->ban_list->ip_ban_list;
+        if (room_impl->has_shared_ban_list) {
+            // Other rooms may already have added to the shared lists, only add what is missing
+            for (const auto& username : ban_list.first) {
+                if (std::find(username_ban_list.begin(), username_ban_list.end(), username) ==
+                    username_ban_list.end()) {
+                    username_ban_list.push_back(username);
+                }
+            }
+            for (const auto& ip : ban_list.second) {
+                if (std::find(ip_ban_list.begin(), ip_ban_list.end(), ip) == ip_ban_list.end()) {
+                    ip_ban_list.push_back(ip);
+                }
+            }
+        } else {
+            username_ban_list = ban_list.first;
+            ip_ban_list = ban_list.second;
+        }
+    }
+    {
+        std::lock_guard lock(room_impl->relay_statistics_mutex);
+        room_impl->relay_statistics = {};
+    }
 
-    room_impl->StartLoop();
+    if (start_thread) {
+        room_impl->StartLoop();
+    }
     return true;
 }
 
+bool Room::Service() {
+    if (room_impl->state != State::Open) {
+        return false;
+    }
+    return room_impl->ServiceEvents(0);
+}
+
+bool Room::WaitForData(std::span<Room* const> rooms, u32 timeout_ms) {
+    ENetSocketSet read_set;
+    ENET_SOCKETSET_EMPTY(read_set);
+    std::optional<ENetSocket> max_socket;
+    for (const Room* const room : rooms) {
+        if (room->room_impl->state != State::Open) {
+            continue;
+        }
+        const ENetSocket socket = room->room_impl->server->socket;
+        ENET_SOCKETSET_ADD(read_set, socket);
+        max_socket = max_socket ? std::max(*max_socket, socket) : socket;
+    }
+    if (!max_socket) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{timeout_ms});
+        return false;
+    }
+    return enet_socketset_select(*max_socket, &read_set, nullptr, timeout_ms) > 0;
+}
+
+void Room::SetSharedBanList(std::shared_ptr<SharedBanList> ban_list) {
+    room_impl->ban_list = std::move(ban_list);
+    room_impl->has_shared_ban_list = true;
+}
+
 Room::State Room::GetState() const {
     return room_impl->state;
 }
@@ -1102,8 +1215,13 @@ std::string Room::GetVerifyUID() const {
 }
 
 Room::BanList Room::GetBanList() const {
-    std::lock_guard lock(room_impl->ban_list_mutex);
-    return {room_impl->username_ban_list, room_impl->ip_ban_list};
+    std::lock_guard lock(room_impl->ban_list->mutex);
+    return {room_impl->ban_list->username_ban_list, room_impl->ban_list->ip_ban_list};
+}
+
+RelayStatistics Room::GetRelayStatistics() const {
+    std::lock_guard lock(room_impl->relay_statistics_mutex);
+    return room_impl->relay_statistics;
 }
 
 std::vector<Member> Room::GetRoomMemberList() const {
@@ -1133,8 +1251,13 @@ void Room::SetVerifyUID(const std::string& uid) {
 
 void Room::Destroy() {
     room_impl->state = State::Closed;
-    room_impl->room_thread->join();
-    room_impl->room_thread.reset();
+    if (room_impl->room_thread) {
+        room_impl->room_thread->join();
+        room_impl->room_thread.reset();
+    } else if (room_impl->server) {
+        // Rooms serviced by their owner are closed from the calling thread
+        room_impl->SendCloseMessage();
+    }
 
     if (room_impl->server) {
         enet_host_destroy(room_impl->server);
@@ -1144,6 +1267,7 @@ void Room::Destroy() {
     {
         std::lock_guard lock(room_impl->member_mutex);
         room_impl->members.clear();
+        room_impl->RebuildMemberIndex();
     }
     room_impl->room_information.member_slots = 0;
     room_impl->room_information.name.clear();
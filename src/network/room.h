@@ -4,7 +4,10 @@
 #pragma once
 
 #include <array>
+#include <chrono>
 #include <memory>
+#include <mutex>
+#include <span>
 #include <string>
 #include <vector>
 #include "common/announce_multiplayer_room.h"
@@ -72,6 +75,19 @@ enum StatusMessageTypes : u8 {
     IdAddressUnbanned, ///< A username / ip address is unbanned from the room
 };
 
+/// Counters for the proxy and LDN packets relayed between the members of a room.
+struct RelayStatistics {
+    u64 packets_received{};  ///< Packets received from connected peers
+    u64 packets_forwarded{}; ///< Copies of those packets queued to other members
+    u64 packets_dropped{};   ///< Packets that were malformed, not sent by a member, or unroutable
+    u64 bytes_received{};
+    u64 bytes_forwarded{};
+    /// Summed time from the start of the service iteration that received a forwarded packet
+    /// until the packet was flushed to the network.
+    std::chrono::nanoseconds total_latency{};
+    std::chrono::nanoseconds max_latency{};
+};
+
 /// This is what a server [person creating a server] would use.
 class Room final {
 public:
@@ -113,9 +129,17 @@ public:
 
     using BanList = std::pair<UsernameBanList, IPBanList>;
 
+    /// Ban lists that several rooms can enforce together, so a ban in one applies to all.
+    struct SharedBanList {
+        std::mutex mutex;
+        UsernameBanList username_ban_list;
+        IPBanList ip_ban_list;
+    };
+
     /**
      * Creates the socket for this room. Will bind to default address if
-     * server is empty string.
+     * server is empty string. Without start_thread, the owner has to call Service regularly
+     * from a single thread instead.
      */
     bool Create(const std::string& name, const std::string& description = "",
                 const std::string& server = "", u16 server_port = DefaultRoomPort,
@@ -123,7 +147,26 @@ public:
                 const u32 max_connections = MaxConcurrentConnections,
                 const std::string& host_username = "", const GameInfo = {},
                 std::unique_ptr<VerifyUser::Backend> verify_backend = nullptr,
-                const BanList& ban_list = {}, bool enable_citron_mods = false);
+                const BanList& ban_list = {}, bool enable_citron_mods = false,
+                bool start_thread = true);
+
+    /**
+     * Handles all pending network events of a room created without its own thread. Does not
+     * block. Returns true if any event was handled.
+     */
+    bool Service();
+
+    /**
+     * Blocks until data arrives for any of the given rooms created without their own thread, or
+     * until timeout_ms have passed. Returns true if data arrived, which Service then handles.
+     */
+    static bool WaitForData(std::span<Room* const> rooms, u32 timeout_ms);
+
+    /**
+     * Makes the room enforce and update the given ban lists instead of its own. Must be called
+     * before Create, which then adds its ban list to the shared one.
+     */
+    void SetSharedBanList(std::shared_ptr<SharedBanList> ban_list);
 
     /**
      * Sets the verification GUID of the room.
@@ -135,6 +178,11 @@ public:
      */
     BanList GetBanList() const;
 
+    /**
+     * Gets the counters of the packets relayed by this room since it was created.
+     */
+    RelayStatistics GetRelayStatistics() const;
+
     /**
      * Destroys the socket
      */
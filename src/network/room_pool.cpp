@@ -0,0 +1,173 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <fmt/format.h>
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "common/thread.h"
+#include "enet/enet.h"
+#include "network/room_pool.h"
+
+namespace Network {
+
+/// Longest time a worker sleeps while none of its rooms has received anything
+constexpr u32 IdleTimeoutMs = 5;
+
+RoomPool::RoomPool(const Room::BanList& ban_list_)
+    : ban_list{std::make_shared<Room::SharedBanList>()} {
+    ban_list->username_ban_list = ban_list_.first;
+    ban_list->ip_ban_list = ban_list_.second;
+}
+
+RoomPool::~RoomPool() {
+    Stop();
+}
+
+bool RoomPool::AddRoom(const RoomConfig& config,
+                       std::unique_ptr<VerifyUser::Backend> verify_backend) {
+    ASSERT_MSG(workers.empty(), "Rooms can only be added while the pool is stopped");
+
+    auto room = std::make_shared<Room>();
+    room->SetSharedBanList(ban_list);
+    if (!room->Create(config.name, config.description, config.bind_address, config.port,
+                      config.password, config.max_members, config.host_username,
+                      config.preferred_game, std::move(verify_backend), {},
+                      config.enable_citron_mods, false)) {
+        LOG_ERROR(Network, "Failed to create room {} on port {}", config.name, config.port);
+        return false;
+    }
+    rooms.push_back(PooledRoom{
+        .room = std::move(room),
+        .last_statistics = {},
+        .last_dump = std::chrono::steady_clock::now(),
+    });
+    return true;
+}
+
+void RoomPool::Start(u32 num_workers) {
+    ASSERT_MSG(workers.empty(), "Room pool is already running");
+    if (rooms.empty()) {
+        return;
+    }
+    num_workers = std::clamp<u32>(num_workers, 1, static_cast<u32>(rooms.size()));
+    LOG_INFO(Network, "Hosting {} rooms on {} worker threads", rooms.size(), num_workers);
+    for (u32 i = 0; i < num_workers; ++i) {
+        workers.emplace_back([this, i, num_workers](std::stop_token stop_token) {
+            WorkerLoop(stop_token, i, num_workers);
+        });
+    }
+}
+
+void RoomPool::Stop() {
+    status_thread = {};
+    workers.clear();
+    for (const PooledRoom& pooled_room : rooms) {
+        if (pooled_room.room->GetState() == Room::State::Open) {
+            pooled_room.room->Destroy();
+        }
+    }
+}
+
+std::vector<std::weak_ptr<Room>> RoomPool::GetRooms() const {
+    std::vector<std::weak_ptr<Room>> result;
+    result.reserve(rooms.size());
+    for (const PooledRoom& pooled_room : rooms) {
+        result.push_back(pooled_room.room);
+    }
+    return result;
+}
+
+Room::BanList RoomPool::GetBanList() const {
+    std::lock_guard lock(ban_list->mutex);
+    return {ban_list->username_ban_list, ban_list->ip_ban_list};
+}
+
+std::string RoomPool::DumpMetrics() {
+    std::lock_guard lock(metrics_mutex);
+    const auto now = std::chrono::steady_clock::now();
+    std::string result;
+    for (PooledRoom& pooled_room : rooms) {
+        const Room& room = *pooled_room.room;
+        const RoomInformation information = room.GetRoomInformation();
+        const RelayStatistics statistics = room.GetRelayStatistics();
+        const RelayStatistics& last = pooled_room.last_statistics;
+        const std::chrono::duration<double> elapsed = now - pooled_room.last_dump;
+        const double seconds = std::max(elapsed.count(), 1e-3);
+
+        result += fmt::format(
+            "{} \"{}\" members={}/{} packets/s={:.1f} bytes/s={:.1f} dropped={}\n",
+            information.port, information.name, room.GetRoomMemberList().size(),
+            information.member_slots,
+            static_cast<double>(statistics.packets_forwarded - last.packets_forwarded) / seconds,
+            static_cast<double>(statistics.bytes_forwarded - last.bytes_forwarded) / seconds,
+            statistics.packets_dropped - last.packets_dropped);
+
+        pooled_room.last_statistics = statistics;
+        pooled_room.last_dump = now;
+    }
+    return result;
+}
+
+bool RoomPool::StartStatusServer(u16 port) {
+    ENetAddress address{};
+    enet_address_set_host_ip(&address, "127.0.0.1");
+    address.port = port;
+
+    const ENetSocket status_socket = enet_socket_create(ENET_SOCKET_TYPE_STREAM);
+    if (status_socket == ENET_SOCKET_NULL) {
+        LOG_ERROR(Network, "Could not create the status socket");
+        return false;
+    }
+    enet_socket_set_option(status_socket, ENET_SOCKOPT_REUSEADDR, 1);
+    if (enet_socket_bind(status_socket, &address) < 0 || enet_socket_listen(status_socket, 4) < 0) {
+        LOG_ERROR(Network, "Could not listen for status requests on port {}", port);
+        enet_socket_destroy(status_socket);
+        return false;
+    }
+    LOG_INFO(Network, "Serving room metrics on 127.0.0.1:{}", port);
+
+    status_thread = std::jthread([this, status_socket](std::stop_token stop_token) {
+        Common::SetCurrentThreadName("RoomPoolStatus");
+        while (!stop_token.stop_requested()) {
+            enet_uint32 condition = ENET_SOCKET_WAIT_RECEIVE;
+            if (enet_socket_wait(status_socket, &condition, 100) < 0 ||
+                !(condition & ENET_SOCKET_WAIT_RECEIVE)) {
+                continue;
+            }
+            const ENetSocket client = enet_socket_accept(status_socket, nullptr);
+            if (client == ENET_SOCKET_NULL) {
+                continue;
+            }
+            std::string metrics = DumpMetrics();
+            ENetBuffer buffer{};
+            buffer.data = metrics.data();
+            buffer.dataLength = metrics.size();
+            enet_socket_send(client, nullptr, &buffer, 1);
+            enet_socket_destroy(client);
+        }
+        enet_socket_destroy(status_socket);
+    });
+    return true;
+}
+
+void RoomPool::WorkerLoop(std::stop_token stop_token, u32 worker_index, u32 num_workers) {
+    Common::SetCurrentThreadName(fmt::format("RoomPool:{}", worker_index).c_str());
+    std::vector<Room*> worker_rooms;
+    for (std::size_t i = worker_index; i < rooms.size(); i += num_workers) {
+        worker_rooms.push_back(rooms[i].room.get());
+    }
+    while (!stop_token.stop_requested()) {
+        bool handled = false;
+        for (Room* const room : worker_rooms) {
+            handled |= room->Service();
+        }
+        if (!handled) {
+            // Sleep until a packet arrives for one of this worker's rooms. The timeout keeps
+            // ENet's resends and timeouts going, like the service timeout of a room's own thread.
+            Room::WaitForData(worker_rooms, IdleTimeoutMs);
+        }
+    }
+}
+
+} // namespace Network
@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "common/common_types.h"
+#include "common/polyfill_thread.h"
+#include "network/room.h"
+
+namespace Network {
+
+/**
+ * Hosts several rooms in one process. The rooms are serviced by a fixed number of worker threads
+ * instead of a thread each and enforce a single ban list, so a ban in one room applies to all.
+ */
+class RoomPool final {
+public:
+    /// Settings of a room hosted by the pool, see Room::Create
+    struct RoomConfig {
+        std::string name;
+        std::string description;
+        std::string bind_address;
+        u16 port = DefaultRoomPort;
+        std::string password;
+        u32 max_members = MaxConcurrentConnections;
+        std::string host_username;
+        GameInfo preferred_game;
+        bool enable_citron_mods = false;
+    };
+
+    explicit RoomPool(const Room::BanList& ban_list = {});
+    ~RoomPool();
+
+    RoomPool(const RoomPool&) = delete;
+    RoomPool& operator=(const RoomPool&) = delete;
+
+    /**
+     * Creates a room with the given settings. Rooms can only be added while the pool is stopped.
+     * @return Whether the room could be created
+     */
+    bool AddRoom(const RoomConfig& config, std::unique_ptr<VerifyUser::Backend> verify_backend);
+
+    /// Starts servicing the rooms on num_workers threads
+    void Start(u32 num_workers);
+
+    /// Stops the worker threads and the status server, then closes all rooms.
+    void Stop();
+
+    /// Returns the rooms hosted by the pool
+    std::vector<std::weak_ptr<Room>> GetRooms() const;
+
+    /// Returns the ban list shared by all rooms
+    Room::BanList GetBanList() const;
+
+    /**
+     * Returns one line per room with its members, packets and bytes forwarded per second since
+     * the previous dump.
+     */
+    std::string DumpMetrics();
+
+    /**
+     * Listens on localhost at the given TCP port and answers every connection with DumpMetrics.
+     * @return Whether the socket could be opened
+     */
+    bool StartStatusServer(u16 port);
+
+private:
+    struct PooledRoom {
+        std::shared_ptr<Room> room;
+        RelayStatistics last_statistics;
+        std::chrono::steady_clock::time_point last_dump;
+    };
+
+    void WorkerLoop(std::stop_token stop_token, u32 worker_index, u32 num_workers);
+
+    std::shared_ptr<Room::SharedBanList> ban_list;
+    std::vector<PooledRoom> rooms;
+    std::mutex metrics_mutex; ///< Protects the last statistics of the rooms
+
+    std::vector<std::jthread> workers;
+    std::jthread status_thread;
+};
+
+} // namespace Network
@@ -0,0 +1,858 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <new>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "common/cityhash.h"
+#include "common/common_types.h"
+#include "common/container_hash.h"
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+#include "common/fs/path_util.h"
+#include "common/logging/backend.h"
+#include "common/logging/log.h"
+#include "common/scm_rev.h"
+#include "common/scope_exit.h"
+#include "common/string_util.h"
+#include "common/thread_worker.h"
+#include "shader_recompiler/arena.h"
+#include "shader_recompiler/backend/bindings.h"
+#include "shader_recompiler/backend/glasm/emit_glasm.h"
+#include "shader_recompiler/backend/glsl/emit_glsl.h"
+#include "shader_recompiler/backend/spirv/emit_spirv.h"
+#include "shader_recompiler/exception.h"
+#include "shader_recompiler/frontend/ir/program.h"
+#include "shader_recompiler/frontend/maxwell/control_flow.h"
+#include "shader_recompiler/frontend/maxwell/translate_program.h"
+#include "shader_recompiler/host_translate_info.h"
+#include "shader_recompiler/object_pool.h"
+#include "shader_recompiler/profile.h"
+#include "shader_recompiler/program_header.h"
+#include "shader_recompiler/runtime_info.h"
+#include "video_core/renderer_opengl/gl_shader_cache.h"
+#include "video_core/renderer_vulkan/vk_pipeline_cache.h"
+#include "video_core/shader_environment.h"
+
+#undef _UNICODE
+#include <getopt.h>
+#ifndef _MSC_VER
+#include <unistd.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Maxwell = Tegra::Engines::Maxwell3D::Regs;
+using VideoCommon::FileEnvironment;
+
+/// Pipeline caches store the keys of the renderer that wrote them
+enum class CacheType {
+    Vulkan,
+    OpenGL,
+};
+
+enum class Backend {
+    SPIRV,
+    GLSL,
+    GLASM,
+};
+
+/// Storage buffers a GLASM stage can bind before it falls back to global memory, the value
+/// reported by desktop drivers for GL_MAX_VERTEX_SHADER_STORAGE_BLOCKS
+constexpr u32 GLASM_STORAGE_BUFFER_LIMIT = 16;
+
+constexpr std::array<std::string_view, Maxwell::MaxShaderProgram> STAGE_NAMES{
+    "vertex_a", "vertex_b", "tess_control", "tess_eval", "geometry", "fragment",
+};
+
+/// Heap allocations made by the current thread, to report the allocations of each pipeline
+thread_local size_t num_allocations{};
+
+struct Options {
+    std::filesystem::path cache_path;
+    CacheType cache_type{};
+    Backend backend{};
+    size_t num_threads{};
+    std::filesystem::path output_dir;
+    std::filesystem::path hashes_path;
+    std::filesystem::path compare_path;
+    std::filesystem::path report_path;
+};
+
+struct ShaderPools {
+    void ReleaseContents() {
+        flow_block.ReleaseContents();
+        block.ReleaseContents();
+        inst.ReleaseContents();
+        arena.ReleaseContents();
+    }
+
+    Shader::ObjectPool<Shader::IR::Inst> inst{8192};
+    Shader::ObjectPool<Shader::IR::Block> block{32};
+    Shader::ObjectPool<Shader::Maxwell::Flow::Block> flow_block{32};
+    Shader::Arena arena;
+};
+
+struct EmittedStage {
+    std::string_view name;
+    std::vector<u8> code;
+};
+
+/// Everything measured while recompiling a single pipeline
+struct PipelineResult {
+    u64 key_hash{};
+    bool is_compute{};
+    bool failed{};
+    Clock::duration cfg_time{};
+    Clock::duration translate_time{};
+    Clock::duration emit_time{};
+    size_t num_blocks{};
+    size_t num_insts{};
+    size_t code_size{};
+    size_t num_allocations{};
+    u64 code_hash{};
+    std::vector<EmittedStage> stages;
+};
+
+/// A pipeline read from the cache, recompiled later on a worker thread
+struct PipelineJob {
+    u64 key_hash{};
+    bool is_compute{};
+    Vulkan::ComputePipelineCacheKey vk_compute_key{};
+    Vulkan::GraphicsPipelineCacheKey vk_graphics_key{};
+    OpenGL::ComputePipelineKey gl_compute_key{};
+    OpenGL::GraphicsPipelineKey gl_graphics_key{};
+    std::vector<std::shared_ptr<FileEnvironment>> envs;
+};
+
+void PrintHelp(const char* argv0) {
+    std::cout << "Usage: " << argv0
+              << " [options] <pipeline cache>\n"
+                 "Recompiles every pipeline of a vulkan.bin or opengl.bin shader cache without a "
+                 "GPU and reports\nthe time spent in each phase of the shader recompiler.\n\n"
+                 "--backend      spirv, glsl or glasm. Vulkan caches only support spirv\n"
+                 "--threads      The number of threads recompiling pipelines\n"
+                 "--output       Write the emitted code of every stage to this directory\n"
+                 "--hashes       Write the hash of the code emitted for every pipeline to this "
+                 "file\n"
+                 "--compare      Compare the emitted code against a file written by --hashes\n"
+                 "--report       Write the results as JSON to this file, - for stdout\n"
+                 "-h, --help     Display this help and exit\n"
+                 "-v, --version  Output version information and exit\n";
+}
+
+void PrintVersion() {
+    std::cout << "citron-shader-bench " << Common::g_scm_branch << " " << Common::g_scm_desc
+              << std::endl;
+}
+
+std::optional<Backend> ParseBackend(std::string_view name) {
+    const std::string lower{Common::ToLower(std::string{name})};
+    if (lower == "spirv") {
+        return Backend::SPIRV;
+    }
+    if (lower == "glsl") {
+        return Backend::GLSL;
+    }
+    if (lower == "glasm") {
+        return Backend::GLASM;
+    }
+    return std::nullopt;
+}
+
+std::string_view BackendName(Backend backend) {
+    switch (backend) {
+    case Backend::SPIRV:
+        return "spirv";
+    case Backend::GLSL:
+        return "glsl";
+    case Backend::GLASM:
+        return "glasm";
+    }
+    return "unknown";
+}
+
+/// A desktop GPU that supports every feature the recompiler can take advantage of, so that the
+/// emitted code does not depend on the machine running the tool
+Shader::Profile MakeProfile(CacheType cache_type) {
+    if (cache_type == CacheType::Vulkan) {
+        return Shader::Profile{
+            .supported_spirv = 0x00010600,
+            .unified_descriptor_binding = true,
+            .support_descriptor_aliasing = true,
+            .support_int8 = true,
+            .support_int16 = true,
+            .support_int64 = true,
+            .support_vertex_instance_id = false,
+            .support_float_controls = true,
+            .support_separate_denorm_behavior = true,
+            .support_separate_rounding_mode = true,
+            .support_fp16_denorm_preserve = true,
+            .support_fp32_denorm_preserve = true,
+            .support_fp16_denorm_flush = true,
+            .support_fp32_denorm_flush = true,
+            .support_fp16_signed_zero_nan_preserve = true,
+            .support_fp32_signed_zero_nan_preserve = true,
+            .support_fp64_signed_zero_nan_preserve = true,
+            .support_explicit_workgroup_layout = true,
+            .support_vote = true,
+            .support_viewport_index_layer_non_geometry = true,
+            .support_viewport_mask = false,
+            .support_typeless_image_loads = true,
+            .support_demote_to_helper_invocation = true,
+            .support_int64_atomics = true,
+            .support_derivative_control = true,
+            .support_geometry_shader_passthrough = false,
+            .support_native_ndc = true,
+            .support_scaled_attributes = true,
+            .support_multi_viewport = true,
+            .support_geometry_streams = true,
+            .warp_size_potentially_larger_than_guest = false,
+            .lower_left_origin_mode = false,
+            .need_declared_frag_colors = false,
+            .need_gather_subpixel_offset = false,
+            .min_ssbo_alignment = 16,
+            .max_user_clip_distances = 8,
+        };
+    }
+    return Shader::Profile{
+        .supported_spirv = 0x00010000,
+        .support_int64 = true,
+        .support_vertex_instance_id = true,
+        .support_vote = true,
+        .support_viewport_index_layer_non_geometry = true,
+        .support_viewport_mask = false,
+        .support_typeless_image_loads = true,
+        .support_derivative_control = true,
+        .support_geometry_shader_passthrough = false,
+        .support_native_ndc = true,
+        .support_gl_nv_gpu_shader_5 = false,
+        .support_gl_amd_gpu_shader_half_float = false,
+        .support_gl_texture_shadow_lod = true,
+        .support_gl_warp_intrinsics = false,
+        .support_gl_variable_aoffi = true,
+        .support_gl_sparse_textures = true,
+        .support_gl_derivative_control = true,
+        .support_geometry_streams = true,
+        .warp_size_potentially_larger_than_guest = false,
+        .lower_left_origin_mode = true,
+        .need_declared_frag_colors = true,
+        .has_broken_spirv_clamp = true,
+        .has_broken_unsigned_image_offsets = true,
+        .has_broken_signed_operations = true,
+        .ignore_nan_fp_comparisons = true,
+        .gl_max_compute_smem_size = 48 * 1024,
+        .min_ssbo_alignment = 16,
+        .max_user_clip_distances = 8,
+    };
+}
+
+Shader::HostTranslateInfo MakeHostInfo(CacheType cache_type) {
+    return Shader::HostTranslateInfo{
+        .support_float64 = true,
+        .support_float16 = cache_type == CacheType::Vulkan,
+        .support_int64 = true,
+        .needs_demote_reorder = false,
+        .support_snorm_render_buffer = cache_type == CacheType::Vulkan,
+        .support_viewport_index_layer = true,
+        .min_ssbo_alignment = 16,
+        .support_geometry_shader_passthrough = false,
+        .support_conditional_barrier = true,
+    };
+}
+
+template <typename T>
+std::vector<u8> ToBytes(const T& code) {
+    const auto bytes{std::as_bytes(std::span(code))};
+    std::vector<u8> result(bytes.size());
+    std::memcpy(result.data(), bytes.data(), bytes.size());
+    return result;
+}
+
+size_t CountInstructions(const Shader::IR::Program& program) {
+    size_t count{};
+    for (const Shader::IR::Block* const block : program.blocks) {
+        count += block->Instructions().size();
+    }
+    return count;
+}
+
+class Recompiler {
+public:
+    explicit Recompiler(const Options& options)
+        : cache_type{options.cache_type}, backend{options.backend},
+          profile{MakeProfile(options.cache_type)}, host_info{MakeHostInfo(options.cache_type)} {}
+
+    PipelineResult Recompile(ShaderPools& pools, PipelineJob& job) const try {
+        const size_t allocations_begin{num_allocations};
+        PipelineResult result{
+            .key_hash = job.key_hash,
+            .is_compute = job.is_compute,
+        };
+        pools.ReleaseContents();
+        if (job.is_compute) {
+            RecompileCompute(pools, *job.envs.front(), result);
+        } else {
+            RecompileGraphics(pools, job, result);
+        }
+        size_t code_hash{};
+        for (const EmittedStage& stage : result.stages) {
+            result.code_size += stage.code.size();
+            Common::HashCombine(code_hash,
+                                Common::CityHash64(reinterpret_cast<const char*>(stage.code.data()),
+                                                   stage.code.size()));
+        }
+        result.code_hash = code_hash;
+        result.num_allocations = num_allocations - allocations_begin;
+        return result;
+    } catch (const Shader::Exception& exception) {
+        LOG_ERROR(Frontend, "Failed to recompile pipeline {:016x}: {}", job.key_hash,
+                  exception.what());
+        return PipelineResult{
+            .key_hash = job.key_hash,
+            .is_compute = job.is_compute,
+            .failed = true,
+        };
+    }
+
+private:
+    void RecompileCompute(ShaderPools& pools, Shader::Environment& env,
+                          PipelineResult& result) const {
+        const auto cfg_start{Clock::now()};
+        Shader::Maxwell::Flow::CFG cfg{env, pools.flow_block, env.StartAddress()};
+        const auto translate_start{Clock::now()};
+        auto program{Shader::Maxwell::TranslateProgram(pools.inst, pools.block, pools.arena, env,
+                                                       cfg, host_info)};
+        const auto emit_start{Clock::now()};
+        Shader::RuntimeInfo info;
+        info.glasm_use_storage_buffers =
+            Shader::NumDescriptors(program.info.storage_buffers_descriptors) <=
+            GLASM_STORAGE_BUFFER_LIMIT;
+        std::vector<u8> code;
+        switch (backend) {
+        case Backend::SPIRV:
+            code = ToBytes(Shader::Backend::SPIRV::EmitSPIRV(profile, program));
+            break;
+        case Backend::GLSL:
+            code = ToBytes(Shader::Backend::GLSL::EmitGLSL(profile, program));
+            break;
+        case Backend::GLASM:
+            code = ToBytes(Shader::Backend::GLASM::EmitGLASM(profile, info, program));
+            break;
+        }
+        const auto emit_end{Clock::now()};
+
+        result.cfg_time = translate_start - cfg_start;
+        result.translate_time = emit_start - translate_start;
+        result.emit_time = emit_end - emit_start;
+        result.num_blocks = program.blocks.size();
+        result.num_insts = CountInstructions(program);
+        result.stages.push_back(EmittedStage{"compute", std::move(code)});
+    }
+
+    /// Mirrors the translation done by the pipeline caches when they build a graphics pipeline
+    void RecompileGraphics(ShaderPools& pools, PipelineJob& job, PipelineResult& result) const {
+        const auto& unique_hashes{cache_type == CacheType::Vulkan
+                                      ? job.vk_graphics_key.unique_hashes
+                                      : job.gl_graphics_key.unique_hashes};
+        std::array<Shader::IR::Program, Maxwell::MaxShaderProgram> programs;
+        const bool uses_vertex_a{unique_hashes[0] != 0};
+        const bool uses_vertex_b{unique_hashes[1] != 0};
+        u32 total_storage_buffers{};
+        size_t env_index{};
+        for (size_t index = 0; index < Maxwell::MaxShaderProgram; ++index) {
+            if (unique_hashes[index] == 0) {
+                continue;
+            }
+            Shader::Environment& env{*job.envs[env_index]};
+            ++env_index;
+
+            const auto cfg_start{Clock::now()};
+            const u32 cfg_offset{
+                static_cast<u32>(env.StartAddress() + sizeof(Shader::ProgramHeader))};
+            Shader::Maxwell::Flow::CFG cfg(env, pools.flow_block, cfg_offset, index == 0);
+            const auto translate_start{Clock::now()};
+            auto program{Shader::Maxwell::TranslateProgram(pools.inst, pools.block, pools.arena,
+                                                           env, cfg, host_info)};
+            total_storage_buffers +=
+                Shader::NumDescriptors(program.info.storage_buffers_descriptors);
+            if (uses_vertex_a && index == 1) {
+                programs[index] =
+                    Shader::Maxwell::MergeDualVertexPrograms(programs[0], program, env);
+            } else {
+                programs[index] = std::move(program);
+            }
+            result.cfg_time += translate_start - cfg_start;
+            result.translate_time += Clock::now() - translate_start;
+        }
+
+        const Shader::IR::Program* previous_program{};
+        Shader::Backend::Bindings binding;
+        for (size_t index = uses_vertex_a && uses_vertex_b ? 1 : 0;
+             index < Maxwell::MaxShaderProgram; ++index) {
+            if (unique_hashes[index] == 0) {
+                continue;
+            }
+            Shader::IR::Program& program{programs[index]};
+            result.num_blocks += program.blocks.size();
+            result.num_insts += CountInstructions(program);
+
+            const auto emit_start{Clock::now()};
+            const Shader::RuntimeInfo runtime_info{
+                cache_type == CacheType::Vulkan
+                    ? Vulkan::MakeRuntimeInfo(programs, job.vk_graphics_key, program,
+                                              previous_program)
+                    : OpenGL::MakeRuntimeInfo(job.gl_graphics_key, program, previous_program,
+                                              total_storage_buffers <= GLASM_STORAGE_BUFFER_LIMIT,
+                                              backend == Backend::GLASM)};
+            std::vector<u8> code;
+            switch (backend) {
+            case Backend::SPIRV:
+                Shader::Maxwell::ConvertLegacyToGeneric(program, runtime_info);
+                code = ToBytes(
+                    Shader::Backend::SPIRV::EmitSPIRV(profile, runtime_info, program, binding));
+                break;
+            case Backend::GLSL:
+                Shader::Maxwell::ConvertLegacyToGeneric(program, runtime_info);
+                code = ToBytes(
+                    Shader::Backend::GLSL::EmitGLSL(profile, runtime_info, program, binding));
+                break;
+            case Backend::GLASM:
+                code = ToBytes(
+                    Shader::Backend::GLASM::EmitGLASM(profile, runtime_info, program, binding));
+                break;
+            }
+            result.emit_time += Clock::now() - emit_start;
+            result.stages.push_back(EmittedStage{STAGE_NAMES[index], std::move(code)});
+            previous_program = &program;
+        }
+    }
+
+    CacheType cache_type;
+    Backend backend;
+    Shader::Profile profile;
+    Shader::HostTranslateInfo host_info;
+};
+
+/// Reads the pipelines of a cache. LoadPipelines deletes caches it can not use and migrates old
+/// ones in place, so a temporary copy is loaded instead of the file itself.
+std::optional<std::vector<PipelineJob>> LoadJobs(const Options& options) {
+    std::error_code ec;
+    const auto temp_path{std::filesystem::temp_directory_path(ec) /
+                         fmt::format("citron-shader-bench-{:016x}.bin",
+                                     Clock::now().time_since_epoch().count())};
+    if (ec || !std::filesystem::copy_file(options.cache_path, temp_path, ec)) {
+        LOG_CRITICAL(Frontend, "Failed to copy {} to a temporary file: {}",
+                     Common::FS::PathToUTF8String(options.cache_path), ec.message());
+        return std::nullopt;
+    }
+    SCOPE_EXIT {
+        Common::FS::RemoveFile(temp_path);
+    };
+
+    std::vector<PipelineJob> jobs;
+    if (options.cache_type == CacheType::Vulkan) {
+        VideoCommon::LoadPipelines<Vulkan::ComputePipelineCacheKey,
+                                   Vulkan::GraphicsPipelineCacheKey>(
+            {}, temp_path, Vulkan::CACHE_VERSION,
+            [&](const Vulkan::ComputePipelineCacheKey& key, std::shared_ptr<FileEnvironment> env) {
+                PipelineJob& job{jobs.emplace_back()};
+                job.key_hash = key.Hash();
+                job.is_compute = true;
+                job.vk_compute_key = key;
+                job.envs.push_back(std::move(env));
+            },
+            [&](const Vulkan::GraphicsPipelineCacheKey& key,
+                std::vector<std::shared_ptr<FileEnvironment>> envs) {
+                PipelineJob& job{jobs.emplace_back()};
+                job.key_hash = key.Hash();
+                job.vk_graphics_key = key;
+                job.envs = std::move(envs);
+            });
+    } else {
+        VideoCommon::LoadPipelines<OpenGL::ComputePipelineKey, OpenGL::GraphicsPipelineKey>(
+            {}, temp_path, OpenGL::CACHE_VERSION,
+            [&](const OpenGL::ComputePipelineKey& key, std::shared_ptr<FileEnvironment> env) {
+                PipelineJob& job{jobs.emplace_back()};
+                job.key_hash = key.Hash();
+                job.is_compute = true;
+                job.gl_compute_key = key;
+                job.envs.push_back(std::move(env));
+            },
+            [&](const OpenGL::GraphicsPipelineKey& key,
+                std::vector<std::shared_ptr<FileEnvironment>> envs) {
+                PipelineJob& job{jobs.emplace_back()};
+                job.key_hash = key.Hash();
+                job.gl_graphics_key = key;
+                job.envs = std::move(envs);
+            });
+    }
+    if (!Common::FS::Exists(temp_path)) {
+        LOG_CRITICAL(Frontend, "{} is not a pipeline cache of version {}",
+                     Common::FS::PathToUTF8String(options.cache_path),
+                     options.cache_type == CacheType::Vulkan ? Vulkan::CACHE_VERSION
+                                                             : OpenGL::CACHE_VERSION);
+        return std::nullopt;
+    }
+    return jobs;
+}
+
+bool WriteStages(const std::filesystem::path& output_dir, Backend backend,
+                 const PipelineResult& result) {
+    const std::string_view extension{backend == Backend::SPIRV  ? "spv"
+                                     : backend == Backend::GLSL ? "glsl"
+                                                                : "glasm"};
+    for (const EmittedStage& stage : result.stages) {
+        const auto path{output_dir /
+                        fmt::format("{:016x}.{}.{}", result.key_hash, stage.name, extension)};
+        Common::FS::IOFile file{path, Common::FS::FileAccessMode::Write,
+                                Common::FS::FileType::BinaryFile};
+        if (file.WriteSpan(std::span(stage.code)) != stage.code.size()) {
+            LOG_ERROR(Frontend, "Failed to write {}", Common::FS::PathToUTF8String(path));
+            return false;
+        }
+    }
+    return true;
+}
+
+/// The hash file has one line per pipeline, with its key hash and the hash of its emitted code
+std::string FormatHashes(std::span<const PipelineResult> results) {
+    std::string text;
+    for (const PipelineResult& result : results) {
+        text += fmt::format("{:016x} {:016x}\n", result.key_hash, result.code_hash);
+    }
+    return text;
+}
+
+std::optional<std::map<u64, u64>> ReadHashes(const std::filesystem::path& path) {
+    const std::string text{Common::FS::ReadStringFromFile(path, Common::FS::FileType::TextFile)};
+    if (text.empty()) {
+        return std::nullopt;
+    }
+    std::vector<std::string> lines;
+    Common::SplitString(text, '\n', lines);
+    std::map<u64, u64> hashes;
+    for (const std::string& line : lines) {
+        if (line.empty()) {
+            continue;
+        }
+        const size_t separator{line.find(' ')};
+        if (separator == std::string::npos) {
+            return std::nullopt;
+        }
+        hashes.emplace(std::strtoull(line.substr(0, separator).c_str(), nullptr, 16),
+                       std::strtoull(line.substr(separator + 1).c_str(), nullptr, 16));
+    }
+    return hashes;
+}
+
+/// Returns the number of pipelines whose emitted code differs from the reference
+size_t CompareHashes(const std::map<u64, u64>& reference,
+                     std::span<const PipelineResult> results) {
+    size_t num_mismatches{};
+    for (const PipelineResult& result : results) {
+        const auto it{reference.find(result.key_hash)};
+        if (it == reference.end()) {
+            LOG_WARNING(Frontend, "Pipeline {:016x} is missing from the reference",
+                        result.key_hash);
+            ++num_mismatches;
+        } else if (it->second != result.code_hash) {
+            LOG_ERROR(Frontend, "Pipeline {:016x} emitted {:016x}, expected {:016x}",
+                      result.key_hash, result.code_hash, it->second);
+            ++num_mismatches;
+        }
+    }
+    if (reference.size() > results.size()) {
+        LOG_WARNING(Frontend, "{} pipelines of the reference are not in the cache",
+                    reference.size() - results.size());
+    }
+    return num_mismatches;
+}
+
+double ToMilliseconds(Clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+struct Summary {
+    size_t num_pipelines{};
+    size_t num_compute{};
+    size_t num_failed{};
+    Clock::duration cfg_time{};
+    Clock::duration translate_time{};
+    Clock::duration emit_time{};
+    size_t num_blocks{};
+    size_t num_insts{};
+    size_t max_insts{};
+    size_t code_size{};
+    size_t num_allocations{};
+};
+
+Summary Summarize(std::span<const PipelineResult> results) {
+    Summary summary{};
+    summary.num_pipelines = results.size();
+    for (const PipelineResult& result : results) {
+        summary.num_compute += result.is_compute ? 1 : 0;
+        summary.num_failed += result.failed ? 1 : 0;
+        summary.cfg_time += result.cfg_time;
+        summary.translate_time += result.translate_time;
+        summary.emit_time += result.emit_time;
+        summary.num_blocks += result.num_blocks;
+        summary.num_insts += result.num_insts;
+        summary.max_insts = std::max(summary.max_insts, result.num_insts);
+        summary.code_size += result.code_size;
+        summary.num_allocations += result.num_allocations;
+    }
+    return summary;
+}
+
+std::string FormatReport(const Options& options, const Summary& summary, size_t num_threads,
+                         Clock::duration load_time, Clock::duration wall_time) {
+    const double seconds{std::chrono::duration<double>(wall_time).count()};
+    return fmt::format("{{\n"
+                       "  \"cache\": \"{}\",\n"
+                       "  \"backend\": \"{}\",\n"
+                       "  \"threads\": {},\n"
+                       "  \"pipelines\": {},\n"
+                       "  \"compute_pipelines\": {},\n"
+                       "  \"failed_pipelines\": {},\n"
+                       "  \"load_ms\": {:.3f},\n"
+                       "  \"wall_ms\": {:.3f},\n"
+                       "  \"pipelines_per_second\": {:.3f},\n"
+                       "  \"cfg_ms\": {:.3f},\n"
+                       "  \"translate_ms\": {:.3f},\n"
+                       "  \"emit_ms\": {:.3f},\n"
+                       "  \"ir_blocks\": {},\n"
+                       "  \"ir_instructions\": {},\n"
+                       "  \"max_ir_instructions\": {},\n"
+                       "  \"code_bytes\": {},\n"
+                       "  \"allocations\": {}\n"
+                       "}}\n",
+                       Common::FS::PathToUTF8String(options.cache_path.filename()),
+                       BackendName(options.backend), num_threads, summary.num_pipelines,
+                       summary.num_compute, summary.num_failed, ToMilliseconds(load_time),
+                       ToMilliseconds(wall_time),
+                       seconds > 0.0 ? static_cast<double>(summary.num_pipelines) / seconds : 0.0,
+                       ToMilliseconds(summary.cfg_time), ToMilliseconds(summary.translate_time),
+                       ToMilliseconds(summary.emit_time), summary.num_blocks, summary.num_insts,
+                       summary.max_insts, summary.code_size, summary.num_allocations);
+}
+
+void LogSummary(const Summary& summary, size_t num_threads, Clock::duration load_time,
+                Clock::duration wall_time) {
+    const size_t num_built{summary.num_pipelines - summary.num_failed};
+    const double per_pipeline{num_built > 0 ? 1.0 / static_cast<double>(num_built) : 0.0};
+    LOG_INFO(Frontend, "Loaded {} pipelines ({} compute) in {:.1f} ms", summary.num_pipelines,
+             summary.num_compute, ToMilliseconds(load_time));
+    LOG_INFO(Frontend, "Recompiled {} pipelines on {} threads in {:.1f} ms, {} failed", num_built,
+             num_threads, ToMilliseconds(wall_time), summary.num_failed);
+    LOG_INFO(Frontend, "CPU time: cfg {:.1f} ms, translate {:.1f} ms, emit {:.1f} ms",
+             ToMilliseconds(summary.cfg_time), ToMilliseconds(summary.translate_time),
+             ToMilliseconds(summary.emit_time));
+    LOG_INFO(Frontend,
+             "Per pipeline: {:.1f} IR blocks, {:.1f} IR instructions, {:.0f} bytes, {:.1f} "
+             "allocations",
+             static_cast<double>(summary.num_blocks) * per_pipeline,
+             static_cast<double>(summary.num_insts) * per_pipeline,
+             static_cast<double>(summary.code_size) * per_pipeline,
+             static_cast<double>(summary.num_allocations) * per_pipeline);
+}
+
+} // Anonymous namespace
+
+// Counts the allocations of each thread, aligned allocations are rare enough to be left out
+void* operator new(std::size_t size) {
+    ++num_allocations;
+    if (void* const pointer{std::malloc(size == 0 ? 1 : size)}) {
+        return pointer;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+int main(int argc, char** argv) {
+    Common::Log::Initialize();
+    Common::Log::SetColorConsoleBackendEnabled(true);
+    Common::Log::Start();
+
+    Options options;
+    options.num_threads = std::max(std::thread::hardware_concurrency(), 1U);
+    std::optional<Backend> backend;
+
+    static struct option long_options[] = {
+        // clang-format off
+        {"backend", required_argument, 0, 'b'},
+        {"compare", required_argument, 0, 'c'},
+        {"hashes", required_argument, 0, 'H'},
+        {"help", no_argument, 0, 'h'},
+        {"output", required_argument, 0, 'o'},
+        {"report", required_argument, 0, 'r'},
+        {"threads", required_argument, 0, 'j'},
+        {"version", no_argument, 0, 'v'},
+        {0, 0, 0, 0},
+        // clang-format on
+    };
+
+    int option_index = 0;
+    while (optind < argc) {
+        int arg = getopt_long(argc, argv, "b:j:o:hv", long_options, &option_index);
+        if (arg != -1) {
+            switch (static_cast<char>(arg)) {
+            case 'b':
+                backend = ParseBackend(optarg);
+                if (!backend) {
+                    std::cout << "Unknown backend " << optarg << "\n";
+                    PrintHelp(argv[0]);
+                    return -1;
+                }
+                break;
+            case 'c':
+                options.compare_path = optarg;
+                break;
+            case 'H':
+                options.hashes_path = optarg;
+                break;
+            case 'h':
+                PrintHelp(argv[0]);
+                return 0;
+            case 'j':
+                options.num_threads = std::max<size_t>(std::strtoull(optarg, nullptr, 10), 1);
+                break;
+            case 'o':
+                options.output_dir = optarg;
+                break;
+            case 'r':
+                options.report_path = optarg;
+                break;
+            case 'v':
+                PrintVersion();
+                return 0;
+            default:
+                PrintHelp(argv[0]);
+                return -1;
+            }
+        } else {
+            options.cache_path = argv[optind];
+            optind++;
+        }
+    }
+
+    if (options.cache_path.empty()) {
+        PrintHelp(argv[0]);
+        return -1;
+    }
+    options.cache_type =
+        options.cache_path.stem() == "opengl" ? CacheType::OpenGL : CacheType::Vulkan;
+    options.backend =
+        backend.value_or(options.cache_type == CacheType::Vulkan ? Backend::SPIRV : Backend::GLSL);
+    if (options.cache_type == CacheType::Vulkan && options.backend != Backend::SPIRV) {
+        LOG_CRITICAL(Frontend, "Vulkan pipeline caches can only be recompiled to SPIR-V");
+        return -1;
+    }
+    if (!options.output_dir.empty() && !Common::FS::CreateDirs(options.output_dir)) {
+        LOG_CRITICAL(Frontend, "Failed to create {}",
+                     Common::FS::PathToUTF8String(options.output_dir));
+        return -1;
+    }
+
+    const auto load_start{Clock::now()};
+    auto jobs{LoadJobs(options)};
+    if (!jobs) {
+        return -1;
+    }
+    const auto load_time{Clock::now() - load_start};
+
+    const Recompiler recompiler{options};
+    std::vector<PipelineResult> results(jobs->size());
+    std::atomic_bool write_failed{};
+    const auto recompile_start{Clock::now()};
+    {
+        Common::StatefulThreadWorker<ShaderPools> workers(options.num_threads, "ShaderBench",
+                                                          [] { return ShaderPools{}; });
+        for (size_t index = 0; index < jobs->size(); ++index) {
+            workers.QueueWork([&, index](ShaderPools* pools) {
+                results[index] = recompiler.Recompile(*pools, (*jobs)[index]);
+                if (!options.output_dir.empty() &&
+                    !WriteStages(options.output_dir, options.backend, results[index])) {
+                    write_failed = true;
+                }
+                // Keep the emitted code alive only as long as it is needed
+                results[index].stages.clear();
+                results[index].stages.shrink_to_fit();
+            });
+        }
+        workers.WaitForRequests();
+    }
+    const auto wall_time{Clock::now() - recompile_start};
+
+    std::ranges::sort(results, {}, &PipelineResult::key_hash);
+    const Summary summary{Summarize(results)};
+    LogSummary(summary, options.num_threads, load_time, wall_time);
+
+    int exit_code = write_failed ? -1 : 0;
+    if (!options.hashes_path.empty()) {
+        const std::string hashes{FormatHashes(results)};
+        if (Common::FS::WriteStringToFile(options.hashes_path, Common::FS::FileType::TextFile,
+                                          hashes) != hashes.size()) {
+            LOG_CRITICAL(Frontend, "Failed to write {}",
+                         Common::FS::PathToUTF8String(options.hashes_path));
+            exit_code = -1;
+        }
+    }
+    if (!options.compare_path.empty()) {
+        const auto reference{ReadHashes(options.compare_path)};
+        if (!reference) {
+            LOG_CRITICAL(Frontend, "Failed to read {}",
+                         Common::FS::PathToUTF8String(options.compare_path));
+            return -1;
+        }
+        const size_t num_mismatches{CompareHashes(*reference, results)};
+        if (num_mismatches != 0) {
+            LOG_ERROR(Frontend, "{} of {} pipelines differ from the reference", num_mismatches,
+                      results.size());
+            exit_code = 1;
+        } else {
+            LOG_INFO(Frontend, "All {} pipelines match the reference", results.size());
+        }
+    }
+    if (!options.report_path.empty()) {
+        const std::string report{
+            FormatReport(options, summary, options.num_threads, load_time, wall_time)};
+        if (options.report_path == "-") {
+            fmt::print("{}", report);
+        } else if (Common::FS::WriteStringToFile(options.report_path,
+                                                 Common::FS::FileType::TextFile,
+                                                 report) != report.size()) {
+            LOG_CRITICAL(Frontend, "Failed to write {}",
+                         Common::FS::PathToUTF8String(options.report_path));
+            exit_code = -1;
+        }
+    }
+    Common::Log::Stop();
+    return exit_code;
+}
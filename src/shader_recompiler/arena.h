@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <type_traits>
+
+namespace Shader {
+
+/// Allocates the containers of a program from a memory resource. Unlike polymorphic_allocator
+/// it follows the contents of a container when it is assigned, so a program moved into a default
+/// constructed one keeps the storage it was built in instead of being copied to the heap.
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    ArenaAllocator() noexcept = default;
+
+    ArenaAllocator(std::pmr::memory_resource* resource_) noexcept : resource{resource_} {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : resource{other.Resource()} {}
+
+    [[nodiscard]] T* allocate(size_t count) {
+        return static_cast<T*>(resource->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* pointer, size_t count) noexcept {
+        resource->deallocate(pointer, count * sizeof(T), alignof(T));
+    }
+
+    [[nodiscard]] std::pmr::memory_resource* Resource() const noexcept {
+        return resource;
+    }
+
+    template <typename U>
+    [[nodiscard]] bool operator==(const ArenaAllocator<U>& other) const noexcept {
+        return resource == other.Resource();
+    }
+
+private:
+    std::pmr::memory_resource* resource{std::pmr::new_delete_resource()};
+};
+
+/// Memory of the programs translated by a worker and of the tables of their passes. Nothing is
+/// freed until the contents are released, which must only happen once the programs are gone.
+class Arena {
+public:
+    explicit Arena(size_t initial_size = 256 * 1024) : state{std::make_unique<State>()} {
+        state->Reset(initial_size);
+    }
+
+    [[nodiscard]] std::pmr::memory_resource* Resource() noexcept {
+        return &*state->resource;
+    }
+
+    void ReleaseContents() {
+        if (state->overflow_size == 0) {
+            state->resource->release();
+            return;
+        }
+        // The buffer has been exceeded, squash the memory of the last programs into a new one
+        state->Reset(state->buffer_size + state->overflow_size);
+    }
+
+private:
+    /// Upstream of the arena once its buffer is full, counting how much memory it handed out
+    class OverflowResource final : public std::pmr::memory_resource {
+    public:
+        explicit OverflowResource(size_t& overflow_size_) : overflow_size{overflow_size_} {}
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            overflow_size += bytes;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* pointer, size_t bytes, size_t alignment) override {
+            std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+        size_t& overflow_size;
+    };
+
+    struct State {
+        void Reset(size_t size) {
+            resource.reset();
+            buffer_size = std::max<size_t>(size, 1);
+            buffer = std::make_unique<std::byte[]>(buffer_size);
+            overflow_size = 0;
+            resource.emplace(buffer.get(), buffer_size, &overflow);
+        }
+
+        size_t buffer_size{};
+        size_t overflow_size{};
+        std::unique_ptr<std::byte[]> buffer;
+        OverflowResource overflow{overflow_size};
+        std::optional<std::pmr::monotonic_buffer_resource> resource;
+    };
+
+    std::unique_ptr<State> state;
+};
+
+} // namespace Shader
@@ -7,6 +7,7 @@
 
 #include <sirit/sirit.h>
 
+#include "shader_recompiler/arena.h"
 #include "shader_recompiler/backend/bindings.h"
 #include "shader_recompiler/frontend/ir/program.h"
 #include "shader_recompiler/profile.h"
@@ -248,10 +249,11 @@ public:
 
     std::array<UniformDefinitions, Info::MAX_CBUFS> cbufs{};
     std::array<StorageDefinitions, Info::MAX_SSBOS> ssbos{};
-    std::vector<TextureBufferDefinition> texture_buffers;
-    std::vector<ImageBufferDefinition> image_buffers;
-    std::vector<TextureDefinition> textures;
-    std::vector<ImageDefinition> images;
+    // Allocated from the arena of the program, as the context does not outlive it
+    std::vector<TextureBufferDefinition, ArenaAllocator<TextureBufferDefinition>> texture_buffers;
+    std::vector<ImageBufferDefinition, ArenaAllocator<ImageBufferDefinition>> image_buffers;
+    std::vector<TextureDefinition, ArenaAllocator<TextureDefinition>> textures;
+    std::vector<ImageDefinition, ArenaAllocator<ImageDefinition>> images;
 
     Id workgroup_id{};
     Id local_invocation_id{};
@@ -350,7 +352,7 @@ public:
     Id sample_mask{};
     Id frag_depth{};
 
-    std::vector<Id> interfaces;
+    std::vector<Id, ArenaAllocator<Id>> interfaces;
 
     Id load_const_func_u8{};
     Id load_const_func_u16{};
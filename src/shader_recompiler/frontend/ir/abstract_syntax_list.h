@@ -5,6 +5,7 @@
 
 #include <vector>
 
+#include "shader_recompiler/arena.h"
 #include "shader_recompiler/frontend/ir/value.h"
 
 namespace Shader::IR {
@@ -52,6 +53,6 @@ struct AbstractSyntaxNode {
     Data data{};
     Type type{};
 };
-using AbstractSyntaxList = std::vector<AbstractSyntaxNode>;
+using AbstractSyntaxList = std::vector<AbstractSyntaxNode, ArenaAllocator<AbstractSyntaxNode>>;
 
 } // namespace Shader::IR
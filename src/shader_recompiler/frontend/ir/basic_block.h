@@ -8,10 +8,12 @@
 #include <span>
 #include <vector>
 
+#include <boost/container/small_vector.hpp>
 #include <boost/intrusive/list.hpp>
 
 #include "common/bit_cast.h"
 #include "common/common_types.h"
+#include "shader_recompiler/arena.h"
 #include "shader_recompiler/frontend/ir/condition.h"
 #include "shader_recompiler/frontend/ir/value.h"
 #include "shader_recompiler/object_pool.h"
@@ -60,11 +62,11 @@ public:
 
     /// Gets an immutable span to the immediate predecessors.
     [[nodiscard]] std::span<Block* const> ImmPredecessors() const noexcept {
-        return imm_predecessors;
+        return {imm_predecessors.data(), imm_predecessors.size()};
     }
     /// Gets an immutable span to the immediate successors.
     [[nodiscard]] std::span<Block* const> ImmSuccessors() const noexcept {
-        return imm_successors;
+        return {imm_successors.data(), imm_successors.size()};
     }
 
     /// Intrusively store the host definition of this instruction.
@@ -172,10 +174,10 @@ private:
     /// List of instructions in this block
     InstructionList instructions;
 
-    /// Block immediate predecessors
-    std::vector<Block*> imm_predecessors;
+    /// Block immediate predecessors, stored inline as most blocks have at most two
+    boost::container::small_vector<Block*, 2> imm_predecessors;
     /// Block immediate successors
-    std::vector<Block*> imm_successors;
+    boost::container::small_vector<Block*, 2> imm_successors;
 
     /// Intrusively store the value of a register in the block.
     std::array<Value, NUM_REGS> ssa_reg_values;
@@ -189,7 +191,7 @@ private:
     u32 order{};
 };
 
-using BlockList = std::vector<Block*>;
+using BlockList = std::vector<Block*, ArenaAllocator<Block*>>;
 
 [[nodiscard]] std::string DumpBlock(const Block& block);
 
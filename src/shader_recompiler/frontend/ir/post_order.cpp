@@ -11,11 +11,12 @@
 
 namespace Shader::IR {
 
-BlockList PostOrder(const AbstractSyntaxNode& root) {
+BlockList PostOrder(const AbstractSyntaxList& syntax_list) {
     boost::container::small_vector<Block*, 16> block_stack;
     boost::container::flat_set<Block*> visited;
-    BlockList post_order_blocks;
+    BlockList post_order_blocks{syntax_list.get_allocator()};
 
+    const AbstractSyntaxNode& root{syntax_list.front()};
     if (root.type != AbstractSyntaxNode::Type::Block) {
         throw LogicError("First node in abstract syntax list root is not a block");
     }
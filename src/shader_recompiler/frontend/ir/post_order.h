@@ -8,6 +8,8 @@
 
 namespace Shader::IR {
 
-BlockList PostOrder(const AbstractSyntaxNode& root);
+/// Returns the blocks reachable from the root in post order, allocated from the same resource as
+/// the syntax list
+BlockList PostOrder(const AbstractSyntaxList& syntax_list);
 
 } // namespace Shader::IR
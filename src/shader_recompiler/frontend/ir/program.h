@@ -4,6 +4,7 @@
 #pragma once
 
 #include <array>
+#include <memory_resource>
 #include <string>
 
 #include "shader_recompiler/frontend/ir/abstract_syntax_list.h"
@@ -15,6 +16,17 @@
 namespace Shader::IR {
 
 struct Program {
+    Program() = default;
+
+    /// Creates a program whose containers are allocated from the given resource
+    explicit Program(std::pmr::memory_resource* resource)
+        : syntax_list{resource}, blocks{resource}, post_order_blocks{resource} {}
+
+    /// Resource the containers of the program and the tables of its passes are allocated from
+    [[nodiscard]] std::pmr::memory_resource* MemoryResource() const noexcept {
+        return syntax_list.get_allocator().Resource();
+    }
+
     AbstractSyntaxList syntax_list;
     BlockList blocks;
     BlockList post_order_blocks;
@@ -982,12 +982,12 @@ private:
 } // Anonymous namespace
 
 IR::AbstractSyntaxList BuildASL(ObjectPool<IR::Inst>& inst_pool, ObjectPool<IR::Block>& block_pool,
-                                Environment& env, Flow::CFG& cfg,
+                                Arena& arena, Environment& env, Flow::CFG& cfg,
                                 const HostTranslateInfo& host_info) {
     ObjectPool<Statement> stmt_pool{64};
     GotoPass goto_pass{cfg, stmt_pool};
     Statement& root{goto_pass.RootStatement()};
-    IR::AbstractSyntaxList syntax_list;
+    IR::AbstractSyntaxList syntax_list{arena.Resource()};
     TranslatePass{inst_pool, block_pool, stmt_pool, env, root, syntax_list, host_info};
     stmt_pool.ReleaseContents();
     return syntax_list;
@@ -26,7 +26,7 @@ IR::BlockList GenerateBlocks(const IR::AbstractSyntaxList& syntax_list) {
             ++num_syntax_blocks;
         }
     }
-    IR::BlockList blocks;
+    IR::BlockList blocks{syntax_list.get_allocator()};
     blocks.reserve(num_syntax_blocks);
     u32 order_index{};
     for (const auto& node : syntax_list) {
@@ -238,11 +238,12 @@ void LowerGeometryPassthrough(const IR::Program& program, const HostTranslateInf
 } // Anonymous namespace
 
 IR::Program TranslateProgram(ObjectPool<IR::Inst>& inst_pool, ObjectPool<IR::Block>& block_pool,
-                             Environment& env, Flow::CFG& cfg, const HostTranslateInfo& host_info) {
-    IR::Program program;
-    program.syntax_list = BuildASL(inst_pool, block_pool, env, cfg, host_info);
+                             Arena& arena, Environment& env, Flow::CFG& cfg,
+                             const HostTranslateInfo& host_info) {
+    IR::Program program{arena.Resource()};
+    program.syntax_list = BuildASL(inst_pool, block_pool, arena, env, cfg, host_info);
     program.blocks = GenerateBlocks(program.syntax_list);
-    program.post_order_blocks = PostOrder(program.syntax_list.front());
+    program.post_order_blocks = PostOrder(program.syntax_list);
     program.stage = env.ShaderStage();
     program.local_memory_size = env.LocalMemorySize();
     switch (program.stage) {
@@ -304,6 +305,7 @@ IR::Program TranslateProgram(ObjectPool<IR::Inst>& inst_pool, ObjectPool<IR::Blo
     if (Settings::values.resolution_info.active) {
         Optimization::RescalingPass(program);
     }
+    Optimization::GlobalValueNumberingPass(program);
     Optimization::DeadCodeEliminationPass(program);
     if (Settings::values.renderer_debug) {
         Optimization::VerificationPass(program);
@@ -319,7 +321,7 @@ IR::Program TranslateProgram(ObjectPool<IR::Inst>& inst_pool, ObjectPool<IR::Blo
 
 IR::Program MergeDualVertexPrograms(IR::Program& vertex_a, IR::Program& vertex_b,
                                     Environment& env_vertex_b) {
-    IR::Program result{};
+    IR::Program result{vertex_b.MemoryResource()};
     Optimization::VertexATransformPass(vertex_a);
     Optimization::VertexBTransformPass(vertex_b);
     for (const auto& term : vertex_a.syntax_list) {
@@ -415,7 +417,7 @@ IR::Program GenerateGeometryPassthrough(ObjectPool<IR::Inst>& inst_pool,
                                         const HostTranslateInfo& host_info,
                                         IR::Program& source_program,
                                         Shader::OutputTopology output_topology) {
-    IR::Program program;
+    IR::Program program{source_program.MemoryResource()};
     program.stage = Stage::Geometry;
     program.output_topology = output_topology;
     program.output_vertices = GetOutputTopologyVertices(output_topology);
@@ -445,7 +447,7 @@ IR::Program GenerateGeometryPassthrough(ObjectPool<IR::Inst>& inst_pool,
     program.syntax_list.emplace_back().type = IR::AbstractSyntaxNode::Type::Return;
 
     program.blocks = GenerateBlocks(program.syntax_list);
-    program.post_order_blocks = PostOrder(program.syntax_list.front());
+    program.post_order_blocks = PostOrder(program.syntax_list);
     Optimization::SsaRewritePass(program);
 
     return program;
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "shader_recompiler/arena.h"
 #include "shader_recompiler/environment.h"
 #include "shader_recompiler/frontend/ir/basic_block.h"
 #include "shader_recompiler/frontend/ir/program.h"
@@ -16,9 +17,11 @@ struct HostTranslateInfo;
 
 namespace Shader::Maxwell {
 
+/// Translates a program. Its containers are allocated from the arena, which must outlive it.
 [[nodiscard]] IR::Program TranslateProgram(ObjectPool<IR::Inst>& inst_pool,
-                                           ObjectPool<IR::Block>& block_pool, Environment& env,
-                                           Flow::CFG& cfg, const HostTranslateInfo& host_info);
+                                           ObjectPool<IR::Block>& block_pool, Arena& arena,
+                                           Environment& env, Flow::CFG& cfg,
+                                           const HostTranslateInfo& host_info);
 
 [[nodiscard]] IR::Program MergeDualVertexPrograms(IR::Program& vertex_a, IR::Program& vertex_b,
                                                   Environment& env_vertex_b);
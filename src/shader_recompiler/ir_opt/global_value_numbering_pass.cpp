@@ -0,0 +1,528 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <functional>
+#include <limits>
+#include <memory_resource>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "common/container_hash.h"
+#include "common/logging/log.h"
+#include "shader_recompiler/frontend/ir/basic_block.h"
+#include "shader_recompiler/frontend/ir/value.h"
+#include "shader_recompiler/ir_opt/passes.h"
+
+namespace Shader::Optimization {
+namespace {
+constexpr size_t NO_DOMINATOR{std::numeric_limits<size_t>::max()};
+
+bool IsCommutative(IR::Opcode opcode) {
+    switch (opcode) {
+    case IR::Opcode::IAdd32:
+    case IR::Opcode::IAdd64:
+    case IR::Opcode::IMul32:
+    case IR::Opcode::FPAdd32:
+    case IR::Opcode::FPMul32:
+    case IR::Opcode::BitwiseAnd32:
+    case IR::Opcode::BitwiseOr32:
+    case IR::Opcode::BitwiseXor32:
+    case IR::Opcode::SMin32:
+    case IR::Opcode::UMin32:
+    case IR::Opcode::SMax32:
+    case IR::Opcode::UMax32:
+    case IR::Opcode::IEqual:
+    case IR::Opcode::INotEqual:
+    case IR::Opcode::LogicalOr:
+    case IR::Opcode::LogicalAnd:
+    case IR::Opcode::LogicalXor:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/// Returns true when two instances of the opcode with the same arguments may produce different
+/// results. These read memory that can be written, depend on other invocations or on the point
+/// of the control flow they are executed at.
+bool IsVolatile(IR::Opcode opcode) {
+    switch (opcode) {
+    case IR::Opcode::Phi:
+    case IR::Opcode::Identity:
+    case IR::Opcode::GetRegister:
+    case IR::Opcode::GetPred:
+    case IR::Opcode::GetGotoVariable:
+    case IR::Opcode::GetIndirectBranchVariable:
+    case IR::Opcode::GetZFlag:
+    case IR::Opcode::GetSFlag:
+    case IR::Opcode::GetCFlag:
+    case IR::Opcode::GetOFlag:
+    case IR::Opcode::GetAttributeIndexed:
+    case IR::Opcode::GetPatch:
+    case IR::Opcode::IsHelperInvocation:
+    case IR::Opcode::LoadGlobalU8:
+    case IR::Opcode::LoadGlobalS8:
+    case IR::Opcode::LoadGlobalU16:
+    case IR::Opcode::LoadGlobalS16:
+    case IR::Opcode::LoadGlobal32:
+    case IR::Opcode::LoadGlobal64:
+    case IR::Opcode::LoadGlobal128:
+    case IR::Opcode::LoadStorageU8:
+    case IR::Opcode::LoadStorageS8:
+    case IR::Opcode::LoadStorageU16:
+    case IR::Opcode::LoadStorageS16:
+    case IR::Opcode::LoadStorage32:
+    case IR::Opcode::LoadStorage64:
+    case IR::Opcode::LoadStorage128:
+    case IR::Opcode::LoadLocal:
+    case IR::Opcode::LoadSharedU8:
+    case IR::Opcode::LoadSharedS8:
+    case IR::Opcode::LoadSharedU16:
+    case IR::Opcode::LoadSharedS16:
+    case IR::Opcode::LoadSharedU32:
+    case IR::Opcode::LoadSharedU64:
+    case IR::Opcode::LoadSharedU128:
+    case IR::Opcode::BindlessImageSampleImplicitLod:
+    case IR::Opcode::BindlessImageSampleExplicitLod:
+    case IR::Opcode::BindlessImageSampleDrefImplicitLod:
+    case IR::Opcode::BindlessImageSampleDrefExplicitLod:
+    case IR::Opcode::BindlessImageGather:
+    case IR::Opcode::BindlessImageGatherDref:
+    case IR::Opcode::BindlessImageFetch:
+    case IR::Opcode::BindlessImageQueryDimensions:
+    case IR::Opcode::BindlessImageQueryLod:
+    case IR::Opcode::BindlessImageGradient:
+    case IR::Opcode::BindlessImageRead:
+    case IR::Opcode::BoundImageSampleImplicitLod:
+    case IR::Opcode::BoundImageSampleExplicitLod:
+    case IR::Opcode::BoundImageSampleDrefImplicitLod:
+    case IR::Opcode::BoundImageSampleDrefExplicitLod:
+    case IR::Opcode::BoundImageGather:
+    case IR::Opcode::BoundImageGatherDref:
+    case IR::Opcode::BoundImageFetch:
+    case IR::Opcode::BoundImageQueryDimensions:
+    case IR::Opcode::BoundImageQueryLod:
+    case IR::Opcode::BoundImageGradient:
+    case IR::Opcode::BoundImageRead:
+    case IR::Opcode::ImageSampleImplicitLod:
+    case IR::Opcode::ImageSampleExplicitLod:
+    case IR::Opcode::ImageSampleDrefImplicitLod:
+    case IR::Opcode::ImageSampleDrefExplicitLod:
+    case IR::Opcode::ImageGather:
+    case IR::Opcode::ImageGatherDref:
+    case IR::Opcode::ImageFetch:
+    case IR::Opcode::ImageQueryDimensions:
+    case IR::Opcode::ImageQueryLod:
+    case IR::Opcode::ImageGradient:
+    case IR::Opcode::ImageRead:
+    case IR::Opcode::VoteAll:
+    case IR::Opcode::VoteAny:
+    case IR::Opcode::VoteEqual:
+    case IR::Opcode::SubgroupBallot:
+    case IR::Opcode::ShuffleIndex:
+    case IR::Opcode::ShuffleUp:
+    case IR::Opcode::ShuffleDown:
+    case IR::Opcode::ShuffleButterfly:
+    case IR::Opcode::FSwizzleAdd:
+    case IR::Opcode::DPdxFine:
+    case IR::Opcode::DPdyFine:
+    case IR::Opcode::DPdxCoarse:
+    case IR::Opcode::DPdyCoarse:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/// Attributes the shader writes, reading them back is only numbered when nothing can change them
+struct WrittenAttributes {
+    std::unordered_set<IR::Attribute> attributes;
+    bool any{};
+};
+
+WrittenAttributes CollectWrittenAttributes(const IR::Program& program) {
+    WrittenAttributes written;
+    // Output patches and attributes can be written by other invocations
+    written.any = program.stage == Stage::TessellationControl;
+    for (const IR::Block* const block : program.blocks) {
+        for (const IR::Inst& inst : block->Instructions()) {
+            switch (inst.GetOpcode()) {
+            case IR::Opcode::SetAttribute:
+                written.attributes.insert(inst.Arg(0).Attribute());
+                break;
+            case IR::Opcode::SetAttributeIndexed:
+                written.any = true;
+                break;
+            default:
+                break;
+            }
+        }
+    }
+    return written;
+}
+
+bool CanBeNumbered(const IR::Inst& inst, const WrittenAttributes& written) {
+    if (inst.Type() == IR::Type::Void || inst.MayHaveSideEffects() ||
+        inst.IsPseudoInstruction() || inst.HasAssociatedPseudoOperation() ||
+        IsVolatile(inst.GetOpcode())) {
+        return false;
+    }
+    switch (inst.GetOpcode()) {
+    case IR::Opcode::GetAttribute:
+    case IR::Opcode::GetAttributeU32:
+        return !written.any && !written.attributes.contains(inst.Arg(0).Attribute());
+    default:
+        return true;
+    }
+}
+
+size_t HashValue(const IR::Value& value) {
+    if (!value.IsImmediate()) {
+        return std::hash<const IR::Inst*>{}(value.InstRecursive());
+    }
+    // Collisions between other immediates of the same type are resolved by comparing them
+    switch (value.Type()) {
+    case IR::Type::U32:
+        return value.U32();
+    case IR::Type::Attribute:
+        return static_cast<size_t>(value.Attribute());
+    default:
+        return static_cast<size_t>(value.Type());
+    }
+}
+
+struct InstHash {
+    size_t operator()(const IR::Inst* inst) const {
+        size_t seed{static_cast<size_t>(inst->GetOpcode())};
+        Common::HashCombine(seed, inst->Flags<u32>());
+        const size_t num_args{inst->NumArgs()};
+        if (IsCommutative(inst->GetOpcode())) {
+            // Order independent, so that both operand orders land in the same bucket
+            Common::HashCombine(seed, HashValue(inst->Arg(0).Resolve()) +
+                                          HashValue(inst->Arg(1).Resolve()));
+            return seed;
+        }
+        for (size_t arg = 0; arg < num_args; ++arg) {
+            Common::HashCombine(seed, HashValue(inst->Arg(arg).Resolve()));
+        }
+        return seed;
+    }
+};
+
+struct InstEqual {
+    bool operator()(const IR::Inst* lhs, const IR::Inst* rhs) const {
+        if (lhs->GetOpcode() != rhs->GetOpcode() || lhs->Flags<u32>() != rhs->Flags<u32>()) {
+            return false;
+        }
+        const auto arg{[](const IR::Inst* inst, size_t index) {
+            return inst->Arg(index).Resolve();
+        }};
+        if (IsCommutative(lhs->GetOpcode()) && arg(lhs, 0) == arg(rhs, 1) &&
+            arg(lhs, 1) == arg(rhs, 0)) {
+            return true;
+        }
+        const size_t num_args{lhs->NumArgs()};
+        for (size_t index = 0; index < num_args; ++index) {
+            if (arg(lhs, index) != arg(rhs, index)) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+bool IsImmediate(const IR::Value& value, u32 imm) {
+    return value.IsImmediate() && value.Type() == IR::Type::U32 && value.U32() == imm;
+}
+
+/// Algebraic identities that only show up once equal values are known to be the same instruction,
+/// constant propagation has already folded the ones between immediates.
+std::optional<IR::Value> Simplify(const IR::Inst& inst) {
+    if (inst.HasAssociatedPseudoOperation()) {
+        return std::nullopt;
+    }
+    const auto arg{[&inst](size_t index) { return inst.Arg(index).Resolve(); }};
+    switch (inst.GetOpcode()) {
+    case IR::Opcode::ISub32:
+        if (arg(0) == arg(1)) {
+            return IR::Value{u32{0}};
+        }
+        if (IsImmediate(arg(1), 0)) {
+            return arg(0);
+        }
+        break;
+    case IR::Opcode::IMul32:
+        if (IsImmediate(arg(0), 0) || IsImmediate(arg(1), 0)) {
+            return IR::Value{u32{0}};
+        }
+        if (IsImmediate(arg(0), 1)) {
+            return arg(1);
+        }
+        if (IsImmediate(arg(1), 1)) {
+            return arg(0);
+        }
+        break;
+    case IR::Opcode::BitwiseAnd32:
+        if (arg(0) == arg(1) || IsImmediate(arg(1), 0xffffffff)) {
+            return arg(0);
+        }
+        if (IsImmediate(arg(0), 0xffffffff)) {
+            return arg(1);
+        }
+        if (IsImmediate(arg(0), 0) || IsImmediate(arg(1), 0)) {
+            return IR::Value{u32{0}};
+        }
+        break;
+    case IR::Opcode::BitwiseOr32:
+        if (arg(0) == arg(1) || IsImmediate(arg(1), 0)) {
+            return arg(0);
+        }
+        if (IsImmediate(arg(0), 0)) {
+            return arg(1);
+        }
+        break;
+    case IR::Opcode::BitwiseXor32:
+        if (arg(0) == arg(1)) {
+            return IR::Value{u32{0}};
+        }
+        if (IsImmediate(arg(1), 0)) {
+            return arg(0);
+        }
+        if (IsImmediate(arg(0), 0)) {
+            return arg(1);
+        }
+        break;
+    case IR::Opcode::ShiftLeftLogical32:
+    case IR::Opcode::ShiftRightLogical32:
+    case IR::Opcode::ShiftRightArithmetic32:
+        if (IsImmediate(arg(1), 0)) {
+            return arg(0);
+        }
+        break;
+    case IR::Opcode::SMin32:
+    case IR::Opcode::UMin32:
+    case IR::Opcode::SMax32:
+    case IR::Opcode::UMax32:
+    case IR::Opcode::LogicalOr:
+    case IR::Opcode::LogicalAnd:
+        if (arg(0) == arg(1)) {
+            return arg(0);
+        }
+        break;
+    case IR::Opcode::IEqual:
+    case IR::Opcode::SLessThanEqual:
+    case IR::Opcode::ULessThanEqual:
+    case IR::Opcode::SGreaterThanEqual:
+    case IR::Opcode::UGreaterThanEqual:
+        if (arg(0) == arg(1)) {
+            return IR::Value{true};
+        }
+        break;
+    case IR::Opcode::INotEqual:
+    case IR::Opcode::SLessThan:
+    case IR::Opcode::ULessThan:
+    case IR::Opcode::SGreaterThan:
+    case IR::Opcode::UGreaterThan:
+    case IR::Opcode::LogicalXor:
+        if (arg(0) == arg(1)) {
+            return IR::Value{false};
+        }
+        break;
+    case IR::Opcode::SelectU1:
+    case IR::Opcode::SelectU8:
+    case IR::Opcode::SelectU16:
+    case IR::Opcode::SelectU32:
+    case IR::Opcode::SelectU64:
+    case IR::Opcode::SelectF16:
+    case IR::Opcode::SelectF32:
+    case IR::Opcode::SelectF64:
+        if (arg(1) == arg(2)) {
+            return arg(1);
+        }
+        break;
+    default:
+        break;
+    }
+    return std::nullopt;
+}
+
+/// Immediate dominator of each block as an index in reverse post order, following "A Simple,
+/// Fast Dominance Algorithm" by Cooper, Harvey and Kennedy
+std::pmr::vector<size_t> ComputeImmediateDominators(
+    const std::pmr::vector<IR::Block*>& rpo_blocks,
+    const std::pmr::unordered_map<const IR::Block*, size_t>& rpo_index) {
+    std::pmr::vector<size_t> idom(rpo_blocks.size(), NO_DOMINATOR, rpo_blocks.get_allocator());
+    if (rpo_blocks.empty()) {
+        return idom;
+    }
+    const auto intersect{[&idom](size_t lhs, size_t rhs) {
+        while (lhs != rhs) {
+            while (lhs > rhs) {
+                lhs = idom[lhs];
+            }
+            while (rhs > lhs) {
+                rhs = idom[rhs];
+            }
+        }
+        return lhs;
+    }};
+    idom[0] = 0;
+    bool changed{true};
+    while (changed) {
+        changed = false;
+        for (size_t index = 1; index < rpo_blocks.size(); ++index) {
+            size_t new_idom{NO_DOMINATOR};
+            for (const IR::Block* const pred : rpo_blocks[index]->ImmPredecessors()) {
+                const auto it{rpo_index.find(pred)};
+                if (it == rpo_index.end() || idom[it->second] == NO_DOMINATOR) {
+                    continue;
+                }
+                new_idom = new_idom == NO_DOMINATOR ? it->second : intersect(it->second, new_idom);
+            }
+            if (new_idom != idom[index]) {
+                idom[index] = new_idom;
+                changed = true;
+            }
+        }
+    }
+    return idom;
+}
+
+class ValueNumbering {
+public:
+    explicit ValueNumbering(const IR::Program& program, std::pmr::memory_resource* arena_)
+        : arena{arena_}, written_attributes{CollectWrittenAttributes(program)}, table{arena},
+          scope{arena}, replaced{arena} {}
+
+    void Run(const IR::Program& program) {
+        std::pmr::vector<IR::Block*> rpo_blocks(program.post_order_blocks.rbegin(),
+                                                program.post_order_blocks.rend(), arena);
+        std::pmr::unordered_map<const IR::Block*, size_t> rpo_index{arena};
+        for (size_t index = 0; index < rpo_blocks.size(); ++index) {
+            rpo_index.emplace(rpo_blocks[index], index);
+        }
+        const std::pmr::vector<size_t> idom{ComputeImmediateDominators(rpo_blocks, rpo_index)};
+        std::pmr::vector<std::pmr::vector<size_t>> children(rpo_blocks.size(), arena);
+        for (size_t index = 1; index < rpo_blocks.size(); ++index) {
+            if (idom[index] != NO_DOMINATOR) {
+                children[idom[index]].push_back(index);
+            }
+        }
+
+        // Walk the dominator tree in pre-order. Values numbered in a block are only visible to
+        // the blocks it dominates and are forgotten when the walk leaves its subtree.
+        struct Node {
+            size_t index;
+            size_t scope_begin;
+            bool leaving;
+        };
+        std::pmr::vector<Node> stack{arena};
+        if (!rpo_blocks.empty()) {
+            stack.push_back({0, 0, false});
+        }
+        while (!stack.empty()) {
+            const Node node{stack.back()};
+            stack.pop_back();
+            if (node.leaving) {
+                while (scope.size() > node.scope_begin) {
+                    table.erase(scope.back());
+                    scope.pop_back();
+                }
+                continue;
+            }
+            stack.push_back({node.index, scope.size(), true});
+            VisitBlock(*rpo_blocks[node.index]);
+            for (auto it = children[node.index].rbegin(); it != children[node.index].rend();
+                 ++it) {
+                stack.push_back({*it, 0, false});
+            }
+        }
+        RemoveReplaced(program);
+    }
+
+    [[nodiscard]] size_t NumRemoved() const noexcept {
+        return num_removed;
+    }
+
+private:
+    void VisitBlock(IR::Block& block) {
+        for (IR::Inst& inst : block.Instructions()) {
+            ForwardArgs(inst);
+            if (std::optional<IR::Value> simplified{Simplify(inst)}) {
+                Replace(block, inst, *simplified);
+                continue;
+            }
+            if (!CanBeNumbered(inst, written_attributes)) {
+                continue;
+            }
+            const auto [it, inserted]{table.insert(&inst)};
+            if (inserted) {
+                scope.push_back(&inst);
+            } else {
+                Replace(block, inst, IR::Value{*it});
+            }
+        }
+    }
+
+    void Replace(IR::Block& block, IR::Inst& inst, const IR::Value& value) {
+        inst.ReplaceUsesWith(value);
+        replaced.emplace(&inst, &block);
+    }
+
+    /// Makes the uses of replaced instructions refer to their replacement
+    void ForwardArgs(IR::Inst& inst) {
+        const size_t num_args{inst.NumArgs()};
+        for (size_t index = 0; index < num_args; ++index) {
+            IR::Value arg;
+            while ((arg = inst.Arg(index)).IsIdentity() && replaced.contains(arg.Inst())) {
+                inst.SetArg(index, arg.Inst()->Arg(0));
+            }
+        }
+    }
+
+    void RemoveReplaced(const IR::Program& program) {
+        if (replaced.empty()) {
+            return;
+        }
+        // Phi arguments coming from back edges are visited before their definition is replaced
+        for (IR::Block* const block : program.blocks) {
+            for (IR::Inst& inst : block->Instructions()) {
+                ForwardArgs(inst);
+            }
+        }
+        for (const auto& [inst, block] : replaced) {
+            inst->Invalidate();
+            block->Instructions().erase(IR::Block::InstructionList::s_iterator_to(*inst));
+        }
+        num_removed = replaced.size();
+    }
+
+    std::pmr::memory_resource* arena;
+    WrittenAttributes written_attributes;
+    std::pmr::unordered_set<IR::Inst*, InstHash, InstEqual> table;
+    std::pmr::vector<IR::Inst*> scope;
+    std::pmr::unordered_map<IR::Inst*, IR::Block*> replaced;
+    size_t num_removed{};
+};
+
+size_t CountInstructions(const IR::Program& program) {
+    size_t count{};
+    for (const IR::Block* const block : program.blocks) {
+        count += block->Instructions().size();
+    }
+    return count;
+}
+} // Anonymous namespace
+
+void GlobalValueNumberingPass(IR::Program& program) {
+    const size_t num_before{CountInstructions(program)};
+    // The tables are allocated from the arena of the program, released with the shader pools
+    ValueNumbering numbering{program, program.MemoryResource()};
+    numbering.Run(program);
+    LOG_DEBUG(Shader, "Global value numbering: {} instructions before, {} after", num_before,
+              num_before - numbering.NumRemoved());
+}
+
+} // namespace Shader::Optimization
@@ -13,10 +13,13 @@
 //      https://link.springer.com/chapter/10.1007/978-3-642-37051-9_6
 //
 
+#include <array>
 #include <deque>
 #include <map>
+#include <memory_resource>
 #include <span>
 #include <unordered_map>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -52,9 +55,20 @@ struct IndirectBranchVariable {
 
 using Variant = std::variant<IR::Reg, IR::Pred, ZeroFlagTag, SignFlagTag, CarryFlagTag,
                              OverflowFlagTag, GotoVariable, IndirectBranchVariable>;
-using ValueMap = std::unordered_map<IR::Block*, IR::Value>;
+using ValueMap = std::pmr::unordered_map<IR::Block*, IR::Value>;
+
+template <size_t... Indices>
+std::array<ValueMap, sizeof...(Indices)> MakeValueMaps(std::pmr::memory_resource* arena,
+                                                       std::index_sequence<Indices...>) {
+    return {((void)Indices, ValueMap{arena})...};
+}
 
 struct DefTable {
+    explicit DefTable(std::pmr::memory_resource* arena)
+        : preds{MakeValueMaps(arena, std::make_index_sequence<IR::NUM_USER_PREDS>{})},
+          goto_vars{arena}, indirect_branch_var{arena}, zero_flag{arena}, sign_flag{arena},
+          carry_flag{arena}, overflow_flag{arena} {}
+
     const IR::Value& Def(IR::Block* block, IR::Reg variable) {
         return block->SsaRegValue(variable);
     }
@@ -112,7 +126,7 @@ struct DefTable {
     }
 
     std::array<ValueMap, IR::NUM_USER_PREDS> preds;
-    std::unordered_map<u32, ValueMap> goto_vars;
+    std::pmr::unordered_map<u32, ValueMap> goto_vars;
     ValueMap indirect_branch_var;
     ValueMap zero_flag;
     ValueMap sign_flag;
@@ -158,6 +172,8 @@ struct ReadState {
 
 class Pass {
 public:
+    explicit Pass(std::pmr::memory_resource* arena) : incomplete_phis{arena}, current_def{arena} {}
+
     template <typename Type>
     void WriteVariable(Type variable, IR::Block* block, const IR::Value& value) {
         current_def.SetDef(block, variable, value);
@@ -295,7 +311,7 @@ private:
         return same;
     }
 
-    std::unordered_map<IR::Block*, std::map<Variant, IR::Inst*>> incomplete_phis;
+    std::pmr::unordered_map<IR::Block*, std::pmr::map<Variant, IR::Inst*>> incomplete_phis;
     DefTable current_def;
 };
 
@@ -391,7 +407,8 @@ IR::Type GetConcreteType(IR::Inst* inst) {
 } // Anonymous namespace
 
 void SsaRewritePass(IR::Program& program) {
-    Pass pass;
+    // Definitions are allocated from the arena of the program, released with the shader pools
+    Pass pass{program.MemoryResource()};
     const auto end{program.post_order_blocks.rend()};
     for (auto block = program.post_order_blocks.rbegin(); block != end; ++block) {
         VisitBlock(pass, *block);
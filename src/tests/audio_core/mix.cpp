@@ -0,0 +1,256 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+
+#include "audio_core/adsp/apps/audio_renderer/command_list_processor.h"
+#include "audio_core/common/common.h"
+#include "audio_core/renderer/command/command_list_header.h"
+#include "audio_core/renderer/command/commands.h"
+#include "audio_core/renderer/command/mix/mix_kernels.h"
+#include "common/common_types.h"
+#include "core/core.h"
+
+using AudioCore::ADSP::AudioRenderer::CommandListProcessor;
+
+namespace AudioCore::Renderer {
+namespace {
+
+constexpr u32 NUM_BUFFERS = 4;
+
+struct MixState {
+    std::vector<s32> buffers;
+    std::array<s32, MaxMixBuffers> previous_samples{};
+
+    bool operator==(const MixState&) const = default;
+};
+
+MixState MakeState(std::mt19937& rng, u32 sample_count) {
+    std::uniform_int_distribution<s32> distribution;
+    MixState state;
+    state.buffers.resize(NUM_BUFFERS * sample_count);
+    for (s32& sample : state.buffers) {
+        sample = distribution(rng);
+    }
+    return state;
+}
+
+template <typename Command>
+MixState Process(MixKernelPath path, Command command, MixState state, u32 sample_count) {
+    if constexpr (requires { command.previous_sample; }) {
+        command.previous_sample = CpuAddr(state.previous_samples.data());
+    }
+    if constexpr (requires { command.previous_samples; }) {
+        command.previous_samples = CpuAddr(state.previous_samples.data());
+    }
+    CommandListProcessor processor;
+    processor.sample_count = sample_count;
+    processor.buffer_count = NUM_BUFFERS;
+    processor.mix_buffers = state.buffers;
+
+    SetMixKernelPath(path);
+    command.Process(processor);
+    return state;
+}
+
+// Runs a command through the scalar loops and every vectorized path the host supports
+template <typename Command>
+void RequireBitExact(const Command& command, const MixState& state, u32 sample_count,
+                     MixKernelPath host_path) {
+    const MixState expected{Process(MixKernelPath::Scalar, command, state, sample_count)};
+    for (const MixKernelPath path : {MixKernelPath::SSE41, MixKernelPath::AVX2}) {
+        if (path <= host_path) {
+            INFO("Path " << static_cast<int>(path));
+            REQUIRE(Process(path, command, state, sample_count) == expected);
+        }
+    }
+}
+
+template <typename T, CommandId Id>
+T& Append(std::vector<u8>& command_list, size_t& size) {
+    auto& cmd{*std::construct_at<T>(reinterpret_cast<T*>(&command_list[size]))};
+    cmd.magic = CommandMagic;
+    cmd.enabled = true;
+    cmd.type = Id;
+    cmd.size = sizeof(T);
+    size += sizeof(T);
+    return cmd;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("Mix[Kernels]", "[audio_core]") {
+    constexpr std::array<u32, 9> sample_counts{0, 1, 3, 7, 8, 13, 120, 240, 241};
+    // Includes volumes that do not fit the 32-bit lanes of the vectorized kernels
+    constexpr std::array<f32, 9> volumes{0.0f, 1.0f,  0.5f,   -0.75f, 0.123456f,
+                                         3.2f, 97.1f, 255.9f, 70000.0f};
+    const MixKernelPath host_path{GetMixKernelPath()};
+    std::mt19937 rng{0x4D495845};
+
+    for (const u8 precision : {u8{15}, u8{23}}) {
+        for (const u32 sample_count : sample_counts) {
+            for (const f32 prev_volume : volumes) {
+                for (const f32 volume : volumes) {
+                    INFO("Q" << +precision << " count " << sample_count << " volumes "
+                             << prev_volume << " " << volume);
+                    const MixState state{MakeState(rng, sample_count)};
+                    for (const s16 output_index : {s16{1}, s16{0}}) {
+                        MixCommand mix{};
+                        mix.precision = precision;
+                        mix.input_index = 0;
+                        mix.output_index = output_index;
+                        mix.volume = volume;
+                        RequireBitExact(mix, state, sample_count, host_path);
+
+                        MixRampCommand mix_ramp{};
+                        mix_ramp.precision = precision;
+                        mix_ramp.input_index = 0;
+                        mix_ramp.output_index = output_index;
+                        mix_ramp.prev_volume = prev_volume;
+                        mix_ramp.volume = volume;
+                        RequireBitExact(mix_ramp, state, sample_count, host_path);
+
+                        VolumeCommand gain{};
+                        gain.precision = precision;
+                        gain.input_index = 0;
+                        gain.output_index = output_index;
+                        gain.volume = volume;
+                        RequireBitExact(gain, state, sample_count, host_path);
+
+                        VolumeRampCommand gain_ramp{};
+                        gain_ramp.precision = precision;
+                        gain_ramp.input_index = 0;
+                        gain_ramp.output_index = output_index;
+                        gain_ramp.prev_volume = prev_volume;
+                        gain_ramp.volume = volume;
+                        RequireBitExact(gain_ramp, state, sample_count, host_path);
+                    }
+
+                    MixRampGroupedCommand grouped{};
+                    grouped.precision = precision;
+                    grouped.buffer_count = NUM_BUFFERS - 1;
+                    for (u32 i = 0; i < grouped.buffer_count; i++) {
+                        grouped.inputs[i] = 0;
+                        grouped.outputs[i] = static_cast<s16>(i + 1);
+                        grouped.prev_volumes[i] = prev_volume * static_cast<f32>(i);
+                        grouped.volumes[i] = volume;
+                    }
+                    RequireBitExact(grouped, state, sample_count, host_path);
+                }
+            }
+        }
+    }
+    SetMixKernelPath(host_path);
+}
+
+TEST_CASE("Mix[Throughput]", "[.benchmark]") {
+    using Clock = std::chrono::steady_clock;
+    constexpr u32 num_voices = 24;
+    constexpr u32 num_channels = 6;
+    constexpr u32 submix_offset = num_voices;
+    constexpr u32 final_mix_offset = submix_offset + num_channels;
+    constexpr u32 num_buffers = final_mix_offset + num_channels;
+    constexpr u32 sample_count = 240;
+    constexpr u32 iterations = 2000;
+
+    Core::System system;
+    std::mt19937 rng{0x41444E50};
+    std::uniform_real_distribution<f32> volume_distribution{0.0f, 1.0f};
+    std::uniform_int_distribution<s32> sample_distribution{-0x8000, 0x7FFF};
+
+    std::vector<s32> mix_buffers(num_buffers * sample_count);
+    std::vector<s32> voice_samples(num_voices * sample_count);
+    for (s32& sample : voice_samples) {
+        sample = sample_distribution(rng);
+    }
+    std::vector<s32> previous_samples(num_voices * MaxMixBuffers);
+    std::vector<s32> depop_buffer(num_buffers);
+
+    // Mirrors the mixing part of the list the command generator builds for 24 voices played
+    // through a 5.1 sub mix into the final mix
+    std::vector<u8> command_list(sizeof(CommandListHeader) + 64 * 1024);
+    size_t size{sizeof(CommandListHeader)};
+    u32 command_count{};
+    for (u32 voice = 0; voice < num_voices; voice++) {
+        auto& volume_ramp{Append<VolumeRampCommand, CommandId::VolumeRamp>(command_list, size)};
+        volume_ramp.precision = 15;
+        volume_ramp.input_index = static_cast<s16>(voice);
+        volume_ramp.output_index = static_cast<s16>(voice);
+        volume_ramp.prev_volume = volume_distribution(rng);
+        volume_ramp.volume = volume_distribution(rng);
+
+        auto& grouped{
+            Append<MixRampGroupedCommand, CommandId::MixRampGrouped>(command_list, size)};
+        grouped.precision = 15;
+        grouped.buffer_count = num_channels;
+        for (u32 channel = 0; channel < num_channels; channel++) {
+            grouped.inputs[channel] = static_cast<s16>(voice);
+            grouped.outputs[channel] = static_cast<s16>(submix_offset + channel);
+            grouped.prev_volumes[channel] = volume_distribution(rng);
+            grouped.volumes[channel] = volume_distribution(rng);
+        }
+        grouped.previous_samples = CpuAddr(&previous_samples[voice * MaxMixBuffers]);
+        command_count += 2;
+    }
+    for (u32 channel = 0; channel < num_channels; channel++) {
+        auto& mix{Append<MixCommand, CommandId::Mix>(command_list, size)};
+        mix.precision = 15;
+        mix.input_index = static_cast<s16>(submix_offset + channel);
+        mix.output_index = static_cast<s16>(final_mix_offset + channel);
+        mix.volume = volume_distribution(rng);
+        command_count++;
+    }
+    auto& depop{Append<DepopForMixBuffersCommand, CommandId::DepopForMixBuffers>(command_list,
+                                                                                 size)};
+    depop.input = final_mix_offset;
+    depop.count = num_channels;
+    depop.decay = 0.96218872f;
+    depop.depop_buffer = CpuAddr(depop_buffer.data());
+    command_count++;
+    for (u32 channel = 0; channel < num_channels; channel++) {
+        auto& volume{Append<VolumeCommand, CommandId::Volume>(command_list, size)};
+        volume.precision = 15;
+        volume.input_index = static_cast<s16>(final_mix_offset + channel);
+        volume.output_index = static_cast<s16>(final_mix_offset + channel);
+        volume.volume = volume_distribution(rng);
+        command_count++;
+    }
+
+    const auto measure = [&](MixKernelPath path) {
+        SetMixKernelPath(path);
+        CommandListProcessor processor;
+        processor.system = &system;
+        processor.commands_buffer_size = size;
+        processor.command_count = command_count;
+        processor.sample_count = sample_count;
+        processor.mix_buffers = mix_buffers;
+        processor.buffer_count = num_buffers;
+
+        const auto start = Clock::now();
+        for (u32 i = 0; i < iterations; i++) {
+            std::ranges::copy(voice_samples, mix_buffers.begin());
+            std::ranges::fill(depop_buffer, 0x4000);
+            processor.commands = &command_list[sizeof(CommandListHeader)];
+            processor.processed_command_count = 0;
+            processor.Process(0);
+        }
+        const std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+        return elapsed.count() / iterations;
+    };
+    const MixKernelPath host_path{GetMixKernelPath()};
+    const double scalar = measure(MixKernelPath::Scalar);
+    const double dispatched = measure(host_path);
+    SetMixKernelPath(host_path);
+    fmt::print("Mix command list ({} commands)  scalar {:8.2f} us  dispatched {:8.2f} us\n",
+               command_count, scalar, dispatched);
+}
+
+} // namespace AudioCore::Renderer
@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+
+#include "common/common_types.h"
+#include "common/fs/fs_paths.h"
+#include "common/fs/path_util.h"
+#include "common/logging/backend.h"
+#include "common/logging/filter.h"
+#include "common/logging/log.h"
+
+namespace {
+
+/// Starts logging into a temporary directory, so the tests leave the user's log file alone.
+/// Returns the path of the log file.
+std::filesystem::path StartTestLogging() {
+    static const auto log_dir = [] {
+        auto dir = std::filesystem::temp_directory_path() / "citron_logging_test";
+        std::filesystem::create_directories(dir);
+        Common::FS::SetCitronPath(Common::FS::CitronPath::LogDir, dir);
+        return dir;
+    }();
+    Common::Log::Initialize();
+    Common::Log::Filter filter;
+    filter.ParseFilterString("*:Debug");
+    Common::Log::SetGlobalFilter(filter);
+    Common::Log::Start();
+    return log_dir / LOG_FILE;
+}
+
+void StopTestLogging() {
+    Common::Log::SetDeferredFormattingEnabled(false);
+    Common::Log::Stop();
+    Common::Log::DisableLoggingInTests();
+}
+
+} // Anonymous namespace
+
+TEST_CASE("Logging[Deferred]", "[common]") {
+    // More than a deferred ring holds, so a burst also waits on the logging thread to catch up
+    constexpr u32 num_messages = 0x1000;
+    constexpr u32 num_runs = 3;
+
+    const auto message = [](u32 run, u32 index) {
+        if (index % 5 == 0) {
+            return fmt::format("run={} message={} name={}", run, index, "formatted");
+        }
+        return fmt::format("run={} message={} address=0x{:X} ratio={}", run, index,
+                           u64{0x80000000} + index * 0x40, index / 4.0f);
+    };
+    const auto log_run = [](u32 run) {
+        for (u32 index = 0; index < num_messages; ++index) {
+            if (index % 5 == 0) {
+                // Strings are never deferred, these take the calling thread's formatting path
+                LOG_DEBUG(Debug, "run={} message={} name={}", run, index,
+                          std::string{"formatted"});
+            } else {
+                LOG_DEBUG(Debug, "run={} message={} address=0x{:X} ratio={}", run, index,
+                          u64{0x80000000} + index * 0x40, index / 4.0f);
+            }
+        }
+    };
+
+    const auto log_file = StartTestLogging();
+
+    // Immediate, deferred, and immediate again right after deferred calls are still queued
+    Common::Log::SetDeferredFormattingEnabled(false);
+    log_run(0);
+    Common::Log::SetDeferredFormattingEnabled(true);
+    log_run(1);
+    Common::Log::SetDeferredFormattingEnabled(false);
+    log_run(2);
+    StopTestLogging();
+
+    std::ifstream file{log_file};
+    std::vector<std::string> logged;
+    for (std::string line; std::getline(file, line);) {
+        const size_t begin = line.find("run=");
+        if (begin != std::string::npos) {
+            logged.push_back(line.substr(begin));
+        }
+    }
+
+    REQUIRE(logged.size() == num_runs * num_messages);
+    for (u32 run = 0; run < num_runs; ++run) {
+        for (u32 index = 0; index < num_messages; ++index) {
+            REQUIRE(logged[run * num_messages + index] == message(run, index));
+        }
+    }
+}
+
+TEST_CASE("Logging[Throughput]", "[.benchmark]") {
+    using Clock = std::chrono::steady_clock;
+    constexpr u32 bursts = 256;
+    constexpr u32 burst_size = 256;
+
+    StartTestLogging();
+
+    // Verbose logging usually comes in bursts from the emulated threads, give the logging thread
+    // time to catch up between them so only the cost on the calling thread is measured.
+    const auto measure = [] {
+        std::chrono::duration<double, std::nano> elapsed{};
+        for (u32 burst = 0; burst < bursts; ++burst) {
+            const auto start = Clock::now();
+            for (u32 i = 0; i < burst_size; ++i) {
+                LOG_DEBUG(Debug, "Benchmark burst={} address=0x{:016X} size={} ratio={}", burst,
+                          u64{0x80000000} + i * 0x40, i * 4, i / 3.0f);
+            }
+            elapsed += Clock::now() - start;
+            std::this_thread::sleep_for(std::chrono::milliseconds{2});
+        }
+        return elapsed.count() / (bursts * burst_size);
+    };
+
+    Common::Log::SetDeferredFormattingEnabled(false);
+    const double immediate = measure();
+    Common::Log::SetDeferredFormattingEnabled(true);
+    const double deferred = measure();
+    fmt::print("Log call  immediate {:8.2f} ns  deferred {:8.2f} ns\n", immediate, deferred);
+
+    StopTestLogging();
+}
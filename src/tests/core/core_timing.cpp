@@ -9,8 +9,11 @@
 #include <cstdlib>
 #include <memory>
 #include <optional>
+#include <random>
 #include <string>
 
+#include <fmt/format.h>
+
 #include "core/core.h"
 #include "core/core_timing.h"
 
@@ -139,3 +142,74 @@ TEST_CASE("CoreTiming[BasicOrderNoPausing]", "[core]") {
     printf("HostTimer No Pausing Timer Time: %.3f %.6f\n", timer_time / 1000.f,
            timer_time / 1000000.f);
 }
+
+TEST_CASE("CoreTiming[Throughput]", "[.benchmark]") {
+    using Clock = std::chrono::steady_clock;
+    using namespace std::chrono_literals;
+    constexpr size_t num_timers = 256;
+    constexpr u32 rounds = 2000;
+
+    // Single core mode advances on the calling thread, which keeps the host timer thread and its
+    // wakeups out of the measurement.
+    Core::Timing::CoreTiming core_timing;
+    core_timing.SetMulticore(false);
+    core_timing.Initialize([]() {});
+
+    const auto callback = [](s64, std::chrono::nanoseconds) {
+        return std::optional<std::chrono::nanoseconds>{};
+    };
+
+    // Periodic events resembling vsync, audio and input sampling, which stay scheduled
+    std::vector<std::shared_ptr<Core::Timing::EventType>> periodic{
+        Core::Timing::CreateEvent("vsync", callback),
+        Core::Timing::CreateEvent("audio", callback),
+        Core::Timing::CreateEvent("hid_npad", callback),
+        Core::Timing::CreateEvent("hid_motion", callback),
+    };
+    core_timing.ScheduleLoopingEvent(16666666ns, 16666666ns, periodic[0]);
+    core_timing.ScheduleLoopingEvent(5ms, 5ms, periodic[1]);
+    core_timing.ScheduleLoopingEvent(4ms, 4ms, periodic[2]);
+    core_timing.ScheduleLoopingEvent(10ms, 10ms, periodic[3]);
+
+    // Kernel style timeouts, most of which are cancelled before they expire
+    std::vector<std::shared_ptr<Core::Timing::EventType>> timers;
+    for (size_t i = 0; i < num_timers; ++i) {
+        timers.push_back(Core::Timing::CreateEvent(fmt::format("timer{}", i), callback));
+    }
+
+    std::mt19937 rng{0xC0DE};
+    std::chrono::duration<double, std::nano> schedule_time{};
+    std::chrono::duration<double, std::nano> unschedule_time{};
+    std::chrono::duration<double, std::nano> advance_time{};
+    for (u32 round = 0; round < rounds; ++round) {
+        auto start = Clock::now();
+        for (const auto& timer : timers) {
+            core_timing.ScheduleEvent(std::chrono::microseconds{100 + rng() % 20000}, timer);
+        }
+        schedule_time += Clock::now() - start;
+
+        start = Clock::now();
+        for (size_t i = 0; i < num_timers; ++i) {
+            if (i % 8 != 0) {
+                core_timing.UnscheduleEvent(timers[i], Core::Timing::UnscheduleEventType::NoWait);
+            }
+        }
+        unschedule_time += Clock::now() - start;
+
+        core_timing.AddTicks(1000000);
+        start = Clock::now();
+        core_timing.Advance();
+        advance_time += Clock::now() - start;
+    }
+
+    const double schedules = static_cast<double>(rounds) * num_timers;
+    const double unschedules = static_cast<double>(rounds) * (num_timers - num_timers / 8);
+    fmt::print("CoreTiming schedule   {:8.2f} ns/op\n", schedule_time.count() / schedules);
+    fmt::print("CoreTiming unschedule {:8.2f} ns/op\n", unschedule_time.count() / unschedules);
+    fmt::print("CoreTiming advance    {:8.2f} us/call\n", advance_time.count() / rounds / 1000.0);
+
+    for (const auto& event_type : periodic) {
+        core_timing.UnscheduleEvent(event_type, Core::Timing::UnscheduleEventType::NoWait);
+    }
+    core_timing.ClearPendingEvents();
+}
@@ -0,0 +1,46 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "core/crypto/aes_util.h"
+#include "core/crypto/key_manager.h"
+#include "core/crypto/xts_encryption_layer.h"
+#include "core/file_sys/vfs/vfs_vector.h"
+
+TEST_CASE("XTSEncryptionLayer[ShortRead]", "[core]") {
+    using namespace Core::Crypto;
+    constexpr size_t sector_size = 0x4000;
+    // The file ends half way through its third sector
+    constexpr size_t file_size = sector_size * 2 + 0x2010;
+
+    std::mt19937 rng{0x575};
+    Key256 key;
+    std::generate(key.begin(), key.end(), [&] { return static_cast<u8>(rng()); });
+    std::vector<u8> plaintext(sector_size * 3);
+    std::generate(plaintext.begin(), plaintext.end(), [&] { return static_cast<u8>(rng()); });
+
+    AESCipher<Key256> cipher{key, Mode::XTS};
+    std::vector<u8> encrypted(plaintext.size());
+    cipher.XTSTranscode(plaintext.data(), plaintext.size(), encrypted.data(), 0, sector_size,
+                        Op::Encrypt);
+    encrypted.resize(file_size);
+
+    const XTSEncryptionLayer layer{
+        std::make_shared<FileSys::VectorVfsFile>(std::move(encrypted)), key};
+
+    // Sector aligned reads past the end decrypt the partial sector as well
+    std::vector<u8> out(sector_size * 4, 0xCC);
+    REQUIRE(layer.Read(out.data(), out.size(), 0) == file_size);
+    REQUIRE(std::equal(out.begin(), out.begin() + file_size, plaintext.begin()));
+
+    constexpr size_t tail_size = file_size - sector_size * 2;
+    REQUIRE(layer.Read(out.data(), sector_size * 2, sector_size * 2) == tail_size);
+    REQUIRE(std::equal(out.begin(), out.begin() + tail_size, plaintext.begin() + sector_size * 2));
+}
@@ -0,0 +1,163 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+
+#include "common/alignment.h"
+#include "common/common_types.h"
+#include "common/literals.h"
+#include "common/lz4_compression.h"
+#include "common/swap.h"
+#include "common/thread_worker.h"
+#include "core/file_sys/fssystem/fssystem_aes_ctr_storage.h"
+#include "core/file_sys/fssystem/fssystem_alignment_matching_storage.h"
+#include "core/file_sys/fssystem/fssystem_nca_header.h"
+#include "core/file_sys/vfs/vfs_offset.h"
+#include "core/file_sys/vfs/vfs_vector.h"
+#include "core/loader/nso.h"
+
+namespace {
+
+using namespace Common::Literals;
+
+constexpr size_t NumModules = 8;
+constexpr size_t PageSize = 4_KiB;
+
+struct ModuleImage {
+    std::string name;
+    std::vector<u8> file;
+    std::array<std::vector<u8>, 3> segments;
+    std::array<u32, 3> locations{};
+};
+
+// Builds an NSO with LZ4 compressed text, rodata and data segments. The segments are made of
+// short runs of random bytes so they compress, but still differ between modules.
+ModuleImage MakeModule(std::mt19937& rng, std::string name) {
+    ModuleImage module;
+    module.name = std::move(name);
+
+    Loader::NSOHeader header{};
+    header.magic = Common::MakeMagic('N', 'S', 'O', '0');
+    header.flags = 0b111;
+
+    std::vector<u8> contents;
+    u32 location = 0;
+    for (size_t i = 0; i < module.segments.size(); ++i) {
+        std::vector<u8>& segment = module.segments[i];
+        segment.resize(64_KiB + rng() % 256_KiB);
+        for (size_t offset = 0; offset < segment.size(); offset += 8) {
+            const u8 value = static_cast<u8>(rng());
+            std::memset(segment.data() + offset, value,
+                        std::min<size_t>(8, segment.size() - offset));
+        }
+
+        const std::vector<u8> compressed =
+            Common::Compression::CompressDataLZ4(segment.data(), segment.size());
+        header.segments[i].offset = static_cast<u32>(sizeof(header) + contents.size());
+        header.segments[i].location = location;
+        header.segments[i].size = static_cast<u32>(segment.size());
+        header.segments_compressed_size[i] = static_cast<u32>(compressed.size());
+        contents.insert(contents.end(), compressed.begin(), compressed.end());
+
+        module.locations[i] = location;
+        location += static_cast<u32>(Common::AlignUp(segment.size(), PageSize));
+    }
+
+    module.file.resize(sizeof(header));
+    std::memcpy(module.file.data(), &header, sizeof(header));
+    module.file.insert(module.file.end(), contents.begin(), contents.end());
+    return module;
+}
+
+struct EncryptedExeFs {
+    std::vector<ModuleImage> modules;
+    std::vector<FileSys::VirtualFile> files;
+};
+
+// Lays the modules out back to back in one AES-CTR section, built with the same layers as
+// NcaFileSystemDriver::CreateAesCtrStorage, and returns a view over each of them.
+EncryptedExeFs MakeEncryptedExeFs(std::mt19937& rng) {
+    EncryptedExeFs exefs;
+    std::vector<u8> plaintext;
+    std::vector<std::pair<size_t, size_t>> ranges;
+    for (size_t i = 0; i < NumModules; ++i) {
+        const std::string name = i == 0 ? "main" : fmt::format("subsdk{}", i - 1);
+        ModuleImage& module = exefs.modules.emplace_back(MakeModule(rng, name));
+        ranges.emplace_back(plaintext.size(), module.file.size());
+        plaintext.insert(plaintext.end(), module.file.begin(), module.file.end());
+    }
+    plaintext.resize(Common::AlignUp(plaintext.size(), FileSys::AesCtrStorage::BlockSize));
+
+    std::array<u8, FileSys::AesCtrStorage::KeySize> key;
+    for (u8& byte : key) {
+        byte = static_cast<u8>(rng());
+    }
+    std::array<u8, FileSys::AesCtrStorage::IvSize> iv{};
+    FileSys::AesCtrStorage::MakeIv(iv.data(), iv.size(), rng(), 0);
+
+    auto encrypted = std::make_shared<FileSys::VectorVfsFile>(std::vector<u8>(plaintext.size()));
+    auto aes_ctr_storage = std::make_shared<FileSys::AesCtrStorage>(
+        encrypted, key.data(), key.size(), iv.data(), iv.size());
+    REQUIRE(aes_ctr_storage->Write(plaintext.data(), plaintext.size(), 0) == plaintext.size());
+    REQUIRE(encrypted->ReadAllBytes() != plaintext);
+
+    auto section = std::make_shared<
+        FileSys::AlignmentMatchingStorage<FileSys::NcaHeader::CtrBlockSize, 1>>(
+        std::move(aes_ctr_storage));
+    for (size_t i = 0; i < NumModules; ++i) {
+        exefs.files.push_back(std::make_shared<FileSys::OffsetVfsFile>(
+            section, ranges[i].second, ranges[i].first, exefs.modules[i].name));
+    }
+    return exefs;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("AesCtrStorage: Concurrent ExeFS module reads", "[core][file_sys]") {
+    std::mt19937 rng(0xC17E);
+    const EncryptedExeFs exefs = MakeEncryptedExeFs(rng);
+
+    // Read the modules the way AppLoader_DeconstructedRomDirectory does, one worker per module,
+    // several times so the workers overlap on the shared section.
+    for (int iteration = 0; iteration < 8; ++iteration) {
+        std::array<std::promise<std::optional<Loader::AppLoader_NSO::NSOModule>>, NumModules>
+            promises;
+        std::array<std::future<std::optional<Loader::AppLoader_NSO::NSOModule>>, NumModules>
+            futures;
+        {
+            Common::ThreadWorker worker(NumModules, "NSOLoader");
+            for (size_t i = 0; i < NumModules; ++i) {
+                futures[i] = promises[i].get_future();
+                worker.QueueWork([&, i] {
+                    promises[i].set_value(
+                        Loader::AppLoader_NSO::ReadModule(*exefs.files[i], false));
+                });
+            }
+
+            for (size_t i = 0; i < NumModules; ++i) {
+                const ModuleImage& expected = exefs.modules[i];
+                const auto module = futures[i].get();
+                REQUIRE(module.has_value());
+                REQUIRE(module->name == expected.name);
+
+                const Kernel::PhysicalMemory& memory = module->codeset.memory;
+                for (size_t segment = 0; segment < expected.segments.size(); ++segment) {
+                    const std::vector<u8>& data = expected.segments[segment];
+                    const u32 location = expected.locations[segment];
+                    REQUIRE(memory.size() >= location + data.size());
+                    REQUIRE(std::memcmp(memory.data() + location, data.data(), data.size()) == 0);
+                }
+            }
+        }
+    }
+}
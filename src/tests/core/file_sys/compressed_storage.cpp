@@ -0,0 +1,123 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "common/literals.h"
+#include "core/file_sys/fssystem/fssystem_bucket_tree.h"
+#include "core/file_sys/fssystem/fssystem_compressed_storage.h"
+#include "core/file_sys/vfs/vfs_vector.h"
+
+namespace {
+
+using namespace Common::Literals;
+
+constexpr size_t EntrySize = 64_KiB;
+constexpr u8 CompressionKey = 0xA5;
+
+// Stands in for LZ4, the "compressed" data is the plain data xored with a key.
+Result Decompress(void* dst, size_t dst_size, const void* src, size_t src_size) {
+    if (dst_size != src_size) {
+        return ResultUnknown;
+    }
+    for (size_t i = 0; i < dst_size; ++i) {
+        static_cast<u8*>(dst)[i] = static_cast<const u8*>(src)[i] ^ CompressionKey;
+    }
+    return ResultSuccess;
+}
+
+FileSys::DecompressorFunction GetDecompressor(FileSys::CompressionType type) {
+    return type == FileSys::CompressionType::Lz4 ? Decompress : nullptr;
+}
+
+struct CompressedImage {
+    std::vector<u8> plain;
+    std::shared_ptr<FileSys::CompressedStorage> storage;
+};
+
+// Builds a compressed storage with a single entry set, every entry compressed except for a few
+// runs of zeros.
+CompressedImage MakeCompressedImage(std::mt19937& rng, s32 entry_count) {
+    using FileSys::CompressedStorage;
+
+    CompressedImage image;
+    image.plain.resize(EntrySize * entry_count);
+
+    std::vector<u8> data;
+    std::vector<CompressedStorage::Entry> entries;
+    for (s32 i = 0; i < entry_count; ++i) {
+        const s64 virt_offset = static_cast<s64>(EntrySize) * i;
+        if (i % 7 == 3) {
+            // Zero entries keep a nominal physical size, but never touch the data storage.
+            entries.push_back({virt_offset, static_cast<s64>(data.size()),
+                               FileSys::CompressionType::Zeros, 0x10});
+            continue;
+        }
+        entries.push_back({virt_offset, static_cast<s64>(data.size()),
+                           FileSys::CompressionType::Lz4, static_cast<s32>(EntrySize)});
+        for (size_t j = 0; j < EntrySize; ++j) {
+            const u8 value = static_cast<u8>(rng());
+            image.plain[virt_offset + j] = value;
+            data.push_back(value ^ CompressionKey);
+        }
+    }
+
+    // The L1 node points at the only entry set, which starts at offset zero.
+    const s64 end_offset = static_cast<s64>(image.plain.size());
+    const FileSys::BucketTree::NodeHeader node_header{0, 1, end_offset};
+    const s64 entry_set_offset = 0;
+    std::vector<u8> node(CompressedStorage::QueryNodeStorageSize(entry_count));
+    std::memcpy(node.data(), &node_header, sizeof(node_header));
+    std::memcpy(node.data() + sizeof(node_header), &entry_set_offset, sizeof(entry_set_offset));
+
+    const FileSys::BucketTree::NodeHeader entry_set_header{0, entry_count, end_offset};
+    std::vector<u8> entry_set(CompressedStorage::QueryEntryStorageSize(entry_count));
+    std::memcpy(entry_set.data(), &entry_set_header, sizeof(entry_set_header));
+    std::memcpy(entry_set.data() + sizeof(entry_set_header), entries.data(),
+                entries.size() * sizeof(CompressedStorage::Entry));
+
+    image.storage = std::make_shared<CompressedStorage>();
+    REQUIRE(image.storage
+                ->Initialize(std::make_shared<FileSys::VectorVfsFile>(std::move(data)),
+                             std::make_shared<FileSys::VectorVfsFile>(std::move(node)),
+                             std::make_shared<FileSys::VectorVfsFile>(std::move(entry_set)),
+                             entry_count, 64_KiB, 640_KiB, GetDecompressor, 16_KiB, 16_KiB, 32)
+                .IsSuccess());
+    return image;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("CompressedStorage[Prefetch]", "[core]") {
+    std::mt19937 rng{0xC0FFEE};
+    const CompressedImage image = MakeCompressedImage(rng, 96);
+    const auto& storage = image.storage;
+    REQUIRE(storage->GetSize() == image.plain.size());
+
+    // Stream through the storage in reads that do not line up with the entries
+    std::vector<u8> buffer(24_KiB);
+    for (size_t offset = 0; offset < image.plain.size(); offset += buffer.size()) {
+        const size_t size = std::min(buffer.size(), image.plain.size() - offset);
+        REQUIRE(storage->Read(buffer.data(), size, offset) == size);
+        REQUIRE(std::memcmp(buffer.data(), image.plain.data() + offset, size) == 0);
+    }
+
+    const auto statistics = storage->GetPrefetchStatistics();
+    REQUIRE(statistics.prefetch_issued > 0);
+    REQUIRE(statistics.cache_hits > 0);
+
+    // Random accesses stop the read-ahead, and still return the right data
+    for (u32 i = 0; i < 512; ++i) {
+        const size_t offset = rng() % image.plain.size();
+        const size_t size = std::min<size_t>(1 + rng() % buffer.size(),
+                                             image.plain.size() - offset);
+        REQUIRE(storage->Read(buffer.data(), size, offset) == size);
+        REQUIRE(std::memcmp(buffer.data(), image.plain.data() + offset, size) == 0);
+    }
+}
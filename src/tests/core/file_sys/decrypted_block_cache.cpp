@@ -0,0 +1,170 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+
+#include "common/common_types.h"
+#include "common/literals.h"
+#include "core/file_sys/fssystem/fssystem_aes_ctr_storage.h"
+#include "core/file_sys/fssystem/fssystem_alignment_matching_storage.h"
+#include "core/file_sys/fssystem/fssystem_decrypted_block_cache.h"
+#include "core/file_sys/fssystem/fssystem_nca_header.h"
+#include "core/file_sys/vfs/vfs_vector.h"
+
+namespace {
+
+using namespace Common::Literals;
+
+struct TraceEntry {
+    size_t offset;
+    size_t size;
+};
+
+std::vector<u8> RandomBytes(std::mt19937& rng, size_t size) {
+    std::vector<u8> bytes(size);
+    for (u8& byte : bytes) {
+        byte = static_cast<u8>(rng());
+    }
+    return bytes;
+}
+
+// Builds the same AES-CTR section layers as NcaFileSystemDriver::CreateAesCtrStorage over random
+// ciphertext.
+FileSys::VirtualFile MakeAesCtrSection(std::mt19937& rng, size_t size) {
+    const std::vector<u8> key = RandomBytes(rng, FileSys::AesCtrStorage::KeySize);
+    std::array<u8, FileSys::AesCtrStorage::IvSize> iv{};
+    FileSys::AesCtrStorage::MakeIv(iv.data(), iv.size(), rng(), 0);
+
+    auto encrypted = std::make_shared<FileSys::VectorVfsFile>(RandomBytes(rng, size));
+    auto aes_ctr_storage = std::make_shared<FileSys::AesCtrStorage>(
+        std::move(encrypted), key.data(), key.size(), iv.data(), iv.size());
+    return std::make_shared<
+        FileSys::AlignmentMatchingStorage<FileSys::NcaHeader::CtrBlockSize, 1>>(
+        std::move(aes_ctr_storage));
+}
+
+// Asset pack style reads: small unaligned reads clustered on a few hot files, mixed with larger
+// streaming reads, the whole pattern repeating as the title reloads its scenes.
+std::vector<TraceEntry> MakeTrace(std::mt19937& rng, size_t storage_size, size_t num_reads) {
+    constexpr size_t num_hot_files = 64;
+    std::vector<TraceEntry> files(num_hot_files);
+    for (TraceEntry& file : files) {
+        file.size = 4_KiB + rng() % 1_MiB;
+        file.offset = rng() % (storage_size - file.size);
+    }
+
+    std::vector<TraceEntry> trace;
+    trace.reserve(num_reads);
+    while (trace.size() < num_reads) {
+        const TraceEntry& file = files[rng() % files.size()];
+        if (rng() % 8 == 0) {
+            trace.push_back(file);
+            continue;
+        }
+        const size_t size = std::min<size_t>(file.size, 0x20 + rng() % 16_KiB);
+        trace.push_back({file.offset + rng() % (file.size - size + 1), size});
+    }
+    return trace;
+}
+
+// Reads a trace recorded from fsp with one "offset size" pair per line.
+std::vector<TraceEntry> LoadTrace(const char* path, size_t storage_size) {
+    std::vector<TraceEntry> trace;
+    std::ifstream file{path};
+    TraceEntry entry{};
+    while (file >> entry.offset >> entry.size) {
+        if (entry.offset < storage_size) {
+            entry.size = std::min(entry.size, storage_size - entry.offset);
+            trace.push_back(entry);
+        }
+    }
+    return trace;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("DecryptedBlockCache[MatchesUncached]", "[core]") {
+    constexpr size_t storage_size = 4_MiB + 0x123;
+    std::mt19937 rng{0xB10C};
+    const FileSys::VirtualFile section = MakeAesCtrSection(rng, storage_size);
+
+    // Keep the budget below the section size so blocks get evicted and read again
+    FileSys::DecryptedBlockCache cache;
+    cache.SetCapacity(1_MiB);
+    const auto cached = std::make_shared<FileSys::DecryptedBlockCacheStorage>(section, 1, cache);
+    REQUIRE(cached->GetSize() == storage_size);
+
+    for (const TraceEntry& read : MakeTrace(rng, storage_size, 2048)) {
+        std::vector<u8> expected(read.size);
+        std::vector<u8> result(read.size);
+        REQUIRE(section->Read(expected.data(), read.size, read.offset) == read.size);
+        REQUIRE(cached->Read(result.data(), read.size, read.offset) == read.size);
+        REQUIRE(result == expected);
+    }
+
+    // Reads at the end of the storage are clamped to its size
+    std::vector<u8> tail(0x200);
+    REQUIRE(cached->Read(tail.data(), tail.size(), storage_size - 0x100) == 0x100);
+
+    const FileSys::DecryptedBlockCache::Statistics statistics = cache.GetStatistics();
+    REQUIRE(statistics.hits > 0);
+    REQUIRE(statistics.evictions > 0);
+    REQUIRE(statistics.cached_bytes <= cache.GetCapacity());
+}
+
+TEST_CASE("DecryptedBlockCache[TraceReplay]", "[.benchmark]") {
+    using Clock = std::chrono::steady_clock;
+    constexpr size_t storage_size = 256_MiB;
+    constexpr u32 passes = 4;
+
+    std::mt19937 rng{0xB10C};
+    const FileSys::VirtualFile section = MakeAesCtrSection(rng, storage_size);
+
+    // A trace recorded from a title can be replayed by pointing this at it
+    const char* const trace_path = std::getenv("CITRON_FSP_READ_TRACE");
+    const std::vector<TraceEntry> trace = trace_path != nullptr
+                                              ? LoadTrace(trace_path, storage_size)
+                                              : MakeTrace(rng, storage_size, 20000);
+    REQUIRE(!trace.empty());
+    size_t trace_bytes = 0;
+    for (const TraceEntry& read : trace) {
+        trace_bytes += read.size;
+    }
+
+    std::vector<u8> buffer;
+    const auto measure = [&](const FileSys::VirtualFile& storage) {
+        const auto start = Clock::now();
+        for (u32 pass = 0; pass < passes; ++pass) {
+            for (const TraceEntry& read : trace) {
+                buffer.resize(read.size);
+                storage->Read(buffer.data(), read.size, read.offset);
+            }
+        }
+        const std::chrono::duration<double> elapsed = Clock::now() - start;
+        return static_cast<double>(trace_bytes) * passes / elapsed.count() / 1e6;
+    };
+
+    FileSys::DecryptedBlockCache cache;
+    cache.SetCapacity(64_MiB);
+    const double uncached = measure(section);
+    const double cached =
+        measure(std::make_shared<FileSys::DecryptedBlockCacheStorage>(section, 1, cache));
+
+    const FileSys::DecryptedBlockCache::Statistics statistics = cache.GetStatistics();
+    fmt::print("Trace of {} reads ({} KiB) x{}: uncached {:8.1f} MB/s  cached {:8.1f} MB/s\n",
+               trace.size(), trace_bytes / 1_KiB, passes, uncached, cached);
+    fmt::print("Cache: hits {} misses {} evictions {} ({:.1f}% hit rate, {} KiB resident)\n",
+               statistics.hits, statistics.misses, statistics.evictions,
+               100.0 * static_cast<double>(statistics.hits) /
+                   static_cast<double>(statistics.hits + statistics.misses),
+               statistics.cached_bytes / 1_KiB);
+}
@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+
+#include "common/common_types.h"
+#include "common/fs/path_util.h"
+#include "common/hex_util.h"
+#include "common/literals.h"
+#include "core/crypto/sha256.h"
+#include "core/file_sys/install_pipeline.h"
+#include "core/file_sys/vfs/vfs_real.h"
+#include "core/file_sys/vfs/vfs_vector.h"
+
+namespace {
+
+using namespace Common::Literals;
+
+std::vector<u8> RandomBytes(size_t size) {
+    std::mt19937 rng{0x1A57};
+    std::vector<u8> bytes(size);
+    std::generate(bytes.begin(), bytes.end(), [&] { return static_cast<u8>(rng()); });
+    return bytes;
+}
+
+// The name of an NCA in a submission package, derived from the hash of its contents
+std::string GetContentName(const std::vector<u8>& data) {
+    Core::Crypto::SHA256 sha256;
+    sha256.Update(data);
+    const auto hash = sha256.Finish();
+    return Common::HexToString(std::span(hash).first<16>()) + ".nca";
+}
+
+} // Anonymous namespace
+
+TEST_CASE("InstallPipeline[Copy]", "[core]") {
+    // Not a multiple of the chunk size, so that the last chunk is partial
+    const auto data = RandomBytes(21_MiB + 0x123);
+    const auto copy = [&](std::string name) {
+        FileSys::InstallProgress progress;
+        const auto src = std::make_shared<FileSys::VectorVfsFile>(data, name);
+        const auto dir = std::make_shared<FileSys::VectorVfsDirectory>();
+        const auto dest = std::make_shared<FileSys::VectorVfsFile>(std::vector<u8>{}, name, dir);
+        dir->AddFile(dest);
+        const bool success = FileSys::PipelinedCopy(src, dest, progress);
+        const auto installed = dir->GetFile(name);
+        return std::tuple{success, installed ? installed->ReadAllBytes() : std::vector<u8>{},
+                          progress.processed_size.load(), installed != nullptr};
+    };
+
+    // Named after its content ID and verified against it
+    const auto [success, copied, processed_size, exists] = copy(GetContentName(data));
+    REQUIRE(success);
+    REQUIRE(exists);
+    REQUIRE(copied == data);
+    REQUIRE(processed_size == data.size());
+
+    // A content ID that does not match the data fails and leaves nothing behind
+    auto bad_name = GetContentName(data);
+    bad_name[0] = bad_name[0] == '0' ? '1' : '0';
+    const auto [bad_success, bad_copied, bad_processed_size, bad_exists] = copy(bad_name);
+    REQUIRE(!bad_success);
+    REQUIRE(!bad_exists);
+
+    // Files that are not named after a content ID are copied without verification
+    const auto [plain_success, plain_copied, plain_processed_size, plain_exists] = copy("data.bin");
+    REQUIRE(plain_success);
+    REQUIRE(plain_exists);
+    REQUIRE(plain_copied == data);
+}
+
+TEST_CASE("InstallPipeline[Throughput]", "[.benchmark]") {
+    using Clock = std::chrono::steady_clock;
+    constexpr size_t file_size = 1_GiB;
+
+    const auto directory = std::filesystem::temp_directory_path() / "citron_install_benchmark";
+    std::filesystem::create_directories(directory);
+
+    // The source is named after its content ID, so that it is verified like an installed NCA
+    const auto data = RandomBytes(file_size);
+    const auto name = GetContentName(data);
+    {
+        std::ofstream stream{directory / name, std::ios::binary | std::ios::trunc};
+        stream.write(reinterpret_cast<const char*>(data.data()),
+                     static_cast<std::streamsize>(data.size()));
+    }
+
+    FileSys::RealVfsFilesystem vfs;
+    const auto dir = vfs.OpenDirectory(Common::FS::PathToUTF8String(directory),
+                                       FileSys::OpenMode::ReadWrite);
+    REQUIRE(dir != nullptr);
+
+    double best_throughput = 0.0;
+    for (int i = 0; i < 3; ++i) {
+        FileSys::InstallProgress progress;
+        const auto dest = dir->CreateFile("dest.nca");
+        const auto start = Clock::now();
+        REQUIRE(FileSys::PipelinedCopy(dir->GetFile(name), dest, progress));
+        const std::chrono::duration<double> elapsed = Clock::now() - start;
+        best_throughput = std::max(best_throughput, file_size / elapsed.count() / 1_MiB);
+    }
+    fmt::print("{} MiB pipelined copy: {:.0f} MiB/s\n", file_size / 1_MiB, best_throughput);
+
+    std::filesystem::remove_all(directory);
+}
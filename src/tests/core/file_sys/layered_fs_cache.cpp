@@ -0,0 +1,102 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "core/file_sys/layered_fs_cache.h"
+#include "core/file_sys/romfs.h"
+#include "core/file_sys/vfs/vfs_layered.h"
+#include "core/file_sys/vfs/vfs_vector.h"
+
+namespace {
+
+using FileSys::VectorVfsDirectory;
+using FileSys::VirtualDir;
+
+std::shared_ptr<VectorVfsDirectory> MakeDir(std::string name) {
+    return std::make_shared<VectorVfsDirectory>(std::vector<FileSys::VirtualFile>{},
+                                                std::vector<VirtualDir>{}, std::move(name));
+}
+
+void AddFile(const std::shared_ptr<VectorVfsDirectory>& dir, std::string name, size_t size) {
+    std::vector<u8> data(size);
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<u8>(name.size() + i);
+    }
+    dir->AddFile(std::make_shared<FileSys::VectorVfsFile>(std::move(data), std::move(name)));
+}
+
+std::shared_ptr<VectorVfsDirectory> AddDir(const std::shared_ptr<VectorVfsDirectory>& parent,
+                                           std::string name) {
+    auto dir = MakeDir(std::move(name));
+    parent->AddDirectory(dir);
+    return dir;
+}
+
+// The RomFS as built without the cache.
+std::vector<u8> BuildReference(const FileSys::VirtualFile& base_romfs,
+                               std::vector<VirtualDir> layers, std::vector<VirtualDir> ext) {
+    layers.push_back(FileSys::ExtractRomFS(base_romfs));
+    auto layered = FileSys::LayeredVfsDirectory::MakeLayeredDirectory(std::move(layers));
+    auto layered_ext = FileSys::LayeredVfsDirectory::MakeLayeredDirectory(std::move(ext));
+    return FileSys::CreateRomFS(std::move(layered), std::move(layered_ext))->ReadAllBytes();
+}
+
+} // Anonymous namespace
+
+TEST_CASE("LayeredFSCache[Rebuild]", "[core]") {
+    const auto cache_path = std::filesystem::temp_directory_path() / "citron_layered_fs_test.bin";
+    std::filesystem::remove(cache_path);
+
+    const auto base = MakeDir("");
+    AddFile(base, "root.txt", 0x30);
+    const auto base_data = AddDir(base, "Data");
+    AddFile(base_data, "a.bin", 0x123);
+    AddFile(AddDir(base_data, "sub"), "b.bin", 0x40);
+    AddFile(AddDir(base, "Model"), "m.bin", 0x2000);
+    AddDir(base, "Empty");
+    const auto base_romfs = FileSys::CreateRomFS(base);
+
+    const auto mod1 = MakeDir("mod1");
+    AddFile(AddDir(mod1, "Data"), "a.bin", 0x77);
+    AddFile(AddDir(mod1, "Model"), "new.bin", 0x10);
+    AddFile(AddDir(mod1, "Extra"), "x.bin", 0x5);
+    const auto mod2 = MakeDir("mod2");
+    const auto mod2_data = AddDir(mod2, "Data");
+    AddFile(mod2_data, "a.bin", 0x99);
+    AddFile(mod2_data, "c.bin", 0x321);
+
+    // Stubs out a base directory and a base file
+    const auto ext = MakeDir("ext");
+    AddFile(AddDir(ext, "Data"), "sub.stub", 0);
+    AddFile(ext, "root.txt.stub", 0);
+
+    const std::vector<VirtualDir> layers{mod1, mod2};
+    const std::vector<VirtualDir> ext_layers{ext};
+    const auto build = [&] {
+        return FileSys::CreateLayeredRomFS(base_romfs, layers, ext_layers, cache_path)
+            ->ReadAllBytes();
+    };
+
+    // Built from scratch, then reused from the cache
+    const auto reference = BuildReference(base_romfs, layers, ext_layers);
+    REQUIRE(build() == reference);
+    REQUIRE(std::filesystem::exists(cache_path));
+    REQUIRE(build() == reference);
+
+    // Only the changed top level directory is merged again
+    AddFile(mod2_data, "d.bin", 0x44);
+    REQUIRE(build() == BuildReference(base_romfs, layers, ext_layers));
+
+    // A corrupted cache is rebuilt
+    std::filesystem::resize_file(cache_path, std::filesystem::file_size(cache_path) / 2);
+    REQUIRE(build() == BuildReference(base_romfs, layers, ext_layers));
+
+    std::filesystem::remove(cache_path);
+}
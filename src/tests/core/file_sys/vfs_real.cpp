@@ -0,0 +1,157 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+
+#include "common/common_types.h"
+#include "common/fs/path_util.h"
+#include "common/literals.h"
+#include "core/file_sys/vfs/vfs_offset.h"
+#include "core/file_sys/vfs/vfs_real.h"
+
+namespace {
+
+using namespace Common::Literals;
+
+// A file in the temporary directory, removed when the object is destroyed.
+class TemporaryFile {
+public:
+    TemporaryFile(const std::string& name, const std::vector<u8>& contents)
+        : path{std::filesystem::temp_directory_path() / name} {
+        std::ofstream stream{path, std::ios::binary | std::ios::trunc};
+        stream.write(reinterpret_cast<const char*>(contents.data()),
+                     static_cast<std::streamsize>(contents.size()));
+    }
+
+    ~TemporaryFile() {
+        std::filesystem::remove(path);
+    }
+
+    std::string Path() const {
+        return Common::FS::PathToUTF8String(path);
+    }
+
+private:
+    std::filesystem::path path;
+};
+
+std::vector<u8> RandomBytes(size_t size) {
+    std::mt19937 rng{0x3A9};
+    std::vector<u8> bytes(size);
+    std::generate(bytes.begin(), bytes.end(), [&] { return static_cast<u8>(rng()); });
+    return bytes;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("RealVfsFile[Mapped]", "[core]") {
+    const auto contents = RandomBytes(0x12345);
+    const TemporaryFile temporary{"citron_vfs_real_mapped.bin", contents};
+    FileSys::RealVfsFilesystem vfs;
+
+    const auto file = vfs.OpenMappedFile(temporary.Path());
+    REQUIRE(file != nullptr);
+    REQUIRE(file->GetSize() == contents.size());
+    REQUIRE(!file->IsWritable());
+    REQUIRE(file->ReadAllBytes() == contents);
+
+    // Views are clamped to the end of the file and forwarded through offset files
+    const auto view = file->ViewBytes(0x100, contents.size() - 0x10);
+    REQUIRE(view.size() == 0x10);
+    REQUIRE(std::equal(view.begin(), view.end(), contents.end() - 0x10));
+    REQUIRE(file->ViewBytes(1, contents.size() + 1).empty());
+
+    const FileSys::OffsetVfsFile offset_file{file, 0x1000, 0x200};
+    const auto offset_view = offset_file.ViewBytes(0x2000, 0x800);
+    REQUIRE(offset_view.size() == 0x800);
+    REQUIRE(std::equal(offset_view.begin(), offset_view.end(), contents.begin() + 0xA00));
+
+    // Files read through handles have nothing to view
+    REQUIRE(vfs.OpenFile(temporary.Path(), FileSys::OpenMode::Read)->ViewBytes(0x10, 0).empty());
+
+    // Empty files can not be mapped and fall back to the regular path
+    const TemporaryFile empty{"citron_vfs_real_empty.bin", {}};
+    const auto empty_file = vfs.OpenMappedFile(empty.Path());
+    REQUIRE(empty_file != nullptr);
+    REQUIRE(empty_file->GetSize() == 0);
+    REQUIRE(vfs.OpenMappedFile(empty.Path() + ".missing") == nullptr);
+}
+
+TEST_CASE("RealVfsFile[ConcurrentReads]", "[core]") {
+    const auto contents = RandomBytes(0x40000);
+    const TemporaryFile temporary{"citron_vfs_real_concurrent.bin", contents};
+    FileSys::RealVfsFilesystem vfs;
+
+    // Transfers on one file share its handle, each of them must still read from its own offset
+    const auto file = vfs.OpenFile(temporary.Path(), FileSys::OpenMode::Read);
+    REQUIRE(file != nullptr);
+    std::vector<bool> matches(4);
+    {
+        std::vector<std::jthread> threads;
+        for (size_t i = 0; i < matches.size(); ++i) {
+            threads.emplace_back([&, i] {
+                std::mt19937 rng{static_cast<u32>(i)};
+                std::vector<u8> buffer(0x1000);
+                bool match = true;
+                for (int read = 0; read < 2000; ++read) {
+                    const size_t offset = rng() % (contents.size() - buffer.size());
+                    match &= file->Read(buffer.data(), buffer.size(), offset) == buffer.size() &&
+                             std::equal(buffer.begin(), buffer.end(), contents.begin() + offset);
+                }
+                matches[i] = match;
+            });
+        }
+    }
+    REQUIRE(std::all_of(matches.begin(), matches.end(), [](bool match) { return match; }));
+}
+
+TEST_CASE("RealVfsFile[ReadThroughput]", "[.benchmark]") {
+    using Clock = std::chrono::steady_clock;
+    constexpr size_t file_size = 512_MiB;
+    constexpr size_t small_read_size = 0x200;
+    constexpr size_t num_small_reads = 1 << 20;
+    constexpr size_t large_read_size = 4_MiB;
+
+    const TemporaryFile temporary{"citron_vfs_real_benchmark.bin", RandomBytes(file_size)};
+    FileSys::RealVfsFilesystem vfs;
+    std::vector<u8> buffer(large_read_size);
+
+    const auto measure = [&](const FileSys::VirtualFile& file) {
+        std::mt19937_64 rng{0x3A9};
+        auto start = Clock::now();
+        for (size_t i = 0; i < num_small_reads; ++i) {
+            const size_t offset = rng() % (file_size - small_read_size);
+            file->Read(buffer.data(), small_read_size, offset);
+        }
+        const std::chrono::duration<double, std::nano> random_elapsed = Clock::now() - start;
+
+        start = Clock::now();
+        for (size_t offset = 0; offset < file_size; offset += large_read_size) {
+            file->Read(buffer.data(), large_read_size, offset);
+        }
+        const std::chrono::duration<double> sequential_elapsed = Clock::now() - start;
+
+        return std::pair{random_elapsed.count() / num_small_reads,
+                         static_cast<double>(file_size) / sequential_elapsed.count() / 1e9};
+    };
+
+    // Warm up the page cache, so that both paths read from memory
+    measure(vfs.OpenFile(temporary.Path(), FileSys::OpenMode::Read));
+    const auto [handle_random, handle_sequential] =
+        measure(vfs.OpenFile(temporary.Path(), FileSys::OpenMode::Read));
+    const auto [mapped_random, mapped_sequential] = measure(vfs.OpenMappedFile(temporary.Path()));
+
+    fmt::print("{} byte random reads: handle {:.0f} ns  mapped {:.0f} ns\n", small_read_size,
+               handle_random, mapped_random);
+    fmt::print("{} MiB sequential reads: handle {:.2f} GB/s  mapped {:.2f} GB/s\n",
+               large_read_size / 1_MiB, handle_sequential, mapped_sequential);
+}
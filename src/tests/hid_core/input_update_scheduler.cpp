@@ -0,0 +1,110 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "core/core_timing.h"
+#include "hid_core/frontend/emulated_controller.h"
+#include "hid_core/hid_core.h"
+#include "hid_core/resources/input_update_scheduler.h"
+
+namespace {
+using namespace std::chrono_literals;
+
+// Long enough for a burst of changes to fall into a single update
+constexpr auto UpdateDelay = 20ms;
+constexpr auto WaitTimeout = 5s;
+
+struct UpdateCounter {
+    void Update() {
+        std::scoped_lock lock{mutex};
+        ++count;
+        cv.notify_all();
+    }
+
+    bool WaitFor(int expected) {
+        std::unique_lock lock{mutex};
+        return cv.wait_for(lock, WaitTimeout, [&] { return count >= expected; });
+    }
+
+    int Count() {
+        std::scoped_lock lock{mutex};
+        return count;
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    int count{};
+};
+
+struct ScopeInit final {
+    ScopeInit() {
+        core_timing.SetMulticore(true);
+        core_timing.Initialize([]() {});
+        core_timing.SyncPause(false);
+    }
+
+    Core::Timing::CoreTiming core_timing;
+    Core::HID::HIDCore hid_core;
+};
+} // Anonymous namespace
+
+TEST_CASE("InputUpdateScheduler[NpadChange]", "[hid_core]") {
+    ScopeInit guard;
+    UpdateCounter npad_updates;
+    UpdateCounter motion_updates;
+    Service::HID::InputUpdateScheduler scheduler{
+        guard.hid_core,
+        guard.core_timing,
+        UpdateDelay,
+        UpdateDelay,
+        [&](std::chrono::nanoseconds) { npad_updates.Update(); },
+        [&](std::chrono::nanoseconds) { motion_updates.Update(); },
+    };
+
+    // No sampler is scheduled, so only a controller change can trigger an update
+    std::this_thread::sleep_for(UpdateDelay * 2);
+    REQUIRE(npad_updates.Count() == 0);
+
+    auto* const controller =
+        guard.hid_core.GetEmulatedController(Core::HID::NpadIdType::Player1);
+    controller->SetNpadStyleIndex(Core::HID::NpadStyleIndex::Fullkey);
+    controller->Connect();
+    REQUIRE(npad_updates.WaitFor(1));
+
+    // Both changes were coalesced into one update
+    std::this_thread::sleep_for(UpdateDelay * 2);
+    REQUIRE(npad_updates.Count() == 1);
+
+    // A later change schedules a new update
+    controller->Disconnect();
+    REQUIRE(npad_updates.WaitFor(2));
+    REQUIRE(motion_updates.Count() == 0);
+}
+
+TEST_CASE("InputUpdateScheduler[Unregister]", "[hid_core]") {
+    ScopeInit guard;
+    UpdateCounter npad_updates;
+    {
+        Service::HID::InputUpdateScheduler scheduler{
+            guard.hid_core,
+            guard.core_timing,
+            UpdateDelay,
+            UpdateDelay,
+            [&](std::chrono::nanoseconds) { npad_updates.Update(); },
+            [](std::chrono::nanoseconds) {},
+        };
+    }
+
+    auto* const controller =
+        guard.hid_core.GetEmulatedController(Core::HID::NpadIdType::Player1);
+    controller->SetNpadStyleIndex(Core::HID::NpadStyleIndex::Fullkey);
+    controller->Connect();
+    std::this_thread::sleep_for(UpdateDelay * 2);
+    REQUIRE(npad_updates.Count() == 0);
+}
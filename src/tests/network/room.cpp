@@ -0,0 +1,368 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+
+#include "common/common_types.h"
+#include "enet/enet.h"
+#include "network/network.h"
+#include "network/packet.h"
+#include "network/room.h"
+#include "network/room_member.h"
+#include "network/verify_user.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template <typename Predicate>
+bool WaitFor(Predicate&& predicate, std::chrono::seconds timeout) {
+    const auto deadline = Clock::now() + timeout;
+    while (!predicate()) {
+        if (Clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    return true;
+}
+
+/// Uses the token as the username, so members can be banned by name
+class TokenBackend final : public Network::VerifyUser::Backend {
+public:
+    Network::VerifyUser::UserData LoadUserData([[maybe_unused]] const std::string& verify_uid,
+                                               const std::string& token) override {
+        Network::VerifyUser::UserData user_data;
+        user_data.username = token;
+        return user_data;
+    }
+};
+
+/// A bare ENet client, for sending packets a RoomMember would not send
+class RawClient {
+public:
+    explicit RawClient(u16 port) {
+        host = enet_host_create(nullptr, 1, Network::NumChannels, 0, 0);
+        ENetAddress address{};
+        enet_address_set_host(&address, "127.0.0.1");
+        address.port = port;
+        peer = enet_host_connect(host, &address, Network::NumChannels, 0);
+    }
+
+    ~RawClient() {
+        enet_host_destroy(host);
+    }
+
+    /// Waits for a connection event, or for a received packet with the given message type
+    bool WaitFor(ENetEventType type, u8 message_type = 0) {
+        const auto deadline = Clock::now() + std::chrono::seconds{10};
+        while (Clock::now() < deadline) {
+            ENetEvent event;
+            if (enet_host_service(host, &event, 10) <= 0) {
+                continue;
+            }
+            bool found = event.type == type;
+            if (event.type == ENET_EVENT_TYPE_RECEIVE) {
+                found = found && event.packet->data[0] == message_type;
+                enet_packet_destroy(event.packet);
+            }
+            if (found) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Send(const Network::Packet& packet) {
+        enet_peer_send(peer, 0,
+                       enet_packet_create(packet.GetData(), packet.GetDataSize(),
+                                          ENET_PACKET_FLAG_RELIABLE));
+        enet_host_flush(host);
+    }
+
+    void SendJoinRequest(const std::string& nickname, const std::string& token) {
+        Network::Packet packet;
+        packet.Write(static_cast<u8>(Network::IdJoinRequest));
+        packet.Write(nickname);
+        packet.Write(Network::NoPreferredIP);
+        packet.Write(Network::network_version);
+        packet.Write(std::string{});
+        packet.Write(token);
+        Send(packet);
+    }
+
+    void SendLdnPacket(const Network::IPv4Address& remote_ip, bool broadcast) {
+        Network::Packet packet;
+        packet.Write(static_cast<u8>(Network::IdLdnPacket));
+        packet.Write(static_cast<u8>(Network::LDNPacketType::SyncNetwork));
+        packet.Write(Network::IPv4Address{10, 13, 0, 200});
+        packet.Write(remote_ip);
+        packet.Write(broadcast);
+        packet.Write(true);
+        packet.Write(std::vector<u8>(16, 0xA5));
+        Send(packet);
+    }
+
+private:
+    ENetHost* host{};
+    ENetPeer* peer{};
+};
+
+/// A room member that counts the LDN packets it receives from each sender
+struct TestMember {
+    explicit TestMember(const std::string& nickname, u16 port,
+                        const Network::IPv4Address& fake_ip, const std::string& token = "") {
+        callback = member.BindOnLdnPacketReceived([this](const Network::LDNPacket& packet) {
+            std::scoped_lock lock{mutex};
+            senders.push_back(packet.local_ip);
+        });
+        member.Join(nickname, "127.0.0.1", port, 0, fake_ip, "", token);
+    }
+
+    ~TestMember() {
+        member.Leave();
+    }
+
+    bool WaitForJoin() {
+        return ::WaitFor(
+            [this] {
+                const auto state = member.GetState();
+                return state == Network::RoomMember::State::Joined ||
+                       state == Network::RoomMember::State::Moderator;
+            },
+            std::chrono::seconds{10});
+    }
+
+    void SendTo(const Network::IPv4Address& remote_ip, bool broadcast = false) {
+        member.SendLdnPacket(Network::LDNPacket{
+            .type = Network::LDNPacketType::SyncNetwork,
+            .local_ip = member.GetFakeIpAddress(),
+            .remote_ip = remote_ip,
+            .broadcast = broadcast,
+            .reliable = true,
+            .data = std::vector<u8>(16, 0x5A),
+        });
+    }
+
+    std::vector<Network::IPv4Address> Senders() {
+        std::scoped_lock lock{mutex};
+        return senders;
+    }
+
+    Network::RoomMember member;
+    Network::RoomMember::CallbackHandle<Network::LDNPacket> callback;
+    std::mutex mutex;
+    std::vector<Network::IPv4Address> senders;
+};
+
+bool WaitForStatistics(const Network::Room& room, u64 received, u64 dropped) {
+    return WaitFor(
+        [&] {
+            const auto stats = room.GetRelayStatistics();
+            return stats.packets_received == received && stats.packets_dropped == dropped;
+        },
+        std::chrono::seconds{10});
+}
+
+} // Anonymous namespace
+
+TEST_CASE("Room[MemberIndex]", "[network]") {
+    constexpr u16 port = Network::DefaultRoomPort + 101;
+    constexpr Network::IPv4Address ip_a{10, 13, 0, 1};
+    constexpr Network::IPv4Address ip_b{10, 13, 0, 2};
+    constexpr Network::IPv4Address ip_c{10, 13, 0, 3};
+
+    Network::RoomNetwork room_network;
+    REQUIRE(room_network.Init());
+    Network::Room room;
+    REQUIRE(room.Create("Member index test", "", "127.0.0.1", port, "", 8, "", {},
+                        std::make_unique<Network::VerifyUser::NullBackend>()));
+
+    auto member_a = std::make_unique<TestMember>("member_a", port, ip_a);
+    REQUIRE(member_a->WaitForJoin());
+    auto member_b = std::make_unique<TestMember>("member_b", port, ip_b);
+    REQUIRE(member_b->WaitForJoin());
+    auto member_c = std::make_unique<TestMember>("member_c", port, ip_c);
+    REQUIRE(member_c->WaitForJoin());
+
+    const auto room_members = room.GetRoomMemberList();
+    REQUIRE(room_members.size() == 3);
+    CHECK(room_members[0].fake_ip == ip_a);
+    CHECK(room_members[1].fake_ip == ip_b);
+    CHECK(room_members[2].fake_ip == ip_c);
+
+    // Unicast packets only reach the member owning the destination address
+    member_a->SendTo(ip_c);
+    member_c->SendTo(ip_b);
+    REQUIRE(WaitForStatistics(room, 2, 0));
+    REQUIRE(WaitFor([&] { return member_b->Senders().size() == 1; }, std::chrono::seconds{10}));
+    REQUIRE(WaitFor([&] { return member_c->Senders().size() == 1; }, std::chrono::seconds{10}));
+    CHECK(member_b->Senders()[0] == ip_c);
+    CHECK(member_c->Senders()[0] == ip_a);
+    CHECK(member_a->Senders().empty());
+
+    // Removing the first member moves the others in the member list, the index has to follow
+    member_a.reset();
+    REQUIRE(WaitFor([&] { return room.GetRoomMemberList().size() == 2; },
+                    std::chrono::seconds{10}));
+    member_b->SendTo(ip_c);
+    member_c->SendTo(ip_b);
+    // The departed member's address is no longer routable
+    member_b->SendTo(ip_a);
+    REQUIRE(WaitForStatistics(room, 5, 1));
+    REQUIRE(WaitFor([&] { return member_b->Senders().size() == 2; }, std::chrono::seconds{10}));
+    REQUIRE(WaitFor([&] { return member_c->Senders().size() == 2; }, std::chrono::seconds{10}));
+    CHECK(member_b->Senders()[1] == ip_c);
+    CHECK(member_c->Senders()[1] == ip_b);
+
+    // A new member can take over the address of one that left
+    auto member_d = std::make_unique<TestMember>("member_d", port, ip_a);
+    REQUIRE(member_d->WaitForJoin());
+    member_c->SendTo(ip_a);
+    REQUIRE(WaitForStatistics(room, 6, 1));
+    REQUIRE(WaitFor([&] { return member_d->Senders().size() == 1; }, std::chrono::seconds{10}));
+    CHECK(member_d->Senders()[0] == ip_c);
+    CHECK(member_b->Senders().size() == 2);
+
+    member_b.reset();
+    member_c.reset();
+    member_d.reset();
+    room.Destroy();
+    room_network.Shutdown();
+}
+
+TEST_CASE("Room[DropNonMembers]", "[network]") {
+    constexpr u16 port = Network::DefaultRoomPort + 102;
+    constexpr Network::IPv4Address ip_member{10, 13, 0, 1};
+
+    Network::RoomNetwork room_network;
+    REQUIRE(room_network.Init());
+    Network::Room room;
+    const Network::Room::BanList ban_list{{"banned_user"}, {}};
+    REQUIRE(room.Create("Relay filter test", "", "127.0.0.1", port, "", 8, "", {},
+                        std::make_unique<TokenBackend>(), ban_list));
+
+    auto member = std::make_unique<TestMember>("member", port, ip_member, "member");
+    REQUIRE(member->WaitForJoin());
+
+    // A peer that connected without joining the room
+    RawClient unknown{port};
+    REQUIRE(unknown.WaitFor(ENET_EVENT_TYPE_CONNECT));
+    unknown.SendLdnPacket(ip_member, false);
+    unknown.SendLdnPacket(ip_member, true);
+    REQUIRE(WaitForStatistics(room, 2, 2));
+
+    // A banned user is turned away on join but stays connected
+    RawClient banned{port};
+    REQUIRE(banned.WaitFor(ENET_EVENT_TYPE_CONNECT));
+    banned.SendJoinRequest("banned", "banned_user");
+    REQUIRE(banned.WaitFor(ENET_EVENT_TYPE_RECEIVE, Network::IdHostBanned));
+    banned.SendLdnPacket(ip_member, false);
+    banned.SendLdnPacket(ip_member, true);
+    REQUIRE(WaitForStatistics(room, 4, 4));
+    CHECK(room.GetRoomMemberList().size() == 1);
+
+    // Packets from members still go through
+    auto other = std::make_unique<TestMember>("other", port, Network::IPv4Address{10, 13, 0, 2},
+                                              "other");
+    REQUIRE(other->WaitForJoin());
+    other->SendTo(ip_member);
+    REQUIRE(WaitForStatistics(room, 5, 4));
+    REQUIRE(WaitFor([&] { return member->Senders().size() == 1; }, std::chrono::seconds{10}));
+    CHECK(member->Senders()[0] == Network::IPv4Address{10, 13, 0, 2});
+
+    other.reset();
+    member.reset();
+    room.Destroy();
+    room_network.Shutdown();
+}
+
+TEST_CASE("Room[RelayLoad]", "[.benchmark]") {
+    constexpr u32 num_members = 16;
+    constexpr u32 packets_per_member = 1000;
+    constexpr u32 broadcast_interval = 8;
+    constexpr u16 port = Network::DefaultRoomPort + 100;
+
+    // Initializes ENet for the rooms and members created below
+    Network::RoomNetwork room_network;
+    REQUIRE(room_network.Init());
+
+    Network::Room room;
+    REQUIRE(room.Create("Relay load test", "", "127.0.0.1", port, "", num_members, "", {},
+                        std::make_unique<Network::VerifyUser::NullBackend>()));
+
+    std::atomic<u64> num_received{};
+    std::vector<std::unique_ptr<Network::RoomMember>> members;
+    std::vector<Network::RoomMember::CallbackHandle<Network::LDNPacket>> callbacks;
+    for (u32 i = 0; i < num_members; ++i) {
+        auto& member = members.emplace_back(std::make_unique<Network::RoomMember>());
+        callbacks.push_back(member->BindOnLdnPacketReceived(
+            [&num_received](const Network::LDNPacket&) { ++num_received; }));
+        member->Join(fmt::format("member{:02}", i), "127.0.0.1", port);
+    }
+    REQUIRE(WaitFor(
+        [&] {
+            return std::ranges::all_of(members, [](const auto& member) {
+                return member->GetState() == Network::RoomMember::State::Joined;
+            });
+        },
+        std::chrono::seconds{10}));
+
+    // Each member streams packets to its neighbour, with the occasional broadcast like the
+    // network scans and syncs of a local wireless session
+    const std::vector<u8> payload(512, 0x5A);
+    u64 num_expected = 0;
+    const auto start = Clock::now();
+    for (u32 packet = 0; packet < packets_per_member; ++packet) {
+        for (u32 i = 0; i < num_members; ++i) {
+            const bool broadcast = packet % broadcast_interval == 0;
+            members[i]->SendLdnPacket(Network::LDNPacket{
+                .type = Network::LDNPacketType::SyncNetwork,
+                .local_ip = members[i]->GetFakeIpAddress(),
+                .remote_ip = members[(i + 1) % num_members]->GetFakeIpAddress(),
+                .broadcast = broadcast,
+                .reliable = true,
+                .data = payload,
+            });
+            num_expected += broadcast ? num_members - 1 : 1;
+        }
+    }
+    const bool received_all =
+        WaitFor([&] { return num_received == num_expected; }, std::chrono::seconds{60});
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    const Network::RelayStatistics stats = room.GetRelayStatistics();
+    const double average_latency_us =
+        stats.packets_forwarded == 0
+            ? 0.0
+            : std::chrono::duration<double, std::micro>(stats.total_latency).count() /
+                  static_cast<double>(stats.packets_received - stats.packets_dropped);
+    fmt::print("Relay {} members: {} of {} packets delivered in {:.3f} s ({:.0f} packets/s)\n",
+               num_members, num_received.load(), num_expected, elapsed.count(),
+               static_cast<double>(num_received.load()) / elapsed.count());
+    fmt::print("Room: received {} ({} bytes), forwarded {} ({} bytes), dropped {}\n",
+               stats.packets_received, stats.bytes_received, stats.packets_forwarded,
+               stats.bytes_forwarded, stats.packets_dropped);
+    fmt::print("Room: average latency {:.1f} us, max latency {:.1f} us\n", average_latency_us,
+               std::chrono::duration<double, std::micro>(stats.max_latency).count());
+
+    for (auto& member : members) {
+        member->Leave();
+    }
+    callbacks.clear();
+    members.clear();
+    room.Destroy();
+    room_network.Shutdown();
+
+    REQUIRE(received_all);
+}
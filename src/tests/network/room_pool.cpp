@@ -0,0 +1,193 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+
+#include "common/common_types.h"
+#include "network/network.h"
+#include "network/room.h"
+#include "network/room_member.h"
+#include "network/room_pool.h"
+#include "network/verify_user.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template <typename Predicate>
+bool WaitFor(Predicate&& predicate) {
+    const auto deadline = Clock::now() + std::chrono::seconds{10};
+    while (!predicate()) {
+        if (Clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    return true;
+}
+
+/// Uses the token as the username, so the host and banned members can be told apart
+class TokenBackend final : public Network::VerifyUser::Backend {
+public:
+    Network::VerifyUser::UserData LoadUserData([[maybe_unused]] const std::string& verify_uid,
+                                               const std::string& token) override {
+        Network::VerifyUser::UserData user_data;
+        user_data.username = token;
+        return user_data;
+    }
+};
+
+Network::RoomPool::RoomConfig MakeConfig(u32 index, u16 port) {
+    return Network::RoomPool::RoomConfig{
+        .name = fmt::format("Pool room {}", index),
+        .description = "",
+        .bind_address = "127.0.0.1",
+        .port = port,
+        .password = "",
+        .max_members = 8,
+        .host_username = "host",
+        .preferred_game = {},
+        .enable_citron_mods = false,
+    };
+}
+
+bool IsInRoom(const Network::RoomMember& member) {
+    const auto state = member.GetState();
+    return state == Network::RoomMember::State::Joined ||
+           state == Network::RoomMember::State::Moderator;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("RoomPool[Workers]", "[network]") {
+    constexpr u32 num_rooms = 3;
+    constexpr u16 base_port = Network::DefaultRoomPort + 110;
+
+    Network::RoomNetwork room_network;
+    REQUIRE(room_network.Init());
+    Network::RoomPool pool;
+    for (u32 i = 0; i < num_rooms; ++i) {
+        REQUIRE(pool.AddRoom(MakeConfig(i, static_cast<u16>(base_port + i)),
+                             std::make_unique<TokenBackend>()));
+    }
+    // Fewer workers than rooms, so one worker services several rooms
+    pool.Start(2);
+
+    // Two members per room, each room relays one packet between them
+    std::atomic<u32> num_received{};
+    std::vector<std::unique_ptr<Network::RoomMember>> members;
+    std::vector<Network::RoomMember::CallbackHandle<Network::LDNPacket>> callbacks;
+    for (u32 i = 0; i < num_rooms * 2; ++i) {
+        auto& member = members.emplace_back(std::make_unique<Network::RoomMember>());
+        callbacks.push_back(member->BindOnLdnPacketReceived(
+            [&num_received](const Network::LDNPacket&) { ++num_received; }));
+        member->Join(fmt::format("member{}", i), "127.0.0.1",
+                     static_cast<u16>(base_port + i / 2));
+    }
+    REQUIRE(WaitFor([&] {
+        return std::ranges::all_of(members, [](const auto& member) { return IsInRoom(*member); });
+    }));
+    for (u32 i = 0; i < num_rooms; ++i) {
+        members[i * 2]->SendLdnPacket(Network::LDNPacket{
+            .type = Network::LDNPacketType::SyncNetwork,
+            .local_ip = members[i * 2]->GetFakeIpAddress(),
+            .remote_ip = members[i * 2 + 1]->GetFakeIpAddress(),
+            .broadcast = false,
+            .reliable = true,
+            .data = std::vector<u8>(16, 0x5A),
+        });
+    }
+    REQUIRE(WaitFor([&] { return num_received == num_rooms; }));
+
+    const auto rooms = pool.GetRooms();
+    REQUIRE(rooms.size() == num_rooms);
+    for (const auto& weak_room : rooms) {
+        const auto room = weak_room.lock();
+        REQUIRE(room);
+        CHECK(room->GetRoomMemberList().size() == 2);
+        CHECK(room->GetRelayStatistics().packets_forwarded == 1);
+    }
+    const std::string metrics = pool.DumpMetrics();
+    CHECK(std::ranges::count(metrics, '\n') == num_rooms);
+
+    for (auto& member : members) {
+        member->Leave();
+    }
+    callbacks.clear();
+    members.clear();
+
+    pool.Stop();
+    for (const auto& weak_room : rooms) {
+        CHECK(weak_room.lock()->GetState() == Network::Room::State::Closed);
+    }
+    room_network.Shutdown();
+}
+
+TEST_CASE("RoomPool[SharedBanList]", "[network]") {
+    constexpr u16 port_a = Network::DefaultRoomPort + 120;
+    constexpr u16 port_b = Network::DefaultRoomPort + 121;
+
+    Network::RoomNetwork room_network;
+    REQUIRE(room_network.Init());
+    const Network::Room::BanList initial_bans{{"old_user"}, {"10.0.0.1"}};
+    Network::RoomPool pool{initial_bans};
+    REQUIRE(pool.AddRoom(MakeConfig(0, port_a), std::make_unique<TokenBackend>()));
+    REQUIRE(pool.AddRoom(MakeConfig(1, port_b), std::make_unique<TokenBackend>()));
+    pool.Start(1);
+
+    // The ban list passed to the pool applies to every room
+    for (const auto& weak_room : pool.GetRooms()) {
+        const Network::Room::BanList bans = weak_room.lock()->GetBanList();
+        CHECK(bans.first == initial_bans.first);
+        CHECK(bans.second == initial_bans.second);
+    }
+
+    Network::RoomMember host;
+    Network::RoomMember target;
+    host.Join("host", "127.0.0.1", port_a, 0, Network::NoPreferredIP, "", "host");
+    target.Join("target", "127.0.0.1", port_a, 0, Network::NoPreferredIP, "", "target_user");
+    REQUIRE(WaitFor([&] {
+        return host.GetState() == Network::RoomMember::State::Moderator && IsInRoom(target);
+    }));
+
+    // A ban in one room lands in the list shared by the pool
+    host.SendModerationRequest(Network::IdModBan, "target");
+    REQUIRE(WaitFor([&] {
+        const Network::Room::BanList bans = pool.GetBanList();
+        return std::ranges::find(bans.first, "target_user") != bans.first.end();
+    }));
+    const Network::Room::BanList bans = pool.GetBanList();
+    CHECK(std::ranges::find(bans.first, "old_user") != bans.first.end());
+    CHECK(std::ranges::find(bans.second, "127.0.0.1") != bans.second.end());
+    for (const auto& weak_room : pool.GetRooms()) {
+        const Network::Room::BanList room_bans = weak_room.lock()->GetBanList();
+        CHECK(room_bans.first == bans.first);
+        CHECK(room_bans.second == bans.second);
+    }
+
+    // So the banned user can't join the other room either
+    Network::RoomMember rejoin;
+    std::atomic_bool banned{};
+    const auto error_callback =
+        rejoin.BindOnError([&banned](const Network::RoomMember::Error& error) {
+            banned = banned || error == Network::RoomMember::Error::HostBanned;
+        });
+    rejoin.Join("target", "127.0.0.1", port_b, 0, Network::NoPreferredIP, "", "target_user");
+    REQUIRE(WaitFor([&] { return banned.load(); }));
+    CHECK(!IsInRoom(rejoin));
+
+    host.Leave();
+    target.Leave();
+    rejoin.Leave();
+    pool.Stop();
+    room_network.Shutdown();
+}
@@ -0,0 +1,230 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <sstream>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "shader_recompiler/frontend/ir/basic_block.h"
+#include "shader_recompiler/frontend/ir/ir_emitter.h"
+#include "shader_recompiler/frontend/ir/program.h"
+#include "shader_recompiler/frontend/maxwell/control_flow.h"
+#include "shader_recompiler/frontend/maxwell/translate_program.h"
+#include "shader_recompiler/host_translate_info.h"
+#include "shader_recompiler/ir_opt/passes.h"
+#include "shader_recompiler/object_pool.h"
+#include "video_core/shader_environment.h"
+
+namespace {
+
+using namespace Shader;
+
+size_t CountOpcode(const IR::Block& block, IR::Opcode opcode) {
+    return std::ranges::count_if(block.Instructions(), [opcode](const IR::Inst& inst) {
+        return inst.GetOpcode() == opcode;
+    });
+}
+
+size_t CountOpcode(const IR::Program& program, IR::Opcode opcode) {
+    size_t count{};
+    for (const IR::Block* const block : program.blocks) {
+        count += CountOpcode(*block, opcode);
+    }
+    return count;
+}
+
+// True when two instructions in a block compute the same value from the same operands
+bool HasRedundantInstructions(const IR::Program& program) {
+    for (const IR::Block* const block : program.blocks) {
+        for (auto lhs = block->begin(); lhs != block->end(); ++lhs) {
+            if (lhs->MayHaveSideEffects() || lhs->Type() == IR::Type::Void ||
+                lhs->GetOpcode() == IR::Opcode::Phi || lhs->GetOpcode() == IR::Opcode::Identity) {
+                continue;
+            }
+            for (auto rhs = std::next(lhs); rhs != block->end(); ++rhs) {
+                if (rhs->GetOpcode() != lhs->GetOpcode() || rhs->NumArgs() != lhs->NumArgs()) {
+                    continue;
+                }
+                bool equal{true};
+                for (size_t arg = 0; arg < lhs->NumArgs(); ++arg) {
+                    equal &= lhs->Arg(arg).Resolve() == rhs->Arg(arg).Resolve();
+                }
+                if (equal) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+// Maxwell instructions, predicated on PT
+constexpr u64 PT{u64{7} << 16};
+constexpr u64 RZ{0xff};
+
+constexpr u64 S2R(u64 dest, u64 special_register) {
+    return (u64{0xf0c8} << 48) | PT | (special_register << 20) | dest;
+}
+
+constexpr u64 IADD_cbuf(u64 dest, u64 src_a, u64 binding, u64 byte_offset) {
+    return (u64{0x4c10} << 48) | (binding << 34) | ((byte_offset / 4) << 20) | PT | (src_a << 8) |
+           dest;
+}
+
+constexpr u64 IADD_reg(u64 dest, u64 src_a, u64 src_b) {
+    return (u64{0x5c10} << 48) | (src_b << 20) | PT | (src_a << 8) | dest;
+}
+
+constexpr u64 MOV32I(u64 dest, u32 value) {
+    return (u64{0x010} << 52) | (u64{value} << 20) | PT | (u64{0xf} << 12) | dest;
+}
+
+// STG.E.32 [addr + offset], data
+constexpr u64 STG(u64 addr, u64 offset, u64 data) {
+    return (u64{0xeed8} << 48) | (u64{4} << 48) | (u64{1} << 45) | (offset << 20) | PT |
+           (addr << 8) | data;
+}
+
+constexpr u64 EXIT() {
+    return (u64{0xe300} << 48) | PT | 0xf;
+}
+
+// A compute shader environment as stored in the pipeline cache, words at multiples of 32 bytes
+// are scheduling information
+VideoCommon::FileEnvironment MakeComputeEnvironment(std::vector<u64> code) {
+    for (size_t index = 0; index < code.size(); index += 4) {
+        code.insert(code.begin() + static_cast<std::ptrdiff_t>(index), 0);
+    }
+    std::stringstream stream;
+    const auto write{[&stream](const auto& value) {
+        stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }};
+    write(static_cast<u64>(code.size() * sizeof(u64)));
+    write(u64{0}); // Texture types
+    write(u64{0}); // Texture pixel formats
+    write(u64{0}); // Constant buffer values
+    write(u64{0}); // Constant buffer replacements
+    write(u32{0}); // Local memory size
+    write(u32{0}); // Texture bound buffer
+    write(u32{0}); // Start address
+    write(u32{0}); // Lowest address read
+    write(static_cast<u32>((code.size() - 1) * sizeof(u64)));
+    write(u32{1}); // Viewport transform state
+    write(Stage::Compute);
+    stream.write(reinterpret_cast<const char*>(code.data()),
+                 static_cast<std::streamsize>(code.size() * sizeof(u64)));
+    write(std::array<u32, 3>{64, 1, 1});
+    write(u32{0}); // Shared memory size
+
+    VideoCommon::FileEnvironment env;
+    env.Deserialize(stream);
+    return env;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("GlobalValueNumbering[Dominance]", "[shader_recompiler]") {
+    ObjectPool<IR::Inst> inst_pool;
+    ObjectPool<IR::Block> block_pool;
+    IR::Block* const entry{block_pool.Create(inst_pool)};
+    IR::Block* const then_block{block_pool.Create(inst_pool)};
+    IR::Block* const merge_block{block_pool.Create(inst_pool)};
+    entry->AddBranch(then_block);
+    entry->AddBranch(merge_block);
+    then_block->AddBranch(merge_block);
+
+    IR::Program program;
+    program.stage = Stage::Compute;
+    program.blocks = {entry, then_block, merge_block};
+    program.post_order_blocks = {merge_block, then_block, entry};
+
+    const auto store{[](IR::IREmitter& ir, const IR::U32& value) {
+        ir.WriteGlobal32(ir.Imm64(u64{0x1000}), value);
+    }};
+    IR::IREmitter entry_ir{*entry};
+    const IR::U32 cbuf{entry_ir.GetCbuf(entry_ir.Imm32(0), entry_ir.Imm32(0x10))};
+    const IR::U32 sum{entry_ir.IAdd(cbuf, entry_ir.Imm32(4))};
+    store(entry_ir, sum);
+
+    // Dominated by the entry, the sum is recomputed with its operands swapped
+    IR::IREmitter then_ir{*then_block};
+    const IR::U32 then_cbuf{then_ir.GetCbuf(then_ir.Imm32(0), then_ir.Imm32(0x10))};
+    store(then_ir, then_ir.IAdd(then_ir.Imm32(4), then_cbuf));
+    store(then_ir, then_ir.IMul(then_cbuf, then_ir.Imm32(3)));
+
+    // The product computed in the then block does not dominate the merge block
+    IR::IREmitter merge_ir{*merge_block};
+    const IR::U32 merge_cbuf{merge_ir.GetCbuf(merge_ir.Imm32(0), merge_ir.Imm32(0x10))};
+    store(merge_ir, merge_ir.IMul(merge_cbuf, merge_ir.Imm32(3)));
+    store(merge_ir, merge_ir.ISub(merge_ir.IAdd(merge_cbuf, merge_ir.Imm32(4)), sum));
+
+    Optimization::GlobalValueNumberingPass(program);
+    Optimization::DeadCodeEliminationPass(program);
+    REQUIRE_NOTHROW(Optimization::VerificationPass(program));
+
+    REQUIRE(CountOpcode(*entry, IR::Opcode::GetCbufU32) == 1);
+    REQUIRE(CountOpcode(*then_block, IR::Opcode::GetCbufU32) == 0);
+    REQUIRE(CountOpcode(*merge_block, IR::Opcode::GetCbufU32) == 0);
+    REQUIRE(CountOpcode(*then_block, IR::Opcode::IAdd32) == 0);
+    REQUIRE(CountOpcode(*then_block, IR::Opcode::IMul32) == 1);
+    REQUIRE(CountOpcode(*merge_block, IR::Opcode::IMul32) == 1);
+
+    // The difference between the sum and itself is folded to zero
+    REQUIRE(CountOpcode(*merge_block, IR::Opcode::ISub32) == 0);
+    const IR::Inst& last_store{merge_block->Instructions().back()};
+    REQUIRE(last_store.Arg(1).IsImmediate());
+    REQUIRE(last_store.Arg(1).U32() == 0);
+}
+
+TEST_CASE("GlobalValueNumbering[FileEnvironment]", "[shader_recompiler]") {
+    constexpr u64 SR_TID_X{33};
+    const std::vector<std::vector<u64>> shaders{
+        {
+            // The same constant buffer offset is added to the thread ID twice
+            S2R(0, SR_TID_X),
+            IADD_cbuf(1, 0, 0, 0x24),
+            IADD_cbuf(2, 0, 0, 0x24),
+            IADD_reg(3, 1, 2),
+            MOV32I(8, 0),
+            MOV32I(9, 0),
+            STG(8, 0, 3),
+            STG(8, 4, 2),
+            EXIT(),
+        },
+        {
+            // Constant buffer values are loaded again for each use
+            IADD_cbuf(0, RZ, 1, 0x10),
+            IADD_cbuf(1, RZ, 1, 0x10),
+            IADD_reg(2, 0, 1),
+            IADD_cbuf(3, RZ, 1, 0x10),
+            IADD_reg(4, 3, 0),
+            MOV32I(8, 0),
+            MOV32I(9, 0),
+            STG(8, 0, 2),
+            STG(8, 4, 4),
+            EXIT(),
+        },
+    };
+    for (const auto& code : shaders) {
+        VideoCommon::FileEnvironment env{MakeComputeEnvironment(code)};
+        ObjectPool<Maxwell::Flow::Block> flow_block_pool;
+        ObjectPool<IR::Inst> inst_pool;
+        ObjectPool<IR::Block> block_pool;
+        Arena arena;
+        Maxwell::Flow::CFG cfg{env, flow_block_pool, env.StartAddress()};
+        const HostTranslateInfo host_info{
+            .support_float64 = true,
+            .support_float16 = true,
+            .support_int64 = true,
+        };
+        const IR::Program program{
+            Maxwell::TranslateProgram(inst_pool, block_pool, arena, env, cfg, host_info)};
+        REQUIRE_NOTHROW(Optimization::VerificationPass(program));
+        REQUIRE(!HasRedundantInstructions(program));
+        REQUIRE(CountOpcode(program, IR::Opcode::GetCbufU32) == 1);
+    }
+}
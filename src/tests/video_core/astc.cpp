@@ -0,0 +1,166 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <chrono>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+
+#include "common/common_types.h"
+#include "video_core/textures/astc.h"
+
+namespace {
+
+struct Footprint {
+    u32 width;
+    u32 height;
+};
+
+constexpr std::array<Footprint, 14> FOOTPRINTS{{
+    {4, 4},
+    {5, 4},
+    {5, 5},
+    {6, 5},
+    {6, 6},
+    {8, 5},
+    {8, 6},
+    {8, 8},
+    {10, 5},
+    {10, 6},
+    {10, 8},
+    {10, 10},
+    {12, 10},
+    {12, 12},
+}};
+
+// Color endpoint modes that do not require HDR decoding
+constexpr std::array<u32, 10> LDR_ENDPOINT_MODES{0, 1, 4, 5, 6, 8, 9, 10, 12, 13};
+
+void WriteLowBits(std::array<u8, 16>& block, u32 value, u32 num_bits) {
+    for (u32 bit = 0; bit < num_bits; ++bit) {
+        const u8 mask = static_cast<u8>(1U << (bit % 8));
+        if ((value >> bit) & 1) {
+            block[bit / 8] |= mask;
+        } else {
+            block[bit / 8] &= static_cast<u8>(~mask);
+        }
+    }
+}
+
+// Number of bits taken by num_weights texel weights of the given block mode weight range R
+u32 WeightBitCount(u32 range, u32 num_weights) {
+    switch (range) {
+    case 2:
+        return num_weights;
+    case 3:
+        return (num_weights * 8 + 4) / 5;
+    case 4:
+        return num_weights * 2;
+    case 5:
+        return (num_weights * 7 + 2) / 3;
+    case 6:
+        return num_weights + (num_weights * 8 + 4) / 5;
+    default:
+        return num_weights * 3;
+    }
+}
+
+// Builds a valid LDR block for the given footprint. Endpoint and weight bits are random, while the
+// block mode is constrained to grids and weight ranges that leave room for the endpoint data.
+std::array<u8, 16> MakeBlock(std::mt19937& rng, Footprint footprint) {
+    std::array<u8, 16> block;
+    for (u8& byte : block) {
+        byte = static_cast<u8>(rng());
+    }
+    if (rng() % 16 == 0) {
+        // LDR void extent
+        WriteLowBits(block, 0xDFC, 12);
+        return block;
+    }
+
+    const bool dual_plane = rng() % 4 == 0;
+    u32 grid_width = 0;
+    u32 grid_height = 0;
+    u32 range = 0;
+    do {
+        grid_width = 4 + static_cast<u32>(rng() % (std::min(footprint.width, 7U) - 3));
+        grid_height = 2 + static_cast<u32>(rng() % (std::min(footprint.height, 5U) - 1));
+        range = 2 + static_cast<u32>(rng() % 5);
+        // Keep enough endpoint bits for eight values of at least two bits each
+    } while (WeightBitCount(range, grid_width * grid_height * (dual_plane ? 2 : 1)) > 77);
+
+    // Block mode layout 0 of table C.2.8
+    u32 mode = (range >> 1) | ((range & 1) << 4);
+    mode |= (grid_height - 2) << 5;
+    mode |= (grid_width - 4) << 7;
+    mode |= dual_plane ? 0x400 : 0;
+
+    const u32 endpoint_mode = LDR_ENDPOINT_MODES[rng() % LDR_ENDPOINT_MODES.size()];
+    WriteLowBits(block, mode | (endpoint_mode << 13), 17);
+    return block;
+}
+
+std::vector<u8> MakeImage(std::mt19937& rng, Footprint footprint, u32 cols, u32 rows) {
+    std::vector<u8> data;
+    data.reserve(cols * rows * 16);
+    for (u32 i = 0; i < cols * rows; ++i) {
+        const std::array<u8, 16> block = MakeBlock(rng, footprint);
+        data.insert(data.end(), block.begin(), block.end());
+    }
+    return data;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("ASTC[SimdMatchesScalar]", "[video_core]") {
+    std::mt19937 rng{0x41535443};
+    for (const Footprint footprint : FOOTPRINTS) {
+        // Dimensions that are not a multiple of the footprint exercise partial blocks
+        constexpr u32 cols = 7;
+        constexpr u32 rows = 5;
+        const u32 width = cols * footprint.width - 1;
+        const u32 height = rows * footprint.height - 2;
+        const std::vector<u8> data = MakeImage(rng, footprint, cols, rows);
+
+        std::vector<u8> simd(width * height * 4);
+        std::vector<u8> scalar(width * height * 4);
+        Tegra::Texture::ASTC::Decompress(data, width, height, 1, footprint.width,
+                                         footprint.height, simd);
+        Tegra::Texture::ASTC::DecompressScalar(data, width, height, 1, footprint.width,
+                                               footprint.height, scalar);
+        INFO("Footprint " << footprint.width << "x" << footprint.height);
+        REQUIRE(simd == scalar);
+    }
+}
+
+TEST_CASE("ASTC[Throughput]", "[.benchmark]") {
+    using Clock = std::chrono::steady_clock;
+    constexpr u32 cols = 128;
+    constexpr u32 rows = 128;
+    constexpr u32 iterations = 8;
+
+    std::mt19937 rng{0x41535443};
+    for (const Footprint footprint : FOOTPRINTS) {
+        const u32 width = cols * footprint.width;
+        const u32 height = rows * footprint.height;
+        const std::vector<u8> data = MakeImage(rng, footprint, cols, rows);
+        std::vector<u8> output(width * height * 4);
+
+        const auto measure = [&](auto&& decompress) {
+            const auto start = Clock::now();
+            for (u32 i = 0; i < iterations; ++i) {
+                decompress(data, width, height, 1, footprint.width, footprint.height, output);
+            }
+            const std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+            return static_cast<double>(width) * height * iterations / elapsed.count();
+        };
+        const double scalar = measure(Tegra::Texture::ASTC::DecompressScalar);
+        const double simd = measure(Tegra::Texture::ASTC::Decompress);
+        fmt::print("ASTC {:>2}x{:<2}  scalar {:8.2f} MTexels/s  dispatched {:8.2f} MTexels/s\n",
+                   footprint.width, footprint.height, scalar, simd);
+    }
+}
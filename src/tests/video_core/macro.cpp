@@ -0,0 +1,434 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+
+#include "common/common_types.h"
+#include "core/core.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/host1x/host1x.h"
+#include "video_core/macro/macro.h"
+#include "video_core/macro/macro_interpreter.h"
+#include "video_core/memory_manager.h"
+#ifdef ARCHITECTURE_x86_64
+#include "video_core/macro/macro_jit_x64.h"
+#endif
+
+namespace {
+
+using Tegra::Macro::ALUOperation;
+using Tegra::Macro::BranchCondition;
+using Tegra::Macro::Operation;
+using Tegra::Macro::ResultOperation;
+using Tegra::Engines::Maxwell3D;
+using Regs = Maxwell3D::Regs;
+
+constexpr u32 SCRATCH = static_cast<u32>(MAXWELL3D_REG_INDEX(shadow_scratch));
+constexpr u32 EXIT = 1U << 7;
+
+constexpr u32 Encode(Operation op, ResultOperation result, u32 dst, u32 src_a) {
+    return static_cast<u32>(op) | (static_cast<u32>(result) << 4) | (dst << 8) | (src_a << 11);
+}
+
+constexpr u32 Alu(ALUOperation alu, ResultOperation result, u32 dst, u32 src_a, u32 src_b) {
+    return Encode(Operation::ALU, result, dst, src_a) | (src_b << 14) |
+           (static_cast<u32>(alu) << 17);
+}
+
+constexpr u32 AddImmediate(ResultOperation result, u32 dst, u32 src_a, s32 immediate) {
+    return Encode(Operation::AddImmediate, result, dst, src_a) |
+           ((static_cast<u32>(immediate) & 0x3FFFF) << 14);
+}
+
+constexpr u32 Read(ResultOperation result, u32 dst, u32 src_a, u32 method) {
+    return Encode(Operation::Read, result, dst, src_a) | (method << 14);
+}
+
+constexpr u32 ExtractInsert(ResultOperation result, u32 dst, u32 src_a, u32 src_b, u32 src_bit,
+                            u32 size, u32 dst_bit) {
+    return Encode(Operation::ExtractInsert, result, dst, src_a) | (src_b << 14) |
+           (src_bit << 17) | (size << 22) | (dst_bit << 27);
+}
+
+constexpr u32 Branch(BranchCondition cond, u32 src_a, s32 offset, bool annul = false) {
+    return static_cast<u32>(Operation::Branch) | (static_cast<u32>(cond) << 4) |
+           (annul ? 1U << 5 : 0U) | (src_a << 11) | ((static_cast<u32>(offset) & 0x3FFFF) << 14);
+}
+
+constexpr u32 ExtractShift(Operation op, ResultOperation result, u32 dst, u32 src_a, u32 src_b,
+                           u32 src_bit, u32 size, u32 dst_bit) {
+    return Encode(op, result, dst, src_a) | (src_b << 14) | (src_bit << 17) | (size << 22) |
+           (dst_bit << 27);
+}
+
+constexpr u32 SetMethod(u32 dst, u32 method, u32 increment) {
+    return AddImmediate(ResultOperation::MoveAndSetMethod, dst, 0,
+                        static_cast<s32>(method | (increment << 12)));
+}
+
+constexpr u32 Nop(u32 flags = 0) {
+    return AddImmediate(ResultOperation::Move, 0, 0, 0) | flags;
+}
+
+struct RecordedMacro {
+    const char* name;
+    std::vector<u32> code;
+    std::vector<u32> parameters;
+};
+
+// Macros shaped after the common instancing and constant buffer update patterns. They only
+// touch the scratch registers so they can run without a rasterizer.
+std::vector<RecordedMacro> MakeRecordedMacros() {
+    std::vector<RecordedMacro> macros;
+    // Copies a counted parameter list into consecutive registers
+    macros.push_back({
+        "upload",
+        {
+            SetMethod(2, SCRATCH + 0x10, 1),
+            AddImmediate(ResultOperation::Move, 3, 1, 0),
+            AddImmediate(ResultOperation::IgnoreAndFetch, 4, 0, 0),
+            AddImmediate(ResultOperation::Move, 3, 3, -1),
+            Branch(BranchCondition::NotZero, 3, -2),
+            AddImmediate(ResultOperation::MoveAndSend, 0, 4, 0),
+            Nop(EXIT),
+            Nop(),
+        },
+        {8, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88},
+    });
+    // Instanced draw bookkeeping: accumulate an instance counter and pack a draw word
+    macros.push_back({
+        "instance",
+        {
+            Read(ResultOperation::Move, 2, 0, SCRATCH + 0x20),
+            Alu(ALUOperation::Add, ResultOperation::Move, 2, 2, 1),
+            SetMethod(3, SCRATCH + 0x20, 0),
+            AddImmediate(ResultOperation::MoveAndSend, 0, 2, 0),
+            AddImmediate(ResultOperation::IgnoreAndFetch, 5, 0, 0),
+            ExtractInsert(ResultOperation::Move, 4, 2, 5, 0, 16, 16),
+            SetMethod(3, SCRATCH + 0x21, 1),
+            Alu(ALUOperation::Xor, ResultOperation::MoveAndSend, 6, 4, 2),
+            Alu(ALUOperation::AndNot, ResultOperation::MoveAndSend, 6, 6, 5),
+            Nop(EXIT),
+            Nop(),
+        },
+        {0x1234, 0x5678},
+    });
+    // Constant buffer binding: only rebinds when the address changed
+    macros.push_back({
+        "bind",
+        {
+            Read(ResultOperation::Move, 2, 0, SCRATCH + 0x30),
+            Alu(ALUOperation::Subtract, ResultOperation::Move, 3, 2, 1),
+            Branch(BranchCondition::Zero, 3, 6),
+            AddImmediate(ResultOperation::IgnoreAndFetch, 5, 0, 0),
+            SetMethod(4, SCRATCH + 0x30, 1),
+            AddImmediate(ResultOperation::MoveAndSend, 0, 1, 0),
+            AddImmediate(ResultOperation::MoveAndSend, 0, 5, 0),
+            Alu(ALUOperation::Or, ResultOperation::MoveAndSend, 0, 1, 5),
+            Nop(EXIT),
+            Nop(),
+        },
+        {0xCAFE, 0xBEEF},
+    });
+    return macros;
+}
+
+struct RandomMacro {
+    std::vector<u32> code;
+    u32 num_parameters;
+};
+
+constexpr std::array<ALUOperation, 9> ALU_OPERATIONS{
+    ALUOperation::Add, ALUOperation::AddWithCarry, ALUOperation::Subtract,
+    ALUOperation::SubtractWithBorrow, ALUOperation::Xor, ALUOperation::Or,
+    ALUOperation::And, ALUOperation::AndNot, ALUOperation::Nand,
+};
+
+// Generates macros that are valid on every path: branches only skip forward over code without
+// parameter fetches, loops have an immediate trip count kept in $r7, shift amounts are below 32
+// and sends stay inside the scratch registers.
+class MacroGenerator {
+public:
+    explicit MacroGenerator(std::mt19937& rng_) : rng{rng_} {}
+
+    RandomMacro Generate() {
+        code.clear();
+        num_fetches = 0;
+        sends_left = 48;
+        multiplier = 1;
+
+        SetMethodAddress();
+        const u32 num_blocks = 4 + Random(8);
+        for (u32 block = 0; block < num_blocks; ++block) {
+            switch (Random(4)) {
+            case 0:
+                EmitForwardBranch();
+                break;
+            case 1:
+                EmitLoop();
+                break;
+            default:
+                EmitStraight(true);
+                break;
+            }
+        }
+        // Expose the registers and the carry flag to the comparison
+        code.push_back(SetMethod(0, SCRATCH + 0xF0, 1));
+        for (u32 reg = 1; reg < 8; ++reg) {
+            code.push_back(AddImmediate(ResultOperation::MoveAndSend, 0, reg, 0));
+        }
+        code.push_back(Alu(ALUOperation::AddWithCarry, ResultOperation::MoveAndSend, 0, 0, 0));
+        code.push_back(Nop(EXIT));
+        code.push_back(Nop());
+        return {code, 1 + num_fetches};
+    }
+
+private:
+    u32 Random(u32 max) {
+        return static_cast<u32>(rng() % max);
+    }
+
+    u32 Source() {
+        return Random(7);
+    }
+
+    u32 Destination() {
+        return 1 + Random(6);
+    }
+
+    ResultOperation Result(bool allow_fetch) {
+        const bool can_send = sends_left >= multiplier;
+        while (true) {
+            const auto result = static_cast<ResultOperation>(Random(5));
+            const bool is_fetch = result == ResultOperation::IgnoreAndFetch ||
+                                  result == ResultOperation::FetchAndSend;
+            const bool is_send = result == ResultOperation::FetchAndSend ||
+                                 result == ResultOperation::MoveAndSend;
+            if (result == ResultOperation::MoveAndSetMethod || (is_fetch && !allow_fetch) ||
+                (is_send && !can_send)) {
+                continue;
+            }
+            num_fetches += is_fetch ? multiplier : 0;
+            sends_left -= is_send ? multiplier : 0;
+            return result;
+        }
+    }
+
+    void SetMethodAddress() {
+        code.push_back(SetMethod(Destination(), SCRATCH + Random(0x40), Random(3)));
+    }
+
+    // Emits a single instruction, unless a shift amount has to be set up first
+    void EmitStraight(bool allow_fetch, bool single = false) {
+        switch (Random(single ? 5 : 6)) {
+        case 0: {
+            const ALUOperation operation = ALU_OPERATIONS[Random(ALU_OPERATIONS.size())];
+            code.push_back(
+                Alu(operation, Result(allow_fetch), Destination(), Source(), Source()));
+            break;
+        }
+        case 1:
+            code.push_back(AddImmediate(Result(allow_fetch), Destination(), Source(),
+                                        static_cast<s32>(Random(600)) - 300));
+            break;
+        case 2:
+            code.push_back(ExtractInsert(Result(allow_fetch), Destination(), Source(), Source(),
+                                         Random(32), Random(31), Random(32)));
+            break;
+        case 3:
+            code.push_back(Read(Result(allow_fetch), Destination(), 0, SCRATCH + Random(0x100)));
+            break;
+        case 4:
+            SetMethodAddress();
+            break;
+        default: {
+            const u32 amount = Destination();
+            const Operation operation = Random(2) == 0 ? Operation::ExtractShiftLeftImmediate
+                                                       : Operation::ExtractShiftLeftRegister;
+            code.push_back(AddImmediate(ResultOperation::Move, amount, 0,
+                                        static_cast<s32>(Random(32))));
+            code.push_back(ExtractShift(operation, Result(allow_fetch), Destination(), amount,
+                                        Source(), Random(32), Random(31), Random(32)));
+            break;
+        }
+        }
+    }
+
+    void EmitForwardBranch() {
+        const size_t branch = code.size();
+        const bool annul = Random(2) == 0;
+        code.push_back(0);
+        // The delay slot and the skipped code must not fetch, so every path fetches the same
+        EmitStraight(false, true);
+        const u32 num_skipped = 1 + Random(4);
+        for (u32 i = 0; i < num_skipped; ++i) {
+            EmitStraight(false);
+        }
+        const auto cond = static_cast<BranchCondition>(Random(2));
+        code[branch] = Branch(cond, Source(), static_cast<s32>(code.size() - branch), annul);
+    }
+
+    void EmitLoop() {
+        const u32 trip_count = 1 + Random(4);
+        code.push_back(AddImmediate(ResultOperation::Move, 7, 0, static_cast<s32>(trip_count)));
+        const size_t body = code.size();
+        multiplier = trip_count;
+        const u32 num_instructions = 1 + Random(4);
+        for (u32 i = 0; i < num_instructions; ++i) {
+            EmitStraight(true);
+        }
+        multiplier = 1;
+        code.push_back(AddImmediate(ResultOperation::Move, 7, 7, -1));
+        const s32 offset = static_cast<s32>(body) - static_cast<s32>(code.size());
+        code.push_back(Branch(BranchCondition::NotZero, 7, offset, Random(2) == 0));
+        code.push_back(Nop());
+    }
+
+    std::mt19937& rng;
+    std::vector<u32> code;
+    u32 num_fetches{};
+    u32 sends_left{};
+    u32 multiplier{};
+};
+
+class MacroFixture {
+public:
+    MacroFixture() {
+        system.Initialize();
+        host1x = std::make_unique<Tegra::Host1x::Host1x>(system);
+        memory_manager = std::make_unique<Tegra::MemoryManager>(system, host1x->MemoryManager());
+        maxwell3d = std::make_unique<Maxwell3D>(system, *memory_manager);
+    }
+
+    /// Runs the macro on a clean register file and returns the resulting registers.
+    std::vector<u32> Run(Tegra::MacroEngine& engine, const RecordedMacro& macro, u32 method,
+                         u32 times = 1) {
+        std::ranges::fill(maxwell3d->regs.reg_array, 0U);
+        Upload(engine, method, macro.code);
+        for (u32 i = 0; i < times; ++i) {
+            engine.Execute(method, macro.parameters);
+        }
+        return {maxwell3d->regs.reg_array.begin(), maxwell3d->regs.reg_array.end()};
+    }
+
+    /// Runs the macro once per parameter list, returning the scratch registers after each call.
+    std::vector<std::vector<u32>> Replay(Tegra::MacroEngine& engine, const std::vector<u32>& code,
+                                         const std::vector<std::vector<u32>>& calls) {
+        std::ranges::fill(maxwell3d->regs.reg_array, 0U);
+        Upload(engine, 0, code);
+        std::vector<std::vector<u32>> states;
+        states.reserve(calls.size());
+        for (const std::vector<u32>& parameters : calls) {
+            engine.Execute(0, parameters);
+            const std::span scratch{maxwell3d->regs.shadow_scratch};
+            states.emplace_back(scratch.begin(), scratch.end());
+        }
+        return states;
+    }
+
+    static void Upload(Tegra::MacroEngine& engine, u32 method, const std::vector<u32>& code) {
+        engine.ClearCode(method);
+        for (const u32 word : code) {
+            engine.AddCode(method, word);
+        }
+    }
+
+    Core::System system;
+    std::unique_ptr<Tegra::Host1x::Host1x> host1x;
+    std::unique_ptr<Tegra::MemoryManager> memory_manager;
+    std::unique_ptr<Maxwell3D> maxwell3d;
+};
+
+} // Anonymous namespace
+
+TEST_CASE("Macro[Replay]", "[video_core]") {
+    MacroFixture fixture;
+    Tegra::MacroInterpreter interpreter{*fixture.maxwell3d};
+#ifdef ARCHITECTURE_x86_64
+    Tegra::MacroJITx64 jit{*fixture.maxwell3d};
+#endif
+    u32 method = 0;
+    for (const RecordedMacro& macro : MakeRecordedMacros()) {
+        INFO(macro.name << "\n" << Tegra::Macro::Disassemble(macro.code));
+        const std::vector<u32> expected = fixture.Run(interpreter, macro, method, 3);
+        REQUIRE(expected != std::vector<u32>(Regs::NUM_REGS));
+#ifdef ARCHITECTURE_x86_64
+        REQUIRE(fixture.Run(jit, macro, method, 3) == expected);
+#endif
+        method += 0x100;
+    }
+}
+
+#ifdef ARCHITECTURE_x86_64
+TEST_CASE("Macro[Tiering]", "[video_core]") {
+    constexpr u32 threshold = Tegra::MacroJITx64::OPTIMIZE_THRESHOLD;
+
+    MacroFixture fixture;
+    Tegra::MacroInterpreter interpreter{*fixture.maxwell3d};
+    Tegra::MacroJITx64 jit{*fixture.maxwell3d};
+    std::mt19937 rng{0x4D4D45};
+    MacroGenerator generator{rng};
+    for (u32 program = 0; program < 48; ++program) {
+        const RandomMacro macro = generator.Generate();
+        INFO(Tegra::Macro::Disassemble(macro.code));
+
+        // Most parameters stay the same so the optimized tier specializes on them. After that the
+        // constant ones change as well, first missing the guard and then dropping the
+        // specialization altogether.
+        std::vector<u32> parameters(macro.num_parameters);
+        std::vector<bool> is_varying(macro.num_parameters);
+        for (size_t slot = 0; slot < parameters.size(); ++slot) {
+            parameters[slot] = rng() % 3 == 0 ? static_cast<u32>(rng()) : rng() % 4;
+            is_varying[slot] = rng() % 3 == 0;
+        }
+        std::vector<std::vector<u32>> calls;
+        for (u32 call = 0; call < threshold * 3; ++call) {
+            for (size_t slot = 0; slot < parameters.size(); ++slot) {
+                if (is_varying[slot] || (call > threshold + 16 && rng() % 2 == 0)) {
+                    parameters[slot] = rng() % 2 == 0 ? static_cast<u32>(rng()) : rng() % 4;
+                }
+            }
+            calls.push_back(parameters);
+        }
+
+        const auto expected = fixture.Replay(interpreter, macro.code, calls);
+        const auto result = fixture.Replay(jit, macro.code, calls);
+        for (size_t call = 0; call < calls.size(); ++call) {
+            INFO("Call " << call);
+            REQUIRE(result[call] == expected[call]);
+        }
+    }
+}
+#endif
+
+TEST_CASE("Macro[Throughput]", "[.benchmark]") {
+    using Clock = std::chrono::steady_clock;
+    constexpr u32 iterations = 100000;
+
+    MacroFixture fixture;
+    std::vector<std::pair<const char*, std::unique_ptr<Tegra::MacroEngine>>> engines;
+    engines.emplace_back("interpreter",
+                         std::make_unique<Tegra::MacroInterpreter>(*fixture.maxwell3d));
+#ifdef ARCHITECTURE_x86_64
+    engines.emplace_back("jit", std::make_unique<Tegra::MacroJITx64>(*fixture.maxwell3d));
+#endif
+    for (const RecordedMacro& macro : MakeRecordedMacros()) {
+        for (auto& [name, engine] : engines) {
+            const auto start = Clock::now();
+            fixture.Run(*engine, macro, 0, iterations);
+            const std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+            fmt::print("Macro {:<10} {:<12} {:8.1f} ns/call\n", macro.name, name,
+                       elapsed.count() / iterations);
+        }
+    }
+}
@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <filesystem>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "video_core/pipeline_predictor.h"
+
+using VideoCommon::PipelinePredictor;
+
+namespace {
+constexpr u32 CACHE_VERSION = 1;
+} // Anonymous namespace
+
+TEST_CASE("PipelinePredictor[FrequencyOrder]", "[video_core]") {
+    PipelinePredictor predictor;
+    predictor.RecordTransition(1, 2);
+    predictor.RecordTransition(1, 3);
+    predictor.RecordTransition(1, 3);
+    predictor.RecordTransition(1, 4);
+    predictor.RecordTransition(1, 4);
+    predictor.RecordTransition(1, 4);
+
+    const auto predictions{predictor.Predict(1)};
+    REQUIRE(predictions.size() == 3);
+    REQUIRE(predictions[0] == 4);
+    REQUIRE(predictions[1] == 3);
+    REQUIRE(predictions[2] == 2);
+    REQUIRE(predictor.Predict(2).empty());
+}
+
+TEST_CASE("PipelinePredictor[Eviction]", "[video_core]") {
+    PipelinePredictor predictor;
+    for (u64 successor = 0; successor < PipelinePredictor::MAX_SUCCESSORS; ++successor) {
+        predictor.RecordTransition(100, successor);
+        predictor.RecordTransition(100, successor);
+    }
+    predictor.RecordTransition(100, 1000);
+    predictor.RecordTransition(100, 1000);
+    predictor.RecordTransition(100, 1000);
+
+    const auto predictions{predictor.Predict(100)};
+    REQUIRE(predictions.size() == PipelinePredictor::MAX_PREDICTIONS);
+    REQUIRE(predictions[0] == 1000);
+}
+
+TEST_CASE("PipelinePredictor[LearnAfterFull]", "[video_core]") {
+    PipelinePredictor predictor;
+    for (u64 successor = 0; successor < PipelinePredictor::MAX_SUCCESSORS; ++successor) {
+        predictor.RecordTransition(100, successor);
+        predictor.RecordTransition(100, successor);
+    }
+    // New successors alternating with each other must not keep replacing one another
+    for (int i = 0; i < 2; ++i) {
+        predictor.RecordTransition(100, 1000);
+        predictor.RecordTransition(100, 2000);
+    }
+
+    const auto predictions{predictor.Predict(100)};
+    REQUIRE(predictions.size() == PipelinePredictor::MAX_PREDICTIONS);
+    REQUIRE(predictions[0] == 1000);
+    REQUIRE(predictions[1] == 2000);
+}
+
+TEST_CASE("PipelinePredictor[Aging]", "[video_core]") {
+    const auto filename{std::filesystem::temp_directory_path() / "citron_transitions_aging.bin"};
+    {
+        PipelinePredictor predictor;
+        for (int i = 0; i < 8; ++i) {
+            predictor.RecordTransition(1, 2);
+        }
+        predictor.Save(filename, CACHE_VERSION);
+    }
+
+    // The count of 8 recorded last session is halved on load, so that 5 transitions in this
+    // session take over
+    PipelinePredictor predictor;
+    predictor.Load(filename, CACHE_VERSION);
+    for (int i = 0; i < 5; ++i) {
+        predictor.RecordTransition(1, 3);
+    }
+    REQUIRE(predictor.Predict(1).front() == 3);
+
+    std::filesystem::remove(filename);
+}
+
+TEST_CASE("PipelinePredictor[SaveLoad]", "[video_core]") {
+    const auto filename{std::filesystem::temp_directory_path() / "citron_transitions_test.bin"};
+    {
+        PipelinePredictor predictor;
+        predictor.RecordBind(1);
+        predictor.RecordTransition(1, 2);
+        predictor.RecordTransition(2, 3);
+        predictor.Save(filename, CACHE_VERSION);
+    }
+    PipelinePredictor predictor;
+    predictor.Load(filename, CACHE_VERSION);
+    REQUIRE(!predictor.Empty());
+    REQUIRE(predictor.Predict(1).front() == 2);
+    REQUIRE(!predictor.IsPredictable(1));
+    REQUIRE(predictor.IsPredictable(2));
+    REQUIRE(predictor.IsPredictable(3));
+
+    predictor.Load(filename, CACHE_VERSION + 1);
+    REQUIRE(predictor.Empty());
+    REQUIRE(!predictor.IsPredictable(2));
+
+    std::filesystem::remove(filename);
+}
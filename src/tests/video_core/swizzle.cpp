@@ -0,0 +1,209 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+
+#include "common/alignment.h"
+#include "common/common_types.h"
+#include "common/div_ceil.h"
+#include "video_core/textures/decoders.h"
+
+namespace {
+
+using namespace Tegra::Texture;
+
+constexpr auto SWIZZLE_TABLE = MakeSwizzleTable();
+
+// Per pixel block linear copy, used as the reference for the optimized swizzlers
+template <bool TO_LINEAR>
+void ReferenceSwizzle(std::span<u8> output, std::span<const u8> input, u32 bytes_per_pixel,
+                      u32 width, u32 height, u32 depth, u32 origin_x, u32 origin_y, u32 extent_x,
+                      u32 extent_y, u32 block_height, u32 block_depth, u32 stride, u32 pitch) {
+    const u32 gobs_in_x = Common::DivCeilLog2(stride, GOB_SIZE_X_SHIFT);
+    const u32 block_size = gobs_in_x << (GOB_SIZE_SHIFT + block_height + block_depth);
+    const u32 slice_size =
+        Common::DivCeilLog2(height, block_height + GOB_SIZE_Y_SHIFT) * block_size;
+    const u32 block_height_mask = (1U << block_height) - 1;
+    const u32 block_depth_mask = (1U << block_depth) - 1;
+    const u32 x_shift = GOB_SIZE_SHIFT + block_height + block_depth;
+
+    for (u32 z = 0; z < depth; ++z) {
+        const u32 offset_z = (z >> block_depth) * slice_size +
+                             ((z & block_depth_mask) << (GOB_SIZE_SHIFT + block_height));
+        for (u32 line = 0; line < extent_y; ++line) {
+            const u32 y = origin_y + line;
+            const u32 block_y = y >> GOB_SIZE_Y_SHIFT;
+            const u32 offset_y = (block_y >> block_height) * block_size +
+                                 ((block_y & block_height_mask) << GOB_SIZE_SHIFT);
+            for (u32 column = 0; column < extent_x; ++column) {
+                const u32 x = (origin_x + column) * bytes_per_pixel;
+                const u32 swizzled_offset = offset_z + offset_y +
+                                            ((x >> GOB_SIZE_X_SHIFT) << x_shift) +
+                                            SWIZZLE_TABLE[y % GOB_SIZE_Y][x % GOB_SIZE_X];
+                const u32 linear_offset =
+                    z * pitch * height + line * pitch + column * bytes_per_pixel;
+                u8* const dst = &output[TO_LINEAR ? swizzled_offset : linear_offset];
+                const u8* const src = &input[TO_LINEAR ? linear_offset : swizzled_offset];
+                std::memcpy(dst, src, bytes_per_pixel);
+            }
+        }
+    }
+}
+
+size_t SwizzledSize(u32 stride, u32 height, u32 depth, u32 block_height, u32 block_depth) {
+    return static_cast<size_t>(Common::AlignUpLog2(stride, GOB_SIZE_X_SHIFT)) *
+           Common::AlignUpLog2(height, GOB_SIZE_Y_SHIFT + block_height) *
+           Common::AlignUpLog2(depth, GOB_SIZE_Z_SHIFT + block_depth);
+}
+
+std::vector<u8> RandomBytes(std::mt19937& rng, size_t size) {
+    std::vector<u8> bytes(size);
+    for (u8& byte : bytes) {
+        byte = static_cast<u8>(rng());
+    }
+    return bytes;
+}
+
+constexpr std::array<u32, 5> TEXTURE_BPP{1, 2, 4, 8, 16};
+constexpr std::array<u32, 8> SUBRECT_BPP{1, 2, 3, 4, 6, 8, 12, 16};
+
+} // Anonymous namespace
+
+TEST_CASE("Swizzle[Texture]", "[video_core]") {
+    std::mt19937 rng{0x60B5};
+    for (const u32 bpp : TEXTURE_BPP) {
+        for (u32 block_height = 0; block_height <= 5; ++block_height) {
+            for (u32 block_depth = 0; block_depth <= 5; ++block_depth) {
+                const u32 width = 37 + static_cast<u32>(rng() % 64);
+                const u32 height = 5 + static_cast<u32>(rng() % 70);
+                const u32 depth = 1 + static_cast<u32>(rng() % 6);
+                const u32 stride_alignment = 1U << (rng() % 4);
+                const u32 stride = Common::AlignUpLog2(width, stride_alignment) * bpp;
+                const u32 pitch = width * bpp;
+                INFO("bpp=" << bpp << " block_height=" << block_height
+                            << " block_depth=" << block_depth);
+
+                const size_t swizzled_size =
+                    SwizzledSize(stride, height, depth, block_height, block_depth);
+                const std::vector<u8> swizzled = RandomBytes(rng, swizzled_size);
+                std::vector<u8> linear(static_cast<size_t>(pitch) * height * depth);
+                std::vector<u8> expected_linear(linear.size());
+                UnswizzleTexture(linear, swizzled, bpp, width, height, depth, block_height,
+                                 block_depth, stride_alignment);
+                ReferenceSwizzle<false>(expected_linear, swizzled, bpp, width, height, depth, 0,
+                                        0, width, height, block_height, block_depth, stride,
+                                        pitch);
+                REQUIRE(linear == expected_linear);
+
+                std::vector<u8> result(swizzled_size);
+                std::vector<u8> expected(swizzled_size);
+                SwizzleTexture(result, linear, bpp, width, height, depth, block_height,
+                               block_depth, stride_alignment);
+                ReferenceSwizzle<true>(expected, linear, bpp, width, height, depth, 0, 0, width,
+                                       height, block_height, block_depth, stride, pitch);
+                REQUIRE(result == expected);
+            }
+        }
+    }
+}
+
+TEST_CASE("Swizzle[Subrect]", "[video_core]") {
+    std::mt19937 rng{0x5B4EC7};
+    for (const u32 bpp : SUBRECT_BPP) {
+        for (u32 block_height = 0; block_height <= 5; ++block_height) {
+            for (u32 block_depth = 0; block_depth <= 2; ++block_depth) {
+                const u32 width = 40 + static_cast<u32>(rng() % 64);
+                const u32 height = 20 + static_cast<u32>(rng() % 40);
+                const u32 origin_x = static_cast<u32>(rng() % (width / 2));
+                const u32 origin_y = static_cast<u32>(rng() % (height / 2));
+                const u32 extent_x = 1 + static_cast<u32>(rng() % (width - origin_x));
+                const u32 extent_y = 1 + static_cast<u32>(rng() % (height - origin_y));
+                const u32 stride = Common::AlignUpLog2(width * bpp, GOB_SIZE_X_SHIFT);
+                const u32 pitch = extent_x * bpp + static_cast<u32>(rng() % 16);
+                INFO("bpp=" << bpp << " block_height=" << block_height
+                            << " block_depth=" << block_depth);
+
+                const size_t swizzled_size =
+                    SwizzledSize(stride, height, 1, block_height, block_depth);
+                const std::vector<u8> swizzled = RandomBytes(rng, swizzled_size);
+                const std::vector<u8> initial_linear =
+                    RandomBytes(rng, static_cast<size_t>(pitch) * height);
+
+                std::vector<u8> linear = initial_linear;
+                std::vector<u8> expected_linear = initial_linear;
+                UnswizzleSubrect(linear, swizzled, bpp, width, height, 1, origin_x, origin_y,
+                                 extent_x, extent_y, block_height, block_depth, pitch);
+                ReferenceSwizzle<false>(expected_linear, swizzled, bpp, width, height, 1,
+                                        origin_x, origin_y, extent_x, extent_y, block_height,
+                                        block_depth, stride, pitch);
+                REQUIRE(linear == expected_linear);
+
+                std::vector<u8> result = swizzled;
+                std::vector<u8> expected = swizzled;
+                SwizzleSubrect(result, initial_linear, bpp, width, height, 1, origin_x, origin_y,
+                               extent_x, extent_y, block_height, block_depth, pitch);
+                ReferenceSwizzle<true>(expected, initial_linear, bpp, width, height, 1, origin_x,
+                                       origin_y, extent_x, extent_y, block_height, block_depth,
+                                       stride, pitch);
+                REQUIRE(result == expected);
+            }
+        }
+    }
+}
+
+TEST_CASE("Swizzle[Throughput]", "[.benchmark]") {
+    using Clock = std::chrono::steady_clock;
+    constexpr u32 iterations = 16;
+    constexpr u32 block_height = 4;
+    constexpr u32 block_depth = 0;
+
+    struct Surface {
+        u32 width;
+        u32 height;
+        u32 depth;
+    };
+    constexpr std::array<Surface, 3> surfaces{{
+        {256, 256, 1},
+        {1920, 1080, 1},
+        {256, 256, 64},
+    }};
+
+    std::mt19937 rng{0x60B5};
+    for (const Surface& surface : surfaces) {
+        for (const u32 bpp : TEXTURE_BPP) {
+            const u32 pitch = surface.width * bpp;
+            const size_t linear_size = static_cast<size_t>(pitch) * surface.height * surface.depth;
+            const std::vector<u8> swizzled = RandomBytes(
+                rng, SwizzledSize(pitch, surface.height, surface.depth, block_height, block_depth));
+            std::vector<u8> linear(linear_size);
+
+            const auto measure = [&](auto&& unswizzle) {
+                const auto start = Clock::now();
+                for (u32 i = 0; i < iterations; ++i) {
+                    unswizzle();
+                }
+                const std::chrono::duration<double> elapsed = Clock::now() - start;
+                return static_cast<double>(linear_size) * iterations / elapsed.count() / 1e9;
+            };
+            const double reference = measure([&] {
+                ReferenceSwizzle<false>(linear, swizzled, bpp, surface.width, surface.height,
+                                        surface.depth, 0, 0, surface.width, surface.height,
+                                        block_height, block_depth, pitch, pitch);
+            });
+            const double optimized = measure([&] {
+                UnswizzleTexture(linear, swizzled, bpp, surface.width, surface.height,
+                                 surface.depth, block_height, block_depth);
+            });
+            fmt::print("Unswizzle {}x{}x{} bpp={:<2}  per pixel {:6.2f} GB/s  GOB {:6.2f} GB/s\n",
+                       surface.width, surface.height, surface.depth, bpp, reference, optimized);
+        }
+    }
+}
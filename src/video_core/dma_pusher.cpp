@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include "common/cityhash.h"
+#include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "common/settings.h"
 #include "core/core.h"
@@ -16,6 +17,63 @@ namespace Tegra {
 constexpr u32 MacroRegistersStart = 0xE00;
 constexpr u32 ComputeInline = 0x6D;
 
+// Released storage kept around for reuse, enough for the lists in flight under async GPU
+constexpr size_t MaxPooledCommandLists = 64;
+
+void CommandList::Recycler::operator()(CommandListStorage* released) const {
+    pool->Release(released);
+}
+
+CommandListPool::CommandListPool() = default;
+
+CommandListPool::~CommandListPool() = default;
+
+CommandList CommandListPool::Acquire() {
+    submissions.fetch_add(1, std::memory_order_relaxed);
+    std::unique_ptr<CommandListStorage> storage;
+    {
+        std::scoped_lock lock{mutex};
+        if (!free_storage.empty()) {
+            storage = std::move(free_storage.back());
+            free_storage.pop_back();
+        }
+    }
+    if (!storage) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        storage = std::make_unique<CommandListStorage>();
+    }
+    return CommandList{shared_from_this(), storage.release()};
+}
+
+void CommandListPool::Release(CommandListStorage* storage) {
+    std::unique_ptr<CommandListStorage> owned{storage};
+    owned->command_lists.clear();
+    owned->prefetch_command_list.clear();
+
+    std::scoped_lock lock{mutex};
+    if (free_storage.size() < MaxPooledCommandLists) {
+        free_storage.push_back(std::move(owned));
+    }
+}
+
+void CommandListPool::EndFrame() {
+    const Stats frame_stats{
+        .submissions = submissions.exchange(0, std::memory_order_relaxed),
+        .allocations = allocations.exchange(0, std::memory_order_relaxed),
+        .bytes_copied = bytes_copied.exchange(0, std::memory_order_relaxed),
+    };
+    LOG_TRACE(HW_GPU, "Command lists: {} submitted, {} allocated, {} bytes copied",
+              frame_stats.submissions, frame_stats.allocations, frame_stats.bytes_copied);
+
+    std::scoped_lock lock{mutex};
+    last_frame_stats = frame_stats;
+}
+
+CommandListPool::Stats CommandListPool::GetLastFrameStats() const {
+    std::scoped_lock lock{mutex};
+    return last_frame_stats;
+}
+
 DmaPusher::DmaPusher(Core::System& system_, GPU& gpu_, MemoryManager& memory_manager_,
                      Control::ChannelState& channel_state_)
     : gpu{gpu_}, system{system_}, memory_manager{memory_manager_}, puller{gpu_, memory_manager_,
@@ -49,25 +107,24 @@ bool DmaPusher::Step() {
 
     CommandList& command_list{dma_pushbuffer.front()};
 
-    ASSERT_OR_EXECUTE(
-        command_list.command_lists.size() || command_list.prefetch_command_list.size(), {
-            // Somehow the command_list is empty, in order to avoid a crash
-            // We ignore it and assume its size is 0.
-            dma_pushbuffer.pop();
-            dma_pushbuffer_subindex = 0;
-            return true;
-        });
+    ASSERT_OR_EXECUTE(!command_list.IsEmpty(), {
+        // Somehow the command_list is empty, in order to avoid a crash
+        // We ignore it and assume its size is 0.
+        dma_pushbuffer.pop();
+        dma_pushbuffer_subindex = 0;
+        return true;
+    });
 
-    if (command_list.prefetch_command_list.size()) {
+    if (!command_list.Prefetch().empty()) {
         // Prefetched command list from nvdrv, used for things like synchronization
-        ProcessCommands(command_list.prefetch_command_list);
+        ProcessCommands(command_list.Prefetch());
         dma_pushbuffer.pop();
     } else {
-        const CommandListHeader command_list_header{
-            command_list.command_lists[dma_pushbuffer_subindex++]};
+        const std::vector<CommandListHeader>& list_headers = command_list.Headers();
+        const CommandListHeader command_list_header{list_headers[dma_pushbuffer_subindex++]};
         dma_state.dma_get = command_list_header.addr;
 
-        if (dma_pushbuffer_subindex >= command_list.command_lists.size()) {
+        if (dma_pushbuffer_subindex >= list_headers.size()) {
             // We've gone through the current list, remove it from the queue
             dma_pushbuffer.pop();
             dma_pushbuffer_subindex = 0;
@@ -89,6 +146,10 @@ bool DmaPusher::Step() {
                                           Tegra::Memory::GuestMemoryFlags::SafeRead>
                 headers(memory_manager, dma_state.dma_get, command_list_header.size,
                         &command_headers);
+            if (headers.data() == command_headers.data()) {
+                // Not contiguous in host memory, the words went through the scratch buffer
+                gpu.CommandLists().CountCopy(headers.size_bytes());
+            }
             ProcessCommands(headers);
         };
         const auto unsafe_process = [&] {
@@ -96,6 +157,9 @@ bool DmaPusher::Step() {
                                           Tegra::Memory::GuestMemoryFlags::UnsafeRead>
                 headers(memory_manager, dma_state.dma_get, command_list_header.size,
                         &command_headers);
+            if (headers.data() == command_headers.data()) {
+                gpu.CommandLists().CountCopy(headers.size_bytes());
+            }
             ProcessCommands(headers);
         };
         if (Settings::IsGPULevelNormal()) {
@@ -4,11 +4,15 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <span>
 #include <vector>
 #include <boost/container/small_vector.hpp>
 #include <queue>
 
+#include "common/assert.h"
 #include "common/bit_field.h"
 #include "common/common_types.h"
 #include "common/scratch_buffer.h"
@@ -100,15 +104,90 @@ inline CommandHeader BuildCommandHeader(BufferMethods method, u32 arg_count, Sub
     return result;
 }
 
+/// Headers and prefetched words of a single submission.
+struct CommandListStorage {
+    std::vector<CommandListHeader> command_lists;
+    std::vector<CommandHeader> prefetch_command_list;
+};
+
+class CommandListPool;
+
+/**
+ * Handle to pooled command list storage. nvdrv fills the storage once, the GPU thread only moves
+ * the handle around and the DmaPusher consumes the words in place. The storage goes back to its
+ * pool when the handle is destroyed, after the list has been processed.
+ */
 struct CommandList final {
     CommandList() = default;
-    explicit CommandList(std::size_t size) : command_lists(size) {}
-    explicit CommandList(
-        boost::container::small_vector<CommandHeader, 512>&& prefetch_command_list_)
-        : prefetch_command_list{std::move(prefetch_command_list_)} {}
 
-    boost::container::small_vector<CommandListHeader, 512> command_lists;
-    boost::container::small_vector<CommandHeader, 512> prefetch_command_list;
+    [[nodiscard]] bool IsEmpty() const {
+        return !storage ||
+               (storage->command_lists.empty() && storage->prefetch_command_list.empty());
+    }
+
+    [[nodiscard]] std::vector<CommandListHeader>& Headers() {
+        ASSERT_MSG(storage, "Command list has no storage");
+        return storage->command_lists;
+    }
+
+    [[nodiscard]] std::vector<CommandHeader>& Prefetch() {
+        ASSERT_MSG(storage, "Command list has no storage");
+        return storage->prefetch_command_list;
+    }
+
+private:
+    friend class CommandListPool;
+
+    struct Recycler {
+        std::shared_ptr<CommandListPool> pool;
+
+        void operator()(CommandListStorage* released) const;
+    };
+
+    explicit CommandList(std::shared_ptr<CommandListPool> pool, CommandListStorage* storage_)
+        : storage{storage_, Recycler{std::move(pool)}} {}
+
+    std::unique_ptr<CommandListStorage, Recycler> storage;
+};
+
+/// Recycles command list storage between submissions, keeping the capacity of its vectors.
+class CommandListPool final : public std::enable_shared_from_this<CommandListPool> {
+public:
+    struct Stats {
+        u64 submissions;  ///< Command lists handed out
+        u64 allocations;  ///< Storage blocks allocated because none could be recycled
+        u64 bytes_copied; ///< Command data copied into lists and DmaPusher scratch buffers
+    };
+
+    CommandListPool();
+    ~CommandListPool();
+
+    /// Returns an empty command list, reusing released storage when possible.
+    [[nodiscard]] CommandList Acquire();
+
+    /// Accounts for command data that had to be copied on its way to the DmaPusher.
+    void CountCopy(size_t bytes) {
+        bytes_copied.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    /// Publishes the counters of the frame that just ended and starts counting a new one.
+    void EndFrame();
+
+    /// Returns the counters of the last completed frame.
+    [[nodiscard]] Stats GetLastFrameStats() const;
+
+private:
+    friend struct CommandList;
+
+    void Release(CommandListStorage* storage);
+
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<CommandListStorage>> free_storage;
+    Stats last_frame_stats{};
+
+    std::atomic<u64> submissions{};
+    std::atomic<u64> allocations{};
+    std::atomic<u64> bytes_copied{};
 };
 
 /**
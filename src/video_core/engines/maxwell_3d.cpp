@@ -672,6 +672,21 @@ u32 Maxwell3D::GetRegisterValue(u32 method) const {
     return regs.reg_array[method];
 }
 
+bool Maxwell3D::IsRedundantWrite(u32 method, u32 argument) const {
+    if (method >= Regs::NUM_REGS || execution_mask[method]) {
+        return false;
+    }
+    switch (shadow_state.shadow_ram_control) {
+    case Regs::ShadowRamControl::Track:
+    case Regs::ShadowRamControl::TrackWithFilter:
+        return regs.reg_array[method] == argument && shadow_state.reg_array[method] == argument;
+    case Regs::ShadowRamControl::Replay:
+        return regs.reg_array[method] == shadow_state.reg_array[method];
+    default:
+        return regs.reg_array[method] == argument;
+    }
+}
+
 void Maxwell3D::SetHLEReplacementAttributeType(u32 bank, u32 offset,
                                                HLEReplacementAttributeType name) {
     const u64 key = (static_cast<u64>(bank) << 32) | offset;
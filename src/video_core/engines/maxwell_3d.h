@@ -3071,6 +3071,9 @@ public:
     /// Reads a register value located at the input method address
     u32 GetRegisterValue(u32 method) const;
 
+    /// Returns true when writing the argument to the method would not change any engine state.
+    [[nodiscard]] bool IsRedundantWrite(u32 method, u32 argument) const;
+
     /// Write the value to the register identified by method.
     void CallMethod(u32 method, u32 method_argument, bool is_last_call) override;
 
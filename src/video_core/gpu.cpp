@@ -196,6 +196,11 @@ struct GPU::Impl {
         return *shader_notify;
     }
 
+    /// Returns the pool command lists are allocated from.
+    [[nodiscard]] CommandListPool& CommandLists() {
+        return *command_list_pool;
+    }
+
     [[nodiscard]] u64 GetTicks() const {
         u64 gpu_tick = system.CoreTiming().GetGPUTicks();
 
@@ -216,6 +221,7 @@ struct GPU::Impl {
 
     void RendererFrameEndNotify() {
         system.GetPerfStats().EndGameFrame();
+        command_list_pool->EndFrame();
     }
 
     /// Performs any additional setup necessary in order to begin GPU emulation.
@@ -361,6 +367,8 @@ struct GPU::Impl {
     GPU& gpu;
     Core::System& system;
     Host1x::Host1x& host1x;
+    /// Shared with the lists in flight, which can outlive the GPU during shutdown
+    std::shared_ptr<CommandListPool> command_list_pool = std::make_shared<CommandListPool>();
 
     std::map<u32, std::unique_ptr<Tegra::CDmaPusher>> cdma_pushers;
     std::unique_ptr<VideoCore::RendererBase> renderer;
@@ -503,6 +511,10 @@ const VideoCore::RendererBase& GPU::Renderer() const {
     return impl->Renderer();
 }
 
+CommandListPool& GPU::CommandLists() {
+    return impl->CommandLists();
+}
+
 VideoCore::ShaderNotify& GPU::ShaderNotify() {
     return impl->ShaderNotify();
 }
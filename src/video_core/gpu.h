@@ -24,6 +24,7 @@ class ShaderNotify;
 namespace Tegra {
 class DmaPusher;
 struct CommandList;
+class CommandListPool;
 
 // TODO: Implement the commented ones
 enum class RenderTargetFormat : u32 {
@@ -198,6 +199,9 @@ public:
     /// Returns a const reference to the underlying renderer.
     [[nodiscard]] const VideoCore::RendererBase& Renderer() const;
 
+    /// Returns the pool command lists are allocated from.
+    [[nodiscard]] Tegra::CommandListPool& CommandLists();
+
     /// Returns a reference to the shader notifier.
     [[nodiscard]] VideoCore::ShaderNotify& ShaderNotify();
 
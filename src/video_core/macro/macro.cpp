@@ -1,6 +1,8 @@
 // SPDX-FileCopyrightText: Copyright 2020 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <array>
 #include <cstring>
 #include <fstream>
 #include <optional>
@@ -12,6 +14,7 @@
 #include "common/assert.h"
 #include "common/fs/fs.h"
 #include "common/fs/path_util.h"
+#include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "common/settings.h"
 #include "video_core/engines/maxwell_3d.h"
@@ -27,6 +30,79 @@ MICROPROFILE_DEFINE(MacroHLE, "GPU", "Execute macro HLE", MP_RGB(128, 192, 192))
 
 namespace Tegra {
 
+namespace Macro {
+
+namespace {
+
+constexpr std::array<const char*, 13> ALU_MNEMONICS{
+    "add",  "addc", "sub", "subb", "alu4", "alu5", "alu6",
+    "alu7", "xor",  "or",  "and",  "andn", "nand",
+};
+
+constexpr std::array<const char*, 8> RESULT_MNEMONICS{
+    "fetch",
+    "move",
+    "move, set method",
+    "fetch, send",
+    "move, send",
+    "fetch, set method",
+    "move, set method, fetch send",
+    "move, set method, send",
+};
+
+std::string DisassembleOpcode(Opcode opcode, u32 address) {
+    const u32 dst = opcode.dst;
+    const u32 src_a = opcode.src_a;
+    const u32 src_b = opcode.src_b;
+    const char* const result =
+        RESULT_MNEMONICS[static_cast<size_t>(opcode.result_operation.Value())];
+    switch (opcode.operation) {
+    case Operation::ALU: {
+        const auto alu = static_cast<size_t>(opcode.alu_operation.Value());
+        return fmt::format("{} r{}, r{}, r{} ({})",
+                           alu < ALU_MNEMONICS.size() ? ALU_MNEMONICS[alu] : "alu?", dst, src_a,
+                           src_b, result);
+    }
+    case Operation::AddImmediate:
+        return fmt::format("addi r{}, r{}, {} ({})", dst, src_a, opcode.immediate.Value(), result);
+    case Operation::ExtractInsert:
+        return fmt::format("bfi r{}, r{}, r{}, src {}, dst {}, size {} ({})", dst, src_a, src_b,
+                           opcode.bf_src_bit.Value(), opcode.bf_dst_bit.Value(),
+                           opcode.bf_size.Value(), result);
+    case Operation::ExtractShiftLeftImmediate:
+        return fmt::format("bfe_shl r{}, r{} >> r{}, dst {}, size {} ({})", dst, src_b, src_a,
+                           opcode.bf_dst_bit.Value(), opcode.bf_size.Value(), result);
+    case Operation::ExtractShiftLeftRegister:
+        return fmt::format("bfe_shl r{}, r{} >> {}, << r{}, size {} ({})", dst, src_b,
+                           opcode.bf_src_bit.Value(), src_a, opcode.bf_size.Value(), result);
+    case Operation::Read:
+        return fmt::format("read r{}, [r{} + {:#x}] ({})", dst, src_a, opcode.immediate.Value(),
+                           result);
+    case Operation::Branch:
+        return fmt::format("b{}{} r{}, {:#06x}",
+                           opcode.branch_condition == BranchCondition::Zero ? "z" : "nz",
+                           opcode.branch_annul ? ".annul" : "", src_a,
+                           static_cast<u32>(address + opcode.GetBranchTarget()));
+    default:
+        return fmt::format("unknown {:#010x}", opcode.raw);
+    }
+}
+
+} // Anonymous namespace
+
+std::string Disassemble(std::span<const u32> code) {
+    std::string listing;
+    for (size_t index = 0; index < code.size(); ++index) {
+        const Opcode opcode{code[index]};
+        const u32 address = static_cast<u32>(index * sizeof(u32));
+        listing += fmt::format("{:04x}: {}{}\n", address, DisassembleOpcode(opcode, address),
+                               opcode.is_exit ? " exit" : "");
+    }
+    return listing;
+}
+
+} // namespace Macro
+
 static void Dump(u64 hash, std::span<const u32> code, bool decompiled = false) {
     const auto base_dir{Common::FS::GetCitronPath(Common::FS::CitronPath::DumpDir)};
     const auto macro_dir{base_dir / "macros"};
@@ -55,9 +131,14 @@ static void Dump(u64 hash, std::span<const u32> code, bool decompiled = false) {
 }
 
 MacroEngine::MacroEngine(Engines::Maxwell3D& maxwell3d_)
-    : hle_macros{std::make_unique<Tegra::HLEMacro>(maxwell3d_)}, maxwell3d{maxwell3d_} {}
+    : hle_macros{std::make_unique<Tegra::HLEMacro>(maxwell3d_)}, maxwell3d{maxwell3d_},
+      profile_macros{Settings::values.profile_macros.GetValue()} {}
 
-MacroEngine::~MacroEngine() = default;
+MacroEngine::~MacroEngine() {
+    if (profile_macros) {
+        ReportProfile();
+    }
+}
 
 void MacroEngine::AddCode(u32 method, u32 data) {
     uploaded_macro_code[method].push_back(data);
@@ -69,6 +150,16 @@ void MacroEngine::ClearCode(u32 method) {
 }
 
 void MacroEngine::Execute(u32 method, const std::vector<u32>& parameters) {
+    if (!profile_macros) [[likely]] {
+        ExecuteImpl(method, parameters);
+        return;
+    }
+    const auto start_time = std::chrono::steady_clock::now();
+    ExecuteImpl(method, parameters);
+    RecordProfile(method, parameters.size(), std::chrono::steady_clock::now() - start_time);
+}
+
+void MacroEngine::ExecuteImpl(u32 method, const std::vector<u32>& parameters) {
     auto compiled_macro = macro_cache.find(method);
     if (compiled_macro != macro_cache.end()) {
         const auto& cache_info = compiled_macro->second;
@@ -128,6 +219,65 @@ void MacroEngine::Execute(u32 method, const std::vector<u32>& parameters) {
     }
 }
 
+void MacroEngine::RecordProfile(u32 method, size_t num_parameters,
+                                std::chrono::nanoseconds time) {
+    const auto cache_it = macro_cache.find(method);
+    if (cache_it == macro_cache.end()) {
+        return;
+    }
+    const CacheInfo& cache_info = cache_it->second;
+    auto [it, is_new] = macro_profile.try_emplace(cache_info.hash);
+    ProfileInfo& profile = it->second;
+    if (is_new) {
+        const auto code_it = uploaded_macro_code.find(method);
+        if (code_it != uploaded_macro_code.end()) {
+            profile.code = code_it->second;
+        }
+        profile.has_hle_program = cache_info.has_hle_program;
+    }
+    profile.total_time += time;
+    profile.num_parameters += num_parameters;
+    ++profile.num_executions;
+}
+
+void MacroEngine::ReportProfile() const {
+    static constexpr size_t MAX_REPORTED_MACROS = 16;
+
+    std::vector<std::pair<u64, const ProfileInfo*>> sorted;
+    sorted.reserve(macro_profile.size());
+    std::chrono::nanoseconds total_time{};
+    std::chrono::nanoseconds lle_time{};
+    for (const auto& [hash, profile] : macro_profile) {
+        sorted.emplace_back(hash, &profile);
+        total_time += profile.total_time;
+        lle_time += profile.has_hle_program ? std::chrono::nanoseconds{} : profile.total_time;
+    }
+    std::ranges::sort(sorted, [](const auto& lhs, const auto& rhs) {
+        return lhs.second->total_time > rhs.second->total_time;
+    });
+    const auto to_ms = [](std::chrono::nanoseconds time) {
+        return std::chrono::duration<double, std::milli>(time).count();
+    };
+    LOG_INFO(HW_GPU, "Macro profile: {} macros, {:.3f} ms total, {:.3f} ms in LLE macros",
+             sorted.size(), to_ms(total_time), to_ms(lle_time));
+
+    for (size_t index = 0; index < std::min(sorted.size(), MAX_REPORTED_MACROS); ++index) {
+        const auto& [hash, profile] = sorted[index];
+        LOG_INFO(HW_GPU,
+                 "#{} macro {:016x} ({}): {} calls, {:.3f} ms, {:.0f} ns/call, {:.1f} params/call",
+                 index, hash, profile->has_hle_program ? "HLE" : "LLE", profile->num_executions,
+                 to_ms(profile->total_time),
+                 static_cast<double>(profile->total_time.count()) /
+                     static_cast<double>(profile->num_executions),
+                 static_cast<double>(profile->num_parameters) /
+                     static_cast<double>(profile->num_executions));
+        if (!profile->has_hle_program) {
+            LOG_INFO(HW_GPU, "Disassembly of {:016x}:\n{}", hash,
+                     Macro::Disassemble(profile->code));
+        }
+    }
+}
+
 std::unique_ptr<MacroEngine> GetMacroEngine(Engines::Maxwell3D& maxwell3d) {
     if (Settings::values.disable_macro_jit) {
         return std::make_unique<MacroInterpreter>(maxwell3d);
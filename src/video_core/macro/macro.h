@@ -3,7 +3,10 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
+#include <span>
+#include <string>
 #include <unordered_map>
 #include <vector>
 #include "common/bit_field.h"
@@ -93,6 +96,9 @@ union MethodAddress {
     BitField<12, 6, u32> increment;
 };
 
+/// Returns a human readable listing of the macro code, one instruction per line.
+[[nodiscard]] std::string Disassemble(std::span<const u32> code);
+
 } // namespace Macro
 
 class HLEMacro;
@@ -134,10 +140,27 @@ private:
         bool has_hle_program{};
     };
 
+    /// Execution statistics of a macro, keyed by code hash so they survive re-uploads.
+    struct ProfileInfo {
+        std::vector<u32> code;
+        std::chrono::nanoseconds total_time{};
+        u64 num_executions{};
+        u64 num_parameters{};
+        bool has_hle_program{};
+    };
+
+    void ExecuteImpl(u32 method, const std::vector<u32>& parameters);
+
+    void RecordProfile(u32 method, size_t num_parameters, std::chrono::nanoseconds time);
+
+    void ReportProfile() const;
+
     std::unordered_map<u32, CacheInfo> macro_cache;
+    std::unordered_map<u64, ProfileInfo> macro_profile;
     std::unordered_map<u32, std::vector<u32>> uploaded_macro_code;
     std::unique_ptr<HLEMacro> hle_macros;
     Engines::Maxwell3D& maxwell3d;
+    bool profile_macros{};
 };
 
 std::unique_ptr<MacroEngine> GetMacroEngine(Engines::Maxwell3D& maxwell3d);
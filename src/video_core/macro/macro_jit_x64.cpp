@@ -1,8 +1,11 @@
 // SPDX-FileCopyrightText: Copyright 2020 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
 #include <array>
 #include <bitset>
+#include <cstring>
+#include <memory>
 #include <optional>
 
 #include <xbyak/xbyak.h>
@@ -22,11 +25,14 @@ MICROPROFILE_DEFINE(MacroJitExecute, "GPU", "Execute macro JIT", MP_RGB(255, 255
 
 namespace Tegra {
 namespace {
+using Maxwell3D = Engines::Maxwell3D;
+
 constexpr Xbyak::Reg64 STATE = Xbyak::util::rbx;
 constexpr Xbyak::Reg32 RESULT = Xbyak::util::r10d;
 constexpr Xbyak::Reg64 MAX_PARAMETER = Xbyak::util::r11;
 constexpr Xbyak::Reg64 PARAMETERS = Xbyak::util::r12;
 constexpr Xbyak::Reg32 METHOD_ADDRESS = Xbyak::util::r14d;
+constexpr Xbyak::Reg64 SEND_BUFFER = Xbyak::util::r13;
 constexpr Xbyak::Reg64 BRANCH_HOLDER = Xbyak::util::r15;
 
 constexpr std::bitset<32> PERSISTENT_REGISTERS = Common::X64::BuildRegSet({
@@ -35,12 +41,73 @@ constexpr std::bitset<32> PERSISTENT_REGISTERS = Common::X64::BuildRegSet({
     MAX_PARAMETER,
     PARAMETERS,
     METHOD_ADDRESS,
+    SEND_BUFFER,
     BRANCH_HOLDER,
 });
 
 // Arbitrarily chosen based on current booting games.
 constexpr size_t MAX_CODE_SIZE = 0x10000;
 
+// Number of method writes the optimized tier buffers before handing them to the engine.
+constexpr u32 MAX_PENDING_SENDS = 64;
+
+/// Method writes of an optimized macro that have not been submitted to the engine yet.
+struct SendBuffer {
+    u32 num_pending{};
+    std::array<u32, MAX_PENDING_SENDS> methods{};
+    std::array<u32, MAX_PENDING_SENDS> values{};
+};
+
+/// Parameter slots that kept the same value while a macro was being profiled.
+struct ParameterSpecialization {
+    std::vector<std::optional<u32>> values;
+    std::vector<u32> constant_slots;
+
+    [[nodiscard]] bool Matches(const std::vector<u32>& parameters) const {
+        if (parameters.size() != values.size()) {
+            return false;
+        }
+        return std::ranges::all_of(constant_slots, [&](u32 slot) {
+            return parameters[slot] == *values[slot];
+        });
+    }
+};
+
+bool IsConstBufferData(u32 method) {
+    const u32 first = static_cast<u32>(MAXWELL3D_REG_INDEX(const_buffer.buffer));
+    return method >= first && method < first + 16;
+}
+
+/// Submits the buffered method writes. Consecutive constant buffer writes are uploaded as a single
+/// block and writes that would not change any register are dropped.
+void FlushSends(Engines::Maxwell3D* maxwell3d, SendBuffer* buffer) {
+    // Copy the writes out, methods can invoke other macros that reuse the same buffer
+    const u32 count = buffer->num_pending;
+    buffer->num_pending = 0;
+    std::array<u32, MAX_PENDING_SENDS> methods;
+    std::array<u32, MAX_PENDING_SENDS> values;
+    std::memcpy(methods.data(), buffer->methods.data(), count * sizeof(u32));
+    std::memcpy(values.data(), buffer->values.data(), count * sizeof(u32));
+
+    u32 index = 0;
+    while (index < count) {
+        const u32 method = Macro::MethodAddress{methods[index]}.address;
+        if (IsConstBufferData(method)) {
+            u32 end = index + 1;
+            while (end < count && IsConstBufferData(Macro::MethodAddress{methods[end]}.address)) {
+                ++end;
+            }
+            maxwell3d->CallMultiMethod(method, &values[index], end - index, end - index);
+            index = end;
+            continue;
+        }
+        if (!maxwell3d->IsRedundantWrite(method, values[index])) {
+            maxwell3d->CallMethod(method, values[index], true);
+        }
+        ++index;
+    }
+}
+
 std::bitset<32> PersistentCallerSavedRegs() {
     return PERSISTENT_REGISTERS & Common::X64::ABI_ALL_CALLER_SAVED;
 }
@@ -52,6 +119,14 @@ public:
         Compile();
     }
 
+    /// Builds the optimized tier, specialized on the parameters seen while profiling.
+    explicit MacroJITx64Impl(Engines::Maxwell3D& maxwell3d_, const std::vector<u32>& code_,
+                             std::optional<ParameterSpecialization> specialization_)
+        : CodeGenerator{MAX_CODE_SIZE}, code{code_}, maxwell3d{maxwell3d_},
+          specialization{std::move(specialization_)}, is_optimized{true} {
+        Compile();
+    }
+
     void Execute(const std::vector<u32>& parameters, u32 method) override;
 
     void Compile_ALU(Macro::Opcode opcode);
@@ -63,6 +138,11 @@ public:
     void Compile_Branch(Macro::Opcode opcode);
 
 private:
+    void Run(const std::vector<u32>& parameters);
+
+    void ProfileParameters(const std::vector<u32>& parameters);
+    void Optimize();
+
     void Optimizer_ScanFlags();
 
     void Compile();
@@ -72,18 +152,40 @@ private:
     Xbyak::Reg32 Compile_GetRegister(u32 index, Xbyak::Reg32 dst);
 
     void Compile_ProcessResult(Macro::ResultOperation operation, u32 reg);
+    void Compile_AddressImmediate(Macro::Opcode opcode);
     void Compile_Send(Xbyak::Reg32 value);
+    void Compile_BufferSend(Xbyak::Reg32 value);
+    void Compile_FlushSends();
+    void Compile_CallFlushSends();
+    void Compile_IncrementMethodAddress();
+    bool Compile_FoldedResult(Macro::Opcode opcode);
+
+    bool IsRedundantMethodMove(Macro::Opcode opcode) const;
+
+    /// Evaluates the instruction at compile time when all of its inputs are known constants.
+    std::optional<u32> FoldConstant(Macro::Opcode opcode) const;
+    std::optional<u32> KnownRegister(u32 index) const;
+    void SetKnownRegister(u32 index, std::optional<u32> value);
+    void ForgetConstants();
 
     Macro::Opcode GetOpCode() const;
 
     struct JITState {
         Engines::Maxwell3D* maxwell3d{};
+        SendBuffer* send_buffer{};
         std::array<u32, Macro::NUM_MACRO_REGISTERS> registers{};
         u32 carry_flag{};
     };
     static_assert(offsetof(JITState, maxwell3d) == 0, "Maxwell3D is not at 0x0");
     using ProgramType = void (*)(JITState*, const u32*, const u32*);
 
+    /// Values known at compile time while emitting the optimized tier. Everything is forgotten at
+    /// branch targets, since the state there depends on the path taken.
+    struct ConstantState {
+        std::array<std::optional<u32>, Macro::NUM_MACRO_REGISTERS> registers{};
+        std::optional<u32> next_parameter{};
+    };
+
     struct OptimizerState {
         bool can_skip_carry{};
         bool has_delayed_pc{};
@@ -104,55 +206,99 @@ private:
     bool is_delay_slot{};
     u32 pc{};
 
-    const std::vector<u32>& code;
+    std::vector<bool> is_branch_target;
+    ConstantState constants{};
+    std::optional<u32> folded_result{};
+    std::optional<u32> fetched_parameter{};
+
+    const std::vector<u32> code;
     Engines::Maxwell3D& maxwell3d;
+
+    const std::optional<ParameterSpecialization> specialization{};
+    const bool is_optimized{};
+    SendBuffer send_buffer{};
+
+    u32 num_executions{};
+    u32 num_guard_misses{};
+    bool has_variable_parameter_count{};
+    std::vector<std::optional<u32>> profiled_parameters;
+    std::shared_ptr<MacroJITx64Impl> optimized;
 };
 
 void MacroJITx64Impl::Execute(const std::vector<u32>& parameters, u32 method) {
     MICROPROFILE_SCOPE(MacroJitExecute);
+    // Hold a reference while running, the macro can invoke itself and replace the program
+    if (const std::shared_ptr<MacroJITx64Impl> tier = optimized) {
+        if (!tier->specialization || tier->specialization->Matches(parameters)) {
+            tier->Run(parameters);
+            return;
+        }
+        // The parameters stopped matching the profile, drop the parameter specialization
+        if (++num_guard_misses == MacroJITx64::OPTIMIZE_THRESHOLD) {
+            optimized = std::make_shared<MacroJITx64Impl>(maxwell3d, code, std::nullopt);
+        }
+    } else {
+        ProfileParameters(parameters);
+        if (++num_executions == MacroJITx64::OPTIMIZE_THRESHOLD) {
+            Optimize();
+        }
+    }
+    Run(parameters);
+}
+
+void MacroJITx64Impl::Run(const std::vector<u32>& parameters) {
     ASSERT_OR_EXECUTE(program != nullptr, { return; });
     JITState state{};
     state.maxwell3d = &maxwell3d;
-    state.registers = {};
+    state.send_buffer = &send_buffer;
     program(&state, parameters.data(), parameters.data() + parameters.size());
 }
 
-void MacroJITx64Impl::Compile_ALU(Macro::Opcode opcode) {
-    const bool is_a_zero = opcode.src_a == 0;
-    const bool is_b_zero = opcode.src_b == 0;
-    const bool valid_operation = !is_a_zero && !is_b_zero;
-    [[maybe_unused]] const bool is_move_operation = !is_a_zero && is_b_zero;
-    const bool has_zero_register = is_a_zero || is_b_zero;
-    const bool no_zero_reg_skip = opcode.alu_operation == Macro::ALUOperation::AddWithCarry ||
-                                  opcode.alu_operation == Macro::ALUOperation::SubtractWithBorrow;
-
-    Xbyak::Reg32 src_a;
-    Xbyak::Reg32 src_b;
-
-    if (!optimizer.zero_reg_skip || no_zero_reg_skip) {
-        src_a = Compile_GetRegister(opcode.src_a, RESULT);
-        src_b = Compile_GetRegister(opcode.src_b, eax);
-    } else {
-        if (!is_a_zero) {
-            src_a = Compile_GetRegister(opcode.src_a, RESULT);
+void MacroJITx64Impl::ProfileParameters(const std::vector<u32>& parameters) {
+    if (has_variable_parameter_count) {
+        return;
+    }
+    if (num_executions == 0) {
+        profiled_parameters.assign(parameters.begin(), parameters.end());
+        return;
+    }
+    if (profiled_parameters.size() != parameters.size()) {
+        has_variable_parameter_count = true;
+        return;
+    }
+    for (size_t slot = 0; slot < parameters.size(); ++slot) {
+        if (profiled_parameters[slot] != parameters[slot]) {
+            profiled_parameters[slot] = std::nullopt;
         }
-        if (!is_b_zero) {
-            src_b = Compile_GetRegister(opcode.src_b, eax);
+    }
+}
+
+void MacroJITx64Impl::Optimize() {
+    std::optional<ParameterSpecialization> parameters;
+    if (!has_variable_parameter_count) {
+        parameters.emplace();
+        parameters->values = std::move(profiled_parameters);
+        for (size_t slot = 0; slot < parameters->values.size(); ++slot) {
+            if (parameters->values[slot]) {
+                parameters->constant_slots.push_back(static_cast<u32>(slot));
+            }
         }
     }
+    optimized = std::make_shared<MacroJITx64Impl>(maxwell3d, code, std::move(parameters));
+}
 
-    bool has_emitted = false;
+void MacroJITx64Impl::Compile_ALU(Macro::Opcode opcode) {
+    if (Compile_FoldedResult(opcode)) {
+        return;
+    }
+    const auto src_a = Compile_GetRegister(opcode.src_a, RESULT);
+    const auto src_b = Compile_GetRegister(opcode.src_b, eax);
 
+    // The macro carry flag is set when an addition overflows and when a subtraction does not
+    // borrow, the latter being the inverse of the x86 carry flag.
     switch (opcode.alu_operation) {
     case Macro::ALUOperation::Add:
-        if (optimizer.zero_reg_skip) {
-            if (valid_operation) {
-                add(src_a, src_b);
-            }
-        } else {
-            add(src_a, src_b);
-        }
-
+        add(src_a, src_b);
         if (!optimizer.can_skip_carry) {
             setc(byte[STATE + offsetof(JITState, carry_flag)]);
         }
@@ -163,72 +309,33 @@ void MacroJITx64Impl::Compile_ALU(Macro::Opcode opcode) {
         setc(byte[STATE + offsetof(JITState, carry_flag)]);
         break;
     case Macro::ALUOperation::Subtract:
-        if (optimizer.zero_reg_skip) {
-            if (valid_operation) {
-                sub(src_a, src_b);
-                has_emitted = true;
-            }
-        } else {
-            sub(src_a, src_b);
-            has_emitted = true;
-        }
-        if (!optimizer.can_skip_carry && has_emitted) {
-            setc(byte[STATE + offsetof(JITState, carry_flag)]);
+        sub(src_a, src_b);
+        if (!optimizer.can_skip_carry) {
+            setnc(byte[STATE + offsetof(JITState, carry_flag)]);
         }
         break;
     case Macro::ALUOperation::SubtractWithBorrow:
         bt(dword[STATE + offsetof(JITState, carry_flag)], 0);
+        cmc();
         sbb(src_a, src_b);
-        setc(byte[STATE + offsetof(JITState, carry_flag)]);
+        setnc(byte[STATE + offsetof(JITState, carry_flag)]);
         break;
     case Macro::ALUOperation::Xor:
-        if (optimizer.zero_reg_skip) {
-            if (valid_operation) {
-                xor_(src_a, src_b);
-            }
-        } else {
-            xor_(src_a, src_b);
-        }
+        xor_(src_a, src_b);
         break;
     case Macro::ALUOperation::Or:
-        if (optimizer.zero_reg_skip) {
-            if (valid_operation) {
-                or_(src_a, src_b);
-            }
-        } else {
-            or_(src_a, src_b);
-        }
+        or_(src_a, src_b);
         break;
     case Macro::ALUOperation::And:
-        if (optimizer.zero_reg_skip) {
-            if (!has_zero_register) {
-                and_(src_a, src_b);
-            }
-        } else {
-            and_(src_a, src_b);
-        }
+        and_(src_a, src_b);
         break;
     case Macro::ALUOperation::AndNot:
-        if (optimizer.zero_reg_skip) {
-            if (!is_a_zero) {
-                not_(src_b);
-                and_(src_a, src_b);
-            }
-        } else {
-            not_(src_b);
-            and_(src_a, src_b);
-        }
+        not_(src_b);
+        and_(src_a, src_b);
         break;
     case Macro::ALUOperation::Nand:
-        if (optimizer.zero_reg_skip) {
-            if (!is_a_zero) {
-                and_(src_a, src_b);
-                not_(src_a);
-            }
-        } else {
-            and_(src_a, src_b);
-            not_(src_a);
-        }
+        and_(src_a, src_b);
+        not_(src_a);
         break;
     default:
         UNIMPLEMENTED_MSG("Unimplemented ALU operation {}", opcode.alu_operation.Value());
@@ -237,6 +344,30 @@ void MacroJITx64Impl::Compile_ALU(Macro::Opcode opcode) {
     Compile_ProcessResult(opcode.result_operation, opcode.dst);
 }
 
+bool MacroJITx64Impl::IsRedundantMethodMove(Macro::Opcode opcode) const {
+    if (!next_opcode || pc == 0) {
+        return false;
+    }
+    // The next instruction has to overwrite both the register and the method address before
+    // anything can observe them. It is not guaranteed to run when this is a delay slot.
+    const Macro::Opcode next = *next_opcode;
+    const Macro::Opcode previous{code[pc - 1]};
+    if (previous.is_exit ||
+        (previous.operation == Macro::Operation::Branch && !previous.branch_annul)) {
+        return false;
+    }
+    if (next.operation == Macro::Operation::Branch ||
+        next.result_operation != Macro::ResultOperation::MoveAndSetMethod ||
+        next.dst != opcode.dst) {
+        return false;
+    }
+    const bool reads_src_b = next.operation == Macro::Operation::ALU ||
+                             next.operation == Macro::Operation::ExtractInsert ||
+                             next.operation == Macro::Operation::ExtractShiftLeftImmediate ||
+                             next.operation == Macro::Operation::ExtractShiftLeftRegister;
+    return next.src_a != opcode.dst && (!reads_src_b || next.src_b != opcode.dst);
+}
+
 void MacroJITx64Impl::Compile_AddImmediate(Macro::Opcode opcode) {
     if (optimizer.skip_dummy_addimmediate) {
         // Games tend to use this as an exit instruction placeholder. It's to encode an instruction
@@ -247,35 +378,40 @@ void MacroJITx64Impl::Compile_AddImmediate(Macro::Opcode opcode) {
     }
     // Check for redundant moves
     if (optimizer.optimize_for_method_move &&
-        opcode.result_operation == Macro::ResultOperation::MoveAndSetMethod) {
-        if (next_opcode.has_value()) {
-            const auto next = *next_opcode;
-            if (next.result_operation == Macro::ResultOperation::MoveAndSetMethod &&
-                opcode.dst == next.dst) {
-                return;
-            }
-        }
+        opcode.result_operation == Macro::ResultOperation::MoveAndSetMethod &&
+        IsRedundantMethodMove(opcode)) {
+        return;
+    }
+    if (Compile_FoldedResult(opcode)) {
+        return;
     }
+    Compile_AddressImmediate(opcode);
+    Compile_ProcessResult(opcode.result_operation, opcode.dst);
+}
+
+void MacroJITx64Impl::Compile_AddressImmediate(Macro::Opcode opcode) {
     if (optimizer.zero_reg_skip && opcode.src_a == 0) {
         if (opcode.immediate == 0) {
             xor_(RESULT, RESULT);
         } else {
             mov(RESULT, opcode.immediate);
         }
-    } else {
-        auto result = Compile_GetRegister(opcode.src_a, RESULT);
-        if (opcode.immediate > 2) {
-            add(result, opcode.immediate);
-        } else if (opcode.immediate == 1) {
-            inc(result);
-        } else if (opcode.immediate < 0) {
-            sub(result, opcode.immediate * -1);
-        }
+        return;
+    }
+    const auto result = Compile_GetRegister(opcode.src_a, RESULT);
+    if (opcode.immediate == 1) {
+        inc(result);
+    } else if (opcode.immediate > 0) {
+        add(result, opcode.immediate);
+    } else if (opcode.immediate < 0) {
+        sub(result, opcode.immediate * -1);
     }
-    Compile_ProcessResult(opcode.result_operation, opcode.dst);
 }
 
 void MacroJITx64Impl::Compile_ExtractInsert(Macro::Opcode opcode) {
+    if (Compile_FoldedResult(opcode)) {
+        return;
+    }
     auto dst = Compile_GetRegister(opcode.src_a, RESULT);
     auto src = Compile_GetRegister(opcode.src_b, eax);
 
@@ -290,6 +426,9 @@ void MacroJITx64Impl::Compile_ExtractInsert(Macro::Opcode opcode) {
 }
 
 void MacroJITx64Impl::Compile_ExtractShiftLeftImmediate(Macro::Opcode opcode) {
+    if (Compile_FoldedResult(opcode)) {
+        return;
+    }
     const auto dst = Compile_GetRegister(opcode.src_a, ecx);
     const auto src = Compile_GetRegister(opcode.src_b, RESULT);
 
@@ -301,6 +440,9 @@ void MacroJITx64Impl::Compile_ExtractShiftLeftImmediate(Macro::Opcode opcode) {
 }
 
 void MacroJITx64Impl::Compile_ExtractShiftLeftRegister(Macro::Opcode opcode) {
+    if (Compile_FoldedResult(opcode)) {
+        return;
+    }
     const auto dst = Compile_GetRegister(opcode.src_a, ecx);
     const auto src = Compile_GetRegister(opcode.src_b, RESULT);
 
@@ -312,22 +454,9 @@ void MacroJITx64Impl::Compile_ExtractShiftLeftRegister(Macro::Opcode opcode) {
 }
 
 void MacroJITx64Impl::Compile_Read(Macro::Opcode opcode) {
-    if (optimizer.zero_reg_skip && opcode.src_a == 0) {
-        if (opcode.immediate == 0) {
-            xor_(RESULT, RESULT);
-        } else {
-            mov(RESULT, opcode.immediate);
-        }
-    } else {
-        auto result = Compile_GetRegister(opcode.src_a, RESULT);
-        if (opcode.immediate > 2) {
-            add(result, opcode.immediate);
-        } else if (opcode.immediate == 1) {
-            inc(result);
-        } else if (opcode.immediate < 0) {
-            sub(result, opcode.immediate * -1);
-        }
-    }
+    // Buffered writes have to land before the register file is observed
+    Compile_FlushSends();
+    Compile_AddressImmediate(opcode);
 
     // Equivalent to Engines::Maxwell3D::GetRegisterValue:
     if (optimizer.enable_asserts) {
@@ -350,6 +479,11 @@ void Send(Engines::Maxwell3D* maxwell3d, Macro::MethodAddress method_address, u3
 }
 
 void MacroJITx64Impl::Compile_Send(Xbyak::Reg32 value) {
+    if (is_optimized) {
+        Compile_BufferSend(value);
+        Compile_IncrementMethodAddress();
+        return;
+    }
     Common::X64::ABI_PushRegistersAndAdjustStack(*this, PersistentCallerSavedRegs(), 0);
     mov(Common::X64::ABI_PARAM1, qword[STATE]);
     mov(Common::X64::ABI_PARAM2, METHOD_ADDRESS);
@@ -357,6 +491,42 @@ void MacroJITx64Impl::Compile_Send(Xbyak::Reg32 value) {
     Common::X64::CallFarFunction(*this, &Send);
     Common::X64::ABI_PopRegistersAndAdjustStack(*this, PersistentCallerSavedRegs(), 0);
 
+    Compile_IncrementMethodAddress();
+}
+
+void MacroJITx64Impl::Compile_BufferSend(Xbyak::Reg32 value) {
+    Xbyak::Label has_space{};
+    mov(ecx, dword[SEND_BUFFER + offsetof(SendBuffer, num_pending)]);
+    mov(dword[SEND_BUFFER + offsetof(SendBuffer, methods) + rcx * sizeof(u32)], METHOD_ADDRESS);
+    mov(dword[SEND_BUFFER + offsetof(SendBuffer, values) + rcx * sizeof(u32)], value);
+    inc(ecx);
+    mov(dword[SEND_BUFFER + offsetof(SendBuffer, num_pending)], ecx);
+    cmp(ecx, MAX_PENDING_SENDS);
+    jb(has_space, T_NEAR);
+    Compile_CallFlushSends();
+    L(has_space);
+}
+
+void MacroJITx64Impl::Compile_FlushSends() {
+    if (!is_optimized) {
+        return;
+    }
+    Xbyak::Label empty{};
+    cmp(dword[SEND_BUFFER + offsetof(SendBuffer, num_pending)], 0);
+    je(empty, T_NEAR);
+    Compile_CallFlushSends();
+    L(empty);
+}
+
+void MacroJITx64Impl::Compile_CallFlushSends() {
+    Common::X64::ABI_PushRegistersAndAdjustStack(*this, PersistentCallerSavedRegs(), 0);
+    mov(Common::X64::ABI_PARAM1, qword[STATE]);
+    mov(Common::X64::ABI_PARAM2, SEND_BUFFER);
+    Common::X64::CallFarFunction(*this, &FlushSends);
+    Common::X64::ABI_PopRegistersAndAdjustStack(*this, PersistentCallerSavedRegs(), 0);
+}
+
+void MacroJITx64Impl::Compile_IncrementMethodAddress() {
     Xbyak::Label dont_process{};
     // Get increment
     test(METHOD_ADDRESS, 0x3f000);
@@ -381,6 +551,14 @@ void MacroJITx64Impl::Compile_Branch(Macro::Opcode opcode) {
     const s32 jump_address =
         static_cast<s32>(pc) + static_cast<s32>(opcode.GetBranchTarget() / sizeof(s32));
 
+    if (const auto known = KnownRegister(opcode.src_a)) {
+        const bool is_zero = *known == 0;
+        if (is_zero != (opcode.branch_condition == Macro::BranchCondition::Zero)) {
+            // Never taken with the specialized parameters
+            return;
+        }
+    }
+
     Xbyak::Label end;
     auto value = Compile_GetRegister(opcode.src_a, eax);
     cmp(value, 0); // test(value, value);
@@ -427,9 +605,10 @@ void MacroJITx64Impl::Compile_Branch(Macro::Opcode opcode) {
 void MacroJITx64Impl::Optimizer_ScanFlags() {
     optimizer.can_skip_carry = true;
     optimizer.has_delayed_pc = false;
-    for (auto raw_op : code) {
+    is_branch_target.assign(code.size(), false);
+    for (size_t i = 0; i < code.size(); ++i) {
         Macro::Opcode op{};
-        op.raw = raw_op;
+        op.raw = code[i];
 
         if (op.operation == Macro::Operation::ALU) {
             // Scan for any ALU operations which actually use the carry flag, if they don't exist in
@@ -444,6 +623,14 @@ void MacroJITx64Impl::Optimizer_ScanFlags() {
             if (!op.branch_annul) {
                 optimizer.has_delayed_pc = true;
             }
+            const s64 target = static_cast<s64>(i) + op.immediate;
+            if (target >= 0 && target < static_cast<s64>(code.size())) {
+                is_branch_target[static_cast<size_t>(target)] = true;
+            }
+        }
+        // Code after the delay slot of an exit is only reachable through a branch
+        if (op.is_exit && i + 2 < code.size()) {
+            is_branch_target[i + 2] = true;
         }
     }
 }
@@ -460,8 +647,15 @@ void MacroJITx64Impl::Compile() {
     xor_(RESULT, RESULT);
     xor_(METHOD_ADDRESS, METHOD_ADDRESS);
     xor_(BRANCH_HOLDER, BRANCH_HOLDER);
+    if (is_optimized) {
+        mov(SEND_BUFFER, qword[STATE + offsetof(JITState, send_buffer)]);
+        // All registers start cleared, the first parameter is always loaded into $r1
+        constants.registers.fill(0U);
+        constants.next_parameter = 0;
+    }
 
     mov(dword[STATE + offsetof(JITState, registers) + 4], Compile_FetchParameter());
+    SetKnownRegister(1, fetched_parameter);
 
     // Track get register for zero registers and mark it as no-op
     optimizer.zero_reg_skip = true;
@@ -493,6 +687,7 @@ void MacroJITx64Impl::Compile() {
     }
 
     L(end_of_code);
+    Compile_FlushSends();
 
     Common::X64::ABI_PopRegistersAndAdjustStack(*this, Common::X64::ABI_ALL_CALLEE_SAVED, 8);
     ret();
@@ -508,6 +703,11 @@ bool MacroJITx64Impl::Compile_NextInstruction() {
 
     L(labels[pc]);
 
+    if (is_branch_target[pc]) {
+        ForgetConstants();
+    }
+    folded_result = FoldConstant(opcode);
+
     switch (opcode.operation) {
     case Macro::Operation::ALU:
         Compile_ALU(opcode);
@@ -574,6 +774,21 @@ static void WarnInvalidParameter(uintptr_t parameter, uintptr_t max_parameter) {
 }
 
 Xbyak::Reg32 MacroJITx64Impl::Compile_FetchParameter() {
+    fetched_parameter = std::nullopt;
+    if (constants.next_parameter) {
+        const u32 slot = (*constants.next_parameter)++;
+        if (specialization && slot < specialization->values.size()) {
+            // The parameter count is checked before entering the specialized program
+            fetched_parameter = specialization->values[slot];
+            if (fetched_parameter) {
+                mov(eax, *fetched_parameter);
+            } else {
+                mov(eax, dword[PARAMETERS]);
+            }
+            add(PARAMETERS, sizeof(u32));
+            return eax;
+        }
+    }
     Xbyak::Label parameter_ok{};
     cmp(PARAMETERS, MAX_PARAMETER);
     jb(parameter_ok, T_NEAR);
@@ -600,51 +815,59 @@ Xbyak::Reg32 MacroJITx64Impl::Compile_GetRegister(u32 index, Xbyak::Reg32 dst) {
 }
 
 void MacroJITx64Impl::Compile_ProcessResult(Macro::ResultOperation operation, u32 reg) {
-    const auto SetRegister = [this](u32 reg_index, const Xbyak::Reg32& result) {
+    const auto SetRegister = [this](u32 reg_index, const Xbyak::Reg32& result,
+                                    std::optional<u32> known_value) {
         // Register 0 is supposed to always return 0. NOP is implemented as a store to the zero
         // register.
         if (reg_index == 0) {
             return;
         }
         mov(dword[STATE + offsetof(JITState, registers) + reg_index * sizeof(u32)], result);
+        SetKnownRegister(reg_index, known_value);
     };
     const auto SetMethodAddress = [this](const Xbyak::Reg32& reg32) { mov(METHOD_ADDRESS, reg32); };
 
     switch (operation) {
-    case Macro::ResultOperation::IgnoreAndFetch:
-        SetRegister(reg, Compile_FetchParameter());
+    case Macro::ResultOperation::IgnoreAndFetch: {
+        const auto parameter = Compile_FetchParameter();
+        SetRegister(reg, parameter, fetched_parameter);
         break;
+    }
     case Macro::ResultOperation::Move:
-        SetRegister(reg, RESULT);
+        SetRegister(reg, RESULT, folded_result);
         break;
     case Macro::ResultOperation::MoveAndSetMethod:
-        SetRegister(reg, RESULT);
+        SetRegister(reg, RESULT, folded_result);
         SetMethodAddress(RESULT);
         break;
-    case Macro::ResultOperation::FetchAndSend:
+    case Macro::ResultOperation::FetchAndSend: {
         // Fetch parameter and send result.
-        SetRegister(reg, Compile_FetchParameter());
+        const auto parameter = Compile_FetchParameter();
+        SetRegister(reg, parameter, fetched_parameter);
         Compile_Send(RESULT);
         break;
+    }
     case Macro::ResultOperation::MoveAndSend:
         // Move and send result.
-        SetRegister(reg, RESULT);
+        SetRegister(reg, RESULT, folded_result);
         Compile_Send(RESULT);
         break;
-    case Macro::ResultOperation::FetchAndSetMethod:
+    case Macro::ResultOperation::FetchAndSetMethod: {
         // Fetch parameter and use result as Method Address.
-        SetRegister(reg, Compile_FetchParameter());
+        const auto parameter = Compile_FetchParameter();
+        SetRegister(reg, parameter, fetched_parameter);
         SetMethodAddress(RESULT);
         break;
+    }
     case Macro::ResultOperation::MoveAndSetMethodFetchAndSend:
         // Move result and use as Method Address, then fetch and send parameter.
-        SetRegister(reg, RESULT);
+        SetRegister(reg, RESULT, folded_result);
         SetMethodAddress(RESULT);
         Compile_Send(Compile_FetchParameter());
         break;
     case Macro::ResultOperation::MoveAndSetMethodSend:
         // Move result and use as Method Address, then send bits 12:17 of result.
-        SetRegister(reg, RESULT);
+        SetRegister(reg, RESULT, folded_result);
         SetMethodAddress(RESULT);
         shr(RESULT, 12);
         and_(RESULT, 0b111111);
@@ -656,6 +879,94 @@ void MacroJITx64Impl::Compile_ProcessResult(Macro::ResultOperation operation, u3
     }
 }
 
+bool MacroJITx64Impl::Compile_FoldedResult(Macro::Opcode opcode) {
+    if (!folded_result) {
+        return false;
+    }
+    if (*folded_result == 0) {
+        xor_(RESULT, RESULT);
+    } else {
+        mov(RESULT, *folded_result);
+    }
+    Compile_ProcessResult(opcode.result_operation, opcode.dst);
+    return true;
+}
+
+std::optional<u32> MacroJITx64Impl::FoldConstant(Macro::Opcode opcode) const {
+    if (!is_optimized) {
+        return std::nullopt;
+    }
+    const std::optional<u32> src_a = KnownRegister(opcode.src_a);
+    const std::optional<u32> src_b = KnownRegister(opcode.src_b);
+    switch (opcode.operation) {
+    case Macro::Operation::ALU:
+        if (!src_a || !src_b) {
+            return std::nullopt;
+        }
+        switch (opcode.alu_operation) {
+        case Macro::ALUOperation::Add:
+            return optimizer.can_skip_carry ? std::optional{*src_a + *src_b} : std::nullopt;
+        case Macro::ALUOperation::Subtract:
+            return optimizer.can_skip_carry ? std::optional{*src_a - *src_b} : std::nullopt;
+        case Macro::ALUOperation::Xor:
+            return *src_a ^ *src_b;
+        case Macro::ALUOperation::Or:
+            return *src_a | *src_b;
+        case Macro::ALUOperation::And:
+            return *src_a & *src_b;
+        case Macro::ALUOperation::AndNot:
+            return *src_a & ~*src_b;
+        case Macro::ALUOperation::Nand:
+            return ~(*src_a & *src_b);
+        default:
+            return std::nullopt;
+        }
+    case Macro::Operation::AddImmediate:
+        if (!src_a) {
+            return std::nullopt;
+        }
+        return *src_a + static_cast<u32>(opcode.immediate.Value());
+    case Macro::Operation::ExtractInsert: {
+        if (!src_a || !src_b) {
+            return std::nullopt;
+        }
+        const u32 mask = opcode.GetBitfieldMask();
+        const u32 field = (*src_b >> opcode.bf_src_bit) & mask;
+        return (*src_a & ~(mask << opcode.bf_dst_bit)) | (field << opcode.bf_dst_bit);
+    }
+    case Macro::Operation::ExtractShiftLeftImmediate:
+        if (!src_a || !src_b) {
+            return std::nullopt;
+        }
+        // x86 shifts only use the low five bits of the amount
+        return ((*src_b >> (*src_a & 31)) & opcode.GetBitfieldMask()) << opcode.bf_dst_bit;
+    case Macro::Operation::ExtractShiftLeftRegister:
+        if (!src_a || !src_b) {
+            return std::nullopt;
+        }
+        return ((*src_b >> opcode.bf_src_bit) & opcode.GetBitfieldMask()) << (*src_a & 31);
+    default:
+        return std::nullopt;
+    }
+}
+
+std::optional<u32> MacroJITx64Impl::KnownRegister(u32 index) const {
+    if (index == 0) {
+        return is_optimized ? std::optional<u32>{0} : std::nullopt;
+    }
+    return constants.registers[index];
+}
+
+void MacroJITx64Impl::SetKnownRegister(u32 index, std::optional<u32> value) {
+    if (is_optimized && index != 0) {
+        constants.registers[index] = value;
+    }
+}
+
+void MacroJITx64Impl::ForgetConstants() {
+    constants = {};
+}
+
 Macro::Opcode MacroJITx64Impl::GetOpCode() const {
     ASSERT(pc < code.size());
     return {code[pc]};
@@ -16,6 +16,10 @@ class MacroJITx64 final : public MacroEngine {
 public:
     explicit MacroJITx64(Engines::Maxwell3D& maxwell3d_);
 
+    /// Number of calls after which a macro is recompiled, specialized on the parameters that did
+    /// not change between those calls.
+    static constexpr u32 OPTIMIZE_THRESHOLD = 256;
+
 protected:
     std::unique_ptr<CachedMacro> Compile(const std::vector<u32>& code) override;
 
@@ -0,0 +1,179 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <limits>
+
+#include "common/fs/fs.h"
+#include "common/fs/path_util.h"
+#include "common/logging/log.h"
+#include "video_core/pipeline_predictor.h"
+
+namespace VideoCommon {
+namespace {
+constexpr std::array<char, 8> MAGIC_NUMBER{'c', 'i', 't', 'r', 'o', 'n', 'p', 't'};
+
+template <typename T>
+void Read(std::istream& file, T& value) {
+    file.read(reinterpret_cast<char*>(&value), sizeof(value));
+}
+
+template <typename T>
+void Write(std::ostream& file, const T& value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+} // Anonymous namespace
+
+void PipelinePredictor::Load(const std::filesystem::path& filename,
+                             u32 expected_cache_version) try {
+    transitions.clear();
+    known_successors.clear();
+    startup_pipelines.clear();
+
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return;
+    }
+    file.exceptions(std::ifstream::failbit);
+
+    std::array<char, 8> magic_number;
+    u32 cache_version;
+    file.read(magic_number.data(), magic_number.size());
+    Read(file, cache_version);
+    if (magic_number != MAGIC_NUMBER || cache_version != expected_cache_version) {
+        LOG_INFO(Render, "Discarding old pipeline transition history");
+        return;
+    }
+    u32 num_startup_pipelines;
+    Read(file, num_startup_pipelines);
+    for (u32 index = 0; index < num_startup_pipelines; ++index) {
+        u64 hash;
+        Read(file, hash);
+        startup_pipelines.insert(hash);
+    }
+    u32 num_predecessors;
+    Read(file, num_predecessors);
+    for (u32 index = 0; index < num_predecessors; ++index) {
+        u64 hash;
+        u32 num_successors;
+        Read(file, hash);
+        Read(file, num_successors);
+        Successors& successors{transitions[hash]};
+        for (u32 successor = 0; successor < num_successors; ++successor) {
+            Successor entry;
+            Read(file, entry.hash);
+            Read(file, entry.count);
+            // Age the history of previous sessions, so that successors that are no longer seen
+            // eventually fall behind the ones bound in recent sessions
+            entry.count = std::max<u32>(entry.count / 2, 1);
+            if (successors.size() < MAX_SUCCESSORS) {
+                successors.push_back(entry);
+                known_successors.insert(entry.hash);
+            }
+        }
+    }
+    LOG_INFO(Render, "Loaded transitions for {} pipelines", transitions.size());
+
+} catch (const std::ios_base::failure& e) {
+    LOG_ERROR(Common_Filesystem, "Failed to load pipeline transition history: {}", e.what());
+    transitions.clear();
+    known_successors.clear();
+    startup_pipelines.clear();
+}
+
+void PipelinePredictor::Save(const std::filesystem::path& filename, u32 cache_version) const try {
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        LOG_ERROR(Common_Filesystem, "Failed to open pipeline transition history file {}",
+                  Common::FS::PathToUTF8String(filename));
+        return;
+    }
+    file.exceptions(std::ofstream::failbit);
+
+    file.write(MAGIC_NUMBER.data(), MAGIC_NUMBER.size());
+    Write(file, cache_version);
+    if (session_startup_pipelines.empty()) {
+        Write(file, static_cast<u32>(startup_pipelines.size()));
+        for (const u64 hash : startup_pipelines) {
+            Write(file, hash);
+        }
+    } else {
+        Write(file, static_cast<u32>(session_startup_pipelines.size()));
+        for (const u64 hash : session_startup_pipelines) {
+            Write(file, hash);
+        }
+    }
+    Write(file, static_cast<u32>(transitions.size()));
+    for (const auto& [hash, successors] : transitions) {
+        Write(file, hash);
+        Write(file, static_cast<u32>(successors.size()));
+        for (const Successor& successor : successors) {
+            Write(file, successor.hash);
+            Write(file, successor.count);
+        }
+    }
+
+} catch (const std::ios_base::failure& e) {
+    LOG_ERROR(Common_Filesystem, "{}", e.what());
+    if (!Common::FS::RemoveFile(filename)) {
+        LOG_ERROR(Common_Filesystem, "Failed to delete pipeline transition history file {}",
+                  Common::FS::PathToUTF8String(filename));
+    }
+}
+
+void PipelinePredictor::RecordBind(u64 hash) {
+    if (session_startup_pipelines.size() >= MAX_STARTUP_PIPELINES) {
+        return;
+    }
+    if (std::ranges::find(session_startup_pipelines, hash) == session_startup_pipelines.end()) {
+        session_startup_pipelines.push_back(hash);
+    }
+}
+
+void PipelinePredictor::RecordTransition(u64 from, u64 to) {
+    Successors& successors{transitions[from]};
+    auto it{std::ranges::find(successors, to, &Successor::hash)};
+    if (it == successors.end()) {
+        u32 count = 0;
+        if (successors.size() == MAX_SUCCESSORS) {
+            // Replace the least frequent successor and inherit its count. Starting from zero
+            // would leave the new successor last, to be replaced by the next new transition
+            // before it could ever be seen again.
+            count = successors.back().count;
+            successors.pop_back();
+        }
+        successors.push_back({.hash = to, .count = count});
+        it = std::prev(successors.end());
+    }
+    if (it->count != std::numeric_limits<u32>::max()) {
+        ++it->count;
+    }
+    // Keep successors sorted by frequency, moving the updated entry towards the front
+    while (it != successors.begin() && std::prev(it)->count < it->count) {
+        std::iter_swap(it, std::prev(it));
+        --it;
+    }
+}
+
+bool PipelinePredictor::IsPredictable(u64 hash) const {
+    return known_successors.contains(hash) && !startup_pipelines.contains(hash);
+}
+
+PipelinePredictor::Predictions PipelinePredictor::Predict(u64 hash) const {
+    Predictions predictions;
+    const auto it{transitions.find(hash)};
+    if (it == transitions.end()) {
+        return predictions;
+    }
+    for (const Successor& successor : it->second) {
+        if (predictions.size() == MAX_PREDICTIONS) {
+            break;
+        }
+        predictions.push_back(successor.hash);
+    }
+    return predictions;
+}
+
+} // namespace VideoCommon
@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: Copyright 2025 citron Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <filesystem>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <boost/container/small_vector.hpp>
+#include <boost/container/static_vector.hpp>
+
+#include "common/common_types.h"
+
+namespace VideoCommon {
+
+/// Records which pipelines are bound after each other and predicts the likely successors of a
+/// pipeline from the transitions observed in previous sessions of the same title.
+/// Pipelines are identified by the hash of their backend specific cache key.
+class PipelinePredictor {
+public:
+    /// Maximum number of successors remembered for a single pipeline
+    static constexpr size_t MAX_SUCCESSORS = 8;
+
+    /// Maximum number of successors returned by a single prediction
+    static constexpr size_t MAX_PREDICTIONS = 4;
+
+    /// Number of distinct pipelines recorded as the startup set of a session
+    static constexpr size_t MAX_STARTUP_PIPELINES = 64;
+
+    using Predictions = boost::container::static_vector<u64, MAX_PREDICTIONS>;
+
+    /// Loads the transition history from a file, discarding it on a version mismatch
+    void Load(const std::filesystem::path& filename, u32 expected_cache_version);
+
+    /// Saves the transition history, including the transitions recorded in this session
+    void Save(const std::filesystem::path& filename, u32 cache_version) const;
+
+    /// Records that a pipeline has been bound
+    void RecordBind(u64 hash);
+
+    /// Records that the pipeline @p to has been bound right after the pipeline @p from
+    void RecordTransition(u64 from, u64 to);
+
+    /// Returns true when there is no transition history
+    [[nodiscard]] bool Empty() const noexcept {
+        return transitions.empty();
+    }
+
+    /// Returns true when a pipeline is expected to be reached from a known predecessor and is
+    /// not needed right after boot, so it can be built on demand instead of at load time
+    [[nodiscard]] bool IsPredictable(u64 hash) const;
+
+    /// Returns the most likely successors of a pipeline, most frequent first
+    [[nodiscard]] Predictions Predict(u64 hash) const;
+
+private:
+    struct Successor {
+        u64 hash;
+        u32 count;
+    };
+    using Successors = boost::container::small_vector<Successor, MAX_SUCCESSORS>;
+
+    std::unordered_map<u64, Successors> transitions;
+    std::unordered_set<u64> known_successors;
+    std::unordered_set<u64> startup_pipelines;
+    std::vector<u64> session_startup_pipelines;
+};
+
+} // namespace VideoCommon
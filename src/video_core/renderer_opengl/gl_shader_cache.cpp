@@ -51,8 +51,6 @@ using VideoCommon::LoadPipelines;
 using VideoCommon::SerializePipeline;
 using Context = ShaderContext::Context;
 
-constexpr u32 CACHE_VERSION = 10;
-
 template <typename Container>
 auto MakeSpan(Container& container) {
     return std::span(container.data(), container.size());
@@ -69,6 +67,19 @@ Shader::OutputTopology MaxwellToOutputTopology(Maxwell::PrimitiveTopology topolo
     }
 }
 
+void SetXfbState(VideoCommon::TransformFeedbackState& state, const Maxwell& regs) {
+    std::ranges::transform(regs.transform_feedback.controls, state.layouts.begin(),
+                           [](const auto& layout) {
+                               return VideoCommon::TransformFeedbackState::Layout{
+                                   .stream = layout.stream,
+                                   .varying_count = layout.varying_count,
+                                   .stride = layout.stride,
+                               };
+                           });
+    state.varyings = regs.stream_out_layout;
+}
+} // Anonymous namespace
+
 Shader::RuntimeInfo MakeRuntimeInfo(const GraphicsPipelineKey& key,
                                     const Shader::IR::Program& program,
                                     const Shader::IR::Program* previous_program,
@@ -155,19 +166,6 @@ Shader::RuntimeInfo MakeRuntimeInfo(const GraphicsPipelineKey& key,
     return info;
 }
 
-void SetXfbState(VideoCommon::TransformFeedbackState& state, const Maxwell& regs) {
-    std::ranges::transform(regs.transform_feedback.controls, state.layouts.begin(),
-                           [](const auto& layout) {
-                               return VideoCommon::TransformFeedbackState::Layout{
-                                   .stream = layout.stream,
-                                   .varying_count = layout.varying_count,
-                                   .stride = layout.stride,
-                               };
-                           });
-    state.varyings = regs.stream_out_layout;
-}
-} // Anonymous namespace
-
 ShaderCache::ShaderCache(Tegra::MaxwellDeviceMemoryManager& device_memory_,
                          Core::Frontend::EmuWindow& emu_window_, const Device& device_,
                          TextureCache& texture_cache_, BufferCache& buffer_cache_,
@@ -292,12 +290,11 @@ void ShaderCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading,
             workers->QueueWork(std::move(work));
         }
     }};
-    const auto load_compute{[&](std::ifstream& file, FileEnvironment env) {
-        ComputePipelineKey key;
-        file.read(reinterpret_cast<char*>(&key), sizeof(key));
+    const auto load_compute{[&](const ComputePipelineKey& key,
+                                std::shared_ptr<FileEnvironment> env) {
         queue_work([this, key, env_ = std::move(env), &state, &callback](Context* ctx) mutable {
             ctx->pools.ReleaseContents();
-            auto pipeline{CreateComputePipeline(ctx->pools, key, env_, true)};
+            auto pipeline{CreateComputePipeline(ctx->pools, key, *env_, true)};
             std::scoped_lock lock{state.mutex};
             if (pipeline) {
                 compute_cache.emplace(key, std::move(pipeline));
@@ -310,13 +307,12 @@ void ShaderCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading,
         ++state.total;
         ++state.total_compute;
     }};
-    const auto load_graphics{[&](std::ifstream& file, std::vector<FileEnvironment> envs) {
-        GraphicsPipelineKey key;
-        file.read(reinterpret_cast<char*>(&key), sizeof(key));
+    const auto load_graphics{[&](const GraphicsPipelineKey& key,
+                                 std::vector<std::shared_ptr<FileEnvironment>> envs) {
         queue_work([this, key, envs_ = std::move(envs), &state, &callback](Context* ctx) mutable {
             boost::container::static_vector<Shader::Environment*, 5> env_ptrs;
             for (auto& env : envs_) {
-                env_ptrs.push_back(&env);
+                env_ptrs.push_back(env.get());
             }
             ctx->pools.ReleaseContents();
             auto pipeline{CreateGraphicsPipeline(ctx->pools, key, MakeSpan(env_ptrs), false, true)};
@@ -332,7 +328,9 @@ void ShaderCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading,
         ++state.total;
         ++state.total_graphics;
     }};
-    LoadPipelines(stop_loading, shader_cache_filename, CACHE_VERSION, load_compute, load_graphics);
+    LoadPipelines<ComputePipelineKey, GraphicsPipelineKey>(stop_loading, shader_cache_filename,
+                                                           CACHE_VERSION, load_compute,
+                                                           load_graphics);
 
     LOG_INFO(Render_OpenGL, "Total Pipeline Count: {}", state.total);
 
@@ -489,14 +487,16 @@ std::unique_ptr<GraphicsPipeline> ShaderCache::CreateGraphicsPipeline(
 
         if (!uses_vertex_a || index != 1) {
             // Normal path
-            programs[index] = TranslateProgram(pools.inst, pools.block, env, cfg, host_info);
+            programs[index] =
+                TranslateProgram(pools.inst, pools.block, pools.arena, env, cfg, host_info);
 
             total_storage_buffers +=
                 Shader::NumDescriptors(programs[index].info.storage_buffers_descriptors);
         } else {
             // VertexB path when VertexA is present.
             auto& program_va{programs[0]};
-            auto program_vb{TranslateProgram(pools.inst, pools.block, env, cfg, host_info)};
+            auto program_vb{
+                TranslateProgram(pools.inst, pools.block, pools.arena, env, cfg, host_info)};
             total_storage_buffers +=
                 Shader::NumDescriptors(program_vb.info.storage_buffers_descriptors);
             programs[index] = MergeDualVertexPrograms(program_va, program_vb, env);
@@ -585,7 +585,7 @@ std::unique_ptr<ComputePipeline> ShaderCache::CreateComputePipeline(
         env.Dump(hash, key.unique_hash);
     }
 
-    auto program{TranslateProgram(pools.inst, pools.block, env, cfg, host_info)};
+    auto program{TranslateProgram(pools.inst, pools.block, pools.arena, env, cfg, host_info)};
     const u32 num_storage_buffers{Shader::NumDescriptors(program.info.storage_buffers_descriptors)};
     Shader::RuntimeInfo info;
     info.glasm_use_storage_buffers = num_storage_buffers <= device.GetMaxGLASMStorageBufferBlocks();
@@ -10,11 +10,16 @@
 #include "common/thread_worker.h"
 #include "shader_recompiler/host_translate_info.h"
 #include "shader_recompiler/profile.h"
+#include "shader_recompiler/runtime_info.h"
 #include "video_core/renderer_opengl/gl_compute_pipeline.h"
 #include "video_core/renderer_opengl/gl_graphics_pipeline.h"
 #include "video_core/renderer_opengl/gl_shader_context.h"
 #include "video_core/shader_cache.h"
 
+namespace Shader::IR {
+struct Program;
+}
+
 namespace Tegra {
 class MemoryManager;
 } // namespace Tegra
@@ -26,6 +31,16 @@ class ProgramManager;
 class RasterizerOpenGL;
 using ShaderWorker = Common::StatefulThreadWorker<ShaderContext::Context>;
 
+/// Version of the shader cache files, bumped whenever the serialized keys change
+constexpr u32 CACHE_VERSION = 10;
+
+/// Returns the runtime information used to emit a stage of a graphics pipeline
+[[nodiscard]] Shader::RuntimeInfo MakeRuntimeInfo(const GraphicsPipelineKey& key,
+                                                  const Shader::IR::Program& program,
+                                                  const Shader::IR::Program* previous_program,
+                                                  bool glasm_use_storage_buffers,
+                                                  bool use_assembly_shaders);
+
 class ShaderCache : public VideoCommon::ShaderCache {
 public:
     explicit ShaderCache(Tegra::MaxwellDeviceMemoryManager& device_memory_,
@@ -54,9 +54,11 @@ using VideoCommon::FileEnvironment;
 using VideoCommon::GenericEnvironment;
 using VideoCommon::GraphicsEnvironment;
 
-constexpr u32 CACHE_VERSION = 11;
 constexpr std::array<char, 8> VULKAN_CACHE_MAGIC_NUMBER{'y', 'u', 'z', 'u', 'v', 'k', 'c', 'h'};
 
+// Speculative builds are limited so pipelines needed by draws are not queued behind them
+constexpr size_t MAX_SPECULATIVE_PIPELINES = 2;
+
 template <typename Container>
 auto MakeSpan(Container& container) {
     return std::span(container.data(), container.size());
@@ -142,6 +144,23 @@ Shader::AttributeType AttributeType(const FixedPipelineState& state, size_t inde
     return Shader::AttributeType::Disabled;
 }
 
+size_t GetTotalPipelineWorkers() {
+    const size_t max_core_threads =
+        std::max<size_t>(static_cast<size_t>(std::thread::hardware_concurrency()), 2ULL);
+#ifdef ANDROID
+    // Leave at least a few cores free in android
+    constexpr size_t free_cores = 3ULL;
+    if (max_core_threads <= free_cores) {
+        return 1ULL;
+    }
+    return max_core_threads - free_cores;
+#else
+    return max_core_threads;
+#endif
+}
+
+} // Anonymous namespace
+
 Shader::RuntimeInfo MakeRuntimeInfo(std::span<const Shader::IR::Program> programs,
                                     const GraphicsPipelineCacheKey& key,
                                     const Shader::IR::Program& program,
@@ -265,23 +284,6 @@ Shader::RuntimeInfo MakeRuntimeInfo(std::span<const Shader::IR::Program> program
     return info;
 }
 
-size_t GetTotalPipelineWorkers() {
-    const size_t max_core_threads =
-        std::max<size_t>(static_cast<size_t>(std::thread::hardware_concurrency()), 2ULL);
-#ifdef ANDROID
-    // Leave at least a few cores free in android
-    constexpr size_t free_cores = 3ULL;
-    if (max_core_threads <= free_cores) {
-        return 1ULL;
-    }
-    return max_core_threads - free_cores;
-#else
-    return max_core_threads;
-#endif
-}
-
-} // Anonymous namespace
-
 size_t ComputePipelineCacheKey::Hash() const noexcept {
     const u64 hash = Common::CityHash64(reinterpret_cast<const char*>(this), sizeof *this);
     return static_cast<size_t>(hash);
@@ -312,6 +314,7 @@ PipelineCache::PipelineCache(Tegra::MaxwellDeviceMemoryManager& device_memory_,
       texture_cache{texture_cache_}, shader_notify{shader_notify_},
       use_asynchronous_shaders{Settings::values.use_asynchronous_shaders.GetValue()},
       use_vulkan_pipeline_cache{Settings::values.use_vulkan_driver_pipeline_cache.GetValue()},
+      use_speculative_pipelines{Settings::values.use_speculative_pipelines.GetValue()},
       workers(device.HasBrokenParallelShaderCompiling() ? 1ULL : GetTotalPipelineWorkers(),
               "VkPipelineBuilder"),
       serialization_thread(1, "VkPipelineSerialization") {
@@ -424,6 +427,14 @@ PipelineCache::~PipelineCache() {
         SerializeVulkanPipelineCache(vulkan_pipeline_cache_filename, vulkan_pipeline_cache,
                                      CACHE_VERSION);
     }
+    if (!pipeline_transitions_filename.empty()) {
+        pipeline_predictor.Save(pipeline_transitions_filename, CACHE_VERSION);
+
+        const auto& stats{speculation_statistics};
+        LOG_INFO(Render_Vulkan,
+                 "Speculative pipelines: {} predicted, {} used, {} wasted, {} never bound",
+                 stats.predicted, stats.used, stats.wasted, speculative_unused.size());
+    }
 }
 
 GraphicsPipeline* PipelineCache::CurrentGraphicsPipeline() {
@@ -485,6 +496,8 @@ void PipelineCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading
         vulkan_pipeline_cache =
             LoadVulkanPipelineCache(vulkan_pipeline_cache_filename, CACHE_VERSION);
     }
+    pipeline_transitions_filename = base_dir / "vulkan_transitions.bin";
+    pipeline_predictor.Load(pipeline_transitions_filename, CACHE_VERSION);
 
     struct {
         std::mutex mutex;
@@ -499,13 +512,11 @@ void PipelineCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading
     if (device.IsKhrPipelineExecutablePropertiesEnabled()) {
         state.statistics = std::make_unique<PipelineStatistics>(device);
     }
-    const auto load_compute{[&](std::ifstream& file, FileEnvironment env) {
-        ComputePipelineCacheKey key;
-        file.read(reinterpret_cast<char*>(&key), sizeof(key));
-
+    const auto load_compute{[&](const ComputePipelineCacheKey& key,
+                                std::shared_ptr<FileEnvironment> env) {
         workers.QueueWork([this, key, env_ = std::move(env), &state, &callback]() mutable {
             ShaderPools pools;
-            auto pipeline{CreateComputePipeline(pools, key, env_, state.statistics.get(), false)};
+            auto pipeline{CreateComputePipeline(pools, key, *env_, state.statistics.get(), false)};
             std::scoped_lock lock{state.mutex};
             if (pipeline) {
                 compute_cache.emplace(key, std::move(pipeline));
@@ -518,10 +529,8 @@ void PipelineCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading
         ++state.total;
         ++state.total_compute;
     }};
-    const auto load_graphics{[&](std::ifstream& file, std::vector<FileEnvironment> envs) {
-        GraphicsPipelineCacheKey key;
-        file.read(reinterpret_cast<char*>(&key), sizeof(key));
-
+    const auto load_graphics{[&](const GraphicsPipelineCacheKey& key,
+                                 std::vector<std::shared_ptr<FileEnvironment>> envs) {
         if ((key.state.extended_dynamic_state != 0) !=
                 dynamic_features.has_extended_dynamic_state ||
             (key.state.extended_dynamic_state_2 != 0) !=
@@ -535,11 +544,18 @@ void PipelineCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading
             (key.state.dynamic_vertex_input != 0) != dynamic_features.has_dynamic_vertex_input) {
             return;
         }
+        // Pipelines reached through a known transition are compiled when their predecessor is
+        // bound instead of at boot
+        const u64 hash{key.Hash()};
+        if (use_speculative_pipelines && pipeline_predictor.IsPredictable(hash)) {
+            deferred_graphics.emplace(hash, DeferredPipeline{.key = key, .envs = std::move(envs)});
+            return;
+        }
         workers.QueueWork([this, key, envs_ = std::move(envs), &state, &callback]() mutable {
             ShaderPools pools;
             boost::container::static_vector<Shader::Environment*, 5> env_ptrs;
             for (auto& env : envs_) {
-                env_ptrs.push_back(&env);
+                env_ptrs.push_back(env.get());
             }
             auto pipeline{CreateGraphicsPipeline(pools, key, MakeSpan(env_ptrs),
                                                  state.statistics.get(), false)};
@@ -556,10 +572,14 @@ void PipelineCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading
         ++state.total;
         ++state.total_graphics;
     }};
-    VideoCommon::LoadPipelines(stop_loading, pipeline_cache_filename, CACHE_VERSION, load_compute,
-                               load_graphics);
+    VideoCommon::LoadPipelines<ComputePipelineCacheKey, GraphicsPipelineCacheKey>(
+        stop_loading, pipeline_cache_filename, CACHE_VERSION, load_compute, load_graphics);
 
     LOG_INFO(Render_Vulkan, "Total Pipeline Count: {}", state.total);
+    if (!deferred_graphics.empty()) {
+        LOG_INFO(Render_Vulkan, "Deferred {} pipelines to speculative compilation",
+                 deferred_graphics.size());
+    }
 
     // Pre-reserve space in caches to reduce rehashing during async builds
     {
@@ -589,21 +609,97 @@ void PipelineCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading
 }
 
 GraphicsPipeline* PipelineCache::CurrentGraphicsPipelineSlowPath() {
+    const bool use_predictor{!pipeline_transitions_filename.empty()};
+    const u64 hash{use_predictor ? graphics_key.Hash() : 0};
+    if (use_predictor) {
+        UpdateSpeculativePipelines();
+    }
     const auto [pair, is_new]{graphics_cache.try_emplace(graphics_key)};
     auto& pipeline{pair->second};
     if (is_new) {
-        pipeline = CreateGraphicsPipeline();
+        pipeline = deferred_graphics.contains(hash) ? CreateDeferredGraphicsPipeline(hash)
+                                                    : CreateGraphicsPipeline();
     }
     if (!pipeline) {
         return nullptr;
     }
     if (current_pipeline) {
         current_pipeline->AddTransition(pipeline.get());
+        if (use_predictor) {
+            pipeline_predictor.RecordTransition(current_pipeline->Key().Hash(), hash);
+        }
     }
     current_pipeline = pipeline.get();
+    if (use_predictor) {
+        PredictGraphicsPipelines(hash);
+    }
     return BuiltPipeline(current_pipeline);
 }
 
+void PipelineCache::PredictGraphicsPipelines(u64 hash) {
+    pipeline_predictor.RecordBind(hash);
+    if (speculative_unused.erase(hash) != 0) {
+        ++speculation_statistics.used;
+    }
+    if (deferred_graphics.empty()) {
+        return;
+    }
+    for (const u64 successor : pipeline_predictor.Predict(hash)) {
+        const auto it{deferred_graphics.find(successor)};
+        if (it == deferred_graphics.end() || it->second.queued) {
+            continue;
+        }
+        it->second.queued = true;
+        speculative_queue.push_back(successor);
+    }
+    UpdateSpeculativePipelines();
+}
+
+void PipelineCache::UpdateSpeculativePipelines() {
+    {
+        std::scoped_lock lock{speculative_mutex};
+        for (auto& [hash, pipeline] : speculative_ready) {
+            --num_speculative_in_flight;
+            deferred_graphics.erase(hash);
+            if (!pipeline) {
+                continue;
+            }
+            const GraphicsPipelineCacheKey& key{pipeline->Key()};
+            if (graphics_cache.try_emplace(key, std::move(pipeline)).second) {
+                speculative_unused.insert(hash);
+            } else {
+                // The pipeline was needed and built before the speculative build finished
+                ++speculation_statistics.wasted;
+            }
+        }
+        speculative_ready.clear();
+    }
+    while (num_speculative_in_flight < MAX_SPECULATIVE_PIPELINES && !speculative_queue.empty()) {
+        const u64 hash{speculative_queue.front()};
+        speculative_queue.pop_front();
+
+        const auto it{deferred_graphics.find(hash)};
+        if (it == deferred_graphics.end()) {
+            continue;
+        }
+        ++num_speculative_in_flight;
+        ++speculation_statistics.predicted;
+        // The environments stay shared with the deferred entry, so a draw needing the pipeline
+        // before the speculative build finishes can still build it from them
+        workers.QueueWork([this, hash, key = it->second.key, envs = it->second.envs] {
+            ShaderPools pools;
+            boost::container::static_vector<Shader::Environment*, 5> env_ptrs;
+            for (auto& env : envs) {
+                env_ptrs.push_back(env.get());
+            }
+            auto pipeline{CreateGraphicsPipeline(pools, key, MakeSpan(env_ptrs), nullptr, false)};
+
+            std::scoped_lock lock{speculative_mutex};
+            speculative_ready.emplace_back(hash, std::move(pipeline));
+        });
+    }
+}
+
 GraphicsPipeline* PipelineCache::BuiltPipeline(GraphicsPipeline* pipeline) const noexcept {
     if (pipeline->IsBuilt()) {
         return pipeline;
@@ -649,11 +745,13 @@ std::unique_ptr<GraphicsPipeline> PipelineCache::CreateGraphicsPipeline(
         Shader::Maxwell::Flow::CFG cfg(env, pools.flow_block, cfg_offset, index == 0);
         if (!uses_vertex_a || index != 1) {
             // Normal path
-            programs[index] = TranslateProgram(pools.inst, pools.block, env, cfg, host_info);
+            programs[index] =
+                TranslateProgram(pools.inst, pools.block, pools.arena, env, cfg, host_info);
         } else {
             // VertexB path when VertexA is present.
             auto& program_va{programs[0]};
-            auto program_vb{TranslateProgram(pools.inst, pools.block, env, cfg, host_info)};
+            auto program_vb{
+                TranslateProgram(pools.inst, pools.block, pools.arena, env, cfg, host_info)};
             programs[index] = MergeDualVertexPrograms(program_va, program_vb, env);
         }
 
@@ -746,6 +844,24 @@ std::unique_ptr<GraphicsPipeline> PipelineCache::CreateGraphicsPipeline() {
     return pipeline;
 }
 
+std::unique_ptr<GraphicsPipeline> PipelineCache::CreateDeferredGraphicsPipeline(u64 hash) {
+    const auto it{deferred_graphics.find(hash)};
+    if (it->second.key != graphics_key) {
+        // A different pipeline with the same hash, build the current one from guest memory
+        return CreateGraphicsPipeline();
+    }
+    const DeferredPipeline deferred{std::move(it->second)};
+    deferred_graphics.erase(it);
+
+    // The pipeline is already in the disk cache, build it from its serialized environments
+    boost::container::static_vector<Shader::Environment*, 5> env_ptrs;
+    for (auto& env : deferred.envs) {
+        env_ptrs.push_back(env.get());
+    }
+    main_pools.ReleaseContents();
+    return CreateGraphicsPipeline(main_pools, deferred.key, MakeSpan(env_ptrs), nullptr, true);
+}
+
 std::unique_ptr<ComputePipeline> PipelineCache::CreateComputePipeline(
     const ComputePipelineCacheKey& key, const ShaderInfo* shader) {
     const GPUVAddr program_base{kepler_compute->regs.code_loc.Address()};
@@ -783,7 +899,7 @@ std::unique_ptr<ComputePipeline> PipelineCache::CreateComputePipeline(
         env.Dump(hash, key.unique_hash);
     }
 
-    auto program{TranslateProgram(pools.inst, pools.block, env, cfg, host_info)};
+    auto program{TranslateProgram(pools.inst, pools.block, pools.arena, env, cfg, host_info)};
     std::vector<u32> code = EmitSPIRV(profile, program);
     // Reserve more space for Insane mode to reduce allocations during shader compilation
     const size_t reserve_size = Settings::values.vram_usage_mode.GetValue() == Settings::VramUsageMode::Insane
@@ -5,22 +5,30 @@
 
 #include <array>
 #include <cstddef>
+#include <deque>
 #include <filesystem>
 #include <memory>
+#include <mutex>
+#include <span>
 #include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "common/common_types.h"
 #include "common/thread_worker.h"
+#include "shader_recompiler/arena.h"
 #include "shader_recompiler/frontend/ir/basic_block.h"
 #include "shader_recompiler/frontend/ir/value.h"
 #include "shader_recompiler/frontend/maxwell/control_flow.h"
 #include "shader_recompiler/host_translate_info.h"
 #include "shader_recompiler/object_pool.h"
 #include "shader_recompiler/profile.h"
+#include "shader_recompiler/runtime_info.h"
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/host1x/gpu_device_memory_manager.h"
+#include "video_core/pipeline_predictor.h"
 #include "video_core/renderer_vulkan/fixed_pipeline_state.h"
 #include "video_core/renderer_vulkan/vk_buffer_cache.h"
 #include "video_core/renderer_vulkan/vk_compute_pipeline.h"
@@ -36,6 +44,10 @@ namespace Shader::IR {
 struct Program;
 }
 
+namespace VideoCommon {
+class FileEnvironment;
+}
+
 namespace VideoCore {
 class ShaderNotify;
 }
@@ -85,16 +97,34 @@ class Scheduler;
 
 using VideoCommon::ShaderInfo;
 
+/// Version of the pipeline cache files, bumped whenever the serialized keys change
+constexpr u32 CACHE_VERSION = 11;
+
 struct ShaderPools {
     void ReleaseContents() {
         flow_block.ReleaseContents();
         block.ReleaseContents();
         inst.ReleaseContents();
+        arena.ReleaseContents();
     }
 
     Shader::ObjectPool<Shader::IR::Inst> inst{8192};
     Shader::ObjectPool<Shader::IR::Block> block{32};
     Shader::ObjectPool<Shader::Maxwell::Flow::Block> flow_block{32};
+    Shader::Arena arena;
+};
+
+/// Returns the runtime information used to emit a stage of a graphics pipeline
+[[nodiscard]] Shader::RuntimeInfo MakeRuntimeInfo(std::span<const Shader::IR::Program> programs,
+                                                  const GraphicsPipelineCacheKey& key,
+                                                  const Shader::IR::Program& program,
+                                                  const Shader::IR::Program* previous_program);
+
+/// Counters of the speculative pipeline compilation driven by the pipeline predictor
+struct SpeculationStatistics {
+    u64 predicted{}; ///< Pipelines queued for compilation before a draw needed them
+    u64 used{};      ///< Speculatively compiled pipelines that were bound afterwards
+    u64 wasted{};    ///< Speculatively compiled pipelines discarded because a draw built them first
 };
 
 class PipelineCache : public VideoCommon::ShaderCache {
@@ -113,13 +143,31 @@ public:
     void LoadDiskResources(u64 title_id, std::stop_token stop_loading,
                            const VideoCore::DiskResourceLoadCallback& callback);
 
+    [[nodiscard]] SpeculationStatistics GetSpeculationStatistics() const noexcept {
+        return speculation_statistics;
+    }
+
 private:
+    struct DeferredPipeline {
+        GraphicsPipelineCacheKey key;
+        std::vector<std::shared_ptr<VideoCommon::FileEnvironment>> envs;
+        bool queued{};
+    };
+
     [[nodiscard]] GraphicsPipeline* CurrentGraphicsPipelineSlowPath();
 
     [[nodiscard]] GraphicsPipeline* BuiltPipeline(GraphicsPipeline* pipeline) const noexcept;
 
     std::unique_ptr<GraphicsPipeline> CreateGraphicsPipeline();
 
+    std::unique_ptr<GraphicsPipeline> CreateDeferredGraphicsPipeline(u64 hash);
+
+    /// Records the bound pipeline and queues its likely successors for compilation
+    void PredictGraphicsPipelines(u64 hash);
+
+    /// Moves speculatively compiled pipelines into the cache and dispatches pending predictions
+    void UpdateSpeculativePipelines();
+
     std::unique_ptr<GraphicsPipeline> CreateGraphicsPipeline(
         ShaderPools& pools, const GraphicsPipelineCacheKey& key,
         std::span<Shader::Environment* const> envs, PipelineStatistics* statistics,
@@ -150,6 +198,7 @@ private:
     VideoCore::ShaderNotify& shader_notify;
     bool use_asynchronous_shaders{};
     bool use_vulkan_pipeline_cache{};
+    bool use_speculative_pipelines{};
 
     GraphicsPipelineCacheKey graphics_key{};
     GraphicsPipeline* current_pipeline{};
@@ -167,6 +216,17 @@ private:
     std::filesystem::path vulkan_pipeline_cache_filename;
     vk::PipelineCache vulkan_pipeline_cache;
 
+    std::filesystem::path pipeline_transitions_filename;
+    VideoCommon::PipelinePredictor pipeline_predictor;
+    std::unordered_map<u64, DeferredPipeline> deferred_graphics;
+    std::deque<u64> speculative_queue;
+    size_t num_speculative_in_flight{};
+    std::unordered_set<u64> speculative_unused;
+    SpeculationStatistics speculation_statistics;
+
+    std::mutex speculative_mutex;
+    std::vector<std::pair<u64, std::unique_ptr<GraphicsPipeline>>> speculative_ready;
+
     Common::ThreadWorker workers;
     Common::ThreadWorker serialization_thread;
     DynamicFeatures dynamic_features;
@@ -2,20 +2,34 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <unordered_set>
 #include <utility>
 
+#include <boost/container/static_vector.hpp>
+
 #include "common/assert.h"
 #include "common/cityhash.h"
 #include "common/common_types.h"
 #include "common/div_ceil.h"
 #include "common/fs/fs.h"
+#include "common/fs/mapped_file.h"
 #include "common/fs/path_util.h"
 #include "common/logging/log.h"
 #include "common/polyfill_ranges.h"
+#include "common/thread_worker.h"
+#include "common/zstd_compression.h"
 #include "shader_recompiler/environment.h"
 #include "video_core/engines/kepler_compute.h"
 #include "video_core/memory_manager.h"
@@ -27,10 +41,172 @@ namespace VideoCommon {
 
 constexpr std::array<char, 8> MAGIC_NUMBER{'y', 'u', 'z', 'u', 'c', 'a', 'c', 'h'};
 
+// Pipeline cache container. After the magic number and the cache version, the file is a sequence
+// of records appended as pipelines are built:
+//  - Environment: u8 type, u64 hash, u32 size, u32 compressed size, zstd compressed environment
+//  - Pipeline: u8 type, u32 number of environments, u64 environment hashes, u32 key size, key
+// Environments are content addressed, identical shaders used by many pipelines are stored once.
+constexpr std::array<char, 8> CONTAINER_MAGIC_NUMBER{'c', 'i', 't', 'r', 'o', 'n', 'p', 'c'};
+constexpr u8 RECORD_ENVIRONMENT = 0;
+constexpr u8 RECORD_PIPELINE = 1;
+
 constexpr size_t INST_SIZE = sizeof(u64);
 
 using Maxwell = Tegra::Engines::Maxwell3D::Regs;
 
+namespace {
+
+/// Environment hashes already stored in each pipeline cache file
+struct {
+    std::mutex mutex;
+    std::unordered_map<std::string, std::unordered_set<u64>> hashes;
+} stored_environments;
+
+/// Read-only stream buffer over memory, used to deserialize environments without copies
+class MemoryStreamBuffer final : public std::streambuf {
+public:
+    explicit MemoryStreamBuffer(std::span<const u8> data) {
+        char* const begin{const_cast<char*>(reinterpret_cast<const char*>(data.data()))};
+        setg(begin, begin, begin + data.size());
+    }
+
+    [[nodiscard]] size_t Position() const {
+        return static_cast<size_t>(gptr() - eback());
+    }
+};
+
+/// Bounds checked sequential reader over a memory region
+class RecordReader {
+public:
+    explicit RecordReader(std::span<const u8> data_) : data{data_} {}
+
+    template <typename T>
+    [[nodiscard]] bool Read(T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (data.size() - offset < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, data.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+
+    [[nodiscard]] bool ReadSpan(size_t size, std::span<const u8>& out) {
+        if (data.size() - offset < size) {
+            return false;
+        }
+        out = data.subspan(offset, size);
+        offset += size;
+        return true;
+    }
+
+    void Skip(size_t size) {
+        offset = std::min(offset + size, data.size());
+    }
+
+    [[nodiscard]] size_t Offset() const {
+        return offset;
+    }
+
+    [[nodiscard]] bool AtEnd() const {
+        return offset == data.size();
+    }
+
+private:
+    std::span<const u8> data;
+    size_t offset{};
+};
+
+std::shared_ptr<FileEnvironment> DeserializeEnvironment(std::span<const u8> serialized) try {
+    MemoryStreamBuffer buffer{serialized};
+    std::istream stream{&buffer};
+    stream.exceptions(std::ios::failbit);
+    auto env{std::make_shared<FileEnvironment>()};
+    env->Deserialize(stream);
+    return env;
+} catch (const std::ios_base::failure&) {
+    return nullptr;
+}
+
+void WritePipelineRecord(std::ostream& file, std::span<const u64> hashes,
+                         std::span<const char> key) {
+    const u32 num_envs{static_cast<u32>(hashes.size())};
+    const u32 key_size{static_cast<u32>(key.size())};
+    file.write(reinterpret_cast<const char*>(&RECORD_PIPELINE), sizeof(RECORD_PIPELINE))
+        .write(reinterpret_cast<const char*>(&num_envs), sizeof(num_envs))
+        .write(reinterpret_cast<const char*>(hashes.data()), hashes.size_bytes())
+        .write(reinterpret_cast<const char*>(&key_size), sizeof(key_size))
+        .write(key.data(), key.size());
+}
+
+/// Writes a pipeline cache in the previous single stream format to temp_filename in the container
+/// format. The source cache is left untouched, the caller replaces it once it has been unmapped.
+bool MigrateLegacyCache(std::span<const u8> data, const std::filesystem::path& temp_filename,
+                        size_t compute_key_size, size_t graphics_key_size) try {
+    {
+        std::ofstream output(temp_filename, std::ios::binary | std::ios::trunc);
+        output.exceptions(std::ios::failbit);
+
+        MemoryStreamBuffer buffer{data};
+        std::istream input{&buffer};
+        input.exceptions(std::ios::failbit);
+        input.ignore(MAGIC_NUMBER.size());
+        u32 cache_version{};
+        input.read(reinterpret_cast<char*>(&cache_version), sizeof(cache_version));
+        output.write(CONTAINER_MAGIC_NUMBER.data(), CONTAINER_MAGIC_NUMBER.size())
+            .write(reinterpret_cast<const char*>(&cache_version), sizeof(cache_version));
+
+        std::unordered_set<u64> written;
+        while (buffer.Position() != data.size()) {
+            u32 num_envs{};
+            input.read(reinterpret_cast<char*>(&num_envs), sizeof(num_envs));
+            if (num_envs == 0 || num_envs > Maxwell::MaxShaderProgram) {
+                throw std::runtime_error("Invalid number of environments in a pipeline");
+            }
+            boost::container::static_vector<u64, Maxwell::MaxShaderProgram> hashes;
+            Shader::Stage stage{};
+            for (u32 index = 0; index < num_envs; ++index) {
+                const size_t begin{buffer.Position()};
+                FileEnvironment env;
+                env.Deserialize(input);
+                stage = index == 0 ? env.ShaderStage() : stage;
+                const std::span<const u8> serialized{
+                    data.subspan(begin, buffer.Position() - begin)};
+                const u64 hash{Common::CityHash64(reinterpret_cast<const char*>(serialized.data()),
+                                                  serialized.size())};
+                hashes.push_back(hash);
+                if (!written.insert(hash).second) {
+                    continue;
+                }
+                const std::vector<u8> compressed{Common::Compression::CompressDataZSTDDefault(
+                    serialized.data(), serialized.size())};
+                const u32 size{static_cast<u32>(serialized.size())};
+                const u32 compressed_size{static_cast<u32>(compressed.size())};
+                output
+                    .write(reinterpret_cast<const char*>(&RECORD_ENVIRONMENT),
+                           sizeof(RECORD_ENVIRONMENT))
+                    .write(reinterpret_cast<const char*>(&hash), sizeof(hash))
+                    .write(reinterpret_cast<const char*>(&size), sizeof(size))
+                    .write(reinterpret_cast<const char*>(&compressed_size), sizeof(compressed_size))
+                    .write(reinterpret_cast<const char*>(compressed.data()), compressed.size());
+            }
+            const size_t key_size{stage == Shader::Stage::Compute ? compute_key_size
+                                                                  : graphics_key_size};
+            std::vector<char> key(key_size);
+            input.read(key.data(), key.size());
+            WritePipelineRecord(output, std::span(hashes.data(), hashes.size()), key);
+        }
+    }
+    return true;
+} catch (const std::exception& e) {
+    LOG_ERROR(Common_Filesystem, "Failed to migrate pipeline cache: {}", e.what());
+    std::error_code ec;
+    std::filesystem::remove(temp_filename, ec);
+    return false;
+}
+
+} // Anonymous namespace
+
 static u64 MakeCbufKey(u32 index, u32 offset) {
     return (static_cast<u64>(index) << 32) | offset;
 }
@@ -193,7 +369,7 @@ void GenericEnvironment::Dump(u64 pipeline_hash, u64 shader_hash) {
     DumpImpl(pipeline_hash, shader_hash, code, read_highest, read_lowest, initial_offset, stage);
 }
 
-void GenericEnvironment::Serialize(std::ofstream& file) const {
+void GenericEnvironment::Serialize(std::ostream& file) const {
     const u64 code_size{static_cast<u64>(CachedSizeBytes())};
     const u64 num_texture_types{static_cast<u64>(texture_types.size())};
     const u64 num_texture_pixel_formats{static_cast<u64>(texture_pixel_formats.size())};
@@ -448,7 +624,7 @@ u32 ComputeEnvironment::ReadViewportTransformState() {
     return viewport_transform_state;
 }
 
-void FileEnvironment::Deserialize(std::ifstream& file) {
+void FileEnvironment::Deserialize(std::istream& file) {
     u64 code_size{};
     u64 num_texture_types{};
     u64 num_texture_pixel_formats{};
@@ -591,20 +767,41 @@ void SerializePipeline(std::span<const char> key, std::span<const GenericEnviron
                   Common::FS::PathToUTF8String(filename));
         return;
     }
-    if (file.tellp() == 0) {
+    const bool is_new_file = file.tellp() == 0;
+    if (is_new_file) {
         // Write header
-        file.write(MAGIC_NUMBER.data(), MAGIC_NUMBER.size())
+        file.write(CONTAINER_MAGIC_NUMBER.data(), CONTAINER_MAGIC_NUMBER.size())
             .write(reinterpret_cast<const char*>(&cache_version), sizeof(cache_version));
     }
     if (!std::ranges::all_of(envs, &GenericEnvironment::CanBeSerialized)) {
         return;
     }
-    const u32 num_envs{static_cast<u32>(envs.size())};
-    file.write(reinterpret_cast<const char*>(&num_envs), sizeof(num_envs));
+    std::scoped_lock lock{stored_environments.mutex};
+    auto& stored{stored_environments.hashes[Common::FS::PathToUTF8String(filename)]};
+    if (is_new_file) {
+        stored.clear();
+    }
+    boost::container::static_vector<u64, Maxwell::MaxShaderProgram> hashes;
     for (const GenericEnvironment* const env : envs) {
-        env->Serialize(file);
+        std::ostringstream stream;
+        env->Serialize(stream);
+        const std::string serialized{std::move(stream).str()};
+        const u64 hash{Common::CityHash64(serialized.data(), serialized.size())};
+        hashes.push_back(hash);
+        if (!stored.insert(hash).second) {
+            continue;
+        }
+        const std::vector<u8> compressed{Common::Compression::CompressDataZSTDDefault(
+            reinterpret_cast<const u8*>(serialized.data()), serialized.size())};
+        const u32 size{static_cast<u32>(serialized.size())};
+        const u32 compressed_size{static_cast<u32>(compressed.size())};
+        file.write(reinterpret_cast<const char*>(&RECORD_ENVIRONMENT), sizeof(RECORD_ENVIRONMENT))
+            .write(reinterpret_cast<const char*>(&hash), sizeof(hash))
+            .write(reinterpret_cast<const char*>(&size), sizeof(size))
+            .write(reinterpret_cast<const char*>(&compressed_size), sizeof(compressed_size))
+            .write(reinterpret_cast<const char*>(compressed.data()), compressed.size());
     }
-    file.write(key.data(), key.size_bytes());
+    WritePipelineRecord(file, std::span(hashes.data(), hashes.size()), key);
 
 } catch (const std::ios_base::failure& e) {
     LOG_ERROR(Common_Filesystem, "{}", e.what());
@@ -616,27 +813,25 @@ void SerializePipeline(std::span<const char> key, std::span<const GenericEnviron
 
 void LoadPipelines(
     std::stop_token stop_loading, const std::filesystem::path& filename, u32 expected_cache_version,
-    Common::UniqueFunction<void, std::ifstream&, FileEnvironment> load_compute,
-    Common::UniqueFunction<void, std::ifstream&, std::vector<FileEnvironment>> load_graphics) try {
-    std::ifstream file(filename, std::ios::binary | std::ios::ate);
-    if (!file.is_open()) {
+    size_t compute_key_size, size_t graphics_key_size,
+    Common::UniqueFunction<void, std::span<const char>, std::shared_ptr<FileEnvironment>>
+        load_compute,
+    Common::UniqueFunction<void, std::span<const char>,
+                           std::vector<std::shared_ptr<FileEnvironment>>>
+        load_graphics) {
+    using Clock = std::chrono::steady_clock;
+    const auto start_time{Clock::now()};
+
+    Common::FS::MappedFile file{filename};
+    if (!file.IsOpen()) {
         return;
     }
-    file.exceptions(std::ifstream::failbit);
-    const auto end{file.tellg()};
-    file.seekg(0, std::ios::beg);
-
-    std::array<char, 8> magic_number;
-    u32 cache_version;
-    file.read(magic_number.data(), magic_number.size())
-        .read(reinterpret_cast<char*>(&cache_version), sizeof(cache_version));
-    if (magic_number != MAGIC_NUMBER || cache_version != expected_cache_version) {
-        file.close();
+    const auto delete_cache{[&](bool is_invalid) {
+        file.Close();
         if (Common::FS::RemoveFile(filename)) {
-            if (magic_number != MAGIC_NUMBER) {
+            if (is_invalid) {
                 LOG_ERROR(Common_Filesystem, "Invalid pipeline cache file");
-            }
-            if (cache_version != expected_cache_version) {
+            } else {
                 LOG_INFO(Common_Filesystem, "Deleting old pipeline cache");
             }
         } else {
@@ -644,31 +839,203 @@ void LoadPipelines(
                       "Invalid pipeline cache file and failed to delete it in \"{}\"",
                       Common::FS::PathToUTF8String(filename));
         }
+    }};
+    std::array<char, 8> magic_number{};
+    u32 cache_version{};
+    RecordReader header{file.Span()};
+    if (!header.Read(magic_number) || !header.Read(cache_version)) {
+        delete_cache(true);
         return;
     }
-    while (file.tellg() != end) {
-        if (stop_loading.stop_requested()) {
+    if (magic_number == MAGIC_NUMBER && cache_version == expected_cache_version) {
+        // Pipelines are still compatible, only the container changed. The mapping has to be
+        // released before the migrated cache replaces it. A legacy cache that can not be migrated
+        // is deleted, otherwise new pipelines would be appended to it in the container format.
+        auto temp_filename{filename};
+        temp_filename += ".tmp";
+        const bool migrated{MigrateLegacyCache(file.Span(), temp_filename, compute_key_size,
+                                               graphics_key_size)};
+        file.Close();
+        if (!migrated) {
+            delete_cache(true);
             return;
         }
-        u32 num_envs{};
-        file.read(reinterpret_cast<char*>(&num_envs), sizeof(num_envs));
-        std::vector<FileEnvironment> envs(num_envs);
-        for (FileEnvironment& env : envs) {
-            env.Deserialize(file);
+        std::error_code ec;
+        std::filesystem::rename(temp_filename, filename, ec);
+        if (ec) {
+            LOG_ERROR(Common_Filesystem, "Failed to replace pipeline cache {}: {}",
+                      Common::FS::PathToUTF8String(filename), ec.message());
+            std::filesystem::remove(temp_filename, ec);
+            delete_cache(false);
+            return;
+        }
+        LOG_INFO(Common_Filesystem, "Migrated pipeline cache {} to the compressed format",
+                 Common::FS::PathToUTF8String(filename));
+        file.Open(filename);
+        if (!file.IsOpen()) {
+            return;
+        }
+    } else if (magic_number != CONTAINER_MAGIC_NUMBER ||
+               cache_version != expected_cache_version) {
+        delete_cache(magic_number != MAGIC_NUMBER && magic_number != CONTAINER_MAGIC_NUMBER);
+        return;
+    }
+
+    // Index the file. Payloads are not touched here, only record headers are read.
+    struct EnvironmentEntry {
+        std::span<const u8> compressed;
+        u32 size;
+        std::shared_ptr<FileEnvironment> env;
+    };
+    struct PipelineEntry {
+        boost::container::static_vector<u64, Maxwell::MaxShaderProgram> hashes;
+        std::span<const u8> key;
+    };
+    std::unordered_map<u64, EnvironmentEntry> environments;
+    std::vector<PipelineEntry> pipelines;
+    size_t num_references{};
+    size_t decompressed_bytes{};
+
+    RecordReader reader{file.Span()};
+    reader.Skip(CONTAINER_MAGIC_NUMBER.size() + sizeof(u32));
+    size_t valid_size{reader.Offset()};
+    while (!reader.AtEnd()) {
+        u8 type{};
+        if (!reader.Read(type)) {
+            break;
         }
-        if (envs.front().ShaderStage() == Shader::Stage::Compute) {
-            load_compute(file, std::move(envs.front()));
+        if (type == RECORD_ENVIRONMENT) {
+            u64 hash{};
+            u32 size{};
+            u32 compressed_size{};
+            std::span<const u8> compressed;
+            if (!reader.Read(hash) || !reader.Read(size) || !reader.Read(compressed_size) ||
+                !reader.ReadSpan(compressed_size, compressed)) {
+                break;
+            }
+            if (environments.try_emplace(hash, compressed, size, nullptr).second) {
+                decompressed_bytes += size;
+            }
+        } else if (type == RECORD_PIPELINE) {
+            u32 num_envs{};
+            if (!reader.Read(num_envs) || num_envs == 0 ||
+                num_envs > Maxwell::MaxShaderProgram) {
+                break;
+            }
+            PipelineEntry& pipeline{pipelines.emplace_back()};
+            pipeline.hashes.resize(num_envs);
+            bool is_valid{true};
+            for (u64& hash : pipeline.hashes) {
+                is_valid &= reader.Read(hash);
+            }
+            u32 key_size{};
+            if (!is_valid || !reader.Read(key_size) || !reader.ReadSpan(key_size, pipeline.key)) {
+                pipelines.pop_back();
+                break;
+            }
+            num_references += num_envs;
         } else {
-            load_graphics(file, std::move(envs));
+            break;
         }
+        valid_size = reader.Offset();
     }
+    const size_t file_size{file.Span().size()};
+    const auto index_time{Clock::now()};
+
+    // Decompress and deserialize every unique environment once, in parallel
+    {
+        std::vector<EnvironmentEntry*> pending;
+        pending.reserve(environments.size());
+        for (auto& [hash, entry] : environments) {
+            pending.push_back(&entry);
+        }
+        static constexpr size_t ENVIRONMENTS_PER_TASK = 32;
+        Common::ThreadWorker parse_workers(
+            std::max(std::thread::hardware_concurrency(), 2U) - 1, "PipelineCacheParse");
+        for (size_t first = 0; first < pending.size(); first += ENVIRONMENTS_PER_TASK) {
+            const size_t last{std::min(first + ENVIRONMENTS_PER_TASK, pending.size())};
+            parse_workers.QueueWork([&pending, &stop_loading, first, last] {
+                for (size_t index = first; index < last; ++index) {
+                    if (stop_loading.stop_requested()) {
+                        return;
+                    }
+                    EnvironmentEntry& entry{*pending[index]};
+                    const std::vector<u8> serialized{
+                        Common::Compression::DecompressDataZSTD(entry.compressed)};
+                    if (serialized.size() != entry.size) {
+                        continue;
+                    }
+                    entry.env = DeserializeEnvironment(serialized);
+                }
+            });
+        }
+        parse_workers.WaitForRequests(stop_loading);
+    }
+    const auto parse_time{Clock::now()};
 
-} catch (const std::ios_base::failure& e) {
-    LOG_ERROR(Common_Filesystem, "{}", e.what());
-    if (!Common::FS::RemoveFile(filename)) {
-        LOG_ERROR(Common_Filesystem, "Failed to delete pipeline cache file {}",
-                  Common::FS::PathToUTF8String(filename));
+    size_t num_loaded{};
+    for (const PipelineEntry& pipeline : pipelines) {
+        if (stop_loading.stop_requested()) {
+            return;
+        }
+        std::vector<std::shared_ptr<FileEnvironment>> envs;
+        envs.reserve(pipeline.hashes.size());
+        for (const u64 hash : pipeline.hashes) {
+            const auto it{environments.find(hash)};
+            if (it == environments.end() || !it->second.env) {
+                break;
+            }
+            envs.push_back(it->second.env);
+        }
+        if (envs.size() != pipeline.hashes.size()) {
+            continue;
+        }
+        const bool is_compute{envs.front()->ShaderStage() == Shader::Stage::Compute};
+        if (pipeline.key.size() != (is_compute ? compute_key_size : graphics_key_size)) {
+            continue;
+        }
+        std::span<const char> key{reinterpret_cast<const char*>(pipeline.key.data()),
+                                  pipeline.key.size()};
+        if (is_compute) {
+            load_compute(std::move(key), std::move(envs.front()));
+        } else {
+            load_graphics(std::move(key), std::move(envs));
+        }
+        ++num_loaded;
     }
+    const auto dispatch_time{Clock::now()};
+
+    {
+        std::scoped_lock lock{stored_environments.mutex};
+        auto& stored{stored_environments.hashes[Common::FS::PathToUTF8String(filename)]};
+        stored.clear();
+        for (const auto& [hash, entry] : environments) {
+            stored.insert(hash);
+        }
+    }
+    file.Close();
+    if (valid_size != file_size) {
+        // Drop a partially written record so new pipelines can be appended after it
+        LOG_WARNING(Common_Filesystem, "Truncating pipeline cache with {} invalid trailing bytes",
+                    file_size - valid_size);
+        std::error_code ec;
+        std::filesystem::resize_file(filename, valid_size, ec);
+    }
+
+    const auto to_ms{[](Clock::duration duration) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+    }};
+    LOG_INFO(Common_Filesystem,
+             "Pipeline cache: {} of {} pipelines loaded, {} unique shaders for {} references "
+             "({:.2f}x deduplication), {} bytes on disk, {} bytes decompressed",
+             num_loaded, pipelines.size(), environments.size(), num_references,
+             environments.empty() ? 0.0
+                                  : static_cast<double>(num_references) /
+                                        static_cast<double>(environments.size()),
+             file_size, decompressed_bytes);
+    LOG_INFO(Common_Filesystem, "Pipeline cache timings: index {} ms, parse {} ms, dispatch {} ms",
+             to_ms(index_time - start_time), to_ms(parse_time - index_time),
+             to_ms(dispatch_time - parse_time));
 }
 
 } // namespace VideoCommon
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <array>
+#include <cstring>
 #include <filesystem>
 #include <iosfwd>
 #include <limits>
@@ -60,7 +61,7 @@ public:
 
     void Dump(u64 pipeline_hash, u64 shader_hash) override;
 
-    void Serialize(std::ofstream& file) const;
+    void Serialize(std::ostream& file) const;
 
     bool HasHLEMacroState() const override {
         return has_hle_engine_state;
@@ -165,7 +166,7 @@ public:
     FileEnvironment& operator=(const FileEnvironment&) = delete;
     FileEnvironment(const FileEnvironment&) = delete;
 
-    void Deserialize(std::ifstream& file);
+    void Deserialize(std::istream& file);
 
     [[nodiscard]] u64 ReadInstruction(u32 address) override;
 
@@ -224,9 +225,39 @@ void SerializePipeline(const Key& key, const Envs& envs, const std::filesystem::
                       std::span(envs.data(), envs.size()), filename, cache_version);
 }
 
+/// Loads every pipeline stored in the cache. Unique shader environments are decompressed and
+/// parsed in parallel before the callbacks are invoked in the order pipelines were stored.
+/// Environments shared between pipelines are passed as the same object.
 void LoadPipelines(
     std::stop_token stop_loading, const std::filesystem::path& filename, u32 expected_cache_version,
-    Common::UniqueFunction<void, std::ifstream&, FileEnvironment> load_compute,
-    Common::UniqueFunction<void, std::ifstream&, std::vector<FileEnvironment>> load_graphics);
+    size_t compute_key_size, size_t graphics_key_size,
+    Common::UniqueFunction<void, std::span<const char>, std::shared_ptr<FileEnvironment>>
+        load_compute,
+    Common::UniqueFunction<void, std::span<const char>,
+                           std::vector<std::shared_ptr<FileEnvironment>>>
+        load_graphics);
+
+template <typename ComputeKey, typename GraphicsKey, typename LoadCompute, typename LoadGraphics>
+void LoadPipelines(std::stop_token stop_loading, const std::filesystem::path& filename,
+                   u32 expected_cache_version, LoadCompute&& load_compute,
+                   LoadGraphics&& load_graphics) {
+    static_assert(std::is_trivially_copyable_v<ComputeKey>);
+    static_assert(std::is_trivially_copyable_v<GraphicsKey>);
+    LoadPipelines(
+        stop_loading, filename, expected_cache_version, sizeof(ComputeKey), sizeof(GraphicsKey),
+        [load = std::forward<LoadCompute>(load_compute)](
+            std::span<const char> key_data, std::shared_ptr<FileEnvironment> env) mutable {
+            ComputeKey key;
+            std::memcpy(&key, key_data.data(), sizeof(key));
+            load(key, std::move(env));
+        },
+        [load = std::forward<LoadGraphics>(load_graphics)](
+            std::span<const char> key_data,
+            std::vector<std::shared_ptr<FileEnvironment>> envs) mutable {
+            GraphicsKey key;
+            std::memcpy(&key, key_data.data(), sizeof(key));
+            load(key, std::move(envs));
+        });
+}
 
 } // namespace VideoCommon
@@ -11,6 +11,11 @@ class ShaderNotify {
 public:
     [[nodiscard]] int ShadersBuilding() noexcept;
 
+    /// Returns the number of pipelines that finished building since boot
+    [[nodiscard]] int ShadersCompleted() const noexcept {
+        return num_complete.load(std::memory_order::relaxed);
+    }
+
     void MarkShaderComplete() noexcept {
         ++num_complete;
     }
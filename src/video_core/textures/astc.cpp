@@ -19,6 +19,11 @@
 #include "video_core/textures/astc.h"
 #include "video_core/textures/workers.h"
 
+#ifdef ARCHITECTURE_x86_64
+#include "common/x64/cpu_detect.h"
+#include "common/x64/simd_target.h"
+#endif
+
 class InputBitStream {
 public:
     constexpr explicit InputBitStream(std::span<const u8> data, size_t start_offset = 0)
@@ -1419,7 +1424,187 @@ static void FillError(std::span<u32> outBuf, u32 blockWidth, u32 blockHeight) {
     }
 }
 
-static void DecompressBlock(std::span<const u8, 16> inBuf, const u32 blockWidth,
+enum class DecodePath {
+    Scalar,
+    SSE41,
+    AVX2,
+};
+
+static DecodePath DetectDecodePath() {
+#ifdef ARCHITECTURE_x86_64
+    const auto& caps = Common::GetCPUCaps();
+    if (caps.avx2) {
+        return DecodePath::AVX2;
+    }
+    if (caps.sse4_1) {
+        return DecodePath::SSE41;
+    }
+#endif
+    return DecodePath::Scalar;
+}
+
+// Endpoints of a single partition block, expanded to 16 bits and laid out in the R8G8B8A8 order
+// of the output texels. plane_mask selects the second weight plane for a channel.
+struct SinglePartitionEndpoints {
+    alignas(16) u32 c0[4];
+    alignas(16) u32 c1[4];
+    alignas(16) u32 plane_mask[4];
+};
+
+// Weight planes of a block. Both entries point to the same plane for single plane blocks.
+using Weights = std::array<const u32*, 2>;
+
+// Converts an interpolated 16-bit channel back to 8 bits. This is the integer equivalent of
+// 255.0 * (C / 65536.0) + 0.5 truncated, which is exact for every C in [0, 65535].
+static constexpr u32 InterpolatedTo8(u32 value) {
+    return (value * 255 + 32768) >> 16;
+}
+
+static u32 InterpolateTexelScalar(const SinglePartitionEndpoints& ep, const Weights& weights,
+                                  u32 index) {
+    u32 texel = 0;
+    for (u32 lane = 0; lane < 4; ++lane) {
+        const u32 weight = weights[ep.plane_mask[lane] != 0 ? 1 : 0][index];
+        const u32 c = (ep.c0[lane] * (64 - weight) + ep.c1[lane] * weight + 32) / 64;
+        texel |= InterpolatedTo8(c) << (lane * 8);
+    }
+    return texel;
+}
+
+#ifdef ARCHITECTURE_x86_64
+CITRON_TARGET_SSE41 static __m128i InterpolateLanesSSE41(__m128i c0, __m128i c1, __m128i weight) {
+    const __m128i inv_weight = _mm_sub_epi32(_mm_set1_epi32(64), weight);
+    __m128i c = _mm_add_epi32(_mm_mullo_epi32(c0, inv_weight), _mm_mullo_epi32(c1, weight));
+    c = _mm_srli_epi32(_mm_add_epi32(c, _mm_set1_epi32(32)), 6);
+    c = _mm_mullo_epi32(c, _mm_set1_epi32(255));
+    return _mm_srli_epi32(_mm_add_epi32(c, _mm_set1_epi32(32768)), 16);
+}
+
+CITRON_TARGET_SSE41 static __m128i LoadWeightSSE41(const Weights& weights, u32 index,
+                                                    __m128i plane_mask) {
+    return _mm_blendv_epi8(_mm_set1_epi32(static_cast<s32>(weights[0][index])),
+                           _mm_set1_epi32(static_cast<s32>(weights[1][index])), plane_mask);
+}
+
+CITRON_TARGET_SSE41 static u32 InterpolateSSE41(const SinglePartitionEndpoints& ep,
+                                                const Weights& weights, u32 begin, u32 end,
+                                                std::span<u32, 12 * 12> out) {
+    const __m128i c0 = _mm_load_si128(reinterpret_cast<const __m128i*>(ep.c0));
+    const __m128i c1 = _mm_load_si128(reinterpret_cast<const __m128i*>(ep.c1));
+    const __m128i plane_mask = _mm_load_si128(reinterpret_cast<const __m128i*>(ep.plane_mask));
+
+    u32 index = begin;
+    for (; index + 4 <= end; index += 4) {
+        const __m128i p0 =
+            InterpolateLanesSSE41(c0, c1, LoadWeightSSE41(weights, index, plane_mask));
+        const __m128i p1 =
+            InterpolateLanesSSE41(c0, c1, LoadWeightSSE41(weights, index + 1, plane_mask));
+        const __m128i p2 =
+            InterpolateLanesSSE41(c0, c1, LoadWeightSSE41(weights, index + 2, plane_mask));
+        const __m128i p3 =
+            InterpolateLanesSSE41(c0, c1, LoadWeightSSE41(weights, index + 3, plane_mask));
+        const __m128i packed =
+            _mm_packus_epi16(_mm_packus_epi32(p0, p1), _mm_packus_epi32(p2, p3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out.data() + index), packed);
+    }
+    for (; index < end; ++index) {
+        const __m128i p =
+            InterpolateLanesSSE41(c0, c1, LoadWeightSSE41(weights, index, plane_mask));
+        const __m128i packed = _mm_packus_epi16(_mm_packus_epi32(p, p), p);
+        out[index] = static_cast<u32>(_mm_cvtsi128_si32(packed));
+    }
+    return index;
+}
+
+CITRON_TARGET_AVX2 static __m256i InterpolateLanesAVX2(__m256i c0, __m256i c1, __m256i weight) {
+    const __m256i inv_weight = _mm256_sub_epi32(_mm256_set1_epi32(64), weight);
+    __m256i c =
+        _mm256_add_epi32(_mm256_mullo_epi32(c0, inv_weight), _mm256_mullo_epi32(c1, weight));
+    c = _mm256_srli_epi32(_mm256_add_epi32(c, _mm256_set1_epi32(32)), 6);
+    c = _mm256_mullo_epi32(c, _mm256_set1_epi32(255));
+    return _mm256_srli_epi32(_mm256_add_epi32(c, _mm256_set1_epi32(32768)), 16);
+}
+
+// Broadcasts two consecutive weights of each plane so that every texel covers four lanes.
+CITRON_TARGET_AVX2 static __m256i LoadWeightPairAVX2(const Weights& weights, u32 index,
+                                                     __m256i plane_mask) {
+    const __m256i spread = _mm256_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1);
+    const __m128i pair0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&weights[0][index]));
+    const __m128i pair1 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&weights[1][index]));
+    const __m256i plane0 = _mm256_permutevar8x32_epi32(_mm256_castsi128_si256(pair0), spread);
+    const __m256i plane1 = _mm256_permutevar8x32_epi32(_mm256_castsi128_si256(pair1), spread);
+    return _mm256_blendv_epi8(plane0, plane1, plane_mask);
+}
+
+CITRON_TARGET_AVX2 static u32 InterpolateAVX2(const SinglePartitionEndpoints& ep,
+                                              const Weights& weights, u32 end,
+                                              std::span<u32, 12 * 12> out) {
+    const __m256i c0 = _mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<const __m128i*>(ep.c0)));
+    const __m256i c1 = _mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<const __m128i*>(ep.c1)));
+    const __m256i plane_mask = _mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<const __m128i*>(ep.plane_mask)));
+    // packus works within 128-bit lanes, leaving texels ordered 0,2,4,6,1,3,5,7
+    const __m256i reorder = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    u32 index = 0;
+    for (; index + 8 <= end; index += 8) {
+        const __m256i p01 =
+            InterpolateLanesAVX2(c0, c1, LoadWeightPairAVX2(weights, index, plane_mask));
+        const __m256i p23 =
+            InterpolateLanesAVX2(c0, c1, LoadWeightPairAVX2(weights, index + 2, plane_mask));
+        const __m256i p45 =
+            InterpolateLanesAVX2(c0, c1, LoadWeightPairAVX2(weights, index + 4, plane_mask));
+        const __m256i p67 =
+            InterpolateLanesAVX2(c0, c1, LoadWeightPairAVX2(weights, index + 6, plane_mask));
+        const __m256i packed = _mm256_packus_epi16(_mm256_packus_epi32(p01, p23),
+                                                   _mm256_packus_epi32(p45, p67));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out.data() + index),
+                            _mm256_permutevar8x32_epi32(packed, reorder));
+    }
+    return index;
+}
+#endif
+
+// Interpolates every texel of a single partition block. Returns false when the block has to go
+// through the generic path instead.
+static bool InterpolateSinglePartition(DecodePath path, const Pixel (&endpoints)[2],
+                                       const u32 (&plane_weights)[2][144], bool dual_plane,
+                                       u32 plane_idx, u32 num_texels,
+                                       std::span<u32, 12 * 12> out) {
+    const Weights weights{plane_weights[0], plane_weights[dual_plane ? 1 : 0]};
+    SinglePartitionEndpoints ep;
+    // Pixel stores A, R, G, B while the output texel is R8G8B8A8
+    static constexpr std::array<u32, 4> component_of_lane{1, 2, 3, 0};
+    for (u32 lane = 0; lane < 4; ++lane) {
+        const u32 c = component_of_lane[lane];
+        ep.c0[lane] = ReplicateByteTo16(static_cast<u32>(endpoints[0].Component(c)));
+        ep.c1[lane] = ReplicateByteTo16(static_cast<u32>(endpoints[1].Component(c)));
+        ep.plane_mask[lane] = dual_plane && (((plane_idx + 1) & 3) == c) ? 0xFFFFFFFF : 0;
+    }
+
+    u32 index = 0;
+    switch (path) {
+#ifdef ARCHITECTURE_x86_64
+    case DecodePath::AVX2:
+        index = InterpolateAVX2(ep, weights, num_texels, out);
+        index = InterpolateSSE41(ep, weights, index, num_texels, out);
+        break;
+    case DecodePath::SSE41:
+        index = InterpolateSSE41(ep, weights, 0, num_texels, out);
+        break;
+#endif
+    default:
+        return false;
+    }
+    for (; index < num_texels; ++index) {
+        out[index] = InterpolateTexelScalar(ep, weights, index);
+    }
+    return true;
+}
+
+static void DecompressBlock(DecodePath path, std::span<const u8, 16> inBuf, const u32 blockWidth,
                             const u32 blockHeight, std::span<u32, 12 * 12> outBuf) {
     InputBitStream strm(inBuf);
     TexelWeightParams weightParams = DecodeBlockInfo(strm);
@@ -1619,6 +1804,11 @@ static void DecompressBlock(std::span<const u8, 16> inBuf, const u32 blockWidth,
 
     // Now that we have endpoints and weights, we can interpolate and generate
     // the proper decoding...
+    if (nPartitions == 1 &&
+        InterpolateSinglePartition(path, endpoints[0], weights, weightParams.m_bDualPlane,
+                                   planeIdx, blockWidth * blockHeight, outBuf)) {
+        return;
+    }
     for (u32 j = 0; j < blockHeight; j++)
         for (u32 i = 0; i < blockWidth; i++) {
             u32 partition = Select2DPartition(partitionIndex, i, j, nPartitions,
@@ -1639,20 +1829,16 @@ static void DecompressBlock(std::span<const u8, 16> inBuf, const u32 blockWidth,
 
                 u32 weight = weights[plane][j * blockWidth + i];
                 u32 C = (C0 * (64 - weight) + C1 * weight + 32) / 64;
-                if (C == 65535) {
-                    p.Component(c) = 255;
-                } else {
-                    double Cf = static_cast<double>(C);
-                    p.Component(c) = static_cast<u16>(255.0 * (Cf / 65536.0) + 0.5);
-                }
+                p.Component(c) = static_cast<u16>(InterpolatedTo8(C));
             }
 
             outBuf[j * blockWidth + i] = p.Pack();
         }
 }
 
-void Decompress(std::span<const uint8_t> data, uint32_t width, uint32_t height, uint32_t depth,
-                uint32_t block_width, uint32_t block_height, std::span<uint8_t> output) {
+static void DecompressImage(DecodePath path, std::span<const uint8_t> data, uint32_t width,
+                            uint32_t height, uint32_t depth, uint32_t block_width,
+                            uint32_t block_height, std::span<uint8_t> output) {
     const u32 rows = Common::DivideUp(height, block_height);
     const u32 cols = Common::DivideUp(width, block_width);
 
@@ -1661,8 +1847,8 @@ void Decompress(std::span<const uint8_t> data, uint32_t width, uint32_t height,
     for (u32 z = 0; z < depth; ++z) {
         const u32 depth_offset = z * height * width * 4;
         for (u32 y_index = 0; y_index < rows; ++y_index) {
-            auto decompress_stride = [data, width, height, block_width, block_height, output, rows,
-                                      cols, z, depth_offset, y_index] {
+            auto decompress_stride = [path, data, width, height, block_width, block_height,
+                                      output, rows, cols, z, depth_offset, y_index] {
                 const u32 y = y_index * block_height;
                 for (u32 x_index = 0; x_index < cols; ++x_index) {
                     const u32 block_index = (z * rows * cols) + (y_index * cols) + x_index;
@@ -1672,7 +1858,7 @@ void Decompress(std::span<const uint8_t> data, uint32_t width, uint32_t height,
 
                     // Blocks can be at most 12x12
                     std::array<u32, 12 * 12> uncompData;
-                    DecompressBlock(blockPtr, block_width, block_height, uncompData);
+                    DecompressBlock(path, blockPtr, block_width, block_height, uncompData);
 
                     u32 decompWidth = std::min(block_width, width - x);
                     u32 decompHeight = std::min(block_height, height - y);
@@ -1690,4 +1876,17 @@ void Decompress(std::span<const uint8_t> data, uint32_t width, uint32_t height,
     }
 }
 
+void Decompress(std::span<const uint8_t> data, uint32_t width, uint32_t height, uint32_t depth,
+                uint32_t block_width, uint32_t block_height, std::span<uint8_t> output) {
+    static const DecodePath path = DetectDecodePath();
+    DecompressImage(path, data, width, height, depth, block_width, block_height, output);
+}
+
+void DecompressScalar(std::span<const uint8_t> data, uint32_t width, uint32_t height,
+                      uint32_t depth, uint32_t block_width, uint32_t block_height,
+                      std::span<uint8_t> output) {
+    DecompressImage(DecodePath::Scalar, data, width, height, depth, block_width, block_height,
+                    output);
+}
+
 } // namespace Tegra::Texture::ASTC
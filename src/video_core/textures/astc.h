@@ -3,9 +3,17 @@
 
 #pragma once
 
+#include <cstdint>
+#include <span>
+
 namespace Tegra::Texture::ASTC {
 
 void Decompress(std::span<const uint8_t> data, uint32_t width, uint32_t height, uint32_t depth,
                 uint32_t block_width, uint32_t block_height, std::span<uint8_t> output);
 
+/// Same as Decompress, but never takes the vectorized fast paths. Used as the reference decoder.
+void DecompressScalar(std::span<const uint8_t> data, uint32_t width, uint32_t height,
+                      uint32_t depth, uint32_t block_width, uint32_t block_height,
+                      std::span<uint8_t> output);
+
 } // namespace Tegra::Texture::ASTC
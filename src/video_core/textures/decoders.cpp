@@ -10,11 +10,16 @@
 #include "common/assert.h"
 #include "common/bit_util.h"
 #include "common/div_ceil.h"
+#include "common/literals.h"
 #include "video_core/gpu.h"
 #include "video_core/textures/decoders.h"
+#include "video_core/textures/workers.h"
 
 namespace Tegra::Texture {
 namespace {
+
+using namespace Common::Literals;
+
 template <u32 mask>
 constexpr u32 pdep(u32 value) {
     u32 result = 0;
@@ -33,61 +38,162 @@ void incrpdep(u32& value) {
     value = ((value | ~mask) + swizzled_incr) & mask;
 }
 
+/// Size of the contiguous runs a GOB row is split into (16 bytes x 2 sector packing)
+constexpr u32 GOB_RUN_SIZE = 16;
+constexpr u32 GOB_RUNS_PER_ROW = GOB_SIZE_X / GOB_RUN_SIZE;
+
+/// Offset within a GOB of each run, indexed by line and run
+constexpr auto GOB_RUN_OFFSETS = [] {
+    std::array<std::array<u32, GOB_RUNS_PER_ROW>, GOB_SIZE_Y> offsets{};
+    for (u32 line = 0; line < GOB_SIZE_Y; ++line) {
+        for (u32 run = 0; run < GOB_RUNS_PER_ROW; ++run) {
+            offsets[line][run] =
+                pdep<SWIZZLE_Y_BITS>(line) | pdep<SWIZZLE_X_BITS>(run * GOB_RUN_SIZE);
+        }
+    }
+    return offsets;
+}();
+
+/// Surfaces at least this large are swizzled on the texture worker threads
+constexpr size_t MULTI_THREAD_THRESHOLD = 4_MiB;
+/// Approximate amount of linear bytes handled by each worker task
+constexpr size_t MULTI_THREAD_TASK_SIZE = 1_MiB;
+
+/// Copies a 16 byte run between the linear and swizzled buffers, compiles to a single vector move
+template <bool TO_LINEAR>
+void CopyRun(std::span<u8> output, std::span<const u8> input, u32 swizzled_offset,
+             u32 unswizzled_offset) {
+    u8* const dst = &output[TO_LINEAR ? swizzled_offset : unswizzled_offset];
+    const u8* const src = &input[TO_LINEAR ? unswizzled_offset : swizzled_offset];
+    std::memcpy(dst, src, GOB_RUN_SIZE);
+}
+
+/// Swizzles the GOB rows [first_gob_row, last_gob_row) of a surface, counted across slices.
+/// Each GOB row is processed one GOB at a time, copying every line of the GOB in 16 byte runs.
 template <bool TO_LINEAR, u32 BYTES_PER_PIXEL>
-void SwizzleImpl(std::span<u8> output, std::span<const u8> input, u32 width, u32 height, u32 depth,
-                 u32 block_height, u32 block_depth, u32 stride) {
-    // The origin of the transformation can be configured here, leave it as zero as the current API
-    // doesn't expose it.
-    static constexpr u32 origin_x = 0;
-    static constexpr u32 origin_y = 0;
-    static constexpr u32 origin_z = 0;
+void SwizzleGobRows(std::span<u8> output, std::span<const u8> input, u32 width, u32 height,
+                    u32 block_height, u32 block_depth, u32 stride, u32 first_gob_row,
+                    u32 last_gob_row) {
+    static_assert(GOB_RUN_SIZE % BYTES_PER_PIXEL == 0, "Pixels must not straddle GOB runs");
 
-    // We can configure here a custom pitch
-    // As it's not exposed 'width * BYTES_PER_PIXEL' will be the expected pitch.
+    // As the current API doesn't expose a custom pitch, 'width * BYTES_PER_PIXEL' is expected.
     const u32 pitch = width * BYTES_PER_PIXEL;
 
     const u32 gobs_in_x = Common::DivCeilLog2(stride, GOB_SIZE_X_SHIFT);
     const u32 block_size = gobs_in_x << (GOB_SIZE_SHIFT + block_height + block_depth);
     const u32 slice_size =
         Common::DivCeilLog2(height, block_height + GOB_SIZE_Y_SHIFT) * block_size;
+    const u32 gob_rows_per_slice = Common::DivCeilLog2(height, GOB_SIZE_Y_SHIFT);
 
     const u32 block_height_mask = (1U << block_height) - 1;
     const u32 block_depth_mask = (1U << block_depth) - 1;
     const u32 x_shift = GOB_SIZE_SHIFT + block_height + block_depth;
 
-    for (u32 slice = 0; slice < depth; ++slice) {
-        const u32 z = slice + origin_z;
+    for (u32 gob_row = first_gob_row; gob_row < last_gob_row; ++gob_row) {
+        const u32 z = gob_row / gob_rows_per_slice;
+        const u32 block_y = gob_row % gob_rows_per_slice;
         const u32 offset_z = (z >> block_depth) * slice_size +
                              ((z & block_depth_mask) << (GOB_SIZE_SHIFT + block_height));
-        for (u32 line = 0; line < height; ++line) {
-            const u32 y = line + origin_y;
-            const u32 swizzled_y = pdep<SWIZZLE_Y_BITS>(y);
-
-            const u32 block_y = y >> GOB_SIZE_Y_SHIFT;
-            const u32 offset_y = (block_y >> block_height) * block_size +
-                                 ((block_y & block_height_mask) << GOB_SIZE_SHIFT);
-
-            u32 swizzled_x = pdep<SWIZZLE_X_BITS>(origin_x * BYTES_PER_PIXEL);
-            for (u32 column = 0; column < width;
-                 ++column, incrpdep<SWIZZLE_X_BITS, BYTES_PER_PIXEL>(swizzled_x)) {
-                const u32 x = (column + origin_x) * BYTES_PER_PIXEL;
-                const u32 offset_x = (x >> GOB_SIZE_X_SHIFT) << x_shift;
-
-                const u32 base_swizzled_offset = offset_z + offset_y + offset_x;
-                const u32 swizzled_offset = base_swizzled_offset + (swizzled_x | swizzled_y);
-
-                const u32 unswizzled_offset =
-                    slice * pitch * height + line * pitch + column * BYTES_PER_PIXEL;
-
-                u8* const dst = &output[TO_LINEAR ? swizzled_offset : unswizzled_offset];
-                const u8* const src = &input[TO_LINEAR ? unswizzled_offset : swizzled_offset];
-
-                std::memcpy(dst, src, BYTES_PER_PIXEL);
+        const u32 offset_y = (block_y >> block_height) * block_size +
+                             ((block_y & block_height_mask) << GOB_SIZE_SHIFT);
+
+        const u32 first_line = block_y << GOB_SIZE_Y_SHIFT;
+        const u32 num_lines = std::min(GOB_SIZE_Y, height - first_line);
+        const u32 linear_base = z * pitch * height + first_line * pitch;
+
+        for (u32 gob_x = 0; (gob_x << GOB_SIZE_X_SHIFT) < pitch; ++gob_x) {
+            const u32 x = gob_x << GOB_SIZE_X_SHIFT;
+            const u32 gob_offset = offset_z + offset_y + (gob_x << x_shift);
+            const u32 gob_bytes = std::min(GOB_SIZE_X, pitch - x);
+            const u32 num_runs = gob_bytes / GOB_RUN_SIZE;
+
+            for (u32 line = 0; line < num_lines; ++line) {
+                const auto& run_offsets = GOB_RUN_OFFSETS[line];
+                const u32 unswizzled_offset = linear_base + line * pitch + x;
+                if (num_runs == GOB_RUNS_PER_ROW) {
+                    // Unrolled by the compiler into four vector moves
+                    for (u32 run = 0; run < GOB_RUNS_PER_ROW; ++run) {
+                        CopyRun<TO_LINEAR>(output, input, gob_offset + run_offsets[run],
+                                           unswizzled_offset + run * GOB_RUN_SIZE);
+                    }
+                    continue;
+                }
+                for (u32 run = 0; run < num_runs; ++run) {
+                    CopyRun<TO_LINEAR>(output, input, gob_offset + run_offsets[run],
+                                       unswizzled_offset + run * GOB_RUN_SIZE);
+                }
+                // Trailing pixels of a partial GOB
+                const u32 line_offset = gob_offset + run_offsets[0];
+                for (u32 gob_x_byte = num_runs * GOB_RUN_SIZE; gob_x_byte < gob_bytes;
+                     gob_x_byte += BYTES_PER_PIXEL) {
+                    const u32 swizzled_offset = line_offset + pdep<SWIZZLE_X_BITS>(gob_x_byte);
+                    const u32 linear_offset = unswizzled_offset + gob_x_byte;
+                    u8* const dst = &output[TO_LINEAR ? swizzled_offset : linear_offset];
+                    const u8* const src = &input[TO_LINEAR ? linear_offset : swizzled_offset];
+                    std::memcpy(dst, src, BYTES_PER_PIXEL);
+                }
             }
         }
     }
 }
 
+/// Copies the bytes [x_begin, x_end) of a line, moving whole runs where the line covers them
+template <bool TO_LINEAR, u32 BYTES_PER_PIXEL>
+void SwizzleLine(std::span<u8> output, std::span<const u8> input, u32 line_offset, u32 x_shift,
+                 u32 x_begin, u32 x_end, u32 unswizzled_offset) {
+    static_assert(GOB_RUN_SIZE % BYTES_PER_PIXEL == 0, "Pixels must not straddle GOB runs");
+
+    const auto swizzled_offset = [line_offset, x_shift](u32 x) {
+        return line_offset + ((x >> GOB_SIZE_X_SHIFT) << x_shift) + pdep<SWIZZLE_X_BITS>(x);
+    };
+    const auto copy_pixel = [&](u32 x) {
+        const u32 linear_offset = unswizzled_offset + x - x_begin;
+        u8* const dst = &output[TO_LINEAR ? swizzled_offset(x) : linear_offset];
+        const u8* const src = &input[TO_LINEAR ? linear_offset : swizzled_offset(x)];
+        std::memcpy(dst, src, BYTES_PER_PIXEL);
+    };
+    const u32 runs_begin = std::min(Common::AlignUp(x_begin, GOB_RUN_SIZE), x_end);
+    u32 x = x_begin;
+    for (; x < runs_begin; x += BYTES_PER_PIXEL) {
+        copy_pixel(x);
+    }
+    for (; x + GOB_RUN_SIZE <= x_end; x += GOB_RUN_SIZE) {
+        const u32 run = (x % GOB_SIZE_X) / GOB_RUN_SIZE;
+        CopyRun<TO_LINEAR>(output, input,
+                           line_offset + ((x >> GOB_SIZE_X_SHIFT) << x_shift) +
+                               GOB_RUN_OFFSETS[0][run],
+                           unswizzled_offset + x - x_begin);
+    }
+    for (; x < x_end; x += BYTES_PER_PIXEL) {
+        copy_pixel(x);
+    }
+}
+
+template <bool TO_LINEAR, u32 BYTES_PER_PIXEL>
+void SwizzleImpl(std::span<u8> output, std::span<const u8> input, u32 width, u32 height, u32 depth,
+                 u32 block_height, u32 block_depth, u32 stride) {
+    const u32 num_gob_rows = Common::DivCeilLog2(height, GOB_SIZE_Y_SHIFT) * depth;
+    const size_t surface_size = static_cast<size_t>(width) * BYTES_PER_PIXEL * height * depth;
+    if (surface_size < MULTI_THREAD_THRESHOLD) {
+        SwizzleGobRows<TO_LINEAR, BYTES_PER_PIXEL>(output, input, width, height, block_height,
+                                                   block_depth, stride, 0, num_gob_rows);
+        return;
+    }
+    // GOB rows never overlap in either layout, so they can be swizzled independently
+    Common::ThreadWorker& workers{GetThreadWorkers()};
+    const size_t gob_row_size = static_cast<size_t>(width) * BYTES_PER_PIXEL * GOB_SIZE_Y;
+    const u32 gob_rows_per_task =
+        static_cast<u32>(std::max<size_t>(1, MULTI_THREAD_TASK_SIZE / gob_row_size));
+    for (u32 first = 0; first < num_gob_rows; first += gob_rows_per_task) {
+        const u32 last = std::min(first + gob_rows_per_task, num_gob_rows);
+        workers.QueueWork([=] {
+            SwizzleGobRows<TO_LINEAR, BYTES_PER_PIXEL>(output, input, width, height, block_height,
+                                                       block_depth, stride, first, last);
+        });
+    }
+    workers.WaitForRequests();
+}
+
 template <bool TO_LINEAR, u32 BYTES_PER_PIXEL>
 void SwizzleSubrectImpl(std::span<u8> output, std::span<const u8> input, u32 width, u32 height,
                         u32 depth, u32 origin_x, u32 origin_y, u32 extent_x, u32 num_lines,
@@ -126,6 +232,15 @@ void SwizzleSubrectImpl(std::span<u8> output, std::span<const u8> input, u32 wid
             const u32 offset_y = (block_y >> block_height) * block_size +
                                  ((block_y & block_height_mask) << GOB_SIZE_SHIFT);
 
+            if constexpr (GOB_RUN_SIZE % BYTES_PER_PIXEL == 0) {
+                SwizzleLine<TO_LINEAR, BYTES_PER_PIXEL>(
+                    output, input, offset_z + offset_y + swizzled_y, x_shift,
+                    origin_x * BYTES_PER_PIXEL, (origin_x + extent_x) * BYTES_PER_PIXEL,
+                    slice * pitch * height + line * pitch);
+                continue;
+            }
+
+            // Pixels of these sizes can straddle runs, copy them one at a time
             u32 swizzled_x = pdep<SWIZZLE_X_BITS>(origin_x * BYTES_PER_PIXEL);
             for (u32 column = 0; column < extent_x;
                  ++column, incrpdep<SWIZZLE_X_BITS, BYTES_PER_PIXEL>(swizzled_x)) {
@@ -161,11 +276,8 @@ void Swizzle(std::span<u8> output, std::span<const u8> input, u32 bytes_per_pixe
                                          block_depth, stride_alignment);
         BPP_CASE(1)
         BPP_CASE(2)
-        BPP_CASE(3)
         BPP_CASE(4)
-        BPP_CASE(6)
         BPP_CASE(8)
-        BPP_CASE(12)
         BPP_CASE(16)
 #undef BPP_CASE
     default: